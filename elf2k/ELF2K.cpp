@@ -132,6 +132,7 @@ int main (int argc, char *argv[])
   g_pMemory->SetROM(ROMBASE, ROMBASE+ROMSIZE-1);
   g_pInterrupt = DBGNEW CSimpleInterrupt();
   g_pCPU = DBGNEW CCOSMAC(g_pMemory, g_pEvents, g_pInterrupt);
+  g_pMemory->SetCPU(g_pCPU);
 //g_pDisplay = DBGNEW CDisplay(PORT_POST);
 //g_pSwitches = DBGNEW CSwitches(PORT_SWITCHES);
 //g_pCPU->InstallDevice(g_pDisplay);
@@ -152,6 +153,8 @@ int main (int argc, char *argv[])
 
   //   Lastly, create the command line parser.  If a startup script was
   // specified on the command line, now is the time to execute it...
+  CStandardUI::g_pCPU = g_pCPU;  g_pCPU->SetWarpConsole(g_pConsole);
+  CStandardUI::g_pConsole = g_pConsole;
   g_pParser = DBGNEW CCmdParser(PROGRAM, CUI::g_aVerbs, &ConfirmExit, g_pConsole);
   if (!CStandardUI::g_sStartupScript.empty())
     g_pParser->OpenScript(CStandardUI::g_sStartupScript);
@@ -161,6 +164,7 @@ int main (int argc, char *argv[])
   // types "EXIT" or "QUIT", the command parser exits and then we shutdown
   // the ELF2K program.
   g_pParser->CommandLoop();
+  CStandardUI::DumpStatistics();
   LOGS(DEBUG, "command parser exited");
 
 shutdown:
@@ -28,6 +28,8 @@
 //    
 // REVISION HISTORY:
 // 23-JUL-19  RLA   New file.
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -176,7 +178,8 @@ CCmdModifier * const CUI::m_modsLoadSave[] = {&m_modFileFormat, &m_modBaseAddres
                                               &m_modByteCount, &m_modRAM, &m_modROM, 
                                               &m_modNVR, &m_modOverwrite, NULL};
 CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoadSave);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave, g_aSaveVerbs);
 
 // ATTACH and DETACH commands ...
 CCmdArgument * const CUI::m_argsAttachIDE[] = {&m_argFileName, NULL};
@@ -265,7 +268,7 @@ CCmdModifier * const CUI::m_modsSetUART[] = {&m_modDelay, &m_modPollDelay, NULL}
 CCmdModifier * const CUI::m_modsSetIDE[] = {&m_modDelayList, NULL};
 CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modIllegalIO, &m_modIllegalOpcode, 
                                             &m_modBreakChar, &m_modEFdefault, 
-                                            &m_modCPUextended, NULL};
+                                            &m_modCPUextended, &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL};
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdSetMemory = {"MEM*ORY", &DoSetMemory, m_argsSetMemory, m_modsSetMemory};
 CCmdVerb CUI::m_cmdSetSwitches = {"SWIT*CHES", &DoSetSwitches, m_argsSetSwitches, NULL};
@@ -276,6 +279,7 @@ CCmdVerb * const CUI::g_aSetVerbs[] = {
   &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetMemory, &m_cmdSetSwitches,
   &m_cmdSetUART, &m_cmdSetIDE, &m_cmdSetSerial,
   &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+  &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
   NULL
 };
 CCmdVerb CUI::m_cmdSet("SE*T", NULL, NULL, NULL, g_aSetVerbs);
@@ -288,6 +292,7 @@ CCmdVerb CUI::m_cmdShowAll("ALL", &DoShowAll);
 CCmdVerb * const CUI::g_aShowVerbs[] = {
   &m_cmdShowBreakpoint, &m_cmdShowMemory, &m_cmdShowConfiguration,
   &CStandardUI::m_cmdShowLog, &m_cmdShowVersion,
+  &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
   &CStandardUI::m_cmdShowAliases, &m_cmdShowAll,
   NULL
 };
@@ -298,11 +303,12 @@ CCmdVerb * const CUI::g_aVerbs[] = {
   &m_cmdLoad, &m_cmdSave, &m_cmdAttach, &m_cmdDetach,
   &m_cmdExamine, &m_cmdDeposit, &m_cmdReset,
   &m_cmdSendFile, &m_cmdReceiveFile, &m_cmdSet, &m_cmdShow,
+  &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdClear, &m_cmdRun, &m_cmdContinue, &m_cmdStep,
   &CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 
@@ -1308,6 +1314,10 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
     case CCPU::STOP_NONE:    break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -1443,6 +1453,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   //   SET CPU allows you to set the CPU type (e.g. 1802 or 1805), and well as
   // vaious options (e.g. stop on illegal I/O, stop on illegal opcode, etc).
   //--
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modIllegalIO.IsPresent())
     g_pCPU->StopOnIllegalIO(m_argStopIO.GetKeyValue() != 0);
   if (m_modIllegalOpcode.IsPresent())
@@ -0,0 +1,28 @@
+; Headless benchmark - run a compute bound checksum loop for 200 seconds ...
+;
+;   The loop sums the first page of the ELF2K EPROM into R8.0, over and over, and
+; never waits for the console or executes an IDL, so the results measure the
+; CPU and memory rather than the idle loop fast forward ...
+;
+;	0000	E7	SEX	7	; X = R7 (data pointer)
+;	0001	F8 80	LDI	80	; R7 = 8000 (the first page of EPROM)
+;	0003	B7	PHI	7
+;	0004	F8 00	LDI	00
+;	0006	A7	PLO	7
+;	0007	88	GLO	8	; D = running sum
+;	0008	F4	ADD		;  ... plus the next byte
+;	0009	A8	PLO	8	;  ... and save it again
+;	000A	17	INC	7	; bump the pointer
+;	000B	87	GLO	7	;  ... and loop for 256 bytes
+;	000C	3A 07	BNZ	07
+;	000E	30 01	BR	01	; then start over
+SET MEMORY/RAM 0-7FFF
+SET MEMORY/ROM 8000-0FFFF
+SET CPU/EFDEFAULT=1,1,1,0/NOEXTENDED
+LOAD Elf2K-alternate-v120/ROM
+SET LOG/CONSOLE/LEVEL=WARNING
+RESET
+DEPOSIT 0 E7,F8,80,B7,F8,00,A7,88,F4,A8,17,87,3A,07,30,01
+DEPOSIT R0 0
+BENCHMARK 200
+SHOW STATISTICS
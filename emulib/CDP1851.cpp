@@ -42,6 +42,7 @@
 // REVISION HISTORY:
 // 31-OCT-24  RLA   New file.
 // 27-MAR-25  RLA   Support READY A/B and STROBE A/B pins in bit programmable mode
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -56,6 +57,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "PPI.hpp"              // generic parallel interface
+#include "StateFile.hpp"        // CStateFile declarations
 #include "CDP1851.hpp"            // declarations for this module
 
 
@@ -539,3 +541,19 @@ void CCDP1851::ShowDevice (ostringstream &ofs) const
     ofs << std::endl;
   }
 }
+
+void CCDP1851::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the generic PPI state plus the CDP1851 control register,
+  // interrupt masks and the bit programmable READY/STROBE pins ...
+  //--
+  CPPI::SyncState(State);
+  State.Sync(m_ControlState);  State.Sync(m_bLastControl);  State.Sync(m_bPortAB);
+  State.Sync(m_bIntMaskA);  State.Sync(m_bIntMaskB);
+  State.Sync(m_bIntFnA);  State.Sync(m_bIntFnB);  State.Sync(m_bStatus);
+  State.Sync(m_fRdyDirA);  State.Sync(m_fRdyDirB);
+  State.Sync(m_fStbDirA);  State.Sync(m_fStbDirB);
+  State.Sync(m_bReadyA);  State.Sync(m_bReadyB);
+  State.Sync(m_bStrobeA);  State.Sync(m_bStrobeB);
+}
@@ -8,6 +8,7 @@
 //
 // REVISION HISTORY:
 // 31-OCT-24  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -102,6 +103,7 @@ public:
   virtual uint8_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, uint8_t bData) override;
   virtual void ShowDevice(ostringstream& ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
   virtual uint1_t GetSense (address_t nSense, uint1_t bDefault=0) override;
 
   // Unique public methods for CCDP1851 ...
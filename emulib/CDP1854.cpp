@@ -31,6 +31,7 @@
 // 28-FEB-24  RLA   On the 1854, BREAK inhibits the transmitter!
 // 10-MAR-24  RLA   Add received break support
 // 25-OCT-24  RLA   Always set the ES bit in the status (used for CTS).
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -48,6 +49,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "UART.hpp"             // generic UART base class
+#include "StateFile.hpp"        // CStateFile declarations
 #include "CDP1854.hpp"          // declarations for this module
 
 
@@ -301,3 +303,13 @@ void CCDP1854::ShowDevice (ostringstream &ofs) const
   ofs << FormatString("RBR=0x%02X THR=0x%02X STS=0x%02X CTL=0x%02X IRQ=%X\n", m_bRBR, m_bTHR, m_bSTS, m_bCTL, MASK1(m_fIRQ));
   CUART::ShowDevice(ofs);
 }
+
+void CCDP1854::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the CDP1854 registers and interrupt flip flops ...
+  //--
+  CUART::SyncState(State);
+  State.Sync(m_bRBR);  State.Sync(m_bTHR);  State.Sync(m_bSTS);  State.Sync(m_bCTL);
+  State.Sync(m_fIRQ);  State.Sync(m_fTHRE_IRQ);
+}
@@ -22,6 +22,7 @@
 //
 // REVISION HISTORY:
 //  4-FEB-20  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -81,6 +82,7 @@ public:
   virtual void DevWrite (address_t nRegister, word_t bData) override;
   virtual uint1_t GetSense (address_t nSense, uint1_t bDefault=0) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Private methods ...
   // Manage the receiver buffer register and handle its side effects ...
@@ -120,6 +120,8 @@
 // REVISION HISTORY:
 // 18-JUN-22  RLA   New file.
 // 25-MAR-25  RLA   Add EnablePIC() ...
+// 16-OCT-26  RLA   Use the request bit map to find the active level ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -133,6 +135,7 @@
 #include "Interrupt.hpp"        // generic priority interrupt controller
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "CDP1877.hpp"          // declarations for this module
 
 
@@ -211,12 +214,11 @@ CPriorityInterrupt::IRQLEVEL CCDP1877::FindInterrupt() const
   //   And lastly, note that this method does NOT clear the request flip flop
   // associated with the active interrupt, and in fact does not change anything
   // about the state of the interrupt system at all.  That's important!
+  //
+  //   The m_lRequests bit map uses the same bit assignments as the mask
+  // register, so all this boils down to finding the highest bit set ...
   //--
-  for (CPriorityInterrupt::IRQLEVEL i = PICLEVELS; i > 0; --i) {
-    if (IsMasked(i)) continue;
-    if (IsRequestedAtLevel(i)) return i;
-  }
-  return 0;
+  return (CPriorityInterrupt::IRQLEVEL) FindHighestBit(m_lRequests & ~m_bMask);
 }
 
 uint8_t CCDP1877::ReadStatus()
@@ -229,12 +231,9 @@ uint8_t CCDP1877::ReadStatus()
   // request F-Fs or only the ones for levels which aren't masked.  The
   // datasheet doesn't say, but I assume the former.
   //--
-  uint8_t bStatus = 0;
+  uint8_t bStatus = LOBYTE(m_lRequests);
   for (uint8_t i = 1; i <= PICLEVELS; ++i) {
-    if (IsRequestedAtLevel(i)) {
-      CPriorityInterrupt::AcknowledgeRequest(i);
-      bStatus |= 1 << (i - 1);
-    }
+    if (ISSET(bStatus, 1 << (i-1))) CPriorityInterrupt::AcknowledgeRequest(i);
   }
   return bStatus;
 }
@@ -400,3 +399,16 @@ void CCDP1877::ShowDevice (ostringstream &ofs) const
   }
 }
 
+
+void CCDP1877::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the request for every interrupt level, and then the CDP1877
+  // registers.  Note that we're both a CPriorityInterrupt and a CDevice, and
+  // this overrides both SyncState() methods.
+  //--
+  CPriorityInterrupt::SyncState(State);
+  State.Sync(m_fEnablePIC);  State.Sync(m_fMIEN);
+  State.Sync(m_bControl);  State.Sync(m_bPage);  State.Sync(m_bMask);
+  State.Sync(m_nVectorByte);
+}
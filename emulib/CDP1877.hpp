@@ -23,6 +23,8 @@
 // 18-JUN-22  RLA   New file.
 // 12-JUN-24  RLA   Suppress Apple C++ warning for AcknowledgeRequest ...
 // 25-MAR-25  RLA   Add EnablePIC() ...
+// 16-OCT-26  RLA   Add GetAttention() and use the request bit map ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -113,6 +115,8 @@ public:
   virtual bool IsRequested() const override;
   // Clear all interrupt requests ...
   virtual void ClearInterrupt() override { ClearDevice(); }
+  // Return our attention word (non-zero if any level is requesting) ...
+  virtual const uint32_t *GetAttention() const override {return &m_lRequests;}
   //   The Apple C++ compiler complains about the next declaration because
   // it hides the overloaded AcknowledgeRequest(IRQLEVEL ...) declaration
   // in the CPriorityInterrupt class.  That's not actually a problem for the
@@ -134,6 +138,7 @@ public:
   virtual word_t DevRead (address_t nRegister) override;
   virtual void DevWrite (address_t nRegister, word_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Other public CDP1877 methods ...
 public:
@@ -33,6 +33,7 @@
 // REVISION HISTORY:
 //  2-NOV-24  RLA   New file.
 // 25-MAR-25  RLA   Add EnableCTC() ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -47,6 +48,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "Timer.hpp"            // generic counter/timer emulation
+#include "StateFile.hpp"        // CStateFile declarations
 #include "CDP1878.hpp"          // declarations for this module
 
 
@@ -242,3 +244,13 @@ void CCDP1878::ShowDevice (ostringstream &ofs) const
     m_TimerB.Show(ofs);
   }
 }
+
+void CCDP1878::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load both timers, the status and the interrupt request ...
+  //--
+  State.Sync(m_fEnableCTC);
+  m_TimerA.SyncState(State);  m_TimerB.SyncState(State);
+  State.Sync(m_bStatus);  State.Sync(m_fIRQ);
+}
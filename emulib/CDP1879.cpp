@@ -62,6 +62,7 @@
 //    
 // REVISION HISTORY:
 // 18-JUN-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -76,6 +77,7 @@
 #include "Device.hpp"           // generic device definitions
 #include "CPU.hpp"              // CPU definitions
 #include "RTC.hpp"              // generic real time clock emulation
+#include "StateFile.hpp"        // CStateFile declarations
 #include "CDP1879.hpp"          // declarations for this module
 
 //   This table gives the period, in NANOSECONDS (!!) of the clock/square
@@ -359,3 +361,17 @@ void CCDP1879::ShowDevice(ostringstream &ofs) const
       ofs << "Square wave output disabled\n"; \
   }
 }
+
+void CCDP1879::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the RTC registers, including the frozen time and date.  If
+  // the clock output is running, the next toggle is saved as an event ...
+  //--
+  State.Sync(m_fEnableRTC);  State.Sync(m_bStatus);  State.Sync(m_bControl);
+  State.Sync(m_fFreeze);  State.Sync(m_fClockOut);
+  State.Sync(m_f12hrMode);  State.Sync(m_fLeapYear);  State.Sync(m_llClockDelay);
+  State.Sync(m_bSeconds);  State.Sync(m_bMinutes);  State.Sync(m_bHours);
+  State.Sync(m_bDay);  State.Sync(m_bMonth);
+  SyncNVR(State);
+}
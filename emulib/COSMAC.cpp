@@ -36,6 +36,17 @@
 //                 We want to implement ClearCPU() instead!
 // 20-DEC-23  RLA  Add default parameter to GetSense() for TLIO
 // 17-JUL-24  RLA  LDC is wrong - should set m_CNTR = m_D if stopped
+// 15-OCT-26  RLA  Only check events and interrupts at the horizon
+// 16-OCT-26  RLA  Skip ahead in IDL and polling loops when we can
+// 16-OCT-26  RLA  Test the interrupt attention word first
+// 16-OCT-26  RLA  Compute the counter/timer from the elapsed time instead of
+//                  stepping it one machine cycle at a time
+// 16-OCT-26  RLA  Add the predecoded instruction cache
+// 16-OCT-26  RLA  Count instructions and obey the event queue time limit
+// 16-OCT-26  RLA  Call the profiler and add DisassembleInstruction()
+// 16-OCT-26  RLA  Count interrupts acknowledged
+// 16-OCT-26  RLA  Record the instruction trace buffer
+// 16-OCT-26  RLA  Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -53,6 +64,7 @@
 #include "CPU.hpp"              // CCPU base class definitions
 #include "Memory.hpp"           // CMemory memory emulation object
 #include "Device.hpp"           // CDevice I/O device emulation objects
+#include "StateFile.hpp"        // CStateFile declarations
 #include "COSMAC.hpp"           // declarations for this module
 
 // Internal CPU register names for GetRegisterNames() ...
@@ -79,11 +91,11 @@ const char *CCOSMAC::g_apszSenseNames[MAXSENSE] = {
 
 
 CCOSMAC::CCOSMAC (CMemory *pMemory, CEventQueue *pEvents, CInterrupt *pInterrupt)
-  : CCPU(pMemory, pEvents, pInterrupt)
+  : CCPU(pMemory, pEvents, pInterrupt), m_Decoded(pMemory)
 {
   //++
   //--
-  m_fExtended = false;
+  m_fExtended = false;  m_CTmode = CT_STOPPED;  m_qCTtime = 0;
   for (uint16_t i = 0;  i < MAXSENSE;  ++i)  SetDefaultEF(i, 0);
   SetCrystalFrequency(DEFAULT_CLOCK);
   CCOSMAC::ClearCPU();
@@ -237,15 +249,16 @@ void CCOSMAC::DoIdle()
   // forever anyway, but this is the best we can do.
   // 
   //   The CEventQueue class has methods to just step ahead directly to the
-  // next scheduled event, but we can't use those here because of the 1804/5/6
-  // internal counter/timer.  If that puppy is running then we have to step
-  // one cycle at a time just to be sure we get the correct timing.
+  // next scheduled event.  That works even when the 1804/5/6 counter/timer is
+  // running, since the counter schedules its own event for the next underflow
+  // and the EF inputs it might be counting can only change when some other
+  // event happens.
   // 
   //   And there is yet one more "gotcha" here - if the user types the break
   // character (break emulation - usually ^E) on the console while we're
   // waiting, then there'll be no interrupt request ('cause it's not really
-  // input to the simulation) but we need to stop anyway.  I think that's the
-  // only way m_nStopCode can get set while we're spinning here.
+  // input to the simulation) but we need to stop anyway.  The event queue's
+  // time limit can also stop us here, and DoHorizon() takes care of that.
   //--
   if (   (m_pInterrupt == NULL)
       || (m_MIE == 0)
@@ -255,8 +268,13 @@ void CCOSMAC::DoIdle()
     m_nStopCode = STOP_BREAK;  return;
   }
   while (true) {
-    AddCycles(1);  DoEvents();
-    if ((m_XIE != 0) && m_pInterrupt->IsRequested()) break;
+    if (m_pEvents->NextStop() > ElapsedTime())
+      m_pEvents->JumpAhead(m_pEvents->NextStop());
+    else
+      AddCycles(1);
+    DoHorizon();
+    if (IsEFCounter()) SampleCounterEF();
+    if ((m_XIE != 0) && IsAttention() && m_pInterrupt->IsRequested()) break;
     if ((m_CIE & m_CIR) != 0) break;
     if (m_nStopCode != STOP_NONE) break;
   }
@@ -292,6 +310,7 @@ uint1_t CCOSMAC::UpdateEF (uint16_t nSense)
   // connected, then the default is ignored.
   //--
   assert(nSense < MAXSENSE);
+  m_fLoopIO = true;
   CDevice *pSense = GetSenseDevice(nSense);
   uint1_t bData = (pSense != NULL) ? pSense->GetSense(nSense, m_EFdefault[nSense]) : m_EFdefault[nSense];
   m_EF[nSense] = MASK1(bData);
@@ -308,84 +327,131 @@ void CCOSMAC::DecrementCounter()
   if (m_CNTR != 1) {
     m_CNTR = MASK8(m_CNTR-1);
   } else {
-    m_CNTR = m_CH;  m_CIR = 1;
+    m_CNTR = m_CH;  m_CIR = 1;  InvalidateHorizon();
     if (m_ETQ != 0) UpdateQ(~m_Q);
   }
 }
 
+void CCOSMAC::CountDown (uint64_t qCount)
+{
+  //++
+  //   Decrement the counter/timer by qCount counts all at once.  Remember that
+  // it takes exactly m_CNTR counts to reach an underflow (and that zero is
+  // really 256!).  We don't expect more than one underflow here, since there
+  // should be an event scheduled for every one, but we handle it anyway.
+  //--
+  while (qCount > 0) {
+    uint64_t qLeft = (m_CNTR == 0) ? 256 : m_CNTR;
+    if (qCount < qLeft) {
+      m_CNTR = MASK8(m_CNTR - qCount);  return;
+    }
+    qCount -= qLeft;  m_CNTR = 1;  DecrementCounter();
+  }
+}
+
 void CCOSMAC::UpdateCounter()
 {
   //++
-  //   This routine is called once every machine cycle, by the AddCycle()
-  // routine, to update the counter/timer.  If we're not emulating the extended
-  // instruction set, or if the counter/timer is currently stopped, then this
-  // is trivial.  In timer mode the prescaller counts 32 calls to this routine,
-  // simulating 32 TPA clocks, before decrementing the counter.  In the pulse
-  // counter modes, we look for a change from true to false (a falling edge) on
-  // the selected EFx input.  In pulse counter mode, we decrement the counter
-  // every time we're here as long as the EFx input is asserted.
+  //   Bring the counter/timer up to date with the current simulated time.  In
+  // timer mode the counter decrements once every 32 machine cycles (that's
+  // the TPA prescaler), and in the pulse modes it decrements once every cycle
+  // while the selected EF input is asserted.  Neither depends on anything that
+  // happens in between, so we can just figure out how many whole machine
+  // cycles have passed since the last update and count them all at once.
+  // m_qCTtime keeps any fractional cycle so that nothing is ever lost.
+  //
+  //   The pulse modes assume that the EF input hasn't changed since the last
+  // call to SampleCounterEF(), and the event counter modes don't count time
+  // at all.  This is called whenever the CPU needs to know the current count
+  // (e.g. GEC) and by the underflow event.
+  //--
+  if (!IsClockCounter() || (ElapsedTime() <= m_qCTtime)) return;
+  uint64_t qCycle = CycleTime();
+  uint64_t qCycles = (ElapsedTime() - m_qCTtime) / qCycle;
+  if (qCycles == 0) return;
+  m_qCTtime += qCycles * qCycle;
+  if (m_CTmode == CT_TIMER) {
+    qCycles += m_Prescaler;
+    m_Prescaler = qCycles % TPAPRESCALE;
+    CountDown(qCycles / TPAPRESCALE);
+  } else if (m_LastEF != 0)
+    CountDown(qCycles);
+}
+
+void CCOSMAC::ScheduleCounter()
+{
+  //++
+  //   Figure out when the counter/timer will next underflow and schedule an
+  // event for that time.  The EventCallback() will update the counter, which
+  // sets the counter interrupt request, toggles Q, reloads the counter, and
+  // then calls us again to schedule the next underflow.  If the counter isn't
+  // counting (it's stopped, or in the event counter modes, or in a pulse
+  // mode with EF deasserted) then no event is needed at all.
+  //--
+  m_pEvents->Cancel(this, 0);
+  if (!IsClockCounter()) return;
+  uint64_t qCycles = (m_CNTR == 0) ? 256 : m_CNTR;
+  if (m_CTmode == CT_TIMER)
+    qCycles = qCycles*TPAPRESCALE - m_Prescaler;
+  else if (m_LastEF == 0)
+    return;
+  m_pEvents->Schedule(this, 0, m_qCTtime + qCycles*CycleTime() - ElapsedTime());
+}
+
+void CCOSMAC::EventCallback (intptr_t lParam)
+{
+  //++
+  // The counter/timer has (or should have) just underflowed ...
+  //--
+  UpdateCounter();  ScheduleCounter();
+}
+
+void CCOSMAC::SampleCounterEF()
+{
+  //++
+  //   This routine is called by the Run() loop at every event horizon, and by
+  // DoIdle() after every event, when the counter is in any of the EF event or
+  // pulse modes.  EF inputs are controlled by devices, and devices can only
+  // change state when an event happens or when the CPU does I/O.  Either one
+  // will bring us to the horizon, so that's the only time we need to look.
+  //
+  //   In the event counter modes we decrement the counter on every falling
+  // edge of the selected EF input.  In the pulse modes we bring the counter
+  // up to date using the old EF state and then, if the EF input has changed,
+  // reschedule the underflow event.
   //--
   uint1_t ef;
-  if (!m_fExtended || (m_CTmode == CT_STOPPED)) return;
+  if (!m_fExtended) return;
   switch (m_CTmode) {
-    case CT_TIMER:
-      if (++m_Prescaler >= TPAPRESCALE) {
-        DecrementCounter();  m_Prescaler = 0;
-      }
-      break;
     case CT_EVENT1:
     case CT_EVENT2:
-      ef = UpdateEF((m_CTmode == CT_EVENT1) ? 1 : 2);
+      ef = UpdateEF(CounterEF());
       if ((m_LastEF != 0) && (ef == 0)) DecrementCounter();
       m_LastEF = ef;
       break;
     case CT_PULSE1:
     case CT_PULSE2:
-      ef = UpdateEF((m_CTmode == CT_EVENT1) ? 1 : 2);
-      if (ef == 1) DecrementCounter();
-      m_LastEF = ef;
+      UpdateCounter();
+      ef = UpdateEF(CounterEF());
+      if (ef != m_LastEF) {
+        m_LastEF = ef;  ScheduleCounter();
+      }
       break;
-    case CT_STOPPED:
+    default:
       break;
   }
 }
 
-void CCOSMAC::AddCycles (uint32_t lCycles)
+void CCOSMAC::StartCounter (CTMODE ctmode)
 {
   //++
-  //   This routine is called to keep track of the simulated time, measured
-  // in 1802 major cycles.  Remember that on the 1802 a major cycle takes
-  // eight clock cycles.  On most processors this is just a matter of updating
-  // the EventQueue so that we can fire off scheduled I/O events at the 
-  // correct simulated time.
-  // 
-  //   The COSMAC needs that too, but for the 1804/5/6 we have the added task
-  // of calling UpdateCounter() every cycle to update the internal counter
-  // /timer.  If the counter/timer is stopped, or is in the timer mode, then
-  // the operation doesn't depend on anything outside of the CPU and just
-  // updating the count is enough.
-  // 
-  //   BUT, simulated time doesn't pass evenly - sometimes this routine might
-  // be called for 1 cycle, and sometimes it might be 7 or 8 cycles at once.
-  // If the counter/timer is in any of the modes that are controlled by EF1 or
-  // EF2, then this could produce incorrect results since the simulated devices
-  // controlling those EF inputs don't get a chance to update every cycle.
-  // 
-  //   So instead we step thru one cycle at a time, processesing events as
-  // we go.  That guarantees that the EF inputs are potentially updated every
-  // major cycle, and that should give the same result that you'd get with
-  // real hardware.
-  //--
-  if (!m_fExtended || (m_CTmode == CT_STOPPED)) {
-    // The counter/timer is not is use, so it's safe to skip updating it!
-    AddTime(lCycles * CLOCKS_PER_CYCLE * HZTONS(m_lClockFrequency));
-  } else {
-    // We'll have to do things the hard way...
-    while (lCycles-- > 0) {
-      AddTime(CLOCKS_PER_CYCLE * HZTONS(m_lClockFrequency));
-      DoEvents();  UpdateCounter();
-    }
-  }
+  //   Start the counter/timer in the specified mode.  Note that the counter
+  // and prescaler are NOT reset here - they continue from where they were.
+  //--
+  UpdateCounter();
+  m_CTmode = ctmode;  m_qCTtime = ElapsedTime();
+  if (IsEFCounter()) m_LastEF = UpdateEF(CounterEF());
+  ScheduleCounter();
 }
 
 void CCOSMAC::DoCounter()
@@ -397,23 +463,24 @@ void CCOSMAC::DoCounter()
   // AddCycle() calls are required here!
   //--
   switch (m_N) {
-    case OP_STPC: StopCounter();                 break;
+    case OP_STPC: UpdateCounter();  StopCounter(); break;
     case OP_SCM1: StartCounter(CT_EVENT1);       break;
     case OP_SCM2: StartCounter(CT_EVENT2);       break;
     case OP_SPM1: StartCounter(CT_PULSE1);       break;
     case OP_SPM2: StartCounter(CT_PULSE2);       break;
     case OP_STM:  StartCounter(CT_TIMER);        break;
-    case OP_DTC:  DecrementCounter();            break;
+    case OP_DTC:  UpdateCounter();  DecrementCounter();
+                  ScheduleCounter();             break;
     case OP_LDC:  m_CH = m_D;
                   if (m_CTmode == CT_STOPPED) {
                     m_CNTR = m_D;  m_CIR = 0;
                   }
                   break;
-    case OP_GEC:  m_D = m_CNTR;                     break;
+    case OP_GEC:  UpdateCounter();  m_D = m_CNTR;   break;
     case OP_ETQ:  m_ETQ = 1;                        break;
-    case OP_XIE:  m_XIE = 1;                        break;
+    case OP_XIE:  m_XIE = 1;  InvalidateHorizon();  break;
     case OP_XID:  m_XIE = 0;                        break;
-    case OP_CIE:  m_CIE = 1;                        break;
+    case OP_CIE:  m_CIE = 1;  InvalidateHorizon();  break;
     case OP_CID:  m_CIE = 0;                        break;
     default: IllegalOpcode();                       break;
   }
@@ -435,7 +502,8 @@ void CCOSMAC::Do7xFx()
     // All the random, miscellaneous operations ...
     case OP_RET:                                  // 0x70 - RETURN
     case OP_DIS:                                  // 0x71 - DISABLE
-      b = MemReadInc(m_X);  m_X = HINIBBLE(b);  m_P = LONIBBLE(b);  m_MIE = MASK1(~m_N);  break;
+      b = MemReadInc(m_X);  m_X = HINIBBLE(b);  m_P = LONIBBLE(b);  m_MIE = MASK1(~m_N);
+      InvalidateHorizon();  break;
     case OP_LDXA: m_D = MemReadInc(m_X);  break;  // 0x72 - LOAD VIA X AND ADVANCE
     case OP_STXD: MemWriteDec(m_X, m_D);  break;  // 0x73 - STORE VIA X AND DECREMENT
     case OP_SAV:  MemWrite(m_X, m_T);     break;  // 0x78 - SAVE T
@@ -552,8 +620,16 @@ void CCOSMAC::DoInOut()
   } else {
     if (m_N > 0x8) {
       // INPUT - D, M[R[X]] <= device ...
-      uint8_t bData = ReadInput(nDevice);
-      m_D = bData;  MemWrite(m_X, bData);
+      //   Polling loops often use INP just to test a status bit, and that
+      // writes M[R[X]] every time.  Nothing the device returns can change
+      // until the next event, so as long as M[R[X]] is ordinary memory this
+      // write doesn't count as a side effect for the idle loop detection ...
+      uint8_t bData = ReadInput(nDevice);  m_D = bData;
+      if (m_pMemory->IsIO(m_R[m_X])) {
+        MemWrite(m_X, bData);
+      } else {
+        m_Decoded.Invalidate(m_R[m_X]);  m_pMemory->FastWrite(m_R[m_X], bData);
+      }
       LOGF(TRACE, "COSMAC read data 0x%02X from port %d", bData, nDevice);
     } else {
       // OUTPUT - device <= M[R[X]], R[X] <= R[X] + 1 ...
@@ -564,13 +640,11 @@ void CCOSMAC::DoInOut()
   }
 }
 
-void CCOSMAC::DoShortBranch()
+bool CCOSMAC::TestShortBranch()
 {
   //++
-  //   COSMAC short branch instructions are two bytes long and replace the
-  // lower byte of the PC with the second byte IF the branch condition is
-  // met.  If the condition isn't met, then the second byte is skipped.  The
-  // upper byte of the PC doesn't change.
+  //   Return TRUE if the condition for the current short branch instruction
+  // (in m_N) is met.  Note that the EF tests have side effects!
   //--
   bool fBranch = false;
 
@@ -587,10 +661,21 @@ void CCOSMAC::DoShortBranch()
     case 0x7: fBranch = UpdateEF(3) != 0;   break;  // B4/BN4
   }
   if (m_N & 0x8) fBranch = !fBranch;
-  
+  return fBranch;
+}
+
+void CCOSMAC::DoShortBranch()
+{
+  //++
+  //   COSMAC short branch instructions are two bytes long and replace the
+  // lower byte of the PC with the second byte IF the branch condition is
+  // met.  If the condition isn't met, then the second byte is skipped.  The
+  // upper byte of the PC doesn't change.
+  //--
+
   //   Short branch instructions either load R[P].0 with the next byte (when
   // the branch condition is true), or increment R[P] to skip over it.
-  if (fBranch)  PutRegLo(m_P, MemRead(m_P));  else IncReg(m_P);
+  if (TestShortBranch())  PutRegLo(m_P, MemRead(m_P));  else IncReg(m_P);
 
   //   If this was a branch on a condition that can't change externally (i.e.
   // NOT one of the EF inputs!), AND interrupts are disabled, AND the branch
@@ -624,6 +709,25 @@ void CCOSMAC::DoInterruptBranch()
   if (fBranch)  PutRegLo(m_P, MemRead(m_P));  else IncReg(m_P);
 }
 
+bool CCOSMAC::TestLongBranch() const
+{
+  //++
+  //   Return TRUE if the condition for the current long branch or skip is met
+  // - i.e. the branch should be taken or the skip skipped.  Bit 3 of the opcode
+  // inverts the sense of the test.  Note that there are really only four
+  // conditions - always true, Q, D==0, and DF (plus a special case for LSIE).
+  //--
+  bool fTest = false;
+  switch (m_N & 3) {
+    case 0x0: fTest = (m_N==0xC) ? (m_MIE != 0) : true;  break;  // LBR/LSKP,  NOP/LSIE
+    case 0x1: fTest = m_Q  != 0;                         break;  // LBQ/LBNQ,  LSNQ/LSQ
+    case 0x2: fTest = m_D  == 0;                         break;  // LBZ/LBNZ,  LSNZ/LSZ
+    case 0x3: fTest = m_DF != 0;                         break;  // LBDF/LBNF, LSNF/LSDF
+  }
+  if (((m_N & 0xC) == 0x8) || ((m_N & 0xC) == 0x4)) fTest = !fTest;
+  return fTest;
+}
+
 void CCOSMAC::DoLongBranch()
 {
   //++
@@ -641,19 +745,7 @@ void CCOSMAC::DoLongBranch()
   // and a successful long branch loads the PC.  So there are really only three
   // cases to be implemented here...
    //--
-
-  //   fTest is TRUE if the condition is met - i.e. the branch should be taken
-  // or the skip skipped.  Bit 3 of the opcode inverts the sense of the test.
-  // Note that there are really only four conditions - always true, Q, D==0,
-  // and DF (plus a special case for LSIE).
-  bool fTest = false;
-  switch (m_N & 3) {
-    case 0x0: fTest = (m_N==0xC) ? (m_MIE != 0) : true;  break;  // LBR/LSKP,  NOP/LSIE
-    case 0x1: fTest = m_Q  != 0;                         break;  // LBQ/LBNQ,  LSNQ/LSQ
-    case 0x2: fTest = m_D  == 0;                         break;  // LBZ/LBNZ,  LSNZ/LSZ
-    case 0x3: fTest = m_DF != 0;                         break;  // LBDF/LBNF, LSNF/LSDF
-  }
-  if (((m_N & 0xC) == 0x8) || ((m_N & 0xC) == 0x4)) fTest = !fTest;
+  bool fTest = TestLongBranch();
 
   // fSkip is true if this is a skip (as opposed to branch) instruction ...
   bool fSkip = (m_N & 4) != 0;
@@ -765,6 +857,15 @@ void CCOSMAC::DoExtended()
   // problem, but we have to add extra cycles here to correct for that.
   //--
   uint8_t eop = MemReadInc(m_P);  AddCycles(1);
+  DoExtended(eop);
+}
+
+void CCOSMAC::DoExtended (uint8_t eop)
+{
+  //++
+  //   And this executes the extended opcode once it's been fetched, either
+  // by the code above or from the predecoded instruction cache ...
+  //--
   m_I = HINIBBLE(eop);  m_N = LONIBBLE(eop);
   switch (m_I << 4) {
     // Counter/timer and interrupt enable instructions ...
@@ -821,6 +922,201 @@ void CCOSMAC::DoInterrupt()
   AddCycles(1);
 }
 
+void CCOSMAC::Decode (address_t a, DECODED &d) const
+{
+  //++
+  //   Decode the instruction at address a into a predecoded instruction cache
+  // entry.  Memory without a page table pointer might be an I/O device, and
+  // reading it could have side effects, so we never decode anything there.
+  // Multi byte instructions are only fully decoded when all their bytes are in
+  // ordinary memory.
+  //
+  //   Fully decoded instructions add all their cycles at once, after they've
+  // been executed, so anything that does I/O, tests the EF inputs, or might
+  // otherwise care about the simulated time has to use DoExecute() instead.
+  // nCycles is the total for the instruction, fetch included, and it's usually
+  // just two ...
+  //--
+  if (!m_Decoded.IsCacheable(a)) {
+    d.bMode = DX_FETCH;  return;
+  }
+  uint8_t op = m_pMemory->FastRead(a);
+  bool f2 = m_Decoded.IsCacheable(ADDRESS(a+1));
+  bool f3 = f2 && m_Decoded.IsCacheable(ADDRESS(a+2));
+  d.bI = HINIBBLE(op);  d.bN = LONIBBLE(op);
+  d.bImmediate = f2 ? m_pMemory->FastRead(ADDRESS(a+1)) : 0;
+  d.wNext = ADDRESS(a+1);  d.wTarget = 0;
+  d.bMode = DX_DECODED;  d.nCycles = 2;
+
+  switch (d.bI << 4) {
+    // LDN can be decoded, but IDL can't ...
+    case 0x00:
+      if (d.bN == 0) d.bMode = DX_EXECUTE;
+      break;
+
+    // Short branches, except for the ones that test EF inputs ...
+    case 0x30:
+      if (f2 && ((d.bN & 0x7) < 4)) {
+        d.wNext = ADDRESS(a+2);  d.wTarget = MKWORD(HIBYTE(a+1), d.bImmediate);
+      } else
+        d.bMode = DX_EXECUTE;
+      break;
+
+    //   Input/output instructions always use DoExecute(), but for the 1804/5/6
+    // extended instructions we can at least save the second fetch ...
+    case 0x60:
+      if (f2 && (d.bN == 0x8) && m_fExtended) {
+        d.wNext = ADDRESS(a+2);  d.nCycles = 1;
+      } else
+        d.bMode = DX_EXECUTE;
+      break;
+
+    // Only the immediate mode ALU operations are decoded ...
+    case 0x70:
+    case 0xF0:
+      switch (op) {
+        case OP_LDI:   case OP_ADCI:  case OP_SDBI:  case OP_SMBI:  case OP_ORI:
+        case OP_XRI:   case OP_ANI:   case OP_ADI:   case OP_SDI:   case OP_SMI:
+          if (f2) {
+            d.wNext = ADDRESS(a+2);  break;
+          }
+          // Fall thru ...
+        default:
+          d.bMode = DX_EXECUTE;  break;
+      }
+      break;
+
+    //   Long branches and skips.  A successful skip goes to wTarget, and an
+    // unsuccessful one just continues with the next byte ...
+    case 0xC0:
+      if (f3) {
+        d.nCycles = 3;
+        if (ISSET(d.bN, 0x4)) {
+          d.wNext = ADDRESS(a+1);  d.wTarget = ADDRESS(a+3);
+        } else {
+          d.wNext = ADDRESS(a+3);
+          d.wTarget = MKWORD(d.bImmediate, m_pMemory->FastRead(ADDRESS(a+2)));
+        }
+      } else
+        d.bMode = DX_EXECUTE;
+      break;
+
+    // And everything else is just register operations ...
+    default:
+      break;
+  }
+}
+
+void CCOSMAC::ExecuteDecoded (const DECODED &d)
+{
+  //++
+  //   Execute a fully predecoded instruction.  This is just like DoExecute(),
+  // except that any operands and branch targets have already been fetched.
+  // R[P] has already been advanced to d.wNext and the opcode is in I and N,
+  // and the caller adds d.nCycles afterwards ...
+  //--
+  bool fTest;
+  switch (m_I<<4) {
+    case   0x00:  m_D = MemRead(m_N);           break;  // 0x0N - LOAD VIA REG N
+    case OP_INC:  IncReg(m_N);                  break;  // 0x1N - INCREMENT REG N
+    case OP_DEC:  DecReg(m_N);                  break;  // 0x2N - DECREMENT REG N
+    case OP_LDA:  m_D = MemReadInc(m_N);        break;  // 0x4N - LOAD ADVANCE VIA REG N
+    case OP_STR:  MemWrite(m_N, m_D);           break;  // 0x5N - STORE VIA REG N
+    case OP_GLO:  m_D = GetRegLo(m_N);          break;  // 0x8N - GET LOW REG N
+    case OP_GHI:  m_D = GetRegHi(m_N);          break;  // 0x9N - GET HIGH REG N
+    case OP_PLO:  PutRegLo(m_N, m_D);           break;  // 0xAN - PUT LOW REG N
+    case OP_PHI:  PutRegHi(m_N, m_D);           break;  // 0xBN - PUT HIGH REG N
+    case OP_SEP:  m_P = m_N;                    break;  // 0xDN - SET P TO N
+    case OP_SEX:  m_X = m_N;                    break;  // 0xEN - SET X TO N
+
+    // Short branches (except for EF tests, which are never decoded) ...
+    case 0x30:
+      m_R[m_P] = TestShortBranch() ? d.wTarget : d.wNext;
+      if ((m_MIE == 0) && (GetRegLo(m_P) == LOBYTE(m_nLastPC))) m_nStopCode = STOP_ENDLESS_LOOP;
+      break;
+
+    // 1804/5/6 extended instructions (the extended opcode is bImmediate) ...
+    case 0x60:
+      AddCycles(2);  DoExtended(d.bImmediate);  break;
+
+    // Immediate mode ALU instructions ...
+    case 0x70:
+    case 0xF0:
+      if (MKBYTE(m_I, m_N) == OP_LDI)
+        m_D = d.bImmediate;
+      else {
+        m_B = d.bImmediate;  DoALU();
+      }
+      break;
+
+    //   Long branches and skips.  This does exactly what DoLongBranch() does,
+    // including leaving the second byte in B, but the two possible results
+    // have already been calculated ...
+    case 0xC0:
+      fTest = TestLongBranch();
+      if (fTest || !ISSET(m_N, 0x4)) m_B = d.bImmediate;
+      m_R[m_P] = fTest ? d.wTarget : d.wNext;
+      if ((m_MIE == 0) && (m_R[m_P] == m_nLastPC)) m_nStopCode = STOP_ENDLESS_LOOP;
+      break;
+  }
+}
+
+size_t CCOSMAC::DisassembleInstruction (address_t nPC, string &sCode) const
+{
+  //++
+  //   Disassemble the instruction at nPC and return its length.  This is
+  // used by the profiler to show what's at the busiest addresses.
+  //--
+  return ::Disassemble(m_pMemory, nPC, sCode);
+}
+
+const char *const *CCOSMAC::GetTraceNames() const
+{
+  //++
+  //   Return the names of the registers saved in each instruction trace entry.
+  // R(P) is the PC and that's saved separately, but R(X) is worth having ...
+  //--
+  static const char *const apszNames[] = {
+    "D", "DF", "P", "X", "R(X)", "T", "IE", "Q", NULL
+  };
+  return apszNames;
+}
+
+void CCOSMAC::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load all the COSMAC registers, including the 1804/5/6 extras.
+  // Note that any pending counter/timer underflow is an event, and that's
+  // taken care of by the event queue ...
+  //--
+  State.Sync(m_fExtended);  State.Sync(m_R);
+  State.Sync(m_D);  State.Sync(m_DF);  State.Sync(m_P);  State.Sync(m_X);
+  State.Sync(m_I);  State.Sync(m_N);  State.Sync(m_T);  State.Sync(m_B);
+  State.Sync(m_MIE);  State.Sync(m_Q);  State.Sync(m_EF);  State.Sync(m_EFdefault);
+  State.Sync(m_CNTR);  State.Sync(m_CH);  State.Sync(m_Prescaler);
+  State.Sync(m_LastEF);  State.Sync(m_CTmode);  State.Sync(m_qCTtime);
+  State.Sync(m_ETQ);  State.Sync(m_CIE);  State.Sync(m_CIR);
+  State.Sync(m_XIE);  State.Sync(m_XIR);
+  CCPU::SyncState(State);
+}
+
+bool CCOSMAC::GetLoopState (uint64_t &qState) const
+{
+  //++
+  //   Return a hash of all the COSMAC internal registers for the idle loop
+  // detection in CCPU.  Note that it's OK to skip ahead even if the 1804/5/6
+  // counter/timer is running, because m_CNTR is only updated on demand and
+  // every counter underflow is an event.
+  //--
+  qState = 0;
+  for (uint4_t r = 0;  r < MAXREGISTER;  ++r)  qState = LoopHash(qState, m_R[r]);
+  qState = LoopHash(qState, MKWORD(m_D, m_T));
+  qState = LoopHash(qState, (m_DF << 12) | (m_P << 8) | (m_X << 4) | (m_MIE << 1) | m_Q);
+  qState = LoopHash(qState, MKWORD(m_CNTR, m_CH));
+  qState = LoopHash(qState, (m_ETQ << 3) | (m_CIE << 2) | (m_CIR << 1) | m_XIE);
+  return true;
+}
+
 CCPU::STOP_CODE CCOSMAC::Run (uint32_t nCount)
 {
   //++
@@ -832,34 +1128,79 @@ CCPU::STOP_CODE CCOSMAC::Run (uint32_t nCount)
   // an illegal opcode or I/O, the user entering the escape sequence on	
   // the console, etc.  If nCount is zero on entry, then we will run for-	
   // ever until one of the previously mentioned break conditions arises.	
+  //
+  //   Device events and interrupt requests are only checked when we reach the
+  // event queue horizon.  That's normally the time of the next event, but I/O
+  // instructions, RET, XIE, CIE, and counter underflows all invalidate the
+  // horizon so that we'll check again before the next instruction.
+  //
+  //   Memory may have been changed by the UI while we were stopped, so the
+  // predecoded instruction cache always starts out empty.
   //--
   bool fFirst = true;
-  m_nStopCode = STOP_NONE;
+  m_nStopCode = STOP_NONE;  InvalidateHorizon();  ResetIdleLoop();
+  m_Decoded.Flush();
   while (m_nStopCode == STOP_NONE) {
 
-    // If any device events need to happen, now is the time...
-    m_pEvents->DoEvents();
+    if (AtHorizon()) {
+      // If any device events need to happen, now is the time...
+      DoHorizon();
+
+      // Look for EF edges if the counter/timer is counting them ...
+      if (IsEFCounter()) SampleCounterEF();
 
-    //   See if any I/O device is requesting an interrupt now.  If one is, and
-    // if COSMAC interrupts are enabled, then simulate an interrupt acknowledge.
-    if (m_pInterrupt != NULL) m_XIR = m_pInterrupt->IsRequested();
-    if ((((m_XIR & m_XIE) | (m_CIR & m_CIE)) & m_MIE) != 0) {
-      DoInterrupt();  m_pInterrupt->AcknowledgeRequest();
+      //   See if any I/O device is requesting an interrupt now.  If one is, and
+      // if COSMAC interrupts are enabled, then simulate an interrupt acknowledge.
+      // The attention word is zero nearly all the time, and it's also zero if
+      // there's no interrupt system at all ...
+      m_XIR = IsAttention() && m_pInterrupt->IsRequested();
+      if ((((m_XIR & m_XIE) | (m_CIR & m_CIE)) & m_MIE) != 0) {
+        DoInterrupt();  m_pInterrupt->AcknowledgeRequest();  ++m_qInterrupts;
+      }
     }
 
     // Stop if we've hit a breakpoint ...
-    if (!fFirst && m_pMemory->IsBreak(m_R[m_P])) {
+    if (!fFirst && m_pMemory->CheckBreak(m_R[m_P])) {
       m_nStopCode = STOP_BREAKPOINT;  break;
     } else
       fFirst = false;
 
     // Fetch, decode and execute an instruction...
-    //   This automatically increments the simulated time for the fetch (S0)
-    // cycle and one execute (S1) cycle.  For the very few instructions that
-    // have a second S1 cycle, they're responsible for adding another 8 cycles.
-    m_nLastPC = GetPC();  AddCycles(1);
-    uint8_t op = MemReadInc(m_P);  m_I = HINIBBLE(op);  m_N = LONIBBLE(op);
-    DoExecute();  AddCycles(1);
+    //   Every instruction takes one fetch (S0) cycle and one execute (S1)
+    // cycle, and a very few have a second S1 cycle.  The predecoded instruction
+    // cache takes care of the fetch and decode, and the cache entry knows how
+    // many cycles to add ...
+    m_nLastPC = GetPC();  ++m_qInstructions;
+    //   Record the registers in the trace buffer before the instruction
+    // changes them, but we don't know the opcode until after it's fetched ...
+    TRACE_ENTRY *pTrace = NextTrace();
+    if (pTrace != NULL) {
+      pTrace->awRegisters[0] = m_D;  pTrace->awRegisters[1] = m_DF;
+      pTrace->awRegisters[2] = m_P;  pTrace->awRegisters[3] = m_X;
+      pTrace->awRegisters[4] = m_R[m_X];  pTrace->awRegisters[5] = m_T;
+      pTrace->awRegisters[6] = m_MIE;  pTrace->awRegisters[7] = m_Q;
+    }
+    bool fValid;  DECODED &d = m_Decoded.Lookup(m_nLastPC, fValid);
+    if (!fValid) Decode(m_nLastPC, d);
+    if (d.bMode == DX_DECODED) {
+      m_I = d.bI;  m_N = d.bN;  m_R[m_P] = d.wNext;
+      ExecuteDecoded(d);  AddCycles(d.nCycles);
+    } else {
+      AddCycles(1);
+      if (d.bMode == DX_EXECUTE) {
+        m_I = d.bI;  m_N = d.bN;  m_R[m_P] = d.wNext;
+      } else {
+        uint8_t op = MemReadInc(m_P);  m_I = HINIBBLE(op);  m_N = LONIBBLE(op);
+      }
+      DoExecute();  AddCycles(1);
+    }
+    if (pTrace != NULL) pTrace->lOpcode = (m_I << 4) | m_N;
+
+    // Skip ahead if we're spinning in an idle or polling loop ...
+    CheckIdleLoop(GetPC());
+
+    // Charge this instruction to the profiler, if it's enabled ...
+    Profile(m_nLastPC);
 
     // Check for some termination conditions ...
     if (m_nStopCode == STOP_NONE) {
@@ -868,6 +1209,8 @@ CCPU::STOP_CODE CCOSMAC::Run (uint32_t nCount)
     }
   }
 
+  // Make sure the counter/timer is up to date for the UI ...
+  UpdateCounter();
   return m_nStopCode;
 }
 
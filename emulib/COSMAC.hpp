@@ -25,6 +25,12 @@
 // 21-JUN-22  RLA   Add the EFx and Q constants
 // 27-JUL-22  RLA   Add 1804/5/6 registers and Extended mode option
 // 17-JUN-24  RLA   Add "override" to GetSenseName and GetFlagName
+// 16-OCT-26  RLA   Add GetLoopState() for idle loop detection
+// 16-OCT-26  RLA   Make the counter/timer event driven
+// 16-OCT-26  RLA   Add the predecoded instruction cache
+// 16-OCT-26  RLA   Add DisassembleInstruction() for the profiler
+// 16-OCT-26  RLA   Add GetTraceNames() for the instruction trace
+// 16-OCT-26  RLA   Add SyncState() for SAVE/LOAD STATE
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -40,7 +46,7 @@
 using std::string;              // ...
 
 
-class CCOSMAC : public CCPU {
+class CCOSMAC : public CCPU, public CEventHandler {
   //++
   // RCA COSMAC CDP1802 CPU emulation...
   //--
@@ -103,6 +109,10 @@ public:
   const char *GetName() const  override {return "COSMAC";}
   // Get the address of the next instruction to be executed ...
   address_t GetPC() const override;
+  // Disassemble one instruction (used by the profiler) ...
+  size_t DisassembleInstruction (address_t nPC, string &sCode) const override;
+  // Return the names of the registers saved in the instruction trace ...
+  const char *const *GetTraceNames() const override;
   // Get or set the extended (1804/5/6) instruction set support ...
   bool IsExtended() const {return m_fExtended;}
   void SetExtended (bool fExtended=true) {m_fExtended = fExtended;}
@@ -110,6 +120,11 @@ public:
   CTMODE GetCounterMode() const {return m_CTmode;}
   static const char *CounterModeToString (CTMODE mode);
 
+  // The 1804/5/6 counter/timer schedules an event for every underflow ...
+public:
+  virtual void EventCallback (intptr_t lParam) override;
+  virtual const char *EventName() const override {return "COSMAC counter/timer";}
+
   // CCOSMAC public functions ...
 public:
   // Reset the CPU ...
@@ -121,6 +136,8 @@ public:
   unsigned GetRegisterSize (cpureg_t nReg) const override;
   uint16_t GetRegister (cpureg_t nReg) const override;
   void SetRegister (cpureg_t nReg, uint16_t nVal) override;
+  // Save or load the CPU state ...
+  void SyncState (CStateFile &State) override;
 
   // COSMAC basic 16 bit register file operations ...
 private:
@@ -142,12 +159,13 @@ private:
   // four bit register number (e.g. N, X, P or a small constant).
 private:
   // Return M[R[r]] ...
-  inline uint8_t MemRead (uint8_t r) const {return m_pMemory->CPUread(m_R[r]);}
+  inline uint8_t MemRead (uint8_t r) const {return m_pMemory->FastRead(m_R[r]);}
   // Return M[R[r]], and then R[r] <= R[r] + 1 ...
   inline uint8_t MemReadInc (uint8_t r)
     {uint8_t d = MemRead(r);  IncReg(r);  return d;}
   // M[R[r]] <= data ...
-  inline void MemWrite (uint4_t r, uint8_t d) {m_pMemory->CPUwrite(m_R[r], d);}
+  inline void MemWrite (uint4_t r, uint8_t d)
+    {LoopWrite();  m_Decoded.Invalidate(m_R[r]);  m_pMemory->FastWrite(m_R[r], d);}
   // M[R[r]] <= data, and then R[r] <= R[r] - 1 ...
   inline void MemWriteDec (uint4_t r, uint8_t d) {MemWrite(r, d);  DecReg(r);}
 
@@ -190,12 +208,24 @@ private:
   void DoShortBranch();
   void DoLongBranch();
   void DoInterruptBranch();
+  bool TestShortBranch();
+  bool TestLongBranch() const;
   // Emulate the 1804/5/6 counter/timer ...
   void DoCounter();
   void DecrementCounter();
+  void CountDown (uint64_t qCount);
   void UpdateCounter();
-  void StartCounter (CTMODE ctmode)  {m_CTmode = ctmode;}
-  void StopCounter() {m_CTmode = CT_STOPPED;  m_Prescaler = 0;}
+  void ScheduleCounter();
+  void SampleCounterEF();
+  void StartCounter (CTMODE ctmode);
+  void StopCounter()
+    {m_CTmode = CT_STOPPED;  m_Prescaler = 0;  m_pEvents->Cancel(this, 0);}
+  // Return TRUE if the counter runs from the clock, EF1 or EF2 ...
+  inline bool IsClockCounter() const
+    {return (m_CTmode == CT_TIMER) || (m_CTmode == CT_PULSE1) || (m_CTmode == CT_PULSE2);}
+  inline bool IsEFCounter() const {return (m_CTmode != CT_STOPPED) && (m_CTmode != CT_TIMER);}
+  inline uint16_t CounterEF() const
+    {return ((m_CTmode == CT_EVENT1) || (m_CTmode == CT_PULSE1)) ? EF1 : EF2;}
   // Emulate the SCAL and SRET instructions ...
   void DoSCAL();
   void DoSRET();
@@ -203,12 +233,41 @@ private:
   void DoExecute();
   // Emulate an interrupt acknowledge cycle ...
   void DoInterrupt();
+  // Return the CPU state for idle loop detection ...
+  bool GetLoopState (uint64_t &qState) const override;
   // Execute an extended 1804/5/6 instruction ...
   void DoExtended();
+  void DoExtended (uint8_t eop);
+
+  //   The predecoded instruction cache remembers, for every address that's
+  // been executed, the opcode along with its immediate operand, branch target
+  // and cycle count.  That saves the fetch for every instruction, and for the
+  // common ones ExecuteDecoded() can skip the operand fetches and the second
+  // level of dispatch too.  Everything else just goes to DoExecute().
+private:
+  enum _DECODE_MODES {
+    DX_FETCH,                   // fetch and decode this instruction every time
+    DX_EXECUTE,                 // opcode is known, but use DoExecute()
+    DX_DECODED,                 // fully predecoded - use ExecuteDecoded()
+  };
+  struct _DECODED {
+    uint8_t   bMode;            // one of the DX_xyz modes above
+    uint4_t   bI, bN;           // opcode
+    uint8_t   bImmediate;       // immediate operand or extended opcode
+    uint8_t   nCycles;          // machine cycles to add after ExecuteDecoded()
+    address_t wNext;            // address of the next sequential instruction
+    address_t wTarget;          // branch target (or skip address)
+  };
+  typedef struct _DECODED DECODED;
+  void Decode (address_t a, DECODED &d) const;
+  void ExecuteDecoded (const DECODED &d);
 
   // Other private COSMAC helper routines ...
 private:
-  void AddCycles (uint32_t lCycles);
+  // Return the time, in nanoseconds, for one COSMAC machine cycle ...
+  inline uint64_t CycleTime() const
+    {return CLOCKS_PER_CYCLE * HZTONS(m_lClockFrequency);}
+  void AddCycles (uint32_t lCycles)  {AddTime(lCycles * CycleTime());}
 
   // CDP1802 COSMAC internal registers and state ...
 private:
@@ -232,11 +291,14 @@ private:
   uint8_t   m_Prescaler;      //  "   "    "   prescale counter
   uint1_t   m_LastEF;         // negative edge trigger for EF1/EF2
   CTMODE    m_CTmode;         // current counter/timer mode
+  uint64_t  m_qCTtime;        // simulated time m_CNTR was last updated
   uint1_t   m_ETQ;            // toggle Q mode enabled
   uint1_t   m_CIE;            // counter interrupt enable
   uint1_t   m_CIR;            //   "  "    "    "  request
   uint1_t   m_XIE;            // external interrupt enable
   uint1_t   m_XIR;            //   "   "   "    "   request
+  // Predecoded instruction cache ...
+  CDecodeCache<DECODED, 3> m_Decoded;
   // Constant strings for sense (EFx) names ...
   static const char *g_apszSenseNames[MAXSENSE];
 };
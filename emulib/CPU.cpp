@@ -44,6 +44,13 @@
 //  4-JUL-22  RLA  Remove breakpoint stuff (it's handled by memory now!)
 // 22-Aug-22  RLA  Constructor should call ClearCPU(), not MasterClear()!
 // 14-Jun-23  RLA  MasterClear() should clear the event queue first!
+// 16-OCT-26  RLA  Add IdleLoop() ...
+// 16-OCT-26  RLA  Add the interrupt attention word ...
+// 16-OCT-26  RLA  Don't skip an idle loop past the time limit ...
+// 16-OCT-26  RLA  Add EnableProfiler() ...
+// 16-OCT-26  RLA  Add the instruction trace buffer ...
+// 16-OCT-26  RLA  Add warp mode ...
+// 16-OCT-26  RLA  Add SyncState() ...
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -58,6 +65,11 @@
 #include "Memory.hpp"           // basic memory emulation declarations ...
 #include "CPU.hpp"              // CCPU base class definitions
 #include "Device.hpp"           // basic I/O device emulation declarations ...
+#include "VirtualConsole.hpp"   // CVirtualConsole::IsInputPending()
+#include "StateFile.hpp"        // CStateFile declarations
+
+// The attention word used when there's no interrupt system at all ...
+const uint32_t CCPU::g_lNoAttention = 0;
 
 
 CCPU::CCPU (CMemory *pMemory, CEventQueue *pEvents, CInterrupt *pInterrupt)
@@ -67,11 +79,15 @@ CCPU::CCPU (CMemory *pMemory, CEventQueue *pEvents, CInterrupt *pInterrupt)
   //--
   assert ((pMemory != NULL)  &&  (pEvents != NULL));
   m_pInterrupt = pInterrupt;
+  m_plAttention = (pInterrupt != NULL) ? pInterrupt->GetAttention() : &g_lNoAttention;
   m_pMemory = pMemory;
   m_pEvents = pEvents;
   m_fStopOnIllegalIO = false;
   m_fStopOnIllegalOpcode = true;
-  m_nLastPC = 0;
+  m_nLastPC = m_nLoopPC = 0;  m_qLoopTime = m_qLoopState = 0;
+  m_fLoopIO = false;  m_qInstructions = m_qInterrupts = 0;
+  m_pProfiler = NULL;  m_fWarp = true;  m_pWarpConsole = NULL;
+  m_pTrace = NULL;  m_nTraceMask = 0;  m_qTraceNext = 0;
   ClearCPU();
 }
 
@@ -82,6 +98,59 @@ CCPU::~CCPU()
   // DOES NOT delete the memory - that's up to the caller.  Maybe we should?
   //--
   RemoveAllDevices();
+  if (m_pProfiler != NULL) delete m_pProfiler;
+  if (m_pTrace != NULL) delete[] m_pTrace;
+}
+
+void CCPU::EnableProfiler (bool fEnable)
+{
+  //++
+  //   Turn the execution profiler on or off.  Turning it on creates a new,
+  // empty, profiler if we don't already have one.  Turning it off throws away
+  // the profiler and everything it has recorded.
+  //--
+  if (fEnable) {
+    if (m_pProfiler == NULL) m_pProfiler = DBGNEW CProfiler();
+  } else if (m_pProfiler != NULL) {
+    delete m_pProfiler;  m_pProfiler = NULL;
+  }
+}
+
+void CCPU::EnableTrace (size_t nSize)
+{
+  //++
+  //   Allocate a new instruction trace buffer with (at least) nSize entries,
+  // or turn tracing off if nSize is zero.  The size is rounded up to a power
+  // of two so that wrapping around is just a mask.  Either way, anything
+  // that's already in the trace buffer is lost.
+  //--
+  if (m_pTrace != NULL) delete[] m_pTrace;
+  m_pTrace = NULL;  m_nTraceMask = 0;  m_qTraceNext = 0;
+  if (nSize == 0) return;
+  size_t nActual = 1;
+  while (nActual < nSize) nActual <<= 1;
+  m_pTrace = DBGNEW TRACE_ENTRY[nActual];  m_nTraceMask = nActual-1;
+}
+
+string CCPU::FormatTrace (const TRACE_ENTRY &Entry) const
+{
+  //++
+  //   Convert one trace entry to a human readable string.  Note that unless
+  // the CPU overrides DisassembleTrace(), the disassembly comes from whatever
+  // is in memory NOW, not what was there when the instruction executed, and
+  // that's wrong for self modifying code or if memory has been reloaded.  The
+  // opcode saved in the entry is always right, though ...
+  //--
+  const char *pszFormat = (GetAddressRadix() == 8) ? "%06o" : "%04X";
+  string sCode;  DisassembleTrace(Entry, sCode);
+  for (size_t i = 0;  i < sCode.length();  ++i)  if (sCode[i] == '\t') sCode[i] = ' ';
+  string sLine = FormatString("%12llu  ", (unsigned long long) Entry.qTime)
+    + FormatString(pszFormat, Entry.nPC) + "  " + FormatString(pszFormat, Entry.lOpcode)
+    + FormatString("  %-24s", sCode.c_str());
+  const char *const *ppszNames = GetTraceNames();
+  for (unsigned i = 0;  (ppszNames != NULL) && (i < TRACE_REGISTERS) && (ppszNames[i] != NULL);  ++i)
+    sLine += FormatString(" %s=", ppszNames[i]) + FormatString(pszFormat, Entry.awRegisters[i]);
+  return sLine;
 }
 
 void CCPU::MasterClear()
@@ -108,6 +177,67 @@ void CCPU::ClearCPU()
   // or interrupts!
   //--
   m_nStopCode = STOP_NONE;
+  ResetIdleLoop();
+}
+
+void CCPU::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the state that's common to all CPUs.  The clock frequency
+  // is included because it determines how fast simulated time passes.  After
+  // loading we forget about any idle loop we might have been watching, and
+  // force the CPU to check for interrupts before the next instruction.
+  //--
+  State.Sync(m_lClockFrequency);  State.Sync(m_nLastPC);
+  State.Sync(m_qInstructions);  State.Sync(m_qInterrupts);
+  if (State.IsLoading()) {ResetIdleLoop();  InvalidateHorizon();}
+}
+
+void CCPU::IdleLoop (address_t nPC)
+{
+  //++
+  //   This routine is called by CheckIdleLoop() whenever the PC moves backward
+  // by a short distance, which is to say at the end of each pass thru some
+  // short loop.  nPC is the address of the start of the loop.  
+  // 
+  //   If this is the same loop as last time, AND nothing was written during
+  // the last pass, AND the CPU registers are exactly the same as they were at
+  // the end of the previous pass, then the CPU is guaranteed to keep going
+  // around this loop until some event changes the state of the outside world.
+  // In that case we skip ahead to the time of the next event, but we always
+  // charge the time for a whole number of passes thru the loop.  If there are
+  // no events at all then nothing will ever change and this loop is endless.
+  // The event queue's time limit, if there is one, counts as an event here.
+  // 
+  //   Computing the CPU state hash isn't free, so we only bother if the loop
+  // has actually accessed some I/O device.  The exception is a "branch to
+  // self", which is the usual way to wait for an interrupt.  A loop with no
+  // I/O that isn't waiting for an interrupt is probably a delay loop, and
+  // those always change some register anyway.
+  //
+  //   If warp mode is off, or if there's console input waiting, then we just
+  // keep interpreting the loop instead.  Endless loops are detected either way.
+  //--
+  uint64_t qNow = ElapsedTime();  uint64_t qState;
+  if (   (nPC == m_nLoopPC)  &&  !m_fLoopWrite
+      && (m_fLoopIO || (nPC == m_nLastPC))
+      && GetLoopState(qState)) {
+    if (m_fLoopState && (qState == m_qLoopState)) {
+      uint64_t qNext = m_pEvents->NextStop();
+      uint64_t qPass = qNow - m_qLoopTime;
+      if (qNext == 0) {
+        m_nStopCode = STOP_ENDLESS_LOOP;
+      } else if (   (qNext > qNow) && (qPass > 0) && m_fWarp
+                 && ((m_pWarpConsole == NULL) || !m_pWarpConsole->IsInputPending())) {
+        uint64_t nPasses = (qNext - qNow + qPass - 1) / qPass;
+        qNow = m_pEvents->JumpAhead(qNow + nPasses*qPass);
+      }
+    }
+    m_qLoopState = qState;  m_fLoopState = true;
+  } else
+    m_fLoopState = false;
+  m_nLoopPC = nPC;  m_qLoopTime = qNow;
+  m_fLoopIO = m_fLoopWrite = false;
 }
 
 void CCPU::ClearAllDevices()
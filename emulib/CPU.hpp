@@ -39,6 +39,18 @@
 //  5-JUL-22  RLA   Change to use CDeviceMap class ...
 // 18-JUL-22  RLA   Change NSTOMS to return uint64_t, not uint32_t!
 //  6-NOV-24  RLA   Add m_lClockFrequency ...
+// 15-OCT-26  RLA   Add AtHorizon(), DoHorizon() and InvalidateHorizon() ...
+// 16-OCT-26  RLA   Add idle and polling loop detection ...
+// 16-OCT-26  RLA   Add IsAttention() ...
+// 16-OCT-26  RLA   Add the CDecodeCache template ...
+// 16-OCT-26  RLA   Add the instruction counter and the event queue time limit
+// 16-OCT-26  RLA   Add the execution profiler and DisassembleInstruction()
+// 16-OCT-26  RLA   Count interrupts acknowledged
+// 16-OCT-26  RLA   Add the instruction trace buffer ...
+// 16-OCT-26  RLA   Pace the simulation at the horizon ...
+// 16-OCT-26  RLA   Add warp mode ...
+// 16-OCT-26  RLA   Add SyncState() ...
+// 16-OCT-26  RLA   Add GetMemory() ...
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -49,7 +61,10 @@
 #include "DeviceMap.hpp"        // CDeviceMap class
 #include "Memory.hpp"           // basic memory emulation declarations ...
 #include "CommandParser.hpp"    // needed for type KEYWORD
+#include "Profiler.hpp"         // guest program execution profiler
 using std::string;              // ...
+class CVirtualConsole;          // console for IsInputPending()
+class CStateFile;               // save/load state file
 
 
 //++
@@ -116,12 +131,27 @@ public:
   // Get a constant string for the CPU name, type or options ...
   virtual const char *GetDescription() const {return "unknown";}
   virtual const char *GetName() const {return "none";}
+  // Return the total number of instructions executed ...
+  inline uint64_t GetInstructionCount() const {return m_qInstructions;}
+  // Return the total number of interrupts acknowledged ...
+  inline uint64_t GetInterruptCount() const {return m_qInterrupts;}
+  // Reset both of those for SHOW STATISTICS ...
+  void ClearStatistics() {m_qInstructions = m_qInterrupts = 0;}
+  //   Disassemble one instruction for the UI and return its length, in the
+  // same units as addresses.  The default is to do nothing ...
+  virtual size_t DisassembleInstruction (address_t nAddress, string &sCode) const
+    {sCode.clear();  return 1;}
+  // Return the radix (8 or 16) that this CPU uses for addresses ...
+  virtual unsigned GetAddressRadix() const {return 16;}
 
   // Emulation control...
 public:
   // Reset the CPU ...
   virtual void MasterClear();
   virtual void ClearCPU();
+  //   Save or load the CPU state.  Every CPU should override this to save
+  // its registers, and then call this one for the common stuff ...
+  virtual void SyncState (CStateFile &State);
   // Simulate one or more instructions ...
   virtual STOP_CODE Run (uint32_t nCount=0) = 0;
   // Interrupt the simulation gracefully ...
@@ -151,9 +181,11 @@ public:
   virtual CDevice *FindDevice (const class CSimpleInterrupt *pInterrupt) const;
   // Clear (simulate a hardware reset) for all devices ...
   virtual void ClearAllDevices();
-  // Read or write data from or to a device ...
-  virtual word_t ReadInput (address_t nPort) {return m_InputDevices.DevRead(nPort);}
-  virtual void WriteOutput (address_t nPort, word_t bData) {return m_OutputDevices.DevWrite(nPort, bData);}
+  // Read or write data from or to a device (and recheck interrupts after) ...
+  virtual word_t ReadInput (address_t nPort)
+    {InvalidateHorizon();  return m_InputDevices.DevRead(nPort);}
+  virtual void WriteOutput (address_t nPort, word_t bData)
+    {InvalidateHorizon();  LoopWrite();  return m_OutputDevices.DevWrite(nPort, bData);}
   // Delete all attached I/O devices (including flags and sense!) ...
   virtual void RemoveAllDevices();
 
@@ -175,8 +207,8 @@ public:
   virtual const char *GetSenseName (address_t nSense=0) const {return "unknown";}
   virtual const char *GetFlagName (address_t nFlag=0) const {return "unknown";}
   // Sense inputs or update flag ouputs ...
-  virtual uint1_t GetSense (address_t nSense=0, uint1_t bDefault=0) {return m_SenseDevices.GetSense(nSense, bDefault);}
-  virtual void SetFlag (address_t nFlag, uint1_t bData) {return m_FlagDevices.SetFlag(nFlag, bData);}
+  virtual uint1_t GetSense (address_t nSense=0, uint1_t bDefault=0) {m_fLoopIO = true;  return m_SenseDevices.GetSense(nSense, bDefault);}
+  virtual void SetFlag (address_t nFlag, uint1_t bData) {LoopWrite();  return m_FlagDevices.SetFlag(nFlag, bData);}
 
   // Event Queue functions ...
 public:
@@ -185,6 +217,139 @@ public:
   void AddTime (uint64_t llTime) {m_pEvents->AddTime(llTime);}
   // Process outstanding events ...
   void DoEvents() {m_pEvents->DoEvents();}
+  // Return the event queue that belongs to this CPU ...
+  CEventQueue *GetEvents() const {return m_pEvents;}
+  // Return the memory (or memory map) that this CPU addresses ...
+  CMemory *GetMemory() const {return m_pMemory;}
+
+  //   The Run() loop only needs to process events, look for interrupts, etc
+  // when the event queue "horizon" is reached.  The rest of the time it can
+  // just execute instructions as fast as it can.  Anything that might change
+  // the interrupt state of the CPU (I/O instructions, enabling interrupts,
+  // memory mapped I/O, etc) must call InvalidateHorizon() to force the Run()
+  // loop to check again before the next instruction.
+  //
+  //   The horizon never goes past the event queue's time limit, if there is
+  // one, and DoHorizon() stops the simulation when the limit is reached.  If
+  // real time pacing is enabled, then this is also where we sleep ...
+public:
+  void InvalidateHorizon() {m_fLoopIO = true;  m_pEvents->InvalidateHorizon();}
+protected:
+  bool AtHorizon() const {return m_pEvents->AtHorizon();}
+  void DoHorizon()
+  {
+    m_pEvents->DoEvents();
+    if (m_pEvents->IsPaced()) m_pEvents->Pace();
+    m_pEvents->ResetHorizon();
+    if (m_pEvents->IsTimeLimit() && (m_nStopCode == STOP_NONE)) m_nStopCode = STOP_FINISHED;
+  }
+
+  //   The interrupt system keeps an "attention" word that's guaranteed to be
+  // zero whenever no interrupt is requested, and IsAttention() tests that.
+  // It's much cheaper than asking the interrupt system directly, and if it
+  // returns true then the CPU can go ahead and look more carefully.  If there
+  // is no interrupt system then it points to g_lNoAttention and it's always
+  // false.
+protected:
+  inline bool IsAttention() const {return *m_plAttention != 0;}
+  static const uint32_t g_lNoAttention;
+
+  //   Guest firmware spends most of its life spinning in short loops that poll
+  // a UART status bit or a sense input.  Nothing in the simulation can change
+  // except when an event happens, so if the CPU goes around a short loop twice
+  // with exactly the same register state, AND the loop didn't write anything,
+  // then it's guaranteed to keep doing exactly the same thing until the next
+  // event.  In that case we can skip ahead to the time of that event.
+  //
+  //   CheckIdleLoop() should be called by the Run() loop after every
+  // instruction.  It's cheap unless the PC has moved backwards by a short
+  // distance.  The CPU must call LoopWrite() whenever it writes to memory
+  // (output devices and flags are taken care of here), and it must implement
+  // GetLoopState() to return a hash of its internal registers.  Any I/O access
+  // calls InvalidateHorizon(), which is how we know the loop is polling.
+public:
+  enum {MAXIDLELOOP = 32};    // longest loop (in address units) we'll detect
+protected:
+  inline void CheckIdleLoop (address_t nPC)
+    {if ((nPC <= m_nLastPC) && ((m_nLastPC-nPC) <= MAXIDLELOOP)) IdleLoop(nPC);}
+  inline void LoopWrite() {m_fLoopWrite = true;}
+  inline void ResetIdleLoop() {m_fLoopState = false;  m_fLoopWrite = true;}
+  void IdleLoop (address_t nPC);
+  // Return false if skipping ahead isn't possible right now ...
+  virtual bool GetLoopState (uint64_t &qState) const {return false;}
+
+  //   Skipping ahead like that is called "warping", and it's enabled by
+  // default.  It can be turned off, which makes the simulation interpret
+  // every pass thru the loop, and it's also suppressed whenever the console
+  // has input waiting that the guest hasn't read yet.  Note that the IDL and
+  // WAIT instructions always skip to the next event - that's how they work.
+  // The total time skipped is kept by the event queue (see GetJumpTime()).
+public:
+  inline void SetWarp (bool fWarp=true) {m_fWarp = fWarp;}
+  inline bool IsWarp() const {return m_fWarp;}
+  inline void SetWarpConsole (CVirtualConsole *pConsole) {m_pWarpConsole = pConsole;}
+  inline uint64_t GetWarpTime() const {return m_pEvents->GetJumpTime();}
+
+  //   The execution profiler keeps a histogram of where the guest program
+  // spends its time.  The Run() loop should call Profile() with the address
+  // of every instruction just after it's executed.  When the profiler isn't
+  // enabled there's no CProfiler object at all, and the only cost is testing
+  // m_pProfiler ...
+public:
+  void EnableProfiler (bool fEnable=true);
+  inline bool IsProfilerEnabled() const {return m_pProfiler != NULL;}
+  inline CProfiler *GetProfiler() const {return m_pProfiler;}
+protected:
+  inline void Profile (address_t nPC)
+    {if (m_pProfiler != NULL) m_pProfiler->Record(nPC, ElapsedTime());}
+
+  //   The instruction trace buffer is a ring buffer that remembers the last
+  // few thousand instructions executed.  Each entry is just the raw binary
+  // state - the time, PC, opcode and a few key registers - and recording one
+  // is a handful of stores.  It's only decoded and disassembled when somebody
+  // wants to look at it.  The Run() loop should call NextTrace() after it
+  // fetches each opcode, and if that returns non-NULL then it fills in the
+  // opcode and registers.  NextTrace() fills in the time and m_nLastPC for
+  // us.  The CPU should also implement GetTraceNames() to return a NULL
+  // terminated list of the names of the registers it saves ...
+public:
+  enum {TRACE_REGISTERS = 8};   // maximum registers saved per instruction
+  struct _TRACE_ENTRY {
+    uint64_t  qTime;                          // simulated time
+    address_t nPC;                            // address of the instruction
+    uint32_t  lOpcode;                        // first word or byte of the opcode
+    uint16_t  awRegisters[TRACE_REGISTERS];   // CPU specific register values
+  };
+  typedef struct _TRACE_ENTRY TRACE_ENTRY;
+  void EnableTrace (size_t nSize);
+  inline bool IsTraceEnabled() const {return m_pTrace != NULL;}
+  inline size_t GetTraceSize() const {return (m_pTrace != NULL) ? m_nTraceMask+1 : 0;}
+  // Return the number of entries currently in the buffer ...
+  inline size_t GetTraceCount() const
+    {return (m_qTraceNext < GetTraceSize()) ? (size_t) m_qTraceNext : GetTraceSize();}
+  // Return the n-th most recent entry (0 is the last instruction) ...
+  inline const TRACE_ENTRY &GetTrace (size_t n) const
+    {assert(n < GetTraceCount());  return m_pTrace[(m_qTraceNext-1-n) & m_nTraceMask];}
+  inline void ClearTrace() {m_qTraceNext = 0;}
+  // Return the names of the registers saved in each trace entry ...
+  virtual const char *const *GetTraceNames() const {return NULL;}
+  // Disassemble the instruction for one trace entry (from memory by default) ...
+  virtual void DisassembleTrace (const TRACE_ENTRY &Entry, string &sCode) const
+    {DisassembleInstruction(Entry.nPC, sCode);}
+  // Decode and disassemble one trace entry ...
+  string FormatTrace (const TRACE_ENTRY &Entry) const;
+protected:
+  inline TRACE_ENTRY *NextTrace()
+  {
+    if (m_pTrace == NULL) return NULL;
+    TRACE_ENTRY *p = &m_pTrace[(m_qTraceNext++) & m_nTraceMask];
+    p->qTime = ElapsedTime();  p->nPC = m_nLastPC;  return p;
+  }
+
+  // Accumulate one CPU register into a loop state hash ...
+public:
+  static inline uint64_t LoopHash (uint64_t qState, uint64_t qValue)
+    {return (qState ^ qValue) * 0x100000001B3ULL;}
 
   // Local methods ...
 protected:
@@ -195,12 +360,112 @@ protected:
   bool      m_fStopOnIllegalIO;     // break simulation on unimplemented I/Os
   bool      m_fStopOnIllegalOpcode; //   "      "   "    "   "     "     opcodes
   STOP_CODE       m_nStopCode;      // reason for stopping the emulator
+  uint64_t        m_qInstructions;  // total instructions executed
+  uint64_t        m_qInterrupts;    // total interrupts acknowledged
+  CProfiler      *m_pProfiler;      // execution profiler (NULL if disabled)
+  bool            m_fWarp;          // skip ahead thru idle loops
+  CVirtualConsole *m_pWarpConsole;  // don't warp if this has input waiting
+  TRACE_ENTRY    *m_pTrace;         // instruction trace buffer (NULL if disabled)
+  size_t          m_nTraceMask;     // trace buffer size - 1 (a power of two!)
+  uint64_t        m_qTraceNext;     // total instructions traced
   address_t       m_nLastPC;        // address of instruction that was just executed
   CMemory        *m_pMemory;        // main memory for this CPU
   CEventQueue    *m_pEvents;        // "to do" list of upcoming events
   CInterrupt     *m_pInterrupt;     // interrupt control logic (if any!)
+  const uint32_t *m_plAttention;    // interrupt system attention word
   CDeviceMap      m_InputDevices;   // input  (CPU <- device) devices by address
   CDeviceMap      m_OutputDevices;  // output (CPU -> device)    "    "      "
   CDeviceMap      m_SenseDevices;   // devices connected to sense inputs
   CDeviceMap      m_FlagDevices;    //    "      "   "    " flag  outputs
+  // Idle and polling loop detection ...
+  address_t       m_nLoopPC;        // start of the loop we're watching
+  uint64_t        m_qLoopTime;      // simulated time at the start of this pass
+  uint64_t        m_qLoopState;     // CPU state hash from the last pass
+  bool            m_fLoopState;     // TRUE if m_qLoopState is valid
+  bool            m_fLoopIO;        // TRUE if this pass accessed any I/O
+  bool            m_fLoopWrite;     // TRUE if this pass wrote anything
+};
+
+
+template <class ENTRY, unsigned MAXLENGTH> class CDecodeCache {
+  //++
+  //   CDecodeCache is a predecoded instruction cache that any CPU can use to
+  // avoid fetching and decoding the same instructions over and over again.
+  // ENTRY is a structure defined by the CPU that holds whatever it wants to
+  // remember about a decoded instruction - a handler, operands, branch targets
+  // and so on - and there's exactly one entry for every address.  MAXLENGTH
+  // is the longest instruction, in address units, that the CPU will decode.
+  //
+  //   The CPU must call Invalidate() for every memory write it does, and that
+  // discards any instruction that might contain the location written.  It's
+  // cheap!  Flush() discards everything, and the CPU should call that whenever
+  // memory might have been changed behind its back (e.g. by the UI while the
+  // CPU is stopped).  Lookup() also watches the CMemory page table version and
+  // flushes the cache when the memory map changes, so memory mapping and bank
+  // switching are taken care of automatically.
+  //
+  //   Note that the CPU should only decode instructions from pages that have
+  // a page table pointer, since reading I/O devices may have side effects, and
+  // that invalidation is by CPU address, so aliased memory (the same RAM
+  // appearing at two different addresses) isn't handled.
+  //--
+
+  // Constructor and destructor ...
+public:
+  CDecodeCache (const CMemory *pMemory) : m_pMemory(pMemory)
+  {
+    m_pSlots = DBGNEW SLOT[ADDRESS_MAX+1]();
+    m_lGeneration = 1;  m_lPageVersion = pMemory->GetPageVersion();
+  }
+  virtual ~CDecodeCache() {delete[] m_pSlots;}
+private:
+  // Disallow copy and assignments!
+  CDecodeCache (const CDecodeCache&) = delete;
+  CDecodeCache& operator= (CDecodeCache const &) = delete;
+
+  // Public cache methods ...
+public:
+  //   Return the cache entry for address a.  If fValid is returned false then
+  // the entry is stale and the caller is expected to decode the instruction
+  // into it now ...
+  inline ENTRY &Lookup (address_t a, bool &fValid)
+  {
+    if (m_pMemory->GetPageVersion() != m_lPageVersion) Flush();
+    SLOT &Slot = m_pSlots[a & ADDRESS_MASK];
+    fValid = Slot.lGeneration == m_lGeneration;
+    if (!fValid) Slot.lGeneration = m_lGeneration;
+    return Slot.Entry;
+  }
+  // Return TRUE if instructions at address a can be decoded at all ...
+  inline bool IsCacheable (address_t a) const {return m_pMemory->GetReadPage(a) != NULL;}
+  // Discard any instruction that includes address a ...
+  inline void Invalidate (address_t a)
+    {for (unsigned i = 0;  i < MAXLENGTH;  ++i)  m_pSlots[ADDRESS(a-i)].lGeneration = 0;}
+  //   Discard everything.  This just starts a new generation, and only when
+  // the generation number wraps around do we have to clear all the entries.
+  void Flush()
+  {
+    m_lPageVersion = m_pMemory->GetPageVersion();
+    if (++m_lGeneration == 0) {
+      for (size_t i = 0;  i <= ADDRESS_MAX;  ++i)  m_pSlots[i].lGeneration = 0;
+      m_lGeneration = 1;
+    }
+  }
+
+  //   Each ENTRY is tagged with the cache generation number when it was
+  // decoded.  Zero is never a valid generation, so that's what Invalidate()
+  // uses ...
+private:
+  struct _SLOT {
+    uint32_t  lGeneration;      // cache generation when this entry was decoded
+    ENTRY     Entry;            // and the CPU's decoded instruction
+  };
+  typedef struct _SLOT SLOT;
+
+  // Private member data ...
+private:
+  const CMemory *m_pMemory;       // memory we're caching
+  SLOT          *m_pSlots;        // one SLOT per address
+  uint32_t       m_lGeneration;   // current cache generation
+  uint32_t       m_lPageVersion;  // memory page table version when we started
 };
@@ -60,6 +60,8 @@
 //                    SBR 1234
 // 26-AUG-22  RLA   Clean up Linux/WIN32 conditionals.
 // 15-FEB-24  RLA   Allow comments at the end of commands.
+// 16-OCT-26  RLA   Allow a verb to have both arguments and subverbs.
+// 16-OCT-26  RLA   Add RunScript().
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -1186,8 +1188,24 @@ bool CCmdVerb::ParseVerb (CCmdParser &cmd, const char *&pcNext, CCmdVerb * const
   // have (e.g. "SET ..." and "SHOW ...") but it isn't the only option.  We
   // could, for example, treat any modifiers for the parent verb as "global"
   // modifiers that are valid for all subverbs.
-  if (pVerb->m_paSubVerbs != NULL)
-    return ParseVerb(cmd, pcNext, pVerb->m_paSubVerbs);
+  //
+  //   The one exception is a verb that has BOTH subverbs and its own argument
+  // list (e.g. "SAVE <file>" and "SAVE PROFILE <file>").  In that case we peek
+  // at the next word, and if it's a complete name that matches one of the
+  // subverbs then we recurse.  Otherwise we back up and parse the rest of the
+  // command line as this verb's arguments.
+  if (pVerb->m_paSubVerbs != NULL) {
+    if (pVerb->m_paArguments == NULL)
+      return ParseVerb(cmd, pcNext, pVerb->m_paSubVerbs);
+    const char *pcSave = pcNext;
+    string sSubVerb(CCmdArgName::ScanName(pcNext));
+    if (   !sSubVerb.empty()
+        && (isspace(*pcNext) || IsEOS(*pcNext) || IsModifier(*pcNext) || IsComment(*pcNext))
+        && (CCmdVerb::Search(sSubVerb.c_str(), pVerb->m_paSubVerbs, false) != NULL)) {
+      pcNext = pcSave;  return ParseVerb(cmd, pcNext, pVerb->m_paSubVerbs);
+    }
+    pcNext = pcSave;
+  }
 
   // It's a simple verb - parse the rest of the command line ...
   if (!ParseTail(pcNext, pVerb->m_paArguments, pVerb->m_paModifiers)) return false;
@@ -1360,6 +1378,7 @@ void CCmdVerb::ShowHelp() const
   // ignores modifiers and arguments for the parent.
   //--
   if (m_paSubVerbs != NULL) {
+    if (m_paArguments != NULL) ShowVerb();
     for (uint32_t i = 0;  m_paSubVerbs[i] != NULL; ++i)
       m_paSubVerbs[i]->ShowVerb(m_pszVerb);
   } else
@@ -1606,6 +1625,37 @@ void CCmdParser::ScriptError (bool fAbort)
   }
 }
 
+bool CCmdParser::RunScript (string sFileName)
+{
+  //++
+  //   Open a script and execute it to completion before returning.  Unlike
+  // OpenScript(), this doesn't return until the script (and anything it calls
+  // with DO) ends, executes EXIT, or fails.  It never reads from the console
+  // and it never continues with any script that was already open - those are
+  // left exactly as they were.  That matters for FORK, where the child process
+  // shares the file position of its parent's script!
+  //
+  //   Returns TRUE if the script ran to completion without any errors ...
+  //--
+  uint32_t nLevel = m_nScriptLevel;
+  if (!OpenScript(sFileName)) return false;
+  SetExitRequest(false);
+  bool fOK = true;
+  while (fOK && !IsExitRequested() && (m_nScriptLevel > nLevel)) {
+    if (!ReadScript(m_szCmdBuf, sizeof(m_szCmdBuf))) {CloseScript();  continue;}
+    if (m_Aliases.Expand(m_szCmdBuf, MAXCMD)) {
+      LOGS(DEBUG, "expanded to \"" << m_szCmdBuf << "\"");
+    }
+    const char *pcNext = m_szCmdBuf;
+    if (!ParseCommand(pcNext)) {
+      CMDERRS("error in script " << GetScriptName() << " line " << GetScriptLine());
+      fOK = false;
+    }
+  }
+  while (m_nScriptLevel > nLevel) CloseScript();
+  return fOK;
+}
+
 bool CCmdParser::DefineAlias (string sAlias, string sSubstitution)
 {
   //++
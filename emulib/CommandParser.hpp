@@ -62,6 +62,7 @@
 //                  Add ParseError() et al to get better error messages.
 // 14-JAN-20  RLA   Add CCmdArgNumberRange and CCmdArgNameOrNumber
 // 25-AUG-22  RLA   Be more careful about private copy and assignment constructors
+// 16-OCT-26  RLA   Add RunScript().
 //--
 #pragma once
 #include <string>               // C++ std::string class, et al ...
@@ -1043,6 +1044,8 @@ public:
   void CloseScript();
   bool ReadScript(char *pszBuffer, size_t cbBuffer);
   void ScriptError(bool fAbort=true);
+  // Run one script to completion, ignoring any outer scripts ...
+  bool RunScript(string sFileName);
   // Read from the console ...
   bool ReadConsole(string sPrompt, char *pszBuffer, size_t cbBuffer);
   // Read a command, either from a script or the console ...
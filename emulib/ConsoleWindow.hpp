@@ -43,6 +43,7 @@
 // 17-NOV-23  RLA   Move the console break handling here.
 //                  Split CVirtualConsole into a separate file.
 // 20-NOV-23  RLA   Add keyboard buffer and make IsConsoleBreak() read ahead
+// 16-OCT-26  RLA   Add IsInputPending() ...
 //--
 #pragma once
 #include <string>               // C++ std::string class, et al ...
@@ -141,6 +142,8 @@ public:
   bool ReadLine (const char *pszPrompt, char *pszBuffer, size_t cbBuffer);
 //bool ReadLine (const char *pszPrompt, string &sBuffer);
   virtual int32_t RawRead (uint8_t *pabBuffer, size_t cbBuffer, uint32_t lTimeout=0) override;
+  // Return TRUE if there are keystrokes waiting to be read ...
+  virtual bool IsInputPending() override;
   // Return TRUE if a console break character has been detected ...
   virtual bool IsConsoleBreak (uint32_t lTimeout=0) override;
   // Return TRUE if a serial break should be sent to the UART ...
@@ -30,6 +30,7 @@
 //                    bit actually changes in the RxCSR or TxCSR.
 // 16-SEP-25  RLA   Add PBRI and baud rate support.
 // 23-SEP-25  RLA   Add split baud rates (for TU58 emulation).
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -48,6 +49,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "UART.hpp"             // generic UART base class
+#include "StateFile.hpp"        // CStateFile declarations
 #include "DC319.hpp"            // declarations for this module
 
 
@@ -494,3 +496,15 @@ void CDC319::ShowDevice (ostringstream &ofs) const
   CUART::ShowDevice(ofs);
 }
 
+
+void CDC319::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the DC319 registers and baud rates ...
+  //--
+  CUART::SyncState(State);
+  State.Sync(m_wRxCSR);  State.Sync(m_wRxBuf);
+  State.Sync(m_wTxCSR);  State.Sync(m_wTxBuf);
+  State.Sync(m_lTxBaud);  State.Sync(m_lRxBaud);
+  State.Sync(m_fPBRI);  State.Sync(m_fEnabled);
+}
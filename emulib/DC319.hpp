@@ -22,6 +22,7 @@
 //
 // REVISION HISTORY:
 //  4-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -95,6 +96,7 @@ public:
   virtual uint8_t DevRead (uint16_t nRegister) override;
   virtual void DevWrite (uint16_t nRegister, uint8_t bData) override;
   virtual void ShowDevice(ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Overridden methods from CUART ...
 public:
@@ -71,6 +71,7 @@
 // 22-JAN-20  RLA   New file.
 //  3-FEB-20  RLA   Change name to C12887 ...
 // 21-JUN-22  RLA   Rewrite to use the new generic RTC class
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -86,6 +87,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "RTC.hpp"              // generic real time clock defintions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "DS12887.hpp"          // declarations for this module
 
 // Table of square wave frequencies ...
@@ -305,3 +307,14 @@ void C12887::ShowDevice (ostringstream &ofs) const
   if (m_llPFdelay > 0) ofs << FormatString("Square wave delay=%lldns, frequency=%lldHz\n", m_llPFdelay, NSTOHZ(m_llPFdelay));
   DumpNVR(ofs);
 }
+
+void C12887::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the control registers and the NVR.  If the square wave is
+  // running then the next EVENT_PF is saved with the event queue ...
+  //--
+  State.Sync(m_bREGA);  State.Sync(m_bREGB);  State.Sync(m_bREGC);
+  State.Sync(m_fElfOS);  State.Sync(m_llPFdelay);
+  SyncNVR(State);
+}
@@ -25,6 +25,7 @@
 // REVISION HISTORY:
 // 22-JAN-20  RLA   New file.
 // 21-JUN-22  RLA   Rewrite to use the new generic RTC class
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -111,6 +112,7 @@ public:
   virtual uint8_t DevRead (uint16_t nRegister) override;
   virtual void DevWrite (uint16_t nRegister, uint8_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Other public DS12887A methods ...
 public:
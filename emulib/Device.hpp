@@ -28,6 +28,8 @@
 // 15-JUL-22  RLA   Add second interrupt channel.
 //                  Create a .cpp file for some of the implementation.
 // 20-DEC-23  RLA   Add bDefault parameter to GetSense()
+// 16-OCT-26  RLA   Add DevReadW() and DevWriteW()
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -40,6 +42,7 @@
 #include "Interrupt.hpp"        // CInterrupt definitions
 using std::string;              // ...
 using std::ostringstream;       // ...
+class CStateFile;               // save/load state file
 
 
 class CDevice : public CEventHandler {
@@ -96,11 +99,22 @@ public:
   // read and write device registers.
   virtual word_t DevRead (address_t nPort) {return WORD_MAX;}
   virtual void DevWrite (address_t nPort, word_t bData) {};
+  //   These read or write a 16 bit, little endian, word as one transaction.
+  // They're only used by CPUs with a 16 bit bus (e.g. the DCT11) and then
+  // only when both bytes belong to the same device.  The default is just two
+  // byte operations, but devices with real 16 bit registers can override them.
+  virtual uint16_t DevReadW (address_t nPort)
+    {word_t l = DevRead(nPort & ~1);  word_t h = DevRead(nPort | 1);  return MKWORD(h, l);}
+  virtual void DevWriteW (address_t nPort, uint16_t wData)
+    {DevWrite(nPort & ~1, LOBYTE(wData));  DevWrite(nPort | 1, HIBYTE(wData));}
   //   And this method is used by CPUs like the PDP-8 where it's the device
   // that determines what I/O operation is to be performed!
   virtual bool DevIOT (word_t wIOT, word_t &wAC, word_t &wPC) {return false;}
   // Dump the device state for the user ...
   virtual void ShowDevice (ostringstream &ofs) const;
+  //   Save or load the device's internal state (registers, buffers, etc) in a
+  // state file.  Any device that has some state should override this ...
+  virtual void SyncState (CStateFile &State) {};
 
   // CEventHandler methods used by the event queue ...
 public:
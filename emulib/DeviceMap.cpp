@@ -31,9 +31,18 @@
 // This collection contains exactly one device pointer entry for each device
 // that's mapped on this system.
 // 
+//   Most port address spaces are tiny, though - the COSMAC has only seven I/O
+// ports and four EF inputs, and even the PDP11 I/O page is only a few hundred
+// bytes - and Find() is called for every I/O operation.  So when the range of
+// port addresses in use, from the lowest to the highest, is small enough we
+// also keep a dense array of device pointers that covers that whole range.
+// Find() then just indexes the array, and the map is only used to rebuild
+// that array whenever a device is installed or removed.
+// 
 // REVISION HISTORY:
 //  4-JUL-22  RLA   Split out of CCPU ...
 //  5-JUL-22  RLA   Revise to use map rather than vector ...
+// 15-OCT-26  RLA   Add a dense array for small port address ranges ...
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -42,6 +51,7 @@
 #include <assert.h>             // assert() (what else??)
 #include <map>                  // C++ std::map template
 #include <unordered_set>        // C++ std::unordered_set template
+#include <vector>               // C++ std::vector template
 #include "EMULIB.hpp"           // emulator library definitions
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "MemoryTypes.h"        // address_t and word_t data types
@@ -49,16 +59,38 @@
 #include "DeviceMap.hpp"        // declarations for this module
 
 
-CDevice *CDeviceMap::Find (address_t nPort) const
+CDevice *CDeviceMap::FindSparse (address_t nPort) const
 {
   //++
   //   Return a pointer to the device mapped to the specified port, or NULL
-  // if the port is currently unmapped...
+  // if the port is currently unmapped.  This is only used when the range of
+  // ports is too big for the dense array...
   //--
   CONST_MAP_ITERATOR it = m_Map.find(nPort);
   return (it == MapEnd()) ? NULL : it->second;
 }
 
+void CDeviceMap::UpdateDense()
+{
+  //++
+  //   Rebuild the dense array of device pointers after the map has changed.
+  // The map is sorted by port address, so the first and last entries give us
+  // the range of ports in use.  If that range is too big then the dense array
+  // isn't used at all, and Find() will search the map instead.  Note that an
+  // empty map gives an empty dense array, and Find() always returns NULL.
+  //--
+  m_apDense.clear();  m_nDenseBase = 0;  m_fDense = true;
+  if (m_Map.empty()) return;
+  address_t nFirst = m_Map.begin()->first, nLast = m_Map.rbegin()->first;
+  if ((size_t) (nLast-nFirst) >= DENSE_LIMIT) {
+    m_fDense = false;  return;
+  }
+  m_nDenseBase = nFirst;
+  m_apDense.assign((size_t) (nLast-nFirst) + 1, NULL);
+  for (CONST_MAP_ITERATOR it = MapBegin();  it != MapEnd();  ++it)
+    m_apDense[it->first - nFirst] = it->second;
+}
+
 int16_t CDeviceMap::Find (const CDevice *pDevice) const
 {
   //++
@@ -123,6 +155,7 @@ bool CDeviceMap::Install (CDevice *pDevice, address_t nPort, address_t cPorts)
   for (address_t n = nPort; n < (nPort+cPorts); ++n)
     m_Map.insert(pair<address_t, CDevice*>(n, pDevice));
   if (m_Set.find(pDevice) == SetEnd()) m_Set.insert(pDevice);
+  UpdateDense();
   return true;
 }
 
@@ -176,7 +209,7 @@ bool CDeviceMap::Remove (address_t nPort)
   //--
   CDevice *pDevice = Find(nPort);
   if (pDevice == NULL) return false;
-  m_Map.erase(nPort);
+  m_Map.erase(nPort);  UpdateDense();
   //   WARNING! Don't be tempted to call IsInstalled() here, because that will
   // search the _set_.  What we want to know is whether there are any more map
   // entries that point to pDevice!
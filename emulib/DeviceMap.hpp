@@ -24,12 +24,14 @@
 // REVISION HISTORY:
 //  4-JUL-22  RLA   Split out of CCPU ...
 // 20-DEC-23  RLA   Add bDefault parametter to GetSense()...
+// 15-OCT-26  RLA   Add a dense array for small port address ranges ...
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
 #include <string>               // C++ string functions
 #include <map>                  // C++ std::map template
 #include <unordered_set>        // C++ std::unordered_set template
+#include <vector>               // C++ std::vector template
 #include "MemoryTypes.h"        // address_t and word_t data types
 #include "Device.hpp"           // CDevice class delcarations
 using std::string;              // ...
@@ -37,6 +39,7 @@ using std::iterator;            // ...
 using std::map;                 // ...
 using std::pair;                // ...
 using std::unordered_set;       // ...
+using std::vector;              // ...
 
 
 class CDeviceMap {
@@ -44,9 +47,17 @@ class CDeviceMap {
   // Map ports or memory addresses to devices ...
   //--
 
+  // Magic numbers ...
+public:
+  enum {
+    //   If the range of port addresses in use, from the lowest to the highest,
+    // is no more than this many then we'll use a dense array for lookups ...
+    DENSE_LIMIT = 1024,
+  };
+
   // Constructors and destructors...
 public:
-  CDeviceMap() {m_Map.clear();  m_Set.clear();}
+  CDeviceMap() {m_Map.clear();  m_Set.clear();  UpdateDense();}
   virtual ~CDeviceMap() {RemoveAll();}
 private:
   // Disallow copy and assignments!
@@ -77,7 +88,15 @@ public:
 public:
   // Find a device by name or port address ...
   CDevice *Find (const string sName) const;
-  CDevice *Find (address_t nPort) const;
+  inline CDevice *Find (address_t nPort) const
+  {
+    //   Note that if the dense array is in use then it covers every mapped
+    // port, so anything outside of it is unmapped.  And note that if nPort
+    // is less than m_nDenseBase, then the unsigned subtraction wraps around!
+    if (!m_fDense) return FindSparse(nPort);
+    size_t n = (size_t) (address_t) (nPort - m_nDenseBase);
+    return (n < m_apDense.size()) ? m_apDense[n] : NULL;
+  }
   int16_t Find (const CDevice *pDevice) const;
   CDevice *Find (const class CSimpleInterrupt *pInterrupt) const;
   // Test whether any device is installed at the given address range ...
@@ -128,9 +147,16 @@ public:
 private:
 //  void Insert (address_t nPort, CDevice *pDevice)
 //    {m_Devices.insert(pair<address_t, CDevice*>(nPort, pDevice));}
+  // Search the map for a port (when the dense array isn't used) ...
+  CDevice *FindSparse (address_t nPort) const;
+  // Rebuild the dense array after the map changes ...
+  void UpdateDense();
 
   // Private member data...
 protected:
   DEVICE_MAP  m_Map;          // mapping of port addresses to device pointers
   DEVICE_SET  m_Set;          // set of all unique devices used
+  bool        m_fDense;       // TRUE if m_apDense is used for lookups
+  address_t   m_nDenseBase;   // port address of m_apDense[0]
+  vector<CDevice *> m_apDense;// device pointers for m_nDenseBase and up
 };
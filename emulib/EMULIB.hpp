@@ -25,6 +25,7 @@
 // REVISION HISTORY:
 // 20-MAY-15  RLA   New file.
 // 15-JAN-20  RLA   Add inline SplitPath(string sPath, ...
+// 16-OCT-26  RLA   Add FindHighestBit() ...
 //--
 #pragma once
 #include <string>             // C++ std::string class, et al ...
@@ -109,6 +110,18 @@ using std::string;            // this is used EVERYWHERE!
 #define CPLBIT(x,b)     x ^=  (b)
 #define ISSET(x,b)	(((x) & (b)) != 0)
 
+//   Return the number, PLUS ONE, of the most significant bit that's set in a
+// 32 bit word, or zero if no bits are set.  That happens to be exactly what we
+// need for interrupt priority levels, which always start from one ...
+#if defined(_MSC_VER)
+#include <intrin.h>
+inline unsigned FindHighestBit (uint32_t x)
+  {unsigned long n;  return _BitScanReverse(&n, x) ? (unsigned) (n+1) : 0;}
+#else
+inline unsigned FindHighestBit (uint32_t x)
+  {return (x == 0) ? 0 : (unsigned) (32 - __builtin_clz(x));}
+#endif
+
 // Useful arithmetic macros ...
 #define MAX(a,b)  ((a) > (b) ? (a) : (b))
 #define MIN(a,b)  ((a) < (b) ? (a) : (b))
@@ -42,6 +42,7 @@
 // REVISION HISTORY:
 // 20-JAN-20  RLA   New file.
 //  5-MAR-25  RLA   Add Enable() to disconnect the IDE drives.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -57,6 +58,7 @@
 #include "CPU.hpp"              // CCPU base class definitions
 #include "Device.hpp"           // basic I/O device emulation declarations ...
 #include "IDE.hpp"              // IDE/ATA disk emulation
+#include "StateFile.hpp"        // CStateFile declarations
 #include "ElfDisk.hpp"          // declarations for this module
 
 
@@ -103,3 +105,12 @@ void CElfDisk::ShowDevice (ostringstream &ofs) const
   } else
     ofs << FormatString("IDE DISABLED") << std::endl;
 }
+
+void CElfDisk::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the generic IDE state plus our enable and select register ...
+  //--
+  CIDE::SyncState(State);
+  State.Sync(m_fEnabled);  State.Sync(m_bSelect);
+}
@@ -22,6 +22,7 @@
 //
 // REVISION HISTORY:
 // 20-JAN-20  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -63,6 +64,7 @@ public:
   virtual word_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, word_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Private member data...
 protected:
@@ -28,14 +28,37 @@
 // simulated time as instructions are executed, and also to call our DoEvents()
 // method at some point in the emulation main loop.
 //
-//   The event queue itself is a simple linked list of blocks containing a
-// device pointer, an optional parameter for the device, and the time of the
-// event.  The queue is sorted so that the next event is always at the front
-// of the list.  To save a little time, when an event occurs we don't actually
-// delete the event block; instead we add it to a free list where it can be
-// reused for scheduling future events.  Free events aren't actually deleted
-// until the Clear() method is called.  This minimizes the amount of memory
-// allocation and deallocation needed.
+//   The event queue itself is a binary heap of blocks containing a device
+// pointer, an optional parameter for the device, and the time of the event.
+// The heap is ordered so that the next event is always at the root, which
+// makes both Schedule() and removing the next event O(log n) operations.
+// Events scheduled for exactly the same time are ordered by a sequence
+// number, so they're always executed in the same order they were scheduled.
+//
+//   But most machines only have a handful of events pending at any time, and
+// for those the heap is actually quite a bit slower than the simple sorted
+// linked list that it replaced.  So as long as there are no more than
+// SMALL_QUEUE events they're kept in that same list, sorted soonest first,
+// instead.  Removing the next event is then just a matter of taking the
+// first one, and Schedule() only has to walk past a few events to find the
+// right place.  The events are moved to the heap when the list gets any
+// longer than that, and back again only after the heap drops to half of
+// SMALL_QUEUE, so a queue that hovers around the limit doesn't keep going
+// back and forth.
+//
+//   Devices refer to their events by the CEventHandler pointer and lParam,
+// so when the queue is a heap each CEventHandler also keeps a doubly linked
+// list of its own pending events.  That makes Cancel() and IsPending() cheap,
+// since they only have to look at the events for that one handler rather than
+// walking the whole queue.  Each event also remembers its own index in the
+// heap so that it can be removed directly, without searching.  A small queue
+// doesn't bother with any of that - it's quicker to just search the list.
+//
+//   To save a little time, when an event occurs we don't actually delete the
+// event block; instead we add it to a free list where it can be reused for
+// scheduling future events.  Free events aren't actually deleted until the
+// Clear() method is called.  This minimizes the amount of memory allocation
+// and deallocation needed.
 //
 //   IMPORTANT!
 //   The event queue is currently a singleton object.  The constructor enforces
@@ -48,47 +71,88 @@
 // limits us to one CPU instance per program.  That's not really a problem,
 // since I don't have any plans to emulate any multiprocessor systems just yet.
 // 
-//   FWIW, yes I probably could have used std::list or (better yet!) std::set
-// for the event queue, but there would be a few problems.  std::list is not
-// ordered and so we'd either have to search for the correct insertion point,
-// or resort the list, after every call to Schedule().  std::set is a better
-// choice since it's already sorted, but set doesn't allow duplicate keys and
-// we need to be able to schedule two or more events for the same time.  Yes,
-// we could work around that, but it's super easy to implement our own ordered
-// list or queue, so why bother?
+//   FWIW, yes I probably could have used std::priority_queue for the event
+// queue, but it doesn't allow removing anything other than the top element
+// and Cancel() needs to do exactly that.  std::set or std::multiset would
+// work too, but they're node based and not any simpler.  It's super easy to
+// implement our own heap, so why bother?
 //    
 // REVISION HISTORY:
 // 12-AUG-19  RLA   New file.
 // 19-NOV-23  RLA   Invent CEventHandler and use it for all callbacks...
+// 15-OCT-26  RLA   Add the CPU horizon ...
+//                  Replace the sorted linked list with a binary heap
+// 16-OCT-26  RLA   Add the time limit and event counter ...
+// 16-OCT-26  RLA   Add per handler statistics ...
+// 16-OCT-26  RLA   Add real time pacing ...
+// 16-OCT-26  RLA   Add SyncState() ...
+// 16-OCT-26  RLA   Cancel pending events when a handler is deleted ...
+// 16-OCT-26  RLA   Find the statistics entry inline ...
+// 16-OCT-26  RLA   Key the handler statistics by handler within each queue ...
+// 16-OCT-26  RLA   Keep small queues in a sorted list instead of the heap ...
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
 #include <stdlib.h>             // exit(), system(), etc ...
 #include <stdint.h>	        // uint8_t, uint32_t, etc ...
 #include <assert.h>             // assert() (what else??)
+#include <vector>               // C++ std::vector template
+#include <algorithm>            // std::sort() ...
+#include <chrono>               // steady_clock for real time pacing
 #include "EMULIB.hpp"           // emulator library definitions
 #include "MemoryTypes.h"        // address_t and word_t data types
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "CPU.hpp"              // generic CPU declarations
 //#include "Device.hpp"           // needed to define the Event() method ...
+#include "StateFile.hpp"        // CStateFile declarations
 #include "EventQueue.hpp"       // declarations for this module
 
 
+CEventHandler::~CEventHandler()
+{
+  //++
+  //   If this handler still has events on the queue then cancel them now.
+  // Once the queue is gone, ClearEvents() has already zeroed m_nPending and
+  // we never touch m_pQueue.  Then tell every queue that has statistics for
+  // us to forget our address (a queue that's deleted first removes itself
+  // from m_vQueues) ...
+  //--
+  if (m_nPending != 0) {
+    assert(m_pQueue != NULL);
+    m_pQueue->CancelHandler(this);
+  }
+  for (CEventQueue *pQueue : m_vQueues)  pQueue->ForgetHandler(this);
+}
+
+
 CEventQueue::CEventQueue()
 {
   //++
   // Constructor ...
   //--
-  m_qCurrentTime = m_qNextEvent = 0;
-  m_pNextEvent = m_pFreeEvents = NULL;
+  m_qCurrentTime = m_qNextEvent = m_qHorizon = m_qSequence = 0;
+  m_qTimeLimit = UINT64_MAX;  m_qEventCount = 0;
+  m_qDispatchCount = m_qJumpCount = m_qJumpTime = 0;
+  m_nSpeed = 0;  m_fPaceRestart = true;
+  m_qPaceHost = m_qPaceTime = m_qSleepTime = 0;
+  m_pFreeEvents = NULL;
+  m_fList = true;  m_pList = NULL;  m_nList = 0;
 }
 
 CEventQueue::~CEventQueue()
 {
   //++
-  // Destructor ...
+  //   Destructor.  Tell every handler we have statistics for to forget about
+  // us, so that it won't call ForgetHandler() on a deleted queue ...
   //--
   ClearEvents();
+  for (auto &e : m_mapStatistics) {
+    CEventHandler *pHandler = const_cast<CEventHandler *>(e.first);
+    vector<CEventQueue *> &v = pHandler->m_vQueues;
+    for (size_t i = 0;  i < v.size();  ++i)
+      if (v[i] == this) {v.erase(v.begin()+i);  break;}
+    if (pHandler->m_pStatistics == this) pHandler->m_pStatistics = NULL;
+  }
 }
 
 uint64_t CEventQueue::AddTime (uint64_t qTime)
@@ -101,37 +165,94 @@ uint64_t CEventQueue::AddTime (uint64_t qTime)
   return m_qCurrentTime;
 }
 
-uint64_t CEventQueue::JumpAhead (uint64_t qTime)
+void CEventQueue::Pace()
 {
   //++
-  // Jump ahead to the specified time, which MUST BE IN THE FUTURE!
+  //   Compare the simulated time elapsed since pacing started with the host
+  // time, scaled by the speed, and sleep if the simulation is ahead.  Sleeping
+  // is done in coarse slices - if we're only a millisecond or so ahead it's
+  // not worth it, and if we're a long way ahead (say, because an idle loop
+  // just skipped a whole second) then we only sleep for PACE_MAXSLEEP at a
+  // time so that the UI stays responsive.  The next horizon will sleep again.
+  //
+  //   Note that the simulated time goes backwards when the event queue is
+  // cleared, and in that case we have to start over too.
   //--
-  assert(qTime >= m_qCurrentTime);
-  m_qCurrentTime = qTime;
-  return m_qCurrentTime;
+  uint64_t qHost = std::chrono::duration_cast<std::chrono::nanoseconds>
+    (std::chrono::steady_clock::now().time_since_epoch()).count();
+  if (m_fPaceRestart || (m_qCurrentTime < m_qPaceTime)) {
+    m_qPaceHost = qHost;  m_qPaceTime = m_qCurrentTime;  m_fPaceRestart = false;
+    return;
+  }
+  uint64_t qTarget = (m_qCurrentTime - m_qPaceTime) / m_nSpeed;
+  uint64_t qElapsed = qHost - m_qPaceHost;
+  if (qTarget > qElapsed) {
+    uint64_t qAhead = NSTOMS(qTarget - qElapsed);
+    if (qAhead < PACE_MINSLEEP) return;
+    if (qAhead > PACE_MAXSLEEP) qAhead = PACE_MAXSLEEP;
+    _sleep_ms((uint32_t) qAhead);  m_qSleepTime += MSTONS(qAhead);
+  } else if ((qElapsed - qTarget) > PACE_SLIP) {
+    m_qPaceHost = qHost;  m_qPaceTime = m_qCurrentTime;
+  }
+}
+
+CEventQueue::HANDLER_STATISTICS &CEventQueue::FindStatistics (CEventHandler *pHandler)
+{
+  //++
+  //   Find the statistics entry for a handler whose cached index belongs to
+  // some other queue (or to none), or add a new entry if we've never seen
+  // this handler before.  Either way, cache our index in the handler so that
+  // Statistics() finds it inline next time ...
+  //--
+  size_t nIndex;
+  auto it = m_mapStatistics.find(pHandler);
+  if (it != m_mapStatistics.end()) {
+    nIndex = it->second;
+  } else {
+    nIndex = m_Statistics.size();
+    m_Statistics.push_back({pHandler->EventName(), 0, 0, 0});
+    m_mapStatistics[pHandler] = nIndex;
+    pHandler->m_vQueues.push_back(this);
+  }
+  pHandler->m_pStatistics = this;  pHandler->m_nStatistics = nIndex;
+  return m_Statistics[nIndex];
+}
+
+void CEventQueue::ForgetHandler (CEventHandler *pHandler)
+{
+  //++
+  //   Called when a handler is deleted.  Its counts stay in the table, but
+  // another handler that's later created at the same address must get an
+  // entry of its own ...
+  //--
+  m_mapStatistics.erase(pHandler);
+}
+
+void CEventQueue::ClearStatistics()
+{
+  //++
+  //   Zero all the statistics, including the per handler counts, but keep
+  // the list of handlers.  Note that this DOESN'T reset the event count,
+  // which belongs to BENCHMARK ...
+  //--
+  m_qDispatchCount = m_qJumpCount = m_qJumpTime = m_qSleepTime = 0;
+  for (HANDLER_STATISTICS &s : m_Statistics)
+    s.qScheduled = s.qCancelled = s.qExecuted = 0;
 }
 
 void CEventQueue::Schedule (CEventHandler *pHandler, intptr_t lParam, uint64_t qDelay)
 {
   //++
   //   This routine will add a new event to the event queue.  The event queue
-  // is _always_ sorted by time, so that the next event to occur is on the front
-  // of the queue.  The global variable qEventTime is set to reflect the time of
-  // the next event, and the main emulation loop uses this do decide whether it's
+  // is _always_ ordered by time, so that the next event to occur is at the root
+  // of the heap.  The m_qNextEvent member is set to reflect the time of the
+  // next event, and the main emulation loop uses this do decide whether it's
   // time to process events or not.
   //
   //   Note that the interval given is a delay and it's always relative to the
   // current time!
   //--
-  EVENT *pEvent, *pLast, *pThis;
-
-  //   First, allocate an event block.  Since doing malloc()s all the time is
-  // fairly expensive, we keep a free list of old event blocks for re-use. Only
-  // if this list is empty do we go to the trouble of a malloc()...
-  if (m_pFreeEvents != NULL) {
-    pEvent = m_pFreeEvents;  m_pFreeEvents = pEvent->pNext;
-  } else
-    pEvent = DBGNEW EVENT;
+  EVENT *pEvent = NewEvent();
 
   // Fill it in...
   pEvent->pHandler = pHandler;  pEvent->lParam = lParam;
@@ -147,22 +268,171 @@ void CEventQueue::Schedule (CEventHandler *pHandler, intptr_t lParam, uint64_t q
 
   LOGF(TRACE, "Scheduled event #%d for %s at %lld", lParam, pHandler->EventName(), pEvent->qTime);
 
-  //   Do a simple insertion sort to stick it in the right place on the list.
-  // Remember that the events that happen first - that is, those with the 
-  // _smallest_ time value, are on the front of the list
-  if ((m_pNextEvent == NULL) || (pEvent->qTime < m_pNextEvent->qTime)) {
-    // Special case - insert at the head of the queue...
-    pEvent->pNext = m_pNextEvent;  m_pNextEvent = pEvent;
-    m_qNextEvent = pEvent->qTime;
+  //   Add the new event to the queue.  The sequence number guarantees that
+  // it ends up AFTER any other events already scheduled for the same time ...
+  pEvent->qSequence = m_qSequence++;
+  Insert(pEvent);  ++Statistics(pHandler).qScheduled;
+
+  //   If this event happens before the CPU's current horizon, then pull the
+  // horizon in so that the CPU won't run past it.  Note that the horizon is
+  // never pushed out here - only the CPU does that, by calling ResetHorizon().
+  if (pEvent->qTime < m_qHorizon) m_qHorizon = pEvent->qTime;
+}
+
+CEventQueue::EVENT *CEventQueue::NewEvent()
+{
+  //++
+  //   Allocate an event block.  Since doing malloc()s all the time is fairly
+  // expensive, we keep a free list of old event blocks for re-use. Only if
+  // this list is empty do we go to the trouble of a malloc()...
+  //--
+  EVENT *pEvent;
+  if (m_pFreeEvents != NULL) {
+    pEvent = m_pFreeEvents;  m_pFreeEvents = pEvent->pNext;
+  } else
+    pEvent = DBGNEW EVENT;
+  return pEvent;
+}
+
+void CEventQueue::Insert (EVENT *pEvent)
+{
+  //++
+  //   Add an event, which must already have its time, sequence, handler and
+  // parameter filled in, to the queue.  If the queue is still small then just
+  // walk down the sorted list to find the right place.  Since the sequence
+  // numbers only ever go up, comparing the times is enough - the new event
+  // goes AFTER any others for the same time.  Otherwise add it to the end of
+  // the heap, let it bubble up to the right place, and add it to the
+  // handler's pending list too ...
+  //--
+  CEventHandler *pHandler = pEvent->pHandler;
+  ++pHandler->m_nPending;  pHandler->m_pQueue = this;
+  if (m_fList && (m_nList >= SMALL_QUEUE)) MakeHeap();
+  if (m_fList) {
+    EVENT *pPrevious = NULL, *pNext = m_pList;
+    while ((pNext != NULL) && (pEvent->qTime >= pNext->qTime))
+      pPrevious = pNext, pNext = pNext->pListNext;
+    pEvent->pListNext = pNext;  ++m_nList;
+    if (pPrevious != NULL) {
+      pPrevious->pListNext = pEvent;
+    } else {
+      m_pList = pEvent;  m_qNextEvent = pEvent->qTime;
+    }
   } else {
-    // Insert this event somewhere in the middle of the list...
-    pLast = m_pNextEvent;  pThis = pLast->pNext;
-    while ((pThis != NULL) && (pEvent->qTime >= pThis->qTime))
-      pLast = pThis, pThis = pThis->pNext;
-    pEvent->pNext = pLast->pNext;  pLast->pNext = pEvent;
+    pEvent->nHeap = m_Heap.size();  m_Heap.push_back(pEvent);
+    SiftUp(pEvent->nHeap);  LinkHandler(pEvent);  UpdateNextEvent();
   }
 }
 
+void CEventQueue::SiftUp (size_t n)
+{
+  //++
+  //   Move the event at heap index n up towards the root until its parent
+  // happens before it ...
+  //--
+  EVENT *pEvent = m_Heap[n];
+  while (n > 0) {
+    size_t nParent = (n-1) / 2;
+    if (!IsBefore(pEvent, m_Heap[nParent])) break;
+    m_Heap[n] = m_Heap[nParent];  m_Heap[n]->nHeap = n;  n = nParent;
+  }
+  m_Heap[n] = pEvent;  pEvent->nHeap = n;
+}
+
+void CEventQueue::SiftDown (size_t n)
+{
+  //++
+  //   Move the event at heap index n down towards the leaves until both its
+  // children happen after it ...
+  //--
+  EVENT *pEvent = m_Heap[n];  size_t nSize = m_Heap.size();
+  while (true) {
+    size_t nChild = 2*n + 1;
+    if (nChild >= nSize) break;
+    if ((nChild+1 < nSize) && IsBefore(m_Heap[nChild+1], m_Heap[nChild])) ++nChild;
+    if (!IsBefore(m_Heap[nChild], pEvent)) break;
+    m_Heap[n] = m_Heap[nChild];  m_Heap[n]->nHeap = n;  n = nChild;
+  }
+  m_Heap[n] = pEvent;  pEvent->nHeap = n;
+}
+
+void CEventQueue::MakeHeap()
+{
+  //++
+  //   Move all the events from the sorted list to the heap, and add them to
+  // their handlers' pending lists.  A list that's sorted soonest first is
+  // already a valid heap, so there's no need to do anything more than copy
+  // it ...
+  //--
+  assert(m_fList && m_Heap.empty());
+  for (EVENT *pEvent = m_pList;  pEvent != NULL;  pEvent = pEvent->pListNext) {
+    pEvent->nHeap = m_Heap.size();  m_Heap.push_back(pEvent);
+    LinkHandler(pEvent);
+  }
+  m_fList = false;  m_pList = NULL;  m_nList = 0;
+}
+
+void CEventQueue::MakeList()
+{
+  //++
+  //   Sort the heap and move all the events back to the list.  The handlers'
+  // pending lists aren't used for a small queue, so just forget them ...
+  //--
+  assert(!m_fList && (m_pList == NULL));
+  std::sort(m_Heap.begin(), m_Heap.end(), [] (const EVENT *pA, const EVENT *pB) {return IsBefore(pA, pB);});
+  for (size_t i = m_Heap.size();  i > 0;  --i) {
+    EVENT *pEvent = m_Heap[i-1];
+    pEvent->pHandler->m_pPending = pEvent->pNext = pEvent->pPrevious = NULL;
+    pEvent->pListNext = m_pList;  m_pList = pEvent;
+  }
+  m_nList = m_Heap.size();  m_Heap.clear();  m_fList = true;
+}
+
+/*static*/ void CEventQueue::LinkHandler (EVENT *pEvent)
+{
+  //++
+  // Add this event to the front of its handler's pending list ...
+  //--
+  CEventHandler *pHandler = pEvent->pHandler;
+  pEvent->pPrevious = NULL;  pEvent->pNext = pHandler->m_pPending;
+  if (pHandler->m_pPending != NULL) pHandler->m_pPending->pPrevious = pEvent;
+  pHandler->m_pPending = pEvent;
+}
+
+/*static*/ void CEventQueue::UnlinkHandler (EVENT *pEvent)
+{
+  //++
+  // Remove this event from its handler's pending list ...
+  //--
+  if (pEvent->pPrevious != NULL)
+    pEvent->pPrevious->pNext = pEvent->pNext;
+  else
+    pEvent->pHandler->m_pPending = pEvent->pNext;
+  if (pEvent->pNext != NULL) pEvent->pNext->pPrevious = pEvent->pPrevious;
+  pEvent->pNext = pEvent->pPrevious = NULL;
+}
+
+void CEventQueue::Unlink (EVENT *pEvent)
+{
+  //++
+  //   Remove the specified event from both the heap and its handler's list.
+  // We do that by moving the last event in the heap into the hole left by
+  // this one, and then letting that one float up or down as needed.  If that
+  // leaves the heap small enough, then go back to the list.  The event block
+  // is NOT freed - that's up to the caller - and note that this doesn't update
+  // m_qNextEvent either!
+  //--
+  UnlinkHandler(pEvent);  --pEvent->pHandler->m_nPending;
+  size_t n = pEvent->nHeap;  EVENT *pLast = m_Heap.back();
+  assert((n < m_Heap.size()) && (m_Heap[n] == pEvent));
+  m_Heap.pop_back();
+  if (pLast != pEvent) {
+    m_Heap[n] = pLast;  pLast->nHeap = n;
+    SiftUp(n);  SiftDown(pLast->nHeap);
+  }
+  if (m_Heap.size() <= SMALL_QUEUE/2) MakeList();
+}
+
 void CEventQueue::Cancel (CEventHandler *pHandler, intptr_t lParam)
 {
   //++
@@ -171,23 +441,56 @@ void CEventQueue::Cancel (CEventHandler *pHandler, intptr_t lParam)
   // No other events on the queue are affected.  It's normally used by the device
   // emulator when a device reset type function is executed...
   //--
-  EVENT *pThis = m_pNextEvent, *pLast = NULL, *pFree;
   LOGF(TRACE, "Cancelling all events #%d for %s", lParam, pHandler->EventName());
-  while (pThis != NULL) {
-    if ((pThis->pHandler != pHandler) || (pThis->lParam != lParam)) {
-      // No match - on to the next item...
-      pLast = pThis;  pThis = pThis->pNext;
-    } else if (pLast == NULL) {
-      // Remove the first item on the list!
-      pFree = pThis;  m_pNextEvent = pThis->pNext;  pThis = pThis->pNext;
-      pFree->pNext = m_pFreeEvents;  m_pFreeEvents = pFree;
-      m_qNextEvent = (m_pNextEvent == NULL) ? 0 : m_pNextEvent->qTime;
-    } else {
-      // Remove an item from the middle of the list...
-      pFree = pThis;  pLast->pNext = pThis->pNext;  pThis = pThis->pNext;
-      pFree->pNext = m_pFreeEvents;  m_pFreeEvents = pFree;
+  if (pHandler->m_nPending == 0) return;
+  EVENT *pEvent, *pNext, *pPrevious = NULL;
+  //   Note that Unlink() might turn the heap back into a list, and then this
+  // handler's pending list is gone.  In that case the list search finishes
+  // the job ...
+  for (pEvent = pHandler->m_pPending;  (pEvent != NULL) && !m_fList;  pEvent = pNext) {
+    pNext = pEvent->pNext;
+    if (pEvent->lParam == lParam) {
+      Unlink(pEvent);  FreeEvent(pEvent);  ++Statistics(pHandler).qCancelled;
     }
   }
+  if (m_fList) {
+    for (pEvent = m_pList;  pEvent != NULL;  pEvent = pNext) {
+      pNext = pEvent->pListNext;
+      if ((pEvent->pHandler == pHandler) && (pEvent->lParam == lParam)) {
+        UnlinkList(pEvent, pPrevious);  FreeEvent(pEvent);  ++Statistics(pHandler).qCancelled;
+      } else
+        pPrevious = pEvent;
+    }
+  }
+  UpdateNextEvent();
+}
+
+void CEventQueue::CancelHandler (CEventHandler *pHandler)
+{
+  //++
+  //   Remove all the events for a handler that's being deleted.  This is
+  // called from the CEventHandler destructor, so the derived object is
+  // already gone - don't call EventName() or anything else virtual!
+  //--
+  auto it = m_mapStatistics.find(pHandler);
+  HANDLER_STATISTICS *pStatistics = (it != m_mapStatistics.end()) ? &m_Statistics[it->second] : NULL;
+  while ((pHandler->m_pPending != NULL) && !m_fList) {
+    EVENT *pEvent = pHandler->m_pPending;
+    Unlink(pEvent);  FreeEvent(pEvent);
+    if (pStatistics != NULL) ++pStatistics->qCancelled;
+  }
+  if (m_fList) {
+    EVENT *pEvent, *pNext, *pPrevious = NULL;
+    for (pEvent = m_pList;  pEvent != NULL;  pEvent = pNext) {
+      pNext = pEvent->pListNext;
+      if (pEvent->pHandler == pHandler) {
+        UnlinkList(pEvent, pPrevious);  FreeEvent(pEvent);
+        if (pStatistics != NULL) ++pStatistics->qCancelled;
+      } else
+        pPrevious = pEvent;
+    }
+  }
+  UpdateNextEvent();
 }
 
 void CEventQueue::CancelAllEvents()
@@ -195,28 +498,33 @@ void CEventQueue::CancelAllEvents()
   //++
   //   This routine cancels all current events for all devices but, unlike
   // ClearEvents(), this simply adds the event queue blocks to the free list
-  // and does not reset the current emulation time.
+  // and does not reset the current emulation time.  Every handler on the
+  // heap is still alive, since ~CEventHandler() removes its own events.
   //--
-  EVENT *pThis;
   LOGF(TRACE, "Clearing event queue");
-  while (m_pNextEvent != NULL) {
-    pThis = m_pNextEvent;  m_pNextEvent = pThis->pNext;
-    pThis->pNext = m_pFreeEvents;  m_pFreeEvents = pThis;
+  if (m_fList) MakeHeap();
+  for (EVENT *pEvent : m_Heap) {
+    ++Statistics(pEvent->pHandler).qCancelled;
+    pEvent->pHandler->m_pPending = NULL;  pEvent->pHandler->m_nPending = 0;
+    FreeEvent(pEvent);
   }
-  m_qNextEvent = 0;
+  m_Heap.clear();  m_fList = true;
+  m_qNextEvent = m_qHorizon = 0;
 }
 
 bool CEventQueue::IsPending (const CEventHandler *pHandler, intptr_t lParam) const
 {
   //++
-  //   This routine searches the event queue and returns TRUE if at least one
-  // event is pending for the specified callback.  Both the callback pointer
-  // AND the lParam must match!  The event queue is not changed by this call.
+  //   This routine returns TRUE if at least one event is pending for the
+  // specified callback.  Both the callback pointer AND the lParam must match!
+  // The event queue is not changed by this call.
   //--
-  EVENT *pEvent = m_pNextEvent;
-  while (pEvent != NULL) {
-    if ((pEvent->pHandler==pHandler) && (pEvent->lParam==lParam)) return true;
-    pEvent = pEvent->pNext;
+  if (m_fList) {
+    for (const EVENT *pEvent = m_pList;  pEvent != NULL;  pEvent = pEvent->pListNext)
+      if ((pEvent->pHandler == pHandler) && (pEvent->lParam == lParam)) return true;
+  } else {
+    for (const EVENT *pEvent = pHandler->m_pPending;  pEvent != NULL;  pEvent = pEvent->pNext)
+      if (pEvent->lParam == lParam) return true;
   }
   return false;
 }
@@ -232,6 +540,7 @@ void CEventQueue::DoEvents()
 
   // There's nothing to do unless qCurrentTime is .GE. qNextEvent ...
   if ((m_qNextEvent == 0) || (m_qCurrentTime < m_qNextEvent)) return;
+  ++m_qDispatchCount;
 
   //   You need to be a little careful here, since a device's event routine may
   // very well schedule a new event.  This means that the event on the front of
@@ -239,16 +548,17 @@ void CEventQueue::DoEvents()
   // Likewise, it's possible, although not likely, that a device Event() method
   // will schedule a new event for which the time has already passed and in that
   // case the newly scheduled event needs to be executed immediately...
-  while ((m_pNextEvent != NULL) && (m_pNextEvent->qTime <= m_qCurrentTime)) {
+  while (((pEvent = Soonest()) != NULL) && (pEvent->qTime <= m_qCurrentTime)) {
     // Remove this event from the queue, but don't free it yet!
-    pEvent = m_pNextEvent;  m_pNextEvent = m_pNextEvent->pNext;
+    if (m_fList) UnlinkList(pEvent, NULL);  else Unlink(pEvent);
     // Execute the event procedure ...
     LOGF(TRACE, "Executing event #%d for %s", pEvent->lParam, pEvent->pHandler->EventName());
-    pEvent->pHandler->EventCallback(pEvent->lParam);
+    ++Statistics(pEvent->pHandler).qExecuted;
+    pEvent->pHandler->EventCallback(pEvent->lParam);  ++m_qEventCount;
     // Now free the event...
-    pEvent->pNext = m_pFreeEvents;  m_pFreeEvents = pEvent;
+    FreeEvent(pEvent);
   }
-  m_qNextEvent = (m_pNextEvent == NULL) ? 0 : m_pNextEvent->qTime;
+  UpdateNextEvent();
 }
 
 void CEventQueue::ClearEvents()
@@ -260,12 +570,63 @@ void CEventQueue::ClearEvents()
   // This method is normally only called when the simulation is reset.
   //--
   EVENT *pFree;
-  while (m_pNextEvent != NULL) {
-    pFree = m_pNextEvent;  m_pNextEvent = m_pNextEvent->pNext;  delete pFree;
+  if (m_fList) MakeHeap();
+  for (EVENT *pEvent : m_Heap) {
+    pEvent->pHandler->m_pPending = NULL;  pEvent->pHandler->m_nPending = 0;
+    delete pEvent;
   }
+  m_Heap.clear();  m_fList = true;
   while (m_pFreeEvents != NULL) {
     pFree = m_pFreeEvents;  m_pFreeEvents = m_pFreeEvents->pNext;  delete pFree;
   }
-  m_qNextEvent = m_qCurrentTime = 0;
-  m_pNextEvent = m_pFreeEvents = NULL;
+  m_qNextEvent = m_qCurrentTime = m_qHorizon = m_qSequence = 0;
+  m_pFreeEvents = NULL;
+}
+
+void CEventQueue::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the current simulated time and all the pending events.
+  // Each event is saved with the name of its handler, its parameter, and its
+  // absolute time and sequence number, so the events will happen in exactly
+  // the same order after they're loaded.  When loading, any events that are
+  // currently pending are discarded first, and the handlers are found by name
+  // from the objects that have already been loaded.  That's why the event
+  // queue has to be last!
+  //
+  //   Note that the time limit, the pacing and the statistics aren't part of
+  // the machine state, and they're not changed.
+  //--
+  State.Sync(m_qCurrentTime);  State.Sync(m_qSequence);
+  uint32_t nEvents = (uint32_t) (m_fList ? m_nList : m_Heap.size());  State.Sync(nEvents);
+  if (State.IsSaving()) {
+    vector<EVENT *> Events(m_Heap);
+    for (EVENT *pEvent = m_pList;  pEvent != NULL;  pEvent = pEvent->pListNext)
+      Events.push_back(pEvent);
+    std::sort(Events.begin(), Events.end(), [] (const EVENT *pA, const EVENT *pB) {return IsBefore(pA, pB);});
+    for (EVENT *pEvent : Events) {
+      string sName(pEvent->pHandler->EventName());
+      if (State.FindHandler(sName) != pEvent->pHandler)
+        State.Error("event handler " + sName + " wasn't saved");
+      int64_t llParam = pEvent->lParam;
+      State.Sync(sName);  State.Sync(llParam);
+      State.Sync(pEvent->qTime);  State.Sync(pEvent->qSequence);
+    }
+  } else {
+    CancelAllEvents();
+    for (uint32_t i = 0;  (i < nEvents) && State.IsOK();  ++i) {
+      string sName;  int64_t llParam = 0;  uint64_t qTime = 0, qSequence = 0;
+      State.Sync(sName);  State.Sync(llParam);  State.Sync(qTime);  State.Sync(qSequence);
+      if (!State.IsOK()) break;
+      CEventHandler *pHandler = State.FindHandler(sName);
+      if (pHandler == NULL) {
+        State.Error("no event handler named " + sName);  break;
+      }
+      EVENT *pEvent = NewEvent();
+      pEvent->pHandler = pHandler;  pEvent->lParam = (intptr_t) llParam;
+      pEvent->qTime = qTime;  pEvent->qSequence = qSequence;
+      Insert(pEvent);
+    }
+    m_fPaceRestart = true;  InvalidateHorizon();
+  }
 }
@@ -28,14 +28,50 @@
 // the simulated time as instructions are executed, and also to call our
 // DoEvents() method at some point in the emulation main loop.
 //
+//   The event queue also keeps track of the CPU's "horizon".  That's the
+// simulated time at which the CPU's Run() loop next needs to stop and process
+// events, sample interrupt requests, etc.  Normally that's just the time of
+// the next event, but anything that might change the CPU's interrupt state
+// (an I/O instruction, for example) can invalidate the horizon to force the
+// CPU to check again before the next instruction.
+//
+//   Lastly, the event queue can also have a time limit.  When the simulated
+// time reaches the limit the horizon stops there too, and the CPU's Run()
+// loop returns STOP_FINISHED.  That's used to run benchmarks for a fixed
+// amount of simulated time.
+//
+//   And the event queue can pace the simulation to real time, or to some
+// multiple of real time.  Every time the CPU reaches the horizon it calls
+// Pace(), which compares the simulated time with the host's monotonic clock
+// and sleeps if the simulation has gotten ahead.  When pacing is enabled the
+// horizon is never more than PACE_SLICE in the future, so we get a chance to
+// do that even when no events are scheduled.
+//
 // REVISION HISTORY:
 // 12-AUG-19  RLA   New file.
+// 15-OCT-26  RLA   Add the CPU horizon ...
+//                  Replace the sorted linked list with a binary heap
+// 16-OCT-26  RLA   Add the time limit and event counter ...
+// 16-OCT-26  RLA   Add per handler statistics ...
+// 16-OCT-26  RLA   Add real time pacing ...
+// 16-OCT-26  RLA   Add SyncState() ...
+// 16-OCT-26  RLA   Cancel pending events when a handler is deleted ...
+// 16-OCT-26  RLA   Find the statistics entry inline ...
+// 16-OCT-26  RLA   Key the handler statistics by handler within each queue ...
+// 16-OCT-26  RLA   Keep small queues in a sorted list instead of the heap ...
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
 #include <string>               // C++ std::string class, et al ...
+#include <vector>               // C++ std::vector template
+#include <unordered_map>        // C++ std::unordered_map template
 using std::string;              // ...
+using std::vector;              // ...
+using std::unordered_map;       // ...
 class CDevice;                  // we need pointers to device objects
+class CStateFile;               // save/load state file
+class CEventQueue;              // event handlers point back to their queue
+struct _EVENT;                  // event queue entries (see below)
 
 
 class CEventHandler {
@@ -44,7 +80,12 @@ class CEventHandler {
   // that wants to receive event handler callbacks ...
   //--
 
-  // No constructor or destructor (or rather, the default which does nothing) ...
+  //   The destructor cancels any events that are still pending for this
+  // handler.  That way devices can be deleted either before or after the
+  // event queue, and the queue never keeps a pointer to a deleted object.
+public:
+  CEventHandler() {}
+  virtual ~CEventHandler();
 
   // This is the callback from the event handler ...
 public:
@@ -55,6 +96,42 @@ public:
   // up to you whether you want to implement it.
 public:
   virtual const char *EventName() const {return "unknown";}
+
+  //   When the queue is a heap, every handler keeps a list of its own pending
+  // events.  This allows Cancel() and IsPending() to find them without
+  // searching the entire event queue (a small queue is just searched).  The
+  // count is kept either way.  These belong to CEventQueue and nobody else
+  // should touch them!
+private:
+  friend class CEventQueue;
+  struct _EVENT  *m_pPending = NULL;
+  size_t          m_nPending = 0;       // number of events pending on m_pQueue
+  CEventQueue    *m_pQueue = NULL;      // the queue holding our events
+  //   Every queue that this handler has used keeps its own statistics entry
+  // for it, keyed by the handler's address.  The handler remembers those
+  // queues so that it can tell them when it's deleted, and it also caches the
+  // last queue and index it used so that the usual case doesn't need a hash
+  // table lookup ...
+  vector<CEventQueue *> m_vQueues;      // queues with statistics for us
+  CEventQueue    *m_pStatistics = NULL; // last queue we looked up, and
+  size_t          m_nStatistics = 0;    //  ... our index in its table
+};
+
+
+//   Device actions (e.g. completing an I/O) are scheduled by means of an
+// event queue.  Entries on the queue have a scheduled time and the pointer
+// to a device callback function which processes the event.  The sequence
+// number breaks ties between events scheduled for the same time, so that
+// they're always executed in the order they were scheduled.
+struct _EVENT {                 // structure of event queue entries
+  uint64_t         qTime;       //  simulated CPU time when this event occurs
+  uint64_t         qSequence;   //  order in which the event was scheduled
+  CEventHandler   *pHandler;    //  pointer to callback routine
+  intptr_t         lParam;      //  arbitrary parameter for the event routine
+  size_t           nHeap;       //  index of this event in the heap
+  struct _EVENT   *pNext;       //  next event for this handler, or free list
+  struct _EVENT   *pPrevious;   //  previous event for this handler
+  struct _EVENT   *pListNext;   //  next event in the small queue list
 };
 
 
@@ -65,15 +142,6 @@ class CEventQueue {
 
   // Event queue structure ...
 private:
-  //   Device actions (e.g. completing an I/O) are scheduled by means of
-  // an event queue.  Entries on the queue have a scheduled time and the
-  // pointer to a device callback function which processes the event.
-  struct _EVENT {		// structure of event queue entries
-    uint64_t         qTime;     //  simulated CPU time when this event occurs
-    CEventHandler   *pHandler;  //  pointer to callback routine
-    intptr_t	     lParam;    //  arbitrary parameter for the event routine
-    struct _EVENT   *pNext;     //  next event in the queue
-  };
   typedef struct _EVENT EVENT;
 
 public:
@@ -92,12 +160,87 @@ public:
   // Increment the simulated time ...
   uint64_t AddTime (uint64_t qTime);
   // Jump ahead (forward only!) to the specified time ...
-  uint64_t JumpAhead (uint64_t qTime);
+  inline uint64_t JumpAhead (uint64_t qTime)
+  {
+    assert(qTime >= m_qCurrentTime);
+    ++m_qJumpCount;  m_qJumpTime += qTime - m_qCurrentTime;
+    m_qCurrentTime = qTime;  return m_qCurrentTime;
+  }
   // Return the time of the next event scheduled ...
   uint64_t NextEvent() const {return m_qNextEvent;}
+  // Return the time of the next event or the time limit, whichever is first ...
+  uint64_t NextStop() const
+    {return ((m_qNextEvent == 0) || (m_qNextEvent > m_qTimeLimit)) ? ((m_qTimeLimit == UINT64_MAX) ? 0 : m_qTimeLimit) : m_qNextEvent;}
   //   Note that the only way to reset the simulated time to zero is by
   // calling the Clear() method, which will clear the entire event queue ...
 
+  // CPU horizon methods ...
+public:
+  // Return TRUE if the CPU needs to process events, interrupts, etc ...
+  inline bool AtHorizon() const {return m_qCurrentTime >= m_qHorizon;}
+  // Force the CPU to check again before the next instruction ...
+  inline void InvalidateHorizon() {m_qHorizon = 0;}
+  // Push the horizon out to the time of the next scheduled event ...
+  inline void ResetHorizon()
+  {
+    m_qHorizon = ((m_qNextEvent == 0) || (m_qNextEvent > m_qTimeLimit)) ? m_qTimeLimit : m_qNextEvent;
+    if ((m_nSpeed != 0) && (m_qHorizon - m_qCurrentTime > PACE_SLICE)) m_qHorizon = m_qCurrentTime + PACE_SLICE;
+  }
+
+  //   Time limit methods.  Note that the time limit is an absolute simulated
+  // time and it's NOT cleared by ClearEvents(), so a limit set before a RUN
+  // command counts from the reset.  Zero means no limit at all ...
+public:
+  void SetTimeLimit (uint64_t qLimit)
+    {m_qTimeLimit = (qLimit == 0) ? UINT64_MAX : qLimit;  InvalidateHorizon();}
+  uint64_t GetTimeLimit() const {return (m_qTimeLimit == UINT64_MAX) ? 0 : m_qTimeLimit;}
+  inline bool IsTimeLimit() const {return m_qCurrentTime >= m_qTimeLimit;}
+
+  // Return the total number of events executed (for benchmarks) ...
+public:
+  uint64_t GetEventCount() const {return m_qEventCount;}
+
+  //   Real time pacing.  The speed is a multiple of real time, so 1 is real
+  // time and 0 (the default) means no pacing at all - just run as fast as we
+  // can.  If the simulation falls more than PACE_SLIP behind the host clock,
+  // which is what happens when it's stopped at the command prompt, then we
+  // just start counting again rather than trying to catch up.
+public:
+  enum {
+    PACE_SLICE    = 10000000,   // longest simulated time between Pace() calls
+    PACE_SLIP     = 250000000,  // restart pacing if we're this far behind
+    PACE_MINSLEEP = 2,          // don't bother sleeping for less (ms)
+    PACE_MAXSLEEP = 100,        // never sleep for more than this at once (ms)
+  };
+  void SetSpeed (uint32_t nSpeed)
+    {m_nSpeed = nSpeed;  m_fPaceRestart = true;  InvalidateHorizon();}
+  uint32_t GetSpeed() const {return m_nSpeed;}
+  inline bool IsPaced() const {return m_nSpeed != 0;}
+  void Pace();
+  // Return the total host time spent sleeping (for statistics) ...
+  uint64_t GetSleepTime() const {return m_qSleepTime;}
+
+  //   Statistics.  The queue counts the number of DoEvents() calls that
+  // actually executed something, the number of times the CPU skipped ahead
+  // with JumpAhead() and the total time skipped, and for every handler the
+  // number of events scheduled, cancelled and executed.  Handlers are listed
+  // by name in the order they first scheduled an event on THIS queue, and the
+  // list never forgets one - that way it's safe even after the handler is
+  // deleted.  A handler that's used by several queues has a separate entry
+  // in each one.
+public:
+  struct HANDLER_STATISTICS {
+    string   sName;             // EventName() of this handler
+    uint64_t qScheduled;        // number of events scheduled
+    uint64_t qCancelled;        //   "     "    "    cancelled
+    uint64_t qExecuted;         //   "     "    "    executed
+  };
+  uint64_t GetDispatchCount() const {return m_qDispatchCount;}
+  uint64_t GetJumpCount() const {return m_qJumpCount;}
+  uint64_t GetJumpTime() const {return m_qJumpTime;}
+  const vector<HANDLER_STATISTICS> &GetHandlerStatistics() const {return m_Statistics;}
+  void ClearStatistics();
+
   // Event queue methods ...
 public:
   // Clear the event queue and all pending events ...
@@ -112,11 +255,84 @@ public:
   bool IsPending (const CEventHandler *pHandler, intptr_t lParam) const;
   // Process all current events ...
   void DoEvents();
+  //   Save or load the current time and all pending events.  This must be
+  // the last thing in a state file, after all the event handlers!
+  void SyncState (CStateFile &State);
+
+  //   Queues with no more than this many events are kept in a sorted list
+  // rather than the heap (see EventQueue.cpp) ...
+private:
+  enum {SMALL_QUEUE = 16};
+
+  // Private heap methods ...
+private:
+  // Allocate an event block, from the free list if possible ...
+  EVENT *NewEvent();
+  // Add a new, filled in, event to the heap and its handler ...
+  void Insert (EVENT *pEvent);
+  // Add or remove an event from its handler's pending list ...
+  static void LinkHandler (EVENT *pEvent);
+  static void UnlinkHandler (EVENT *pEvent);
+  // Cancel every event for a handler that's being deleted ...
+  friend class CEventHandler;
+  void CancelHandler (CEventHandler *pHandler);
+  // Return the statistics entry for a handler, creating one if necessary ...
+  inline HANDLER_STATISTICS &Statistics (CEventHandler *pHandler)
+  {
+    return (pHandler->m_pStatistics == this)
+      ? m_Statistics[pHandler->m_nStatistics] : FindStatistics(pHandler);
+  }
+  HANDLER_STATISTICS &FindStatistics (CEventHandler *pHandler);
+  // Forget about a handler that's being deleted (but keep its counts!) ...
+  void ForgetHandler (CEventHandler *pHandler);
+  // Return TRUE if event A should happen before event B ...
+  static inline bool IsBefore (const EVENT *pA, const EVENT *pB)
+    {return (pA->qTime < pB->qTime) || ((pA->qTime == pB->qTime) && (pA->qSequence < pB->qSequence));}
+  // Move an event up or down the heap until it's in the right place ...
+  void SiftUp (size_t n);
+  void SiftDown (size_t n);
+  // Move all the events from the sorted list to the heap, or vice versa ...
+  void MakeHeap();
+  void MakeList();
+  // Return the next event, or NULL if the queue is empty ...
+  inline EVENT *Soonest() const
+    {return m_fList ? m_pList : (m_Heap.empty() ? NULL : m_Heap[0]);}
+  // Remove an event from the heap and its handler (but don't free it!) ...
+  void Unlink (EVENT *pEvent);
+  // Remove an event, which follows pPrevious, from the small queue list ...
+  inline void UnlinkList (EVENT *pEvent, EVENT *pPrevious)
+  {
+    if (pPrevious == NULL) m_pList = pEvent->pListNext;  else pPrevious->pListNext = pEvent->pListNext;
+    --m_nList;  --pEvent->pHandler->m_nPending;
+  }
+  // Return an event block to the free list ...
+  inline void FreeEvent (EVENT *pEvent)
+    {pEvent->pNext = m_pFreeEvents;  m_pFreeEvents = pEvent;}
+  // Update m_qNextEvent after the queue changes ...
+  inline void UpdateNextEvent()
+    {EVENT *pEvent = Soonest();  m_qNextEvent = (pEvent == NULL) ? 0 : pEvent->qTime;}
 
   // CEventQueue members ...
 private:
   uint64_t  m_qCurrentTime; // current simulation virtual time
   uint64_t  m_qNextEvent;   // time of the next scheduled event
-  EVENT    *m_pNextEvent;   // root of the event queue and the next event
+  uint64_t  m_qHorizon;     // time when the CPU must next check events
+  uint64_t  m_qSequence;    // sequence number for the next event scheduled
+  uint64_t  m_qTimeLimit;   // stop the CPU at this time (UINT64_MAX for none)
+  uint64_t  m_qEventCount;  // total number of events executed
+  uint64_t  m_qDispatchCount; // DoEvents() calls that executed anything
+  uint64_t  m_qJumpCount;   // number of JumpAhead() calls
+  uint64_t  m_qJumpTime;    // total time skipped by JumpAhead()
+  uint32_t  m_nSpeed;       // pacing speed (multiple of real time, 0 for none)
+  bool      m_fPaceRestart; // start pacing again from the current time
+  uint64_t  m_qPaceHost;    // host time when pacing (re)started
+  uint64_t  m_qPaceTime;    // simulated  "    "     "      "
+  uint64_t  m_qSleepTime;   // total host time spent sleeping
+  vector<HANDLER_STATISTICS> m_Statistics; // per handler statistics
+  unordered_map<const CEventHandler *, size_t> m_mapStatistics; // handler -> m_Statistics index
+  bool      m_fList;        // TRUE if the events are on m_pList, not m_Heap
+  EVENT    *m_pList;        // sorted list of events, soonest first
+  size_t    m_nList;        // number of events on m_pList
+  vector<EVENT *> m_Heap;   // binary heap of events, soonest first
   EVENT    *m_pFreeEvents;  // list of free event blocks for re-use
 };
@@ -115,6 +115,7 @@
 // 19-FEB-25  RLA   Invalid commands (e.g. $00) never clear the BUSY bit!
 // 16-APR-25  RLA   READY should be set during data transfers!
 //                  Fill in some more IDENTIFY DEVICE geometry information.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -132,6 +133,7 @@
 #include "EventQueue.hpp"       // CEventQueue declarations
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "IDE.hpp"              // declarations for this module
 
 
@@ -828,3 +830,32 @@ void CIDE::ShowDevice (ostringstream &ofs) const
   ofs << std::endl;
   ofs << DumpBuffer("SECTOR BUFFER", m_abBuffer, SECTOR_SIZE);
 }
+
+void CIDE::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the IDE registers, the sector buffer and the names of the
+  // attached image files.  When loading, if a drive isn't attached to the same
+  // file that it was when the state was saved, then we reattach it.  Note that
+  // the image file contents are NOT part of the state - the file had better
+  // not have changed in the mean time!
+  //--
+  for (uint8_t nUnit = 0;  nUnit < NDRIVES;  ++nUnit) {
+    string sFileName = GetFileName(nUnit);
+    uint32_t lCapacity = IsAttached(nUnit) ? GetCapacity(nUnit) : 0;
+    State.Sync(sFileName);  State.Sync(lCapacity);
+    if (State.IsLoading() && State.IsOK() && (sFileName != GetFileName(nUnit))) {
+      Detach(nUnit);
+      if (!sFileName.empty() && !Attach(nUnit, sFileName, lCapacity))
+        State.Error(FormatString("%s unit %d unable to attach %s", GetName(), nUnit, sFileName.c_str()));
+    }
+  }
+  State.Sync(m_bFeatures);  State.Sync(m_bCount);  State.Sync(m_abLBA);
+  State.Sync(m_bLastCommand);  State.Sync(m_nSelectedUnit);
+  State.Sync(m_llLongDelay);  State.Sync(m_llShortDelay);
+  State.Sync(m_cbTransfer);  State.Sync(m_fReadTransfer);  State.Sync(m_fBufferOnly);
+  State.Sync(m_abStatus);  State.Sync(m_abError);
+  State.Sync(m_afIEN);  State.Sync(m_afIRQ);
+  State.Sync(m_af8BitMode);  State.Sync(m_afForce8Bit);
+  State.SyncBytes(m_abBuffer, sizeof(m_abBuffer));
+}
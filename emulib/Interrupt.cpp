@@ -60,6 +60,8 @@
 // REVISION HISTORY:
 // 12-AUG-19  RLA   New file.
 // 22-JUN-22  RLA   Add priority levels.
+// 16-OCT-26  RLA   Add attention words and request bit maps.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -68,6 +70,7 @@
 #include <cstring>              // needed for memset()
 #include <assert.h>             // assert() (what else??)
 #include "EMULIB.hpp"           // generic project wide declarations
+#include "StateFile.hpp"        // CStateFile declarations
 #include "Interrupt.hpp"        // declarations for this module
 
 
@@ -77,8 +80,21 @@ CSimpleInterrupt::CSimpleInterrupt (INTERRUPT_MODE nMode)
   //   The parameter determines whether this simple interrupt system operates
   // in level sensitive (fEdgeTriggered=false) or rising edge triggered mode.
   //--
-  m_nMode = nMode;  m_fRequested = false;
+  m_nMode = nMode;  m_lAttention = 0;
   m_lMasksUsed = m_lRequests = 0;
+  m_plParent = NULL;  m_lParentMask = 0;
+}
+
+void CSimpleInterrupt::SetAttention (IRQMASK *plParent, IRQMASK lMask)
+{
+  //++
+  //   Attach this interrupt to bit lMask in the plParent attention word.  From
+  // now on that bit will always be set when we're requesting an interrupt and
+  // cleared when we're not.  This is used by the priority interrupt systems to
+  // keep a bit map of active levels without having to poll every one ...
+  //--
+  m_plParent = plParent;  m_lParentMask = lMask;
+  SetRequested(IsRequested());
 }
 
 CSimpleInterrupt::IRQMASK CSimpleInterrupt::AllocateMask()
@@ -142,13 +158,13 @@ void CSimpleInterrupt::Request (IRQMASK lMask, bool fInterrupt)
   //
   //   But if we're edge triggered then it's harder - we want to look for
   // m_lRequests changing from a zero to a non-zero value, and set the
-  // m_fRequest flag when that happens.  Note that we don't care about the
+  // request flag when that happens.  Note that we don't care about the
   // specific device mask here - ALL devices are wire ORed together and
   // they're all the same as far as the IRQ flip flop is concerned.
   if (m_nMode == EDGE_TRIGGERED) {
-    if ((lOldRequests == 0)  &&  (m_lRequests != 0)) m_fRequested = true;
+    if ((lOldRequests == 0)  &&  (m_lRequests != 0)) SetRequested(true);
   } else
-    m_fRequested = (m_lRequests != 0);
+    SetRequested(m_lRequests != 0);
 }
 
 void CSimpleInterrupt::AcknowledgeRequest()
@@ -163,14 +179,14 @@ void CSimpleInterrupt::AcknowledgeRequest()
   // device does not remove the interrupt request, then the CPU will just
   // continue to interrupt until it does.
   // 
-  //   In edge triggered mode, however, this routine clears the m_fRequested
-  // flag so that the CPU will not continue to interrupt until this flag gets
+  //   In edge triggered mode, however, this routine clears the request flag
+  // so that the CPU will not continue to interrupt until this flag gets
   // set again.  That happens on the rising edge of a request - i.e. when
   // m_lRequests changes from zero to non-zero.  This is all handled in the
   // Request() method.
   //--
   if (m_nMode == EDGE_TRIGGERED) {
-    m_fRequested = false;  m_lRequests = 0;
+    SetRequested(false);  m_lRequests = 0;
   }
 }
 
@@ -178,23 +194,38 @@ void CSimpleInterrupt::ClearInterrupt()
 {
   //++
   //   This routine is a reset of the interrupt system - it will clear the
-  // m_fRequested flag AND ALL CURRENT DEVICE INTERRUPT REQUESTS.  It does
+  // request flag AND ALL CURRENT DEVICE INTERRUPT REQUESTS.  It does
   // NOT deallocate any assigned masks, however - those are still valid.
   //--
-  m_lRequests = 0;  m_fRequested = false;
+  m_lRequests = 0;  SetRequested(false);
+}
+
+void CSimpleInterrupt::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the device requests and our own request flag, which for
+  // edge triggered interrupts isn't the same thing.  The masks allocated are
+  // part of the configuration and they don't change.  After loading we have
+  // to update the parent's attention word too.
+  //--
+  State.Sync(m_nMode);  State.Sync(m_lRequests);  State.Sync(m_lAttention);
+  if (State.IsLoading()) SetRequested(m_lAttention != 0);
 }
 
 
 CPriorityInterrupt::CPriorityInterrupt (IRQLEVEL nLevels, CSimpleInterrupt::INTERRUPT_MODE nMode)
 {
   //++
-  // Allocate a CSimpleInterrupt object for each level ...
+  //   Allocate a CSimpleInterrupt object for each level, and attach each one
+  // to the corresponding bit in our request bit map ...
   //--
   assert(nLevels <= MAXLEVEL);
-  m_nLevels = nLevels;
+  m_nLevels = nLevels;  m_lRequests = 0;
   memset(&m_pLevel, 0, sizeof(m_pLevel));
-  for (IRQLEVEL i = 0;  i < nLevels; ++i)
+  for (IRQLEVEL i = 0;  i < nLevels; ++i) {
     m_pLevel[i] = DBGNEW CSimpleInterrupt(nMode);
+    m_pLevel[i]->SetAttention(&m_lRequests, 1UL << i);
+  }
 }
 
 CPriorityInterrupt::~CPriorityInterrupt()
@@ -207,25 +238,21 @@ CPriorityInterrupt::~CPriorityInterrupt()
   memset(&m_pLevel, 0, sizeof(m_pLevel));
 }
 
-CPriorityInterrupt::IRQVECTOR CPriorityInterrupt::GetRequests() const
+void CPriorityInterrupt::ClearInterrupt()
 {
   //++
-  //   This method returns a bit map of the priority levels with active
-  // interrupt requests, starting with level 1 as bit 0 (the LSB) and
-  // working up to m_nLevels-1.
+  // Clear all interrupts on all levels ...
   //--
-  IRQVECTOR lIRQs = 0;
-  for (IRQLEVEL i = 1;  i <= m_nLevels;  ++i) {
-    if (IsRequestedAtLevel(i)) SETBIT(lIRQs, (1 << (i-1)));
-  }
-  return lIRQs;
+  for (IRQLEVEL i = 0;  i < m_nLevels;  ++i)
+    m_pLevel[i]->ClearInterrupt();
 }
 
-void CPriorityInterrupt::ClearInterrupt()
+void CPriorityInterrupt::SyncState (CStateFile &State)
 {
   //++
-  // Clear all interrupts on all levels ...
+  // Save or load the state of every level ...
   //--
+  State.Verify(m_nLevels, "levels");
   for (IRQLEVEL i = 0;  i < m_nLevels;  ++i)
-    m_pLevel[i]->ClearInterrupt();
+    m_pLevel[i]->SyncState(State);
 }
@@ -35,12 +35,23 @@
 // some implementation specific way) to identify the highest priority interrupt
 // and service interrupts in priority order.
 //
+//   Every CInterrupt also has an "attention" word.  This word is updated by
+// the interrupt system itself whenever any request changes, and it's always
+// zero when no interrupt can possibly be requested.  The CPU can test this one
+// word and skip all the virtual calls and priority resolution nearly all the
+// time.  A CSimpleInterrupt may also be attached to a bit in somebody else's
+// attention word, and that's how CPriorityInterrupt keeps a bit map of all the
+// levels with active requests.
+//
 // REVISION HISTORY:
 // 23-JUN-22  RLA   New file.
+// 16-OCT-26  RLA   Add attention words and request bit maps.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
 #include "EMULIB.hpp"           // generic project wide declarations
+class CStateFile;               // save/load state file
 
 
 class CInterrupt {
@@ -58,6 +69,8 @@ public:
   virtual void AcknowledgeRequest() = 0;
   // Clear all interrupt requests ...
   virtual void ClearInterrupt() = 0;
+  // Return a pointer to our attention word (zero if nothing is requested) ...
+  virtual const uint32_t *GetAttention() const = 0;
 };
 
 
@@ -101,7 +114,7 @@ public:
   // Request (or clear a request) an interrupt ...
   void Request (IRQMASK lMask, bool fInterrupt=true);
   // Return TRUE if any interrupt is requested ...
-  virtual bool IsRequested() const override {return m_fRequested;}
+  virtual bool IsRequested() const override {return m_lAttention != 0;}
   // Return TRUE if an interrupt is requested by the specified device ...
   virtual bool IsRequested (IRQMASK lMask) const {return ISSET(m_lRequests, lMask);}
   // Acknowledge an interrupt request ...
@@ -110,13 +123,31 @@ public:
   virtual void ClearInterrupt() override;
   // Return true if any device is attached to this interrupt ...
   virtual bool IsAttached() const {return m_lMasksUsed != 0;}
-  
+  // Return our attention word (it's non-zero when we're requesting) ...
+  virtual const uint32_t *GetAttention() const override {return &m_lAttention;}
+  // Attach this interrupt to a bit in another attention word ...
+  void SetAttention (IRQMASK *plParent, IRQMASK lMask);
+  // Save or load the current requests in a state file ...
+  void SyncState (CStateFile &State);
+
+  // Private methods ...
+private:
+  // Set or clear our request and update the attention word(s) to match ...
+  inline void SetRequested (bool fRequested)
+  {
+    m_lAttention = fRequested ? 1 : 0;
+    if (m_plParent == NULL) return;
+    if (fRequested) SETBIT(*m_plParent, m_lParentMask);  else CLRBIT(*m_plParent, m_lParentMask);
+  }
+
   // CSimpleInterrupt members ...
 private:
   INTERRUPT_MODE m_nMode;       // level or edge triggered
-  bool           m_fRequested;  // TRUE if an interrupt is requested now!
+  uint32_t       m_lAttention;  // non-zero if an interrupt is requested now!
   IRQMASK        m_lMasksUsed;  // mask of interrupt masks that are used
   IRQMASK        m_lRequests;   // mask of devices requesting interrupt
+  IRQMASK       *m_plParent;    // parent's attention word (or NULL)
+  IRQMASK        m_lParentMask; // our bit in the parent's attention word
 };
 
 
@@ -168,7 +199,7 @@ public:
   bool IsRequestedAtLevel (IRQLEVEL n) const
     {return GetLevel(n)->IsRequested();}
   // Return a bitmap of requests ...
-  IRQVECTOR GetRequests() const;
+  IRQVECTOR GetRequests() const {return (IRQVECTOR) m_lRequests;}
 
   // Interrupt methods ...
 public:
@@ -176,6 +207,8 @@ public:
   virtual void AcknowledgeRequest (IRQLEVEL n) {GetLevel(n)->AcknowledgeRequest();}
   // Clear all interrupt requests on all levels ...
   virtual void ClearInterrupt();
+  // Save or load all levels in a state file ...
+  void SyncState (CStateFile &State);
 
   // Return TRUE if any interrupt is requested at nLevel OR ABOVE ...
 //virtual bool IsRequested (IRQLEVEL nLevel=1) const;
@@ -196,4 +229,8 @@ public:
 private:
   IRQLEVEL          m_nLevels;          // number of levels implemented
   CSimpleInterrupt *m_pLevel[MAXLEVEL]; // simple interrupt for each level
+protected:
+  //   Each level sets or clears its bit in this mask as its request changes.
+  // Level 1 is bit 0, level 2 is bit 1, etc ...
+  CSimpleInterrupt::IRQMASK m_lRequests;// bit map of levels requesting now
 };
@@ -50,6 +50,8 @@
 //  5-JUN-17  RLA   Split from WindowsConsole.cpp
 // 25-DEC-23  RLA   Add keyboard buffer and make IsConsoleBreak() read ahead
 //                  DON'T call RawWrite() from Write() ...
+// 16-OCT-26  RLA   ReadKey() should return -1 on EOF, not assert ...
+// 16-OCT-26  RLA   Add IsInputPending() ...
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -275,8 +277,10 @@ int32_t CConsoleWindow::ReadKey (uint8_t &bData, uint32_t lTimeout)
   select(STDIN_FILENO+1, &rdfs, NULL, NULL, &tmo);
 
   if (FD_ISSET(STDIN_FILENO, &rdfs)) {
+    //   Note that select() says that stdin is readable at EOF too, which
+    // happens when we're running headless with stdin redirected ...
     ssize_t cbRead = read(STDIN_FILENO, &bData, 1);
-    assert(cbRead == 1);
+    if (cbRead != 1) return -1;
     if ((GetSerialBreak() != 0) && (bData == GetSerialBreak())) {
       // Serial break character - simulate a RS232 break condition ...
       m_fSerialBreak = true;  return 0;
@@ -289,6 +293,19 @@ int32_t CConsoleWindow::ReadKey (uint8_t &bData, uint32_t lTimeout)
     return 0;
 }
 
+bool CConsoleWindow::IsInputPending()
+{
+  //++
+  //   Return TRUE if there are any keystrokes waiting that haven't been read
+  // by RawRead() yet.  Like IsConsoleBreak(), this reads ahead and stuffs
+  // anything it finds into the keyboard buffer.  The CPU uses this to decide
+  // whether it's safe to warp ahead thru an idle loop.
+  //--
+  uint8_t bData;
+  while (ReadKey(bData, 0) > 0) m_KeyBuffer.Put(bData);
+  return !m_KeyBuffer.IsEmpty();
+}
+
 bool CConsoleWindow::IsConsoleBreak (uint32_t lTimeout)
 {
   //++
@@ -73,6 +73,15 @@
 // 26-AUG-22  RLA   Clean up Linux/WIN32 conditionals.
 //  5-MAR-24  RLA   Add ClearROM() and change ClearRAM to use IsRAM() ...
 // 24-MAR-25  RLA   Add warning for write to unwritable memory
+// 15-OCT-26  RLA   Add UpdatePages() for the page table fast path
+// 16-OCT-26  RLA   Add CPUreadW() and CPUwriteW()
+//                  Keep track of breakpoints for CheckBreak()
+// 16-OCT-26  RLA   Count slow path memory accesses
+// 16-OCT-26  RLA   Count CPUread() and CPUwrite() by access type
+// 16-OCT-26  RLA   Add SyncState()
+// 16-OCT-26  RLA   Map memory contents copy-on-write when loading state
+// 16-OCT-26  RLA   Make the breakpoint and access counters per memory
+// 16-OCT-26  RLA   Invalidate the CPU horizon on memory mapped I/O
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -90,10 +99,23 @@
 #include "SafeCRT.h"		// replacements for Microsoft "safe" CRT functions
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "MemoryTypes.h"        // address_t and word_t data types
+#include "StateFile.hpp"        // CStateFile declarations
 #include "Memory.hpp"           // declarations for this module
+#include "CPU.hpp"              // CCPU::InvalidateHorizon()
 using std::string;              // too lazy to type "std::string..."!
 
 
+void CMemory::ClearStatistics()
+{
+  //++
+  //   Reset the slow path and access type counters for this memory.  These
+  // are only statistics, and the simulation doesn't care what they are ...
+  //--
+  m_qSlowAccesses = 0;
+  memset(m_aqReads, 0, sizeof(m_aqReads));  memset(m_aqWrites, 0, sizeof(m_aqWrites));
+}
+
+
 CGenericMemory::CGenericMemory (size_t cwMemory, address_t cwBase, uint8_t bFlags)
 {
   //++
@@ -101,18 +123,24 @@ CGenericMemory::CGenericMemory (size_t cwMemory, address_t cwBase, uint8_t bFlag
   //--
   assert(cwMemory > 0);
   m_cwMemory = cwMemory;  m_cwBase = cwBase;
-  m_pawMemory = DBGNEW word_t[m_cwMemory];
-  m_pabFlags = DBGNEW uint8_t[m_cwMemory];
+  m_pawMemory = DBGNEW word_t[m_cwMemory];  m_fMapped = false;  m_pCPU = NULL;
+  m_pabFlags = DBGNEW uint8_t[m_cwMemory]();
   ClearFlags(bFlags);  ClearMemory();
 }
 
 CGenericMemory:: ~CGenericMemory()
 {
   //++
-  // Delete the memory array ...
+  //   Delete the memory array, or unmap it if it came from a state file.
+  // Note that we don't bother to take our breakpoints away from the mapper,
+  // if any - it may already be gone, and either way so is this machine.
   //--
   assert((m_pawMemory != NULL)  &&  (m_pabFlags != NULL));
-  delete[] m_pawMemory;  delete[] m_pabFlags;
+  if (m_fMapped)
+    CStateFile::UnmapBytes(m_pawMemory, ByteSize());
+  else
+    delete[] m_pawMemory;
+  delete[] m_pabFlags;
   m_cwMemory = m_cwBase = 0;  m_pawMemory = NULL;  m_pabFlags = NULL;
 }
 
@@ -126,10 +154,18 @@ word_t CGenericMemory::CPUread (address_t a) const
   //   Note that this routine gets called by the CPU emulation for EVERY BYTE
   // READ from main memory!  That's a lot of calls, and it's a testament to the
   // speed of modern PCs that we can get away with this.
+  //
+  //   Reading a device may have side effects (e.g. clearing an interrupt
+  // request) so any I/O access invalidates the CPU's event horizon.  Word
+  // accesses to I/O devices always end up here or in CPUwrite(), so they're
+  // covered too.
   //--
   assert(IsValid(a));
-  if (IsIO(a))
+  CountRead(GetAccessType(a));
+  if (IsIO(a)) {
+    if (m_pCPU != NULL) m_pCPU->InvalidateHorizon();
     return m_Devices.DevRead(a);
+  }
   else if (IsReadable(a))
     return MemRead(a);
   else
@@ -145,22 +181,113 @@ void CGenericMemory::CPUwrite (address_t a, word_t d)
   // do nothing.
   //--
   assert(IsValid(a));
-  if (IsIO(a))
+  CountWrite(GetAccessType(a));
+  if (IsIO(a)) {
+    if (m_pCPU != NULL) m_pCPU->InvalidateHorizon();
     m_Devices.DevWrite(a, d);
-  else if (IsWritable(a))
+  } else if (IsWritable(a))
     MemWrite(a, d);
   else
     LOGF(WARNING, "write to un-writable memory at 0x%04x", a);
 }
 
+uint16_t CGenericMemory::CPUreadW (address_t a) const
+{
+  //++
+  //   Read a 16 bit, little endian, word for the CPU.  If both bytes are
+  // plain memory, which is nearly always, then we can read them both with
+  // only one address check.  Otherwise let CPUread() sort it out ...
+  //--
+  a &= ~1;
+  assert(IsValid(a) && IsValid(a|1));
+  if (IsReadable(a) && IsReadable(a|1) && !IsIO(a) && !IsIO(a|1)) {
+    CountRead(GetAccessType(a));  return MKWORD(MemRead(a|1), MemRead(a));
+  }
+  return CMemory::CPUreadW(a);
+}
+
+void CGenericMemory::CPUwriteW (address_t a, uint16_t w)
+{
+  //++
+  // The same as CPUreadW(), but for writing ...
+  //--
+  a &= ~1;
+  assert(IsValid(a) && IsValid(a|1));
+  if (IsWritable(a) && IsWritable(a|1) && !IsIO(a) && !IsIO(a|1)) {
+    CountWrite(GetAccessType(a));  MemWrite(a, LOBYTE(w));  MemWrite(a|1, HIBYTE(w));
+  } else
+    CMemory::CPUwriteW(a, w);
+}
+
+void CGenericMemory::ClearFlags (uint8_t bFlags)
+{
+  //++
+  //   Set the flags for every location in memory to the same value.  This is
+  // pretty simple, except that we have to keep the breakpoint count right!
+  //--
+  assert(m_pabFlags != NULL);
+  ptrdiff_t nBreaks = 0;
+  for (size_t i = Base();  i <= Top();  ++i)
+    if (IsBreak(ADDRESS(i))) --nBreaks;
+  memset(m_pabFlags, bFlags, m_cwMemory);
+  if (ISSET(bFlags, MEM_BREAK)) nBreaks += m_cwMemory;
+  AddBreaks(nBreaks);
+  UpdatePages();
+}
+
 void CGenericMemory::SetFlags (address_t nFirst, address_t nLast, uint8_t bSet, uint8_t bClear)
 {
   //++
-  // Set or clear the flag bits for a whole range of addresses ...
+  //   Set or clear the flag bits for a whole range of addresses.  Note that
+  // this updates the flags directly and then rebuilds the page table just
+  // once at the end, rather than once for every location ...
   //--
   assert(IsValid(nFirst, nLast));
   for (size_t i = nFirst;  i <= nLast;  ++i)
-    SetFlags(ADDRESS(i), bSet, bClear);
+    SetFlags(ADDRESS(i), (GetFlags(ADDRESS(i)) & ~bClear) | bSet);
+  UpdatePages(nFirst, nLast);
+}
+
+void CGenericMemory::UpdatePages (address_t nFirst, address_t nLast)
+{
+  //++
+  //   Rebuild the page table entries for every page that contains any of
+  // the addresses from nFirst to nLast.  A page can be read directly only if
+  // every location in it is readable, and likewise it can be written directly
+  // only if every location is writable.  Any page that contains even one I/O
+  // device or breakpoint, or that isn't entirely contained in this memory,
+  // always uses the slow path.  We also set the breakpoint bit for any page
+  // that contains a breakpoint.
+  //
+  //   If some memory mapping object has cached our page table entries, then
+  // its page table needs to be rebuilt too.  We don't know how it maps our
+  // addresses, so it just has to do all of them.
+  //--
+  for (size_t nPage = PAGE(nFirst);  nPage <= PAGE(nLast);  ++nPage) {
+    address_t a = ADDRESS(nPage << PAGE_SHIFT);
+    word_t *pRead = NULL, *pWrite = NULL;  bool fBreak = false;
+    if (IsValid(a, ADDRESS(a+PAGE_MASK))) {
+      //   bAll is the flags that are set for EVERY location in the page, and
+      // bAny is the flags that are set for at least one location ...
+      uint8_t bAll = MEM_FLAGS, bAny = 0;
+      for (address_t i = 0;  i < PAGE_SIZE;  ++i) {
+        uint8_t bFlags = GetFlags(ADDRESS(a+i));
+        bAll &= bFlags;  bAny |= bFlags;
+      }
+      fBreak = ISSET(bAny, MEM_BREAK);
+      if ((bAny & (MEM_IO|MEM_BREAK)) == 0) {
+        if (ISSET(bAll, MEM_READ))  pRead  = &m_pawMemory[a-m_cwBase];
+        if (ISSET(bAll, MEM_WRITE)) pWrite = &m_pawMemory[a-m_cwBase];
+      }
+    } else {
+      //   A page that's only partly in this memory could still have a
+      // breakpoint, so play it safe ...
+      for (size_t i = a;  i <= (size_t) (a+PAGE_MASK);  ++i)
+        if (IsValid(ADDRESS(i)) && ISSET(GetFlags(ADDRESS(i)), MEM_BREAK)) fBreak = true;
+    }
+    SetPage(nPage, pRead, pWrite);  SetBreakPage(nPage, fBreak);
+  }
+  if (m_pMapper != NULL) m_pMapper->UpdatePages();
 }
 
 size_t CGenericMemory::CountFlags (address_t nFirst) const
@@ -204,7 +331,44 @@ void CGenericMemory::ClearAllBreaks()
   // Clear all address break flags everywhere...
   //--
   for (size_t i = Base();  i <= Top();  ++i)
-    if (IsBreak(ADDRESS(i))) SetBreak(ADDRESS(i), false);
+    if (IsBreak(ADDRESS(i))) SetFlags(ADDRESS(i), GetFlags(ADDRESS(i)) & ~MEM_BREAK);
+  UpdatePages(Base(), Top());
+}
+
+void CGenericMemory::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the contents and the flags for every location.  The size
+  // and base address must match, of course.  Breakpoints belong to the user
+  // and not to the machine, so they're not saved and loading a state file
+  // leaves all the current breakpoints alone.
+  //
+  //   Byte wide memories are saved as a single aligned block, and when we're
+  // loading that block is usually mapped copy-on-write directly from the state
+  // file.  In that case the old memory array is freed and the mapping replaces
+  // it.  Nothing is actually read until it's touched, pages that are never
+  // written (e.g. ROM) are shared with every other emulator that loaded the
+  // same file, and RAM pages are only copied when they're written.  The page
+  // tables all point to the old array, so UpdatePages() is essential here!
+  //--
+  State.Verify(m_cwMemory, "size");  State.Verify(m_cwBase, "base");
+  if (sizeof(word_t) == 1) {
+    word_t *pawMemory = (word_t *) State.SyncMapped(m_pawMemory, ByteSize());
+    if (pawMemory != m_pawMemory) {
+      if (m_fMapped)
+        CStateFile::UnmapBytes(m_pawMemory, ByteSize());
+      else
+        delete[] m_pawMemory;
+      m_pawMemory = pawMemory;  m_fMapped = true;
+    }
+  } else
+    for (size_t i = 0;  i < m_cwMemory;  ++i) State.Sync(m_pawMemory[i]);
+  for (size_t i = 0;  i < m_cwMemory;  ++i) {
+    uint8_t bFlags = m_pabFlags[i] & ~MEM_BREAK;  State.Sync(bFlags);
+    if (State.IsLoading() && State.IsOK())
+      SetFlags(ADDRESS(m_cwBase+i), bFlags | (m_pabFlags[i] & MEM_BREAK));
+  }
+  if (State.IsLoading()) UpdatePages(Base(), Top());
 }
 
 bool CGenericMemory::FindBreak (address_t &nAddr) const
@@ -45,12 +45,65 @@
 // virtual memory map via some mapping hardware, and it's assumed that the UI deals
 // with the actual physical implementation directly.
 //
+// PAGE TABLE
+//   Every CMemory object also keeps a small page table, with one entry per
+// 256 word page of the address space, that holds a direct pointer to the data
+// for that page, or NULL if the page needs special handling.  The FastRead()
+// and FastWrite() methods use this table to access plain RAM and ROM with a
+// single load and index, and fall back to the virtual CPUread()/CPUwrite()
+// methods for anything else (I/O devices, breakpoints, non-existent memory,
+// etc).  It's up to each CMemory implementation to fill in the table, via the
+// UpdatePages() method, whenever its memory map changes.  The default is to
+// leave all pages empty, and then everything takes the slow path.
+//
+//   Memory mapping objects (e.g. the SBC1802 or SBCT11 CMemoryMap) cache the
+// page pointers of the CGenericMemory objects they map, so a CGenericMemory
+// can be told about its "mapper" with SetMapper().  Any change to the memory
+// flags will then update the mapper's page table as well.
+//
+//   Every change to the page table also bumps a version number, which lets
+// the CPU's predecoded instruction cache notice when the memory map changes.
+//
+// BREAKPOINTS
+//   Breakpoints are kept in the MEM_BREAK flag of the physical memory (e.g.
+// RAM or EPROM) and not by CPU address, because a memory mapper may move that
+// physical memory around in the CPU's address space.  Checking for a break on
+// every instruction with the virtual IsBreak() is expensive though, so each
+// memory also keeps a count of the breakpoints set in it (a mapper counts all
+// the breakpoints in the memories it maps, too), plus a bitmap in the page
+// table of the pages that contain one.  CheckBreak() skips the whole thing
+// when no breakpoints are set and otherwise tests one bit, and it only calls
+// IsBreak() for pages that actually have a breakpoint.
+//
+//   All of these counters, and the access statistics, belong to the memory
+// object and not to the class, so two emulated machines in the same process
+// don't share them.
+//
+// WORD ACCESS
+//   Byte addressed CPUs with a 16 bit bus (i.e. the DCT11) can use CPUreadW()
+// and CPUwriteW(), or FastReadW() and FastWriteW(), to transfer a whole little
+// endian word with one call.  The word always starts on an even address - the
+// LSB of the address is ignored.  The default CPUreadW() and CPUwriteW() just
+// do two byte operations, low byte first, but memory implementations can
+// override them to decode the address only once.
+//
 // REVISION HISTORY:
 // 24-Jul-19  RLA   New file.
 // 21-JAN-20  RLA   Remove singleton assumptions.
 // 16-JUN-22  RLA   Split up CMemory interface and CGenericMemory implementation
 // 17-JUN-22  RLA   Add base/offset feature
 // 24-MAR-25  RLA   Add IsReadable() and IsWritable()
+// 15-OCT-26  RLA   Add page table and FastRead()/FastWrite()
+// 16-OCT-26  RLA   Make IsIO() a required method
+//                  Add breakpoint count, page bitmap and CheckBreak()
+//                  Add CPUreadW(), CPUwriteW(), FastReadW() and FastWriteW()
+// 16-OCT-26  RLA   Add GetPageVersion()
+// 16-OCT-26  RLA   Count slow path accesses
+// 16-OCT-26  RLA   Count CPUread() and CPUwrite() by access type
+// 16-OCT-26  RLA   Add SyncState()
+// 16-OCT-26  RLA   Map memory contents copy-on-write when loading state
+// 16-OCT-26  RLA   Make the breakpoint and access counters per memory
+// 16-OCT-26  RLA   Invalidate the CPU horizon on memory mapped I/O
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -59,6 +112,7 @@
 #include "MemoryTypes.h"        // address_t and word_t data types
 #include "DeviceMap.hpp"        // CDeviceMap class for I/O mapping
 using std::string;              // ...
+class CStateFile;               // save/load state file
 
 // Standard extensions for Intel hex and raw binary files ...
 #define DEFAULT_INTEL_FILE_TYPE     ".hex"
@@ -88,9 +142,17 @@ public:
     MEM_IORW  = MEM_IO|MEM_READ|MEM_WRITE,  // R/W I/O location
     MEM_IORO  = MEM_IO|MEM_READ,            // R/O  "     "
     MEM_IOWO  = MEM_IO|MEM_WRITE,           // W/O  "     "
+    // Page table parameters ...
+    PAGE_SHIFT = 8,                         // log2(words per page)
+    PAGE_SIZE  = 1 << PAGE_SHIFT,           // words per page
+    PAGE_MASK  = PAGE_SIZE-1,               // offset within a page
+    PAGE_COUNT = (ADDRESS_MASK >> PAGE_SHIFT) + 1,  // pages in address space
   };
 
-  // This is an abstract class - no constructor or destructor here!
+  //   This is an abstract class and the only thing the constructor does is
+  // to initialize the page table so that every page uses the slow path ...
+protected:
+  CMemory() {m_pMapper = NULL;  m_cBreaks = 0;  m_lPageVersion = 0;  ClearPages();  ClearStatistics();}
 
   // CPU memory access functions ...
 public:
@@ -98,9 +160,141 @@ public:
   virtual void CPUwrite (address_t a, word_t d) = 0;
   virtual bool IsBreak (address_t a) const = 0;
   virtual bool IsSlow (address_t a) const = 0;
-//virtual bool IsIO (address_t a) const = 0;
+  virtual bool IsIO (address_t a) const = 0;
 //virtual bool IsReadable (address_t a) const = 0;
 //virtual bool IsWritable (address_t a) const = 0;
+
+  //   These are the same as CPUread() and CPUwrite(), except that they use
+  // the page table to access plain RAM and ROM directly.  The CPU emulations
+  // should use these for all ordinary memory references ...
+public:
+  inline word_t FastRead (address_t a) const
+  {
+    const word_t *pPage = m_apReadPages[a >> PAGE_SHIFT];
+    if (pPage != NULL) return pPage[a & PAGE_MASK];
+    CountSlow();  return CPUread(a);
+  }
+  inline void FastWrite (address_t a, word_t d)
+  {
+    word_t *pPage = m_apWritePages[a >> PAGE_SHIFT];
+    if (pPage != NULL) pPage[a & PAGE_MASK] = d;  else {CountSlow();  CPUwrite(a, d);}
+  }
+
+  //   Read or write a 16 bit, little endian, word.  Note that both bytes of
+  // a word are always in the same page!
+public:
+  virtual uint16_t CPUreadW (address_t a) const
+    {word_t l = CPUread(a & ~1);  word_t h = CPUread(a | 1);  return MKWORD(h, l);}
+  virtual void CPUwriteW (address_t a, uint16_t w)
+    {CPUwrite(a & ~1, LOBYTE(w));  CPUwrite(a | 1, HIBYTE(w));}
+  inline uint16_t FastReadW (address_t a) const
+  {
+    const word_t *pPage = m_apReadPages[a >> PAGE_SHIFT];
+    if (pPage == NULL) {CountSlow();  return CPUreadW(a);}
+    a &= PAGE_MASK & ~1;
+    return MKWORD(pPage[a+1], pPage[a]);
+  }
+  inline void FastWriteW (address_t a, uint16_t w)
+  {
+    word_t *pPage = m_apWritePages[a >> PAGE_SHIFT];
+    if (pPage == NULL) {CountSlow();  CPUwriteW(a, w);  return;}
+    a &= PAGE_MASK & ~1;
+    pPage[a] = LOBYTE(w);  pPage[a+1] = HIBYTE(w);
+  }
+
+  //   Return the number of FastRead() and FastWrite() calls on this memory
+  // that had to take the slow path thru CPUread() or CPUwrite() ...
+public:
+  inline uint64_t GetSlowAccesses() const {return m_qSlowAccesses;}
+
+  //   CPUread() and CPUwrite() also count every access according to what's at
+  // that address.  Note that this doesn't include any access that's handled by
+  // the page table fast path!  A memory that has a mapper gives its counts to
+  // the mapper instead, so that all the accesses made by one CPU add up in the
+  // one memory that CPU actually uses.
+public:
+  enum ACCESS_TYPE {ACCESS_RAM, ACCESS_ROM, ACCESS_IO, ACCESS_NXM, ACCESS_TYPES};
+  inline uint64_t GetReadCount (ACCESS_TYPE t) const {return m_aqReads[t];}
+  inline uint64_t GetWriteCount (ACCESS_TYPE t) const {return m_aqWrites[t];}
+  void ClearStatistics();
+protected:
+  inline void CountSlow() const {++Counter()->m_qSlowAccesses;}
+  inline void CountRead (ACCESS_TYPE t) const {++Counter()->m_aqReads[t];}
+  inline void CountWrite (ACCESS_TYPE t) const {++Counter()->m_aqWrites[t];}
+  inline const CMemory *Counter() const {return (m_pMapper != NULL) ? m_pMapper : this;}
+
+  // Breakpoint shortcuts ...
+public:
+  //   Return TRUE if any breakpoint is set in this memory, or in any memory
+  // that's mapped thru this one ...
+  inline bool AnyBreaks() const {return m_cBreaks != 0;}
+  // Return TRUE if any location in this page MIGHT have a breakpoint ...
+  inline bool IsBreakPage (address_t a) const
+    {return ISSET(m_alBreakPages[PAGE(a) >> 5], 1UL << (PAGE(a) & 31));}
+  //   And this is what the CPU should call on every instruction to see if
+  // there's a breakpoint at the PC ...
+  inline bool CheckBreak (address_t a) const
+    {return AnyBreaks() && IsBreakPage(a) && IsBreak(a);}
+
+  // Page table management ...
+public:
+  //   Rebuild the page table entries for the specified range of addresses.
+  // The default here is for every page to take the slow path and for every
+  // page to (possibly) contain a breakpoint ...
+  virtual void UpdatePages (address_t nFirst=0, address_t nLast=ADDRESS_MAX)
+    {for (size_t n = PAGE(nFirst);  n <= PAGE(nLast);  ++n) {SetPage(n, NULL, NULL);  SetBreakPage(n, true);}}
+  //   Set the memory mapping object that caches our pages.  The mapper also
+  // needs to know about any breakpoints we already have ...
+  void SetMapper (CMemory *pMapper)
+    {m_pMapper = pMapper;  if (m_pMapper != NULL) m_pMapper->AddBreaks(m_cBreaks);}
+  // Return the page table entries (if any) for the specified address ...
+  inline word_t *GetReadPage (address_t a) const {return m_apReadPages[PAGE(a)];}
+  inline word_t *GetWritePage (address_t a) const {return m_apWritePages[PAGE(a)];}
+  // Return a number that changes whenever the page table does ...
+  inline uint32_t GetPageVersion() const {return m_lPageVersion;}
+protected:
+  // Convert an address to a page number ...
+  static inline size_t PAGE (address_t a) {return (a & ADDRESS_MASK) >> PAGE_SHIFT;}
+  // Set or clear the table entries for one page ...
+  inline void SetPage (size_t nPage, word_t *pRead, word_t *pWrite)
+  {
+    assert(nPage < PAGE_COUNT);  ++m_lPageVersion;
+    m_apReadPages[nPage] = pRead;  m_apWritePages[nPage] = pWrite;
+  }
+  //   Change the number of breakpoints set in this memory, and in our mapper
+  // if there is one ...
+  void AddBreaks (ptrdiff_t nBreaks)
+  {
+    assert((ptrdiff_t) m_cBreaks + nBreaks >= 0);  m_cBreaks += nBreaks;
+    if (m_pMapper != NULL) m_pMapper->AddBreaks(nBreaks);
+  }
+  // Set or clear the breakpoint bit for one page ...
+  inline void SetBreakPage (size_t nPage, bool fBreak)
+  {
+    assert(nPage < PAGE_COUNT);
+    if (fBreak) SETBIT(m_alBreakPages[nPage >> 5], 1UL << (nPage & 31));
+    else        CLRBIT(m_alBreakPages[nPage >> 5], 1UL << (nPage & 31));
+  }
+  //   Clear the entire page table.  Note that every page is assumed to have a
+  // breakpoint until UpdatePages() says otherwise ...
+  void ClearPages()
+  {
+    memset(m_apReadPages, 0, sizeof(m_apReadPages));  memset(m_apWritePages, 0, sizeof(m_apWritePages));
+    memset(m_alBreakPages, 0xFF, sizeof(m_alBreakPages));  ++m_lPageVersion;
+  }
+
+  // Page table members ...
+protected:
+  CMemory    *m_pMapper;                    // mapper that caches our pages
+  size_t      m_cBreaks;                    // breakpoints set in this memory
+  mutable uint64_t m_qSlowAccesses;         // slow path accesses in this memory
+  mutable uint64_t m_aqReads[ACCESS_TYPES]; // CPUread() calls by access type
+  mutable uint64_t m_aqWrites[ACCESS_TYPES];// CPUwrite()  "    "    "     "
+private:
+  word_t     *m_apReadPages[PAGE_COUNT];    // direct pointers for reading
+  word_t     *m_apWritePages[PAGE_COUNT];   //   "        "     "  writing
+  uint32_t    m_alBreakPages[(PAGE_COUNT+31)/32]; // pages with breakpoints
+  uint32_t    m_lPageVersion;               // incremented by every page change
 };
 
 
@@ -140,13 +334,24 @@ public:
   inline word_t MemRead (address_t a) const {return m_pawMemory[a-m_cwBase];}
   inline void MemWrite (address_t a, word_t d) {m_pawMemory[a-m_cwBase] = d;}
   inline uint8_t GetFlags (address_t a) const {return m_pabFlags[a-m_cwBase];}
-  inline void SetFlags (address_t a, uint8_t f) {m_pabFlags[a-m_cwBase] = f;}
+  //   Note that SetFlags() keeps track of the global breakpoint count.  That's
+  // the only reason it's more complicated than GetFlags()!
+  inline void SetFlags (address_t a, uint8_t f)
+  {
+    uint8_t &b = m_pabFlags[a-m_cwBase];
+    if (ISSET(b ^ f, MEM_BREAK)) AddBreaks(ISSET(f, MEM_BREAK) ? 1 : -1);
+    b = f;
+  }
 
   // Basic memory functions ...
 public:
   // Read or write the location for the CPU ...
   virtual word_t CPUread (address_t a) const override;
   virtual void CPUwrite (address_t a, word_t d) override;
+  virtual uint16_t CPUreadW (address_t a) const override;
+  virtual void CPUwriteW (address_t a, uint16_t w) override;
+  // Rebuild the page table after the memory flags change ...
+  virtual void UpdatePages (address_t nFirst=0, address_t nLast=ADDRESS_MAX) override;
   // Return true if an address break is set at this location ...
   virtual bool IsBreak (address_t a) const override
     {assert(IsValid(a));  return ISSET(GetFlags(a), MEM_BREAK);}
@@ -169,6 +374,14 @@ public:
   // Return true if this address is a memory mapped I/O device ...
   virtual bool IsIO (address_t a) const
     {assert(IsValid(a));  return ISSET(GetFlags(a), MEM_IO);}
+  // Classify this address for the access statistics ...
+  inline ACCESS_TYPE GetAccessType (address_t a) const
+  {
+    uint8_t f = GetFlags(a);
+    if (ISSET(f, MEM_IO)) return ACCESS_IO;
+    if (ISSET(f, MEM_WRITE)) return ACCESS_RAM;
+    return ISSET(f, MEM_READ) ? ACCESS_ROM : ACCESS_NXM;
+  }
   // Return true if this address doesn't exist ...
   virtual bool IsNXM (address_t a) const
     {if (!IsValid(a)) return true;  return (GetFlags(a) == 0);}
@@ -186,11 +399,10 @@ public:
   // Memory mapping functions ...
 public:
   // Clear the flags on all of memory, regardless ...
-  void ClearFlags (uint8_t bFlags=0)
-    {assert(m_pabFlags != NULL);  memset(m_pabFlags, bFlags, m_cwMemory);}
+  void ClearFlags (uint8_t bFlags=0);
   // Set or clear the flags on just one location ...
   inline void SetFlags (address_t a, uint8_t bSet, uint8_t bClear)
-    {assert(IsValid(a));  SetFlags(a, (GetFlags(a) & ~bClear) | bSet);}
+    {assert(IsValid(a));  SetFlags(a, (GetFlags(a) & ~bClear) | bSet);  UpdatePages(a, a);}
   // Set or clear the flags on a range of locations ...
   void SetFlags (address_t nFirst, address_t nLast, uint8_t bSet, uint8_t bClear);
   // Set the specified range to be RAM, ROM, I/O or non-existent ...
@@ -231,6 +443,8 @@ public:
   // Load or save the memory in an Intel format .hex file ...
   virtual int32_t LoadIntel (string sFileName, address_t wBase=0, size_t cbLimit=0, address_t wOffset=0);
   virtual int32_t SaveIntel (string sFileName, address_t wBase=0, size_t cbBytes=0, address_t wOffset=0) const;
+  // Save or load the contents and flags in a state file ...
+  virtual void SyncState (CStateFile &State);
 
     // Device functions for memory mapped I/O ...
 public:
@@ -243,6 +457,9 @@ public:
   virtual CDevice *FindDevice (const string sName) const {return m_Devices.Find(sName);}
   // Clear (simulate a hardware reset) for all devices ...
   virtual void ClearAllDevices() {m_Devices.ClearAll();}
+  //   Set the CPU that owns this memory.  Any memory mapped I/O access forces
+  // that CPU to recheck events and interrupts before its next instruction ...
+  void SetCPU (class CCPU *pCPU) {m_pCPU = pCPU;}
   // Delete all attached I/O devices (including flags and sense!) ...
   virtual void RemoveAllDevices() {m_Devices.RemoveAll();}
 
@@ -262,6 +479,8 @@ private:
   size_t      m_cwMemory;     // size of the memory
   address_t   m_cwBase;       // base address offset
   word_t     *m_pawMemory;    // the actual memory data lives here
+  bool        m_fMapped;      // TRUE if m_pawMemory is mapped from a state file
   uint8_t    *m_pabFlags;     // memory flags - read/write or read only
   CDeviceMap  m_Devices;      // I/O devices for memory mapped I/O
+  class CCPU *m_pCPU;         // CPU to notify of memory mapped I/O (if any)
 };
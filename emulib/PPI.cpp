@@ -130,6 +130,7 @@
 //  2-NOV-24  RLA   Reset the InputX ports to 0xFF in ClearDevice() ...
 // 25-MAR-25  RLA   Add EnablePPI()
 //                  Add BIT_PROGRAMMABLE to the READPORT macro!
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -145,6 +146,7 @@
 #include "Interrupt.hpp"        // CInterrupt definitions
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "PPI.hpp"              // declarations for this module
 
 
@@ -448,3 +450,20 @@ void CPPI::ShowDevice (ostringstream &ofs) const
   ofs << FormatString("PPI port C MODE=%d, DDR=0x%02X, MASK=0x%02x, IBUF=0x%02X, OBUF=0x%02X\n",
     m_ModeC, m_bDDRC, m_bMaskC, m_bInputC, m_bOutputC);
 }
+
+void CPPI::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the port latches, flags and modes.  The interrupt request
+  // itself is saved by the interrupt controller, so there's no need to call
+  // UpdateInterrupts() here ...
+  //--
+  State.Sync(m_fEnablePPI);
+  State.Sync(m_bInputA);  State.Sync(m_bOutputA);
+  State.Sync(m_bInputB);  State.Sync(m_bOutputB);
+  State.Sync(m_bInputC);  State.Sync(m_bOutputC);
+  State.Sync(m_fIBFA);  State.Sync(m_fIBFB);  State.Sync(m_fOBEA);  State.Sync(m_fOBEB);
+  State.Sync(m_bDDRA);  State.Sync(m_bDDRB);  State.Sync(m_bDDRC);  State.Sync(m_bMaskC);
+  State.Sync(m_fIENA);  State.Sync(m_fIENB);  State.Sync(m_fIRQA);  State.Sync(m_fIRQB);
+  State.Sync(m_ModeA);  State.Sync(m_ModeB);  State.Sync(m_ModeC);
+}
@@ -12,6 +12,7 @@
 // 25-MAR-25  RLA   Add EnablePPI() ...
 //                  Setting the STROBE/READY outputs in bit programmable mode
 //                  is a separate command byte from the mode set!
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -105,6 +106,7 @@ public:
   virtual uint8_t DevRead (address_t nPort) override = 0;
   virtual void DevWrite (address_t nPort, uint8_t bData) override = 0;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Simple, non-strobed, I/O emulation ...
 public:
@@ -48,6 +48,7 @@
 //    
 // REVISION HISTORY:
 // 27-FEB-24  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -65,6 +66,7 @@
 #include "EventQueue.hpp"       // CEventQueue declarations
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "PSG.hpp"              // declarations for this module
 
 
@@ -157,3 +159,11 @@ void CPSG::ShowDevice (ostringstream &ofs) const
     }
   }
 }
+
+void CPSG::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the PSG register file and address latch ...
+  //--
+  State.Sync(m_abRegisters);  State.Sync(m_bAddress);  State.Sync(m_fEnablePSG);
+}
@@ -24,6 +24,7 @@
 // 72-FEB-24  RLA   New file.
 // 30-OCT-24  RLA   PAOUT and PBOUT are backwards!
 // 25-MAR-25  RLA   Add EnablePSG() ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -109,6 +110,7 @@ public:
   virtual word_t DevRead (address_t nRegister) override;
   virtual void DevWrite (address_t nRegister, word_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Other public CPSG methods ...
 public:
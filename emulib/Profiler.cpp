@@ -0,0 +1,138 @@
+//++
+// Profiler.cpp -> guest program execution profiler
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   This module implements the CProfiler class.  Recording instructions is
+// all done inline in Profiler.hpp, and what's here is just the code to clear
+// the histogram, sort it, and load symbol tables.
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   New file.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#include <stdlib.h>             // exit(), system(), etc ...
+#include <stdint.h>	        // uint8_t, uint32_t, etc ...
+#include <stdio.h>              // fopen(), fgets(), etc ...
+#include <string.h>             // strtok(), etc ...
+#include <assert.h>             // assert() (what else??)
+#include <algorithm>            // std::sort() ...
+#include "EMULIB.hpp"           // emulator library definitions
+#include "SafeCRT.h"		// replacements for Microsoft "safe" CRT functions
+#include "LogFile.hpp"          // emulator library message logging facility
+#include "MemoryTypes.h"        // address_t and word_t data types
+#include "Profiler.hpp"         // declarations for this module
+
+
+CProfiler::CProfiler()
+{
+  //++
+  //   The constructor allocates one count and one time for every address in
+  // the CPU's address space.  That's a lot of memory, which is why we don't
+  // create a profiler until somebody asks for one!
+  //--
+  m_plCounts = DBGNEW uint32_t[ADDRESS_MASK+1];
+  m_pqTimes = DBGNEW uint64_t[ADDRESS_MASK+1];
+  Clear();
+}
+
+CProfiler::~CProfiler()
+{
+  //++
+  // Destructor ...
+  //--
+  delete[] m_plCounts;
+  delete[] m_pqTimes;
+}
+
+void CProfiler::Clear()
+{
+  //++
+  //   Zero all the counts and times.  Note that the last time is cleared too,
+  // and so the first instruction recorded after this may be charged with some
+  // extra time.  That's harmless and it's not worth worrying about.
+  //--
+  memset(m_plCounts, 0, (ADDRESS_MASK+1) * sizeof(uint32_t));
+  memset(m_pqTimes, 0, (ADDRESS_MASK+1) * sizeof(uint64_t));
+  m_qTotalCount = m_qTotalTime = m_qLastTime = 0;
+}
+
+void CProfiler::GetBusiest (vector<address_t> &vAddresses, size_t nMax) const
+{
+  //++
+  //   Return a list of all the addresses that have been executed at least
+  // once, sorted by total time and then by count, and with the busiest ones
+  // first.  If nMax is given, then return at most that many addresses.
+  //--
+  vAddresses.clear();
+  for (uint32_t a = 0;  a <= ADDRESS_MASK;  ++a)
+    if (m_plCounts[a] != 0) vAddresses.push_back((address_t) a);
+  std::sort(vAddresses.begin(), vAddresses.end(),
+    [this] (address_t a, address_t b) {
+      if (m_pqTimes[a] != m_pqTimes[b]) return m_pqTimes[a] > m_pqTimes[b];
+      if (m_plCounts[a] != m_plCounts[b]) return m_plCounts[a] > m_plCounts[b];
+      return a < b;
+    });
+  if (vAddresses.size() > nMax) vAddresses.resize(nMax);
+}
+
+bool CProfiler::LoadSymbols (const string &sFileName, unsigned nRadix)
+{
+  //++
+  //   Load a symbol table from a text file.  Each line should contain a
+  // symbol name and then a value, in the specified radix, separated by spaces,
+  // tabs, "=" or ":".  Anything after the value is ignored, and so are blank
+  // lines and lines that start with ";" or "#".  Symbols are added to any that
+  // are already defined, and if two symbols have the same value then the last
+  // one wins.
+  //--
+  FILE *pFile;  int err = fopen_s(&pFile, sFileName.c_str(), "rt");
+  if (err != 0) {
+    LOGS(ERROR, "error (" << err << ") opening " << sFileName);  return false;
+  }
+  char szLine[256];  unsigned nLine = 0, nCount = 0;
+  while (fgets(szLine, sizeof(szLine), pFile) != NULL) {
+    ++nLine;
+    const char *pszDelimiters = " \t\r\n=:";
+    char *pszName = strtok(szLine, pszDelimiters);
+    if ((pszName == NULL) || (*pszName == ';') || (*pszName == '#')) continue;
+    char *pszValue = strtok(NULL, pszDelimiters);  char *pszEnd = NULL;
+    unsigned long lValue = (pszValue != NULL) ? strtoul(pszValue, &pszEnd, nRadix) : 0;
+    if ((pszValue == NULL) || (*pszEnd != '\0') || (lValue > ADDRESS_MASK)) {
+      LOGS(WARNING, "bad symbol at line " << nLine << " in " << sFileName);  continue;
+    }
+    m_Symbols[(address_t) lValue] = pszName;  ++nCount;
+  }
+  fclose(pFile);
+  LOGS(DEBUG, nCount << " symbols loaded from " << sFileName);
+  return true;
+}
+
+string CProfiler::FindSymbol (address_t nPC, unsigned nRadix) const
+{
+  //++
+  //   Find the symbol with the largest value that's less than or equal to
+  // nPC, and return "symbol" or "symbol+offset".  If there are no symbols
+  // at or before this address, then return an empty string ...
+  //--
+  map<address_t, string>::const_iterator it = m_Symbols.upper_bound(nPC);
+  if (it == m_Symbols.begin()) return "";
+  --it;
+  if (it->first == nPC) return it->second;
+  return it->second + FormatString((nRadix == 8) ? "+%o" : "+%X", nPC - it->first);
+}
@@ -0,0 +1,110 @@
+//++
+// Profiler.hpp -> guest program execution profiler
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   CProfiler keeps a histogram of where the simulated program is spending
+// its time.  There's one execution count and one total simulated time for
+// every address in the CPU's address space, and these are kept in simple flat
+// arrays so that recording an instruction is just a couple of adds.
+//
+//   The CPU's Run() loop calls Record() after every instruction with the
+// address of that instruction and the current simulated time.  The time since
+// the previous call is charged to that address, so it includes any extra time
+// for interrupts, DMA, skipping ahead in idle loops, etc.  The CPU only does
+// that when the profiler is enabled, so the cost when it isn't is just one
+// test of a NULL pointer.
+//
+//   The profiler can also load a symbol table, which is used to print the
+// addresses in a more human friendly form.  The symbol file is just a text
+// file with one "name value" pair per line, in whatever radix the CPU uses.
+// Blank lines, and lines that start with ";" or "#", are ignored.
+//
+// Bob Armstrong <bob@jfcl.com>   [16-OCT-2026]
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   New file.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#pragma once
+#include <stdint.h>             // uint8_t, int32_t, and much more ...
+#include <string>               // C++ std::string class, et al ...
+#include <vector>               // C++ std::vector template
+#include <map>                  // C++ std::map template
+#include "MemoryTypes.h"        // address_t and word_t data types
+using std::string;              // ...
+using std::vector;              // ...
+using std::map;                 // ...
+
+
+class CProfiler {
+  //++
+  // Guest program execution profiler ...
+  //--
+
+  // Constructor and destructor ...
+public:
+  CProfiler();
+  virtual ~CProfiler();
+private:
+  // Disallow copy and assignments!
+  CProfiler (const CProfiler&) = delete;
+  CProfiler& operator= (CProfiler const&) = delete;
+
+  // Profiling methods ...
+public:
+  //   Charge one instruction, and all the simulated time since the last one,
+  // to the specified address.  Note that the simulated time goes backwards
+  // when the CPU is reset!
+  inline void Record (address_t nPC, uint64_t qNow)
+  {
+    uint64_t qDelta = (qNow > m_qLastTime) ? (qNow - m_qLastTime) : 0;
+    nPC = ADDRESS(nPC);  ++m_plCounts[nPC];  m_pqTimes[nPC] += qDelta;
+    ++m_qTotalCount;  m_qTotalTime += qDelta;  m_qLastTime = qNow;
+  }
+  // Clear all the counts and times ...
+  void Clear();
+  // Return the count or time for one address ...
+  inline uint32_t GetCount (address_t nPC) const {return m_plCounts[ADDRESS(nPC)];}
+  inline uint64_t GetTime (address_t nPC) const {return m_pqTimes[ADDRESS(nPC)];}
+  // Return the totals for all addresses ...
+  inline uint64_t GetTotalCount() const {return m_qTotalCount;}
+  inline uint64_t GetTotalTime() const {return m_qTotalTime;}
+  // Return a list of the busiest addresses, most time first ...
+  void GetBusiest (vector<address_t> &vAddresses, size_t nMax=SIZE_MAX) const;
+
+  // Symbol table methods ...
+public:
+  // Load a symbol table file ...
+  bool LoadSymbols (const string &sFileName, unsigned nRadix);
+  // Forget all symbols ...
+  void ClearSymbols() {m_Symbols.clear();}
+  // Return the number of symbols defined ...
+  size_t GetSymbolCount() const {return m_Symbols.size();}
+  // Convert an address to "symbol+offset" form (or "" if there's no symbol) ...
+  string FindSymbol (address_t nPC, unsigned nRadix) const;
+
+  // Private member data ...
+private:
+  uint32_t   *m_plCounts;       // execution count for every address
+  uint64_t   *m_pqTimes;        // total simulated time for every address
+  uint64_t    m_qTotalCount;    // total instructions recorded
+  uint64_t    m_qTotalTime;     // total simulated time recorded
+  uint64_t    m_qLastTime;      // simulated time of the last Record()
+  map<address_t, string> m_Symbols; // symbol table, by address
+};
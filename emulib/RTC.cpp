@@ -43,6 +43,7 @@
 //    
 // REVISION HISTORY:
 // 20-JUN-22  RLA   Generalized from the DS12887 version.
+// 16-OCT-26  RLA   Add SyncNVR()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -55,6 +56,7 @@
 #include "EMULIB.hpp"           // emulator library definitions
 #include "SafeCRT.h"            // replacements for some Microsoft functions
 #include "LogFile.hpp"          // emulator library message logging facility
+#include "StateFile.hpp"        // CStateFile declarations
 #include "RTC.hpp"              // declarations for this module
 
 
@@ -258,6 +260,16 @@ string CRTC::FormatDate (uint8_t bDay, uint8_t bMonth, uint8_t bYear, bool fBCD)
   return FormatString("%02d/%02d/%d", bMonth, bDay, bYear);
 }
 
+void CRTC::SyncNVR (CStateFile &State)
+{
+  //++
+  //   Save or load the NVR contents.  The time of day isn't saved, since it
+  // always comes from the host anyway ...
+  //--
+  State.Verify(m_cbNVR, "NVR size");
+  if (m_cbNVR > 0) State.SyncBytes(m_pbNVR, m_cbNVR);
+}
+
 void CRTC::DumpNVR (ostringstream &ofs) const
 {
   //++
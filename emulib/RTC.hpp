@@ -24,11 +24,13 @@
 //
 // REVISION HISTORY:
 // 20-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncNVR()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
 #include <string>               // C++ std::string class, et al ...
 using std::string;              // ...
+class CStateFile;               // ...
 
 
 class CRTC
@@ -82,6 +84,8 @@ public:
   // Read or write NVR bytes ...
   uint8_t ReadNVR (uint16_t a) const {assert(a<m_cbNVR);  return m_pbNVR[a];}
   void WriteNVR (uint8_t a, uint8_t d) {assert(a<m_cbNVR);  m_pbNVR[a] = d;}
+  // Save or load the NVR contents in a state file ...
+  void SyncNVR (CStateFile &State);
 
   // Other public methods ...
 public:
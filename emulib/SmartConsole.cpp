@@ -26,6 +26,8 @@
 //   * Sending a text file to the UART emulation as input ...
 //   * Receving a file from the UART using the XMODEM protocol
 //   * Sending a file to the UART using the XMODEM protocol
+//   * Recording console input, with simulated time stamps, to a file ...
+//   * Replaying a recording to the UART at exactly the same simulated times
 // 
 // NOTES:
 //   * It is possible to send a text file while a console log file is opened.  The
@@ -52,10 +54,20 @@
 // NAKs us for any reason, we just print an error message and abort.  It _is_ an
 // error free communication channel, after all!
 //
+//   * A recording contains every byte the emulation reads from us, including
+// text and XMODEM data, and the simulated time when it was read.  Since the
+// UART only reads a byte when it's ready to accept one, replaying gives the
+// emulation exactly the same input at exactly the same simulated times.  The
+// replay only matches the recording if it starts from the same machine state
+// and simulated time, though - e.g. after the same startup script, or after a
+// LOAD STATE of the same checkpoint.  The console isn't read while replaying.
+//
 // Bob Armstrong <bob@jfcl.com>   [11-NOV-2023]
 //
 // REVISION HISTORY:
 // 11-NOV-23  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
+// 16-OCT-26  RLA   Add console input recording and replay
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -65,17 +77,20 @@
 #include <assert.h>             // assert() (what else??)
 #include <stdarg.h>             // va_start(), va_end(), et al ...
 #include <string.h>             // strcpy(), memset(), strerror(), etc ...
+#include <ctype.h>              // isspace(), ...
 #include <sys/types.h>          // size_t, ...
 #include "EMULIB.hpp"           // emulator library definitions
 #include "CommandParser.hpp"    // SetDefaultExtension(), ...
 #include "VirtualConsole.hpp"   // CVirtualConsole declarations
 #include "LogFile.hpp"          // message logging facility
+#include "StateFile.hpp"        // CStateFile declarations
 #include "SmartConsole.hpp"     // declarations for this module
 
 // Default file extensions  ...
 const char *CSmartConsole::m_pszDefaultLogType     = ".log";  // default extension for log files
 const char *CSmartConsole::m_pszDefaultTextType    = ".txt";  //    "      "   "    "  text files
 const char *CSmartConsole::m_pszDefaultBinaryType  = ".bin";  //    "      "   "    "  XMODEM files
+const char *CSmartConsole::m_pszDefaultRecordType  = ".rec";  //    "      "   "    "  recordings
 
 
 CSmartConsole::CSmartConsole (CEventQueue *pEvents, const char *pszTitle)
@@ -106,6 +121,11 @@ CSmartConsole::CSmartConsole (CEventQueue *pEvents, const char *pszTitle)
   memset(m_abXbuffer, XPAD, sizeof(m_abXbuffer));
   m_qXdelay = XMODEM_DELAY;
 
+  // Record and replay variables ...
+  m_sRecordName.clear();  m_pRecordFile = NULL;  m_cbRecordTotal = 0;
+  m_sReplayName.clear();  m_pReplayFile = NULL;  m_cbReplayTotal = 0;
+  m_nReplayLine = 0;  m_qReplayTime = 0;  m_bReplayData = 0;
+
   // Others ...
   m_fTXready = true;
 }
@@ -118,6 +138,8 @@ CSmartConsole::~CSmartConsole()
   if (IsLoggingOutput()) CloseLog();
   if (IsSendingText()) AbortText();
   if (IsXactive()) XAbort();
+  if (IsRecording()) StopRecording();
+  if (IsReplaying()) StopReplay();
 }
 
 int32_t CSmartConsole::RawRead (uint8_t *pabBuffer, size_t cbBuffer, uint32_t lTimeout)
@@ -125,24 +147,48 @@ int32_t CSmartConsole::RawRead (uint8_t *pabBuffer, size_t cbBuffer, uint32_t lT
   //++
   //   This routine is called by the emulation whenever it wants to read a
   // character from the console terminal.  It first checks to see whether we're
-  // doing an XMODEM transfer or sending a raw text file and, if neither of
-  // those is happening, it passes the call along to the CConsoleWindow.
+  // replaying a recording, doing an XMODEM transfer or sending a raw text file
+  // and, if none of those is happening, it passes the call along to the
+  // CConsoleWindow.  If we're recording then whatever we return, no matter
+  // where it came from, goes into the recording too.
   //--
   assert(cbBuffer > 0);
-  if (IsSendingText())
-    return NextTextByte(*pabBuffer) ? 1 : 0;
+  int32_t nRet;
+  //   A replay takes priority over everything else, and the real console
+  // isn't read at all until the replay is finished.
+  if (IsReplaying())
+    nRet = NextReplayByte(*pabBuffer) ? 1 : 0;
+  else if (IsSendingText())
+    nRet = NextTextByte(*pabBuffer) ? 1 : 0;
   //   If we're doing an XMODEM transfer BUT we're currently waiting for the
   // transfer to start or a block to be acknowledged, then go ahead and let
   // the user type.  In particular, this allows the user to first issue a
   // RECEIVE command in the emulator, resume emulation, and then issue a SAVE
   // command to the emulated software.
   else if (IsXactive() && XSendByte(*pabBuffer))
-    return 1;
+    nRet = 1;
   //   No XMODEM transfer - check for a raw text file instead.  Note that we
   // never allow both XMODEM and raw text to be active at the same time!
   // Otherwise let the console window handle it...
   else
-    return CConsoleWindow::RawRead(pabBuffer, cbBuffer, lTimeout);
+    nRet = CConsoleWindow::RawRead(pabBuffer, cbBuffer, lTimeout);
+  if (IsRecording())
+    for (int32_t i = 0;  i < nRet;  ++i) RecordByte(pabBuffer[i]);
+  return nRet;
+}
+
+bool CSmartConsole::IsInputPending()
+{
+  //++
+  //   The CPU calls this to decide whether it's OK to skip ahead thru an idle
+  // loop, and normally that depends on whether the operator has typed anything.
+  // That's host timing, though, and while recording or replaying nothing can
+  // depend on the host or the replay won't follow the same path as the
+  // recording did.  Skipping is harmless anyway, because the UART only reads
+  // input when its polling event runs and the CPU never skips past an event.
+  //--
+  if (IsRecording() || IsReplaying()) return false;
+  return CConsoleWindow::IsInputPending();
 }
 
 void CSmartConsole::RawWrite (uint8_t ch)
@@ -422,6 +468,125 @@ void CSmartConsole::AbortText()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////////   RECORD AND REPLAY METHODS   ////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CSmartConsole::StartRecording (const string &sFileName)
+{
+  //++
+  //   Create a new recording file.  From now on every byte that the emulation
+  // reads from the console is written to this file, one per line, along with
+  // the simulated time (in nanoseconds) when it was read.  The file is plain
+  // text so that it's easy to look at or edit.  If we're already recording
+  // to some other file, then that one is closed first.
+  //--
+  if (IsRecording()) StopRecording();
+  m_sRecordName = CCmdParser::SetDefaultExtension(sFileName, m_pszDefaultRecordType);
+  int err = fopen_s(&m_pRecordFile, m_sRecordName.c_str(), "wt");
+  if (err != 0) {
+    CMDERRS("unable (" << err << ") to create file " << m_sRecordName);
+    m_pRecordFile = NULL;  return false;
+  }
+  fprintf(m_pRecordFile, "# console input recorded at %llu ns\n", (unsigned long long) m_pEvents->CurrentTime());
+  fprintf(m_pRecordFile, "# simulated_ns byte\n");
+  LOGS(WARNING, "recording console input to " << m_sRecordName);
+  m_cbRecordTotal = 0;
+  return true;
+}
+
+void CSmartConsole::RecordByte (uint8_t ch)
+{
+  //++
+  // Write one byte, and the current simulated time, to the recording ...
+  //--
+  assert(m_pRecordFile != NULL);
+  fprintf(m_pRecordFile, "%llu %02X\n", (unsigned long long) m_pEvents->CurrentTime(), ch);
+  ++m_cbRecordTotal;
+}
+
+void CSmartConsole::StopRecording()
+{
+  //++
+  // Close the current recording file ...
+  //--
+  if (!IsRecording()) return;
+  LOGS(WARNING, "Recorded " << m_cbRecordTotal << " bytes to " << m_sRecordName);
+  fclose(m_pRecordFile);  m_pRecordFile = NULL;
+}
+
+bool CSmartConsole::StartReplay (const string &sFileName)
+{
+  //++
+  //   Open a recording and start replaying it.  Every byte in the file will
+  // be returned by RawRead() the first time it's called at or after the time
+  // recorded for that byte.  Any replay that's already in progress is stopped
+  // first.  Note that it's perfectly legal to record while replaying, although
+  // the new recording will be the same as the old one unless the operator types
+  // something after the replay is finished!
+  //--
+  if (IsReplaying()) StopReplay();
+  m_sReplayName = CCmdParser::SetDefaultExtension(sFileName, m_pszDefaultRecordType);
+  int err = fopen_s(&m_pReplayFile, m_sReplayName.c_str(), "rt");
+  if (err != 0) {
+    CMDERRS("unable (" << err << ") to open file " << m_sReplayName);
+    m_pReplayFile = NULL;  return false;
+  }
+  LOGS(WARNING, "replaying console input from " << m_sReplayName);
+  m_nReplayLine = 0;  m_cbReplayTotal = 0;
+  return ReadReplay();
+}
+
+bool CSmartConsole::ReadReplay()
+{
+  //++
+  //   Read the next byte, and its time, from the replay file.  Blank lines and
+  // lines that start with "#" are ignored.  At the end of the file, or if
+  // there's any error, the replay is stopped and we return false.
+  //--
+  assert(m_pReplayFile != NULL);
+  char szLine[128];
+  while (fgets(szLine, sizeof(szLine), m_pReplayFile) != NULL) {
+    ++m_nReplayLine;
+    const char *psz = szLine;
+    while (isspace(*psz)) ++psz;
+    if ((*psz == '\0') || (*psz == '#')) continue;
+    unsigned long long llTime;  unsigned nData;
+    if ((sscanf_s(psz, "%llu %x", &llTime, &nData) != 2) || (nData > 0xFF)) {
+      CMDERRS("syntax error in " << m_sReplayName << " line " << m_nReplayLine);
+      StopReplay();  return false;
+    }
+    m_qReplayTime = llTime;  m_bReplayData = MASK8(nData);
+    return true;
+  }
+  StopReplay();
+  return false;
+}
+
+bool CSmartConsole::NextReplayByte (uint8_t &ch)
+{
+  //++
+  //   Return the next byte from the replay, if it's time for it yet.  If the
+  // time has already passed (which can only happen if the replay didn't start
+  // from the same state as the recording) then the byte is returned anyway.
+  //--
+  if (!IsReplaying() || (m_pEvents->CurrentTime() < m_qReplayTime)) return false;
+  ch = m_bReplayData;  ++m_cbReplayTotal;
+  ReadReplay();
+  return true;
+}
+
+void CSmartConsole::StopReplay()
+{
+  //++
+  // Close the current replay file ...
+  //--
+  if (!IsReplaying()) return;
+  LOGS(WARNING, "Replayed " << m_cbReplayTotal << " bytes from " << m_sReplayName);
+  fclose(m_pReplayFile);  m_pReplayFile = NULL;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////   XMODEM METHODS   //////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -843,3 +1008,17 @@ bool CSmartConsole::XSendByte (uint8_t &ch)
   LOGF(DEBUG, "XMODEM state %s sending 0x%02X", StateToString(OldState), ch);
   return true;
 }
+
+void CSmartConsole::SyncState (CStateFile &State)
+{
+  //++
+  //   The console itself has no state worth saving, but it is an event handler
+  // and it only schedules events while sending a text file or doing an XMODEM
+  // transfer.  Those depend on open host files, so we just refuse to save or
+  // load the machine state while one is in progress ...
+  //--
+  if (IsSendingText() || IsXactive())
+    State.Error("can't save or load state during a console file transfer");
+  else if (State.IsLoading())
+    m_fTXready = false;
+}
@@ -20,10 +20,13 @@
 //   The CSmartConsole object sits between any CVirtualConsole object (such as
 // a WindowsConsole or LinuxConsole) and any other thing that needs a console
 // object (usually a UART emulation of some kind), and adds file transfer
-// functions to the console window, including both XMODEM and raw text.
+// functions to the console window, including both XMODEM and raw text.  It
+// can also record console input with simulated time stamps and replay it.
 //
 // REVISION HISTORY:
 // 13-NOV-23  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
+// 16-OCT-26  RLA   Add console input recording and replay
 //--
 #pragma once
 #include <string>               // C++ std::string class, et al ...
@@ -102,12 +105,18 @@ public:
   // Send or receive raw data to or from the serial port or console window ...
   virtual int32_t RawRead (uint8_t *pabBuffer, size_t cbBuffer, uint32_t lTimeout=0) override;
   virtual void RawWrite (const char *pabBuffer, size_t cbBuffer) override;
+  // Return TRUE if there's keyboard input waiting ...
+  virtual bool IsInputPending() override;
 
   // CSmartConsole methods inherited from CEventHandler ...
 public:
   virtual void EventCallback (intptr_t lParam) override;
   virtual const char *EventName() const override {return "SmartConsole";}
 
+  // Save or load the console state ...
+public:
+  void SyncState (CStateFile &State);
+
   // Console log file functions ...
 public:
   bool OpenLog (const string &sFileName, bool fAppend=true);
@@ -130,6 +139,19 @@ public:
   void SetTextNoCRLF (bool fNoCRLF) {m_fNoCRLF = fNoCRLF;}
   bool GetTextNoCRLF() const {return m_fNoCRLF;}
 
+  // Record or replay console input ...
+public:
+  bool StartRecording (const string &sFileName);
+  void StopRecording();
+  bool IsRecording() const {return m_pRecordFile != NULL;}
+  string GetRecordFileName() const
+    {return IsRecording() ? m_sRecordName : string();}
+  bool StartReplay (const string &sFileName);
+  void StopReplay();
+  bool IsReplaying() const {return m_pReplayFile != NULL;}
+  string GetReplayFileName() const
+    {return IsReplaying() ? m_sReplayName : string();}
+
   // Send or receive files via XMODEM protocol ...
 public:
   static const char *StateToString (XSTATE state);
@@ -156,6 +178,12 @@ private:
   void WriteLog (uint8_t ch);
   void WriteLog (const char *pabBuffer, size_t cbBuffer);
 
+  // Record and replay local routines ...
+private:
+  void RecordByte (uint8_t ch);
+  bool ReadReplay();
+  bool NextReplayByte (uint8_t &ch);
+
   // XMODEM local routines ...
 private:
   bool XSendByte (uint8_t &ch);
@@ -188,6 +216,18 @@ protected:
   uint64_t m_qSendCharDelay;        // delay between characters when sending
   uint64_t m_qSendLineDelay;        // delay between lines/blocks when sending
 
+  // Record and replay locals ...
+protected:
+  string    m_sRecordName;          // name of the current recording file
+  FILE     *m_pRecordFile;          // handle of the recording file
+  size_t    m_cbRecordTotal;        // total bytes recorded
+  string    m_sReplayName;          // name of the current replay file
+  FILE     *m_pReplayFile;          // handle of the replay file
+  uint32_t  m_nReplayLine;          // current line number in the replay file
+  uint64_t  m_qReplayTime;          // simulated time for the next replay byte
+  uint8_t   m_bReplayData;          // and the next byte to replay
+  size_t    m_cbReplayTotal;        // total bytes replayed
+
   // XMODEM file transfer locals ...
 protected:
   string    m_sXname;               // current XMODEM file name
@@ -211,6 +251,7 @@ protected:
   static const char *m_pszDefaultLogType;     // default extension for log files
   static const char *m_pszDefaultTextType;    //    "      "   "    "  text files
   static const char *m_pszDefaultBinaryType;  //    "      "   "    "  XMODEM files
+  static const char *m_pszDefaultRecordType;  //    "      "   "    "  recordings
 };
 
 //   This little inserter function allows us to write an XMODEM state to a
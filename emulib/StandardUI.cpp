@@ -30,6 +30,11 @@
 //      SET WINDOW ...
 //      DO ...
 //      EXIT ...
+//      BENCHMARK ...
+//      SET PROFILE ...
+//      SHOW PROFILE ...
+//      SAVE PROFILE ...
+//      SHOW STATISTICS ...
 //
 //   Notice that this class only contains the parser tables and code for these
 // commands - it's still up to each application to add the appropriate entries
@@ -49,17 +54,36 @@
 //  2-JUN-17  RLA   Linux port.
 // 26-AUG-22  RLA   Clean up Linux/WIN32 conditionals.
 //  9-FEB-24  RLA   Add THREADS conditional.
+// 16-OCT-26  RLA   Add the BENCHMARK command.
+// 16-OCT-26  RLA   Add SET, SHOW and SAVE PROFILE.
+// 16-OCT-26  RLA   Add SHOW STATISTICS.
+// 16-OCT-26  RLA   Add SET and SHOW TRACE.
+// 16-OCT-26  RLA   Add SET CPU/SPEED.
+// 16-OCT-26  RLA   Add SET CPU/[NO]WARP.
+// 16-OCT-26  RLA   Add the FORK command.
+// 16-OCT-26  RLA   Label the memory access counts as slow path only.
+// 16-OCT-26  RLA   Show the memory statistics for the CPU's own memory.
+// 16-OCT-26  RLA   Add the RECORD and REPLAY commands.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
 #include <stdlib.h>             // exit(), system(), etc ...
 #include <stdint.h>	        // uint8_t, uint32_t, etc ...
 #include <assert.h>             // assert() (what else??)
+#include <errno.h>              // errno, EINTR, etc ...
 #include <string.h>             // strcpy(), strerror(), etc ...
+#include <ctype.h>              // toupper() ...
 #include <cstring>              // needed for memset()
+#include <chrono>               // steady_clock for BENCHMARK
+#include <iomanip>              // setprecision() for BENCHMARK
 #if defined(_WIN32)
 #include <windows.h>            // WIN32 API for GetModuleFileName() ...
 #include <process.h>            // needed for CreateProcess(), et al ...
+#elif defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>             // fork(), pipe(), dup2(), etc ...
+#include <fcntl.h>              // open(), O_RDONLY, etc ...
+#include <poll.h>               // poll() for FORK
+#include <sys/wait.h>           // waitpid(), WIFEXITED(), etc ...
 #endif
 #include "EMULIB.hpp"           // emulator library definitions
 #include "SafeCRT.h"		// replacements for Microsoft "safe" CRT functions
@@ -70,6 +94,12 @@
 #include "CommandLine.hpp"      // CCommandLine (argc/argv) parser
 #include "CommandParser.hpp"    // emulator library command line parsing methods
 #include "ConsoleWindow.hpp"    // WIN32 console window functions
+#include "SmartConsole.hpp"     // console RECORD and REPLAY functions
+#include "EventQueue.hpp"       // I/O device event queue simulation
+#include "MemoryTypes.h"        // address_t and word_t data types
+#include "Memory.hpp"           // basic memory emulation declarations ...
+#include "CPU.hpp"              // CCPU base class definitions
+#include "Profiler.hpp"         // guest program execution profiler
 #include "StandardUI.hpp"       // declarations for this module
 
 
@@ -77,6 +107,10 @@
 CCommandLine CStandardUI::g_oShellCommand("dlx", 0, 1, false, "-/");
 // And the name of the startup script from the shell command ...
 std::string  CStandardUI::g_sStartupScript;
+// And the CPU that BENCHMARK runs and PROFILE reports on (set by the application) ...
+CCPU        *CStandardUI::g_pCPU = NULL;
+// And the console that RECORD and REPLAY use (also set by the application) ...
+CSmartConsole *CStandardUI::g_pConsole = NULL;
 
 
 // UI class object constructor cheat sheet!
@@ -135,6 +169,15 @@ CCmdArgNumber     CStandardUI::m_argColumns("character columns", 10, 20, 250);
 CCmdArgNumber     CStandardUI::m_argRows("character rows", 10, 5, 100);
 CCmdArgString     CStandardUI::m_argTitle("window title");
 CCmdArgNumber     CStandardUI::m_argInterval("interval (seconds)", 10, 1, 10000);
+CCmdArgNumber     CStandardUI::m_argSeconds("simulated seconds", 10, 1, 3600);
+CCmdArgNumber     CStandardUI::m_argTop("address count", 10, 1, 100000);
+CCmdArgFileName   CStandardUI::m_argSymbolFile("symbol file", true);
+CCmdArgNumber     CStandardUI::m_argTraceSize("trace size", 10, 16, 16777216);
+CCmdArgNumber     CStandardUI::m_argTraceCount("instruction count", 10, 1, 16777216, true);
+CCmdArgName       CStandardUI::m_argCPUspeed("REAL, MAX or Xn");
+CCmdArgFileName   CStandardUI::m_argForkScript("script file");
+CCmdArgList       CStandardUI::m_argForkScripts("script list", m_argForkScript);
+CCmdArgNumber     CStandardUI::m_argJobs("job count", 10, 1, 1024);
 
 // Modifier definitions ...
 CCmdModifier      CStandardUI::m_modVerbosity("LEV*EL", NULL, &m_argVerbosity);
@@ -152,6 +195,14 @@ CCmdModifier      CStandardUI::m_modRows("H*EIGHT", NULL, &m_argRows);
 CCmdModifier      CStandardUI::m_modColumns("W*IDTH", NULL, &m_argColumns);
 CCmdModifier      CStandardUI::m_modEnable("ENA*BLE", "DISA*BLE");
 CCmdModifier      CStandardUI::m_modInterval("INT*ERVAL", NULL, &m_argInterval);
+CCmdModifier      CStandardUI::m_modClear("CL*EAR");
+CCmdModifier      CStandardUI::m_modSymbols("SYM*BOLS", "NOSYM*BOLS", &m_argSymbolFile);
+CCmdModifier      CStandardUI::m_modTop("TOP", NULL, &m_argTop);
+CCmdModifier      CStandardUI::m_modTraceSize("SI*ZE", NULL, &m_argTraceSize);
+CCmdModifier      CStandardUI::m_modCPUspeed("SPE*ED", NULL, &m_argCPUspeed);
+CCmdModifier      CStandardUI::m_modCPUwarp("WA*RP", "NOWA*RP");
+CCmdModifier      CStandardUI::m_modJobs("JOB*S", NULL, &m_argJobs);
+CCmdModifier      CStandardUI::m_modClose("CL*OSE", NULL);
 
 // SET LOGGING and SHOW LOGGING verb definitions ...
 CCmdModifier * const CStandardUI::m_modsSetLog[] = {&m_modNoFile, &m_modConsole, &m_modVerbosity, &m_modAppend, NULL};
@@ -191,6 +242,39 @@ CCmdVerb CStandardUI::m_cmdIndirect("DO", &DoIndirect, m_argsIndirect, NULL);
 CCmdVerb CStandardUI::m_cmdExit("EXIT", &DoExit, NULL, NULL);
 CCmdVerb CStandardUI::m_cmdQuit("QUIT", &DoExit, NULL, NULL);
 
+// BENCHMARK verb definition ...
+CCmdArgument * const CStandardUI::m_argsBenchmark[] = {&m_argSeconds, NULL};
+CCmdVerb CStandardUI::m_cmdBenchmark("BENCH*MARK", &DoBenchmark, m_argsBenchmark, NULL);
+
+// SET PROFILE, SHOW PROFILE and SAVE PROFILE verb definitions ...
+CCmdModifier * const CStandardUI::m_modsSetProfile[] = {&m_modEnable, &m_modClear, &m_modSymbols, NULL};
+CCmdModifier * const CStandardUI::m_modsShowProfile[] = {&m_modTop, NULL};
+CCmdArgument * const CStandardUI::m_argsSaveProfile[] = {&m_argFileName, NULL};
+CCmdVerb CStandardUI::m_cmdSetProfile("PROF*ILE", &DoSetProfile, NULL, m_modsSetProfile);
+CCmdVerb CStandardUI::m_cmdShowProfile("PROF*ILE", &DoShowProfile, NULL, m_modsShowProfile);
+CCmdVerb CStandardUI::m_cmdSaveProfile("PROF*ILE", &DoSaveProfile, m_argsSaveProfile, NULL);
+
+// SHOW STATISTICS verb definition ...
+CCmdModifier * const CStandardUI::m_modsShowStatistics[] = {&m_modClear, NULL};
+CCmdVerb CStandardUI::m_cmdShowStatistics("STAT*ISTICS", &DoShowStatistics, NULL, m_modsShowStatistics);
+
+// SET TRACE and SHOW TRACE verb definitions ...
+CCmdModifier * const CStandardUI::m_modsSetTrace[] = {&m_modEnable, &m_modClear, &m_modTraceSize, NULL};
+CCmdArgument * const CStandardUI::m_argsShowTrace[] = {&m_argTraceCount, NULL};
+CCmdVerb CStandardUI::m_cmdSetTrace("TR*ACE", &DoSetTrace, NULL, m_modsSetTrace);
+CCmdVerb CStandardUI::m_cmdShowTrace("TR*ACE", &DoShowTrace, m_argsShowTrace, NULL);
+
+// FORK verb definition ...
+CCmdArgument * const CStandardUI::m_argsFork[] = {&m_argForkScripts, NULL};
+CCmdModifier * const CStandardUI::m_modsFork[] = {&m_modJobs, NULL};
+CCmdVerb CStandardUI::m_cmdFork("FORK", &DoFork, m_argsFork, m_modsFork);
+
+// RECORD and REPLAY verb definitions ...
+CCmdArgument * const CStandardUI::m_argsRecord[] = {&m_argOptFileName, NULL};
+CCmdModifier * const CStandardUI::m_modsRecord[] = {&m_modClose, NULL};
+CCmdVerb CStandardUI::m_cmdRecord("RECO*RD", &DoRecord, m_argsRecord, m_modsRecord);
+CCmdVerb CStandardUI::m_cmdReplay("REPL*AY", &DoReplay, m_argsRecord, m_modsRecord);
+
 
 bool CStandardUI::DetachProcess (string sCommand)
 {
@@ -745,3 +829,575 @@ bool CStandardUI::DoExit (CCmdParser &cmd)
   if (cmd.ConfirmExit()) cmd.SetExitRequest();
   return true;
 }
+
+
+bool CStandardUI::DoBenchmark (CCmdParser &cmd)
+{
+  //++
+  //   The BENCHMARK command runs the simulation, starting from wherever it
+  // last left off, for a fixed amount of SIMULATED time and then prints one
+  // line that says how long that took in real time.  The line is a list of
+  // "name=value" pairs so that it's easy for scripts to parse and keep track
+  // of from one build to the next.
+  //
+  // Format:
+  //    BENCHMARK <seconds>
+  //
+  //   Note that this calls the CPU's Run() method directly, so none of the
+  // application's usual RUN or CONTINUE messages are printed.  If the
+  // simulation stops for any reason other than reaching the time limit then
+  // the results are still printed, but the command fails.
+  //
+  //   The slow path count is the number of memory accesses that couldn't use
+  // the page table and had to call CPUread() or CPUwrite() instead.
+  //--
+  static const char *const apszStop[] = {
+    "NONE", "FINISHED", "ILLEGAL_IO", "ILLEGAL_OPCODE", "HALT",
+    "ENDLESS_LOOP", "BREAKPOINT", "BREAK"
+  };
+  if (g_pCPU == NULL) {
+    CMDERRS("no CPU to benchmark");  return false;
+  }
+  CEventQueue *pEvents = g_pCPU->GetEvents();
+
+  // Remember where all the counters started ...
+  uint64_t qTime = g_pCPU->ElapsedTime();
+  uint64_t qInstructions = g_pCPU->GetInstructionCount();
+  uint64_t qEvents = pEvents->GetEventCount();
+  uint64_t qSlow = g_pCPU->GetMemory()->GetSlowAccesses();
+
+  //   Run the simulation until it reaches the time limit.  Benchmarks always
+  // run flat out, regardless of any SET CPU/SPEED setting ...
+  uint32_t nSpeed = pEvents->GetSpeed();  pEvents->SetSpeed(0);
+  pEvents->SetTimeLimit(qTime + (uint64_t) m_argSeconds.GetNumber() * 1000000000ULL);
+  std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+  CCPU::STOP_CODE nStop = g_pCPU->Run();
+  std::chrono::steady_clock::time_point tEnd = std::chrono::steady_clock::now();
+  pEvents->SetTimeLimit(0);  pEvents->SetSpeed(nSpeed);
+
+  // And print the results ...
+  qTime = g_pCPU->ElapsedTime() - qTime;
+  qInstructions = g_pCPU->GetInstructionCount() - qInstructions;
+  qEvents = pEvents->GetEventCount() - qEvents;
+  qSlow = g_pCPU->GetMemory()->GetSlowAccesses() - qSlow;
+  uint64_t qHost = std::chrono::duration_cast<std::chrono::nanoseconds>(tEnd - tStart).count();
+  double dHost = (qHost == 0) ? 1.0 : (double) qHost;
+  CMDOUTS(std::fixed << std::setprecision(3)
+    << "BENCHMARK cpu=" << g_pCPU->GetName()
+    << " stop=" << apszStop[nStop]
+    << " simulated_ns=" << qTime << " host_ns=" << qHost
+    << " instructions=" << qInstructions
+    << " ns_per_instruction=" << ((qInstructions == 0) ? 0.0 : dHost / qInstructions)
+    << " mips=" << (qInstructions * 1000.0 / dHost)
+    << " events=" << qEvents << " events_per_second=" << (qEvents * 1.0E9 / dHost)
+    << " slow_accesses=" << qSlow << " slow_per_second=" << (qSlow * 1.0E9 / dHost));
+  return nStop == CCPU::STOP_FINISHED;
+}
+
+
+bool CStandardUI::DoSetProfile (CCmdParser &cmd)
+{
+  //++
+  //   The SET PROFILE command turns the guest program execution profiler on
+  // or off, clears the histogram, and loads or forgets symbol tables.
+  //
+  // Format:
+  //    SET PROFILE /ENABLE /CLEAR /SYMBOLS=<file>
+  //    SET PROFILE /NOSYMBOLS
+  //    SET PROFILE /DISABLE
+  //
+  //   Anything other than /DISABLE enables the profiler if it isn't already.
+  // Note that /DISABLE throws away the profiler, and that includes the counts
+  // AND any symbols that were loaded!
+  //--
+  if (g_pCPU == NULL) {
+    CMDERRS("no CPU to profile");  return false;
+  }
+  if (m_modEnable.IsPresent() && m_modEnable.IsNegated()) {
+    if (m_modClear.IsPresent() || m_modSymbols.IsPresent()) {
+      CMDERRS("other modifiers ignored with /DISABLE");
+    }
+    g_pCPU->EnableProfiler(false);  return true;
+  }
+  g_pCPU->EnableProfiler(true);
+  CProfiler *pProfiler = g_pCPU->GetProfiler();
+  if (m_modClear.IsPresent()) pProfiler->Clear();
+  if (m_modSymbols.IsPresent()) {
+    if (m_modSymbols.IsNegated()) {
+      pProfiler->ClearSymbols();
+    } else if (!m_argSymbolFile.IsPresent()) {
+      CMDERRS("symbol file name required for /SYMBOLS");  return false;
+    } else {
+      if (!pProfiler->LoadSymbols(m_argSymbolFile.GetFullPath(), g_pCPU->GetAddressRadix())) return false;
+      CMDOUTS(pProfiler->GetSymbolCount() << " symbols defined");
+    }
+  }
+  return true;
+}
+
+
+bool CStandardUI::DoShowProfile (CCmdParser &cmd)
+{
+  //++
+  //   SHOW PROFILE prints the busiest addresses, most simulated time first,
+  // along with the execution count, percentage of the total time, and the
+  // disassembled instruction at that address.  /TOP sets the number of
+  // addresses shown, and the default is twenty.
+  //
+  // Format:
+  //    SHOW PROFILE /TOP=<count>
+  //--
+  if ((g_pCPU == NULL) || !g_pCPU->IsProfilerEnabled()) {
+    CMDERRS("profiler not enabled");  return false;
+  }
+  const CProfiler *pProfiler = g_pCPU->GetProfiler();
+  unsigned nRadix = g_pCPU->GetAddressRadix();
+  size_t nTop = m_modTop.IsPresent() ? m_argTop.GetNumber() : 20;
+  vector<address_t> vBusiest;  pProfiler->GetBusiest(vBusiest, nTop);
+  uint64_t qTotalTime = pProfiler->GetTotalTime();
+  CMDOUTS(pProfiler->GetTotalCount() << " instructions and " << qTotalTime << "ns profiled");
+  CMDOUTS("");
+  CMDOUTS(FormatString("%-8s%-16s %10s %15s %6s  %s",
+    "ADDRESS", "SYMBOL", "COUNT", "TIME(ns)", "TIME", "INSTRUCTION"));
+  for (size_t i = 0;  i < vBusiest.size();  ++i) {
+    address_t nPC = vBusiest[i];  string sCode;
+    g_pCPU->DisassembleInstruction(nPC, sCode);
+    double dPercent = (qTotalTime == 0) ? 0.0 : (100.0 * pProfiler->GetTime(nPC) / qTotalTime);
+    CMDOUTS(FormatString((nRadix == 8) ? "%06o  " : "%04X    ", nPC)
+      << FormatString("%-16s %10u %15llu %5.1f%%  ",
+           pProfiler->FindSymbol(nPC, nRadix).c_str(), pProfiler->GetCount(nPC),
+           (unsigned long long) pProfiler->GetTime(nPC), dPercent)
+      << sCode);
+  }
+  CMDOUTS("");
+  return true;
+}
+
+
+bool CStandardUI::DoSaveProfile (CCmdParser &cmd)
+{
+  //++
+  //   SAVE PROFILE writes every address that's been executed at least once to
+  // a text file, busiest first.  Each line has the address, symbol, count,
+  // time and disassembled instruction, separated by tabs, so it's easy to
+  // feed into a spreadsheet or another script.
+  //
+  // Format:
+  //    SAVE PROFILE <file>
+  //--
+  if ((g_pCPU == NULL) || !g_pCPU->IsProfilerEnabled()) {
+    CMDERRS("profiler not enabled");  return false;
+  }
+  const CProfiler *pProfiler = g_pCPU->GetProfiler();
+  unsigned nRadix = g_pCPU->GetAddressRadix();
+  FILE *pFile = m_argFileName.OpenWrite("wt");
+  if (pFile == NULL) return false;
+  vector<address_t> vBusiest;  pProfiler->GetBusiest(vBusiest);
+  fprintf(pFile, "address\tsymbol\tcount\ttime_ns\tinstruction\n");
+  for (size_t i = 0;  i < vBusiest.size();  ++i) {
+    address_t nPC = vBusiest[i];  string sCode;
+    g_pCPU->DisassembleInstruction(nPC, sCode);
+    fprintf(pFile, (nRadix == 8) ? "%06o\t" : "%04X\t", nPC);
+    fprintf(pFile, "%s\t%u\t%llu\t%s\n", pProfiler->FindSymbol(nPC, nRadix).c_str(),
+      pProfiler->GetCount(nPC), (unsigned long long) pProfiler->GetTime(nPC), sCode.c_str());
+  }
+  fclose(pFile);
+  CMDOUTS(vBusiest.size() << " addresses written to " << m_argFileName.GetFullPath());
+  return true;
+}
+
+
+void CStandardUI::GetStatistics (vector<string> &vLines)
+{
+  //++
+  //   Format all the emulator statistics - instructions, interrupts, events
+  // and memory accesses - into a list of lines.  This is shared by the SHOW
+  // STATISTICS command and DumpStatistics(), which write them to different
+  // places.  Note that the memory counts are for the CPU's memory (plus any
+  // memories mapped thru it), and only include the accesses that had to call
+  // CPUread() or CPUwrite() ...
+  //--
+  vLines.clear();
+  if (g_pCPU == NULL) return;
+  const CEventQueue *pEvents = g_pCPU->GetEvents();
+  const CMemory *pMemory = g_pCPU->GetMemory();
+  const char *pszFormat = "%-30s %15llu";
+  vLines.push_back(FormatString(pszFormat, "Instructions executed", (unsigned long long) g_pCPU->GetInstructionCount()));
+  vLines.push_back(FormatString(pszFormat, "Interrupts acknowledged", (unsigned long long) g_pCPU->GetInterruptCount()));
+  vLines.push_back(FormatString(pszFormat, "Simulated time (ns)", (unsigned long long) g_pCPU->ElapsedTime()));
+  vLines.push_back(FormatString(pszFormat, "DoEvents() dispatches", (unsigned long long) pEvents->GetDispatchCount()));
+  vLines.push_back(FormatString(pszFormat, "Events executed", (unsigned long long) pEvents->GetEventCount()));
+  vLines.push_back(FormatString(pszFormat, "Idle fast forwards", (unsigned long long) pEvents->GetJumpCount()));
+  vLines.push_back(FormatString(pszFormat, "Time fast forwarded (ns)", (unsigned long long) pEvents->GetJumpTime()));
+  vLines.push_back(FormatString(pszFormat, "Host time slept pacing (ns)", (unsigned long long) pEvents->GetSleepTime()));
+  vLines.push_back(FormatString(pszFormat, "Memory slow path accesses", (unsigned long long) pMemory->GetSlowAccesses()));
+
+  //   Memory accesses by type.  These are only the ones that missed the page
+  // table fast path, so RAM and ROM are usually zero - counting the fast
+  // path would cost an increment on every single memory reference ...
+  vLines.push_back("");
+  vLines.push_back(FormatString("%-14s %15s %15s %15s %15s", "Slow path", "RAM", "ROM", "I/O", "NXM"));
+  vLines.push_back(FormatString("%-14s %15llu %15llu %15llu %15llu", "  reads",
+    (unsigned long long) pMemory->GetReadCount(CMemory::ACCESS_RAM),
+    (unsigned long long) pMemory->GetReadCount(CMemory::ACCESS_ROM),
+    (unsigned long long) pMemory->GetReadCount(CMemory::ACCESS_IO),
+    (unsigned long long) pMemory->GetReadCount(CMemory::ACCESS_NXM)));
+  vLines.push_back(FormatString("%-14s %15llu %15llu %15llu %15llu", "  writes",
+    (unsigned long long) pMemory->GetWriteCount(CMemory::ACCESS_RAM),
+    (unsigned long long) pMemory->GetWriteCount(CMemory::ACCESS_ROM),
+    (unsigned long long) pMemory->GetWriteCount(CMemory::ACCESS_IO),
+    (unsigned long long) pMemory->GetWriteCount(CMemory::ACCESS_NXM)));
+
+  // And events for each device ...
+  vLines.push_back("");
+  vLines.push_back(FormatString("%-14s %15s %15s %15s", "Events", "Scheduled", "Cancelled", "Executed"));
+  for (const CEventQueue::HANDLER_STATISTICS &s : pEvents->GetHandlerStatistics())
+    vLines.push_back(FormatString("  %-12s %15llu %15llu %15llu", s.sName.c_str(),
+      (unsigned long long) s.qScheduled, (unsigned long long) s.qCancelled,
+      (unsigned long long) s.qExecuted));
+}
+
+
+bool CStandardUI::DoShowStatistics (CCmdParser &cmd)
+{
+  //++
+  //   SHOW STATISTICS prints the emulator's internal counters.  These are
+  // useful for figuring out why one configuration runs slower than another.
+  // The /CLEAR modifier zeros all the counters after showing them.
+  //
+  // Format:
+  //    SHOW STATISTICS /CLEAR
+  //--
+  if (g_pCPU == NULL) {
+    CMDERRS("no CPU");  return false;
+  }
+  vector<string> vLines;  GetStatistics(vLines);
+  for (size_t i = 0;  i < vLines.size();  ++i)  CMDOUTS(vLines[i]);
+  CMDOUTS("");
+  if (m_modClear.IsPresent()) {
+    g_pCPU->ClearStatistics();  g_pCPU->GetEvents()->ClearStatistics();
+    g_pCPU->GetMemory()->ClearStatistics();
+  }
+  return true;
+}
+
+
+void CStandardUI::DumpStatistics()
+{
+  //++
+  //   Each application calls this just before it exits to write the same
+  // report as SHOW STATISTICS to the log, at the DEBUG level, so that it's
+  // there if anybody wants it but doesn't clutter up the console otherwise.
+  //--
+  vector<string> vLines;  GetStatistics(vLines);
+  for (size_t i = 0;  i < vLines.size();  ++i)  LOGS(DEBUG, vLines[i]);
+}
+
+
+bool CStandardUI::DoSetTrace (CCmdParser &cmd)
+{
+  //++
+  //   The SET TRACE command turns the instruction trace buffer on or off, or
+  // clears it.  The trace buffer remembers the last /SIZE instructions
+  // executed, and the default is 4096.  Changing the size, or disabling the
+  // trace, throws away everything that's been recorded so far.
+  //
+  // Format:
+  //    SET TRACE /ENABLE /SIZE=<entries> /CLEAR
+  //    SET TRACE /DISABLE
+  //--
+  if (g_pCPU == NULL) {
+    CMDERRS("no CPU to trace");  return false;
+  }
+  if (m_modEnable.IsPresent() && m_modEnable.IsNegated()) {
+    if (m_modClear.IsPresent() || m_modTraceSize.IsPresent()) {
+      CMDERRS("other modifiers ignored with /DISABLE");
+    }
+    g_pCPU->EnableTrace(0);  return true;
+  }
+  if (m_modTraceSize.IsPresent())
+    g_pCPU->EnableTrace(m_argTraceSize.GetNumber());
+  else if (!g_pCPU->IsTraceEnabled())
+    g_pCPU->EnableTrace(4096);
+  if (m_modClear.IsPresent()) g_pCPU->ClearTrace();
+  return true;
+}
+
+
+bool CStandardUI::DoShowTrace (CCmdParser &cmd)
+{
+  //++
+  //   SHOW TRACE decodes and prints the last few instructions executed,
+  // oldest first, along with the simulated time and the CPU registers saved
+  // in each trace entry.  The default is to show the last twenty.
+  //
+  // Format:
+  //    SHOW TRACE [<count>]
+  //--
+  if ((g_pCPU == NULL) || !g_pCPU->IsTraceEnabled()) {
+    CMDERRS("instruction trace not enabled");  return false;
+  }
+  DumpTrace(m_argTraceCount.IsPresent() ? m_argTraceCount.GetNumber() : 20);
+  return true;
+}
+
+
+void CStandardUI::DumpTrace (size_t nCount)
+{
+  //++
+  //   Print the last nCount instructions in the trace buffer, oldest first.
+  // Each UI calls this after the simulation stops for a breakpoint or an
+  // illegal opcode, and it quietly does nothing if tracing isn't enabled.
+  //--
+  if ((g_pCPU == NULL) || !g_pCPU->IsTraceEnabled()) return;
+  if (nCount > g_pCPU->GetTraceCount()) nCount = g_pCPU->GetTraceCount();
+  if (nCount == 0) return;
+  CMDOUTS("");
+  CMDOUTS(FormatString("%12s  %-*s  %-*s  %-24s REGISTERS", "TIME(ns)",
+    (g_pCPU->GetAddressRadix() == 8) ? 6 : 4, "PC",
+    (g_pCPU->GetAddressRadix() == 8) ? 6 : 4, "OP", "INSTRUCTION"));
+  while (nCount-- > 0)  CMDOUTS(g_pCPU->FormatTrace(g_pCPU->GetTrace(nCount)));
+  CMDOUTS("");
+}
+
+
+bool CStandardUI::SetCPUspeed()
+{
+  //++
+  //   Every application's SET CPU command calls this when the /SPEED modifier
+  // is present.  /SPEED=REAL paces the simulation to real time, /SPEED=MAX
+  // runs it as fast as the host will go (that's the default), and /SPEED=Xn
+  // paces it to n times real time.  When the simulation is paced and it gets
+  // ahead of the host clock the emulator sleeps, so it doesn't burn a whole
+  // host CPU while the guest is waiting at a prompt.
+  //
+  // Format:
+  //    SET CPU/SPEED=REAL
+  //    SET CPU/SPEED=MAX
+  //    SET CPU/SPEED=X<n>
+  //--
+  if (g_pCPU == NULL) {
+    CMDERRS("no CPU to pace");  return false;
+  }
+  string sSpeed = m_argCPUspeed.GetValue();
+  uint32_t nSpeed;
+  if (CCmdArgKeyword::Match(sSpeed, "REAL")) {
+    nSpeed = 1;
+  } else if (CCmdArgKeyword::Match(sSpeed, "MAX*IMUM")) {
+    nSpeed = 0;
+  } else {
+    char *pszEnd = NULL;  unsigned long lSpeed = 0;
+    if ((sSpeed.length() > 1) && (toupper(sSpeed[0]) == 'X'))
+      lSpeed = strtoul(sSpeed.c_str()+1, &pszEnd, 10);
+    if ((lSpeed == 0) || (lSpeed > 1000) || (*pszEnd != '\0')) {
+      CMDERRS("speed must be REAL, MAX or X1 thru X1000");  return false;
+    }
+    nSpeed = (uint32_t) lSpeed;
+  }
+  g_pCPU->GetEvents()->SetSpeed(nSpeed);
+  return true;
+}
+
+
+string CStandardUI::GetCPUspeed()
+{
+  //++
+  // Return the current CPU speed as "MAX", "REAL" or "Xn" ...
+  //--
+  if (g_pCPU == NULL) return "MAX";
+  uint32_t nSpeed = g_pCPU->GetEvents()->GetSpeed();
+  if (nSpeed == 0) return "MAX";
+  if (nSpeed == 1) return "REAL";
+  return FormatString("X%u", nSpeed);
+}
+
+
+string CStandardUI::GetCPUwarp()
+{
+  //++
+  //   Return "WARP" or "NOWARP", plus the total simulated time that's been
+  // skipped so far.  Note that the time includes IDL, WAIT, etc instructions
+  // as well as polling loops - those always skip ahead, warp or not.
+  //--
+  if (g_pCPU == NULL) return "NOWARP";
+  return FormatString("%s (%.3f seconds skipped)",
+    g_pCPU->IsWarp() ? "WARP" : "NOWARP", NSTOMS(g_pCPU->GetWarpTime()) / 1000.0);
+}
+
+
+bool CStandardUI::DoFork (CCmdParser &cmd)
+{
+  //++
+  //   The FORK command runs a list of scripts in parallel, each one in its own
+  // child process that starts with an exact copy of this emulator, including
+  // the complete state of the simulated machine.  The idea is to boot the
+  // machine once (or LOAD STATE a checkpoint) and then run any number of
+  // regression tests from that point.  fork() gives every child a copy-on-write
+  // copy of everything, so starting one costs next to nothing, and nothing
+  // the children do can affect each other or this machine.
+  //
+  // Format:
+  //    FORK script1 script2 ... [/JOBS=n]
+  //
+  //   At most /JOBS children run at the same time, and the default is the
+  // number of host CPU cores.  Each child's console input is /dev/null and its
+  // console output (including any log messages) goes to a pipe.  When a child
+  // finishes we print everything it wrote in one block, followed by a line
+  // that says whether it PASSED or FAILED.  A script passes if it runs to the
+  // end, or to an EXIT command, without any errors.  FORK itself fails if any
+  // of the scripts fail.
+  //--
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+  struct FORK_JOB {string sScript;  pid_t pid;  int fd;  string sOutput;};
+  vector<string> vScripts;
+  for (size_t i = 0;  i < m_argForkScripts.Count();  ++i) {
+    CCmdArgFileName *pArg = dynamic_cast<CCmdArgFileName *> (m_argForkScripts[i]);
+    assert(pArg != NULL);
+    vScripts.push_back(CCmdParser::SetDefaultExtension(pArg->GetFullPath(), ".cmd"));
+  }
+  size_t nJobs = (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+  if (m_modJobs.IsPresent()) nJobs = m_argJobs.GetNumber();
+  if (nJobs < 1) nJobs = 1;
+
+  //   Start children until we have nJobs running or we run out of scripts,
+  // then wait for output from any of them.  Each child keeps the write end of
+  // its pipe until it exits, so EOF on the pipe means that child is done.
+  vector<FORK_JOB> vRunning;  size_t nNext = 0, nPassed = 0, nFailed = 0;
+  while ((nNext < vScripts.size())  ||  !vRunning.empty()) {
+    while ((nNext < vScripts.size())  &&  (vRunning.size() < nJobs)) {
+      FORK_JOB job;  int afd[2];
+      job.sScript = vScripts[nNext++];
+      if (pipe(afd) != 0) {
+        CMDERRS("unable (" << errno << ") to create pipe for " << job.sScript);
+        ++nFailed;  continue;
+      }
+      //   Flush all our output streams first, or else anything that's still
+      // buffered will be written twice - once by us and again by the child!
+      fflush(NULL);
+      job.pid = fork();
+      if (job.pid == 0) {
+        close(afd[0]);  RunForkChild(cmd, job.sScript, afd[1]);
+      }
+      close(afd[1]);
+      if (job.pid < 0) {
+        CMDERRS("unable (" << errno << ") to fork " << job.sScript);
+        close(afd[0]);  ++nFailed;  continue;
+      }
+      job.fd = afd[0];  vRunning.push_back(job);
+    }
+    if (vRunning.empty()) break;
+
+    // Wait for something to happen, and collect any output ...
+    vector<struct pollfd> vPoll(vRunning.size());
+    for (size_t i = 0;  i < vRunning.size();  ++i) {
+      vPoll[i].fd = vRunning[i].fd;  vPoll[i].events = POLLIN;  vPoll[i].revents = 0;
+    }
+    if (poll(vPoll.data(), (nfds_t) vPoll.size(), -1) < 0) {
+      if (errno == EINTR) continue;
+      CMDERRS("unable (" << errno << ") to poll FORK children");  return false;
+    }
+    for (size_t i = vRunning.size();  i > 0;  --i) {
+      FORK_JOB &job = vRunning[i-1];
+      if (vPoll[i-1].revents == 0) continue;
+      char ach[4096];  ssize_t cb = read(job.fd, ach, sizeof(ach));
+      if (cb > 0) {job.sOutput.append(ach, (size_t) cb);  continue;}
+      if ((cb < 0) && (errno == EINTR)) continue;
+
+      // This child is finished - report the results ...
+      close(job.fd);
+      int nStatus = 0;  waitpid(job.pid, &nStatus, 0);
+      bool fPassed = WIFEXITED(nStatus) && (WEXITSTATUS(nStatus) == 0);
+      if (!job.sOutput.empty() && (job.sOutput.back() == '\n')) job.sOutput.pop_back();
+      if (!job.sOutput.empty()) CMDOUTS(job.sOutput);
+      if (WIFSIGNALED(nStatus)) {
+        CMDOUTS("FORK " << job.sScript << " FAILED (signal " << WTERMSIG(nStatus) << ")");
+      } else {
+        CMDOUTS("FORK " << job.sScript << (fPassed ? " PASSED" : " FAILED"));
+      }
+      if (fPassed) ++nPassed; else ++nFailed;
+      vRunning.erase(vRunning.begin() + (i-1));
+    }
+  }
+  CMDOUTF("FORK %zu scripts, %zu passed, %zu failed", vScripts.size(), nPassed, nFailed);
+  return nFailed == 0;
+#else
+  CMDERRS("FORK is not supported on this platform");
+  return false;
+#endif
+}
+
+
+void CStandardUI::RunForkChild (CCmdParser &cmd, const string &sScript, int fdOutput)
+{
+  //++
+  //   This runs in the child process created by FORK.  Connect stdin to the
+  // null device and stdout and stderr to the pipe, then run the script and
+  // exit with status 0 if it worked or 1 if it didn't.  The child never
+  // returns to the command loop, and it uses _exit() rather than exit() so
+  // that no destructors run and no stdio buffers or files are touched on the
+  // way out.  In particular, our parent is probably still reading a startup
+  // script and it shares the file position with us!  The child also stops
+  // writing to the log file so that it doesn't scribble in the middle of the
+  // parent's log.
+  //--
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+  CLog::GetLog()->SetDefaultFileLevel(CLog::NOLOG);
+  int fdNull = open("/dev/null", O_RDONLY);
+  if (fdNull >= 0) {dup2(fdNull, STDIN_FILENO);  close(fdNull);}
+  dup2(fdOutput, STDOUT_FILENO);  dup2(fdOutput, STDERR_FILENO);  close(fdOutput);
+  bool fOK = cmd.RunScript(sScript);
+  fflush(stdout);  fflush(stderr);
+  _exit(fOK ? 0 : 1);
+#else
+  assert(false);  (void) cmd;  (void) sScript;  (void) fdOutput;
+#endif
+}
+
+
+bool CStandardUI::DoRecord (CCmdParser &cmd)
+{
+  //++
+  //   The RECORD command saves every byte that the emulation reads from the
+  // console, along with the simulated time when it was read, in a text file.
+  // REPLAY can feed the same input back later at exactly the same simulated
+  // times, which makes a whole interactive session reproducible.
+  //
+  //   RECORD <filename>
+  //   RECORD/CLOSE
+  //--
+  if (g_pConsole == NULL) {
+    CMDERRS("console recording not supported");  return false;
+  }
+  if (m_modClose.IsPresent()) {
+    if (m_argOptFileName.IsPresent())
+      CMDERRS("File name ignored - " << m_argOptFileName.GetValue());
+    g_pConsole->StopRecording();  return true;
+  }
+  if (!m_argOptFileName.IsPresent())
+    {CMDERRS("File name required");  return false;}
+  return g_pConsole->StartRecording(m_argOptFileName.GetFullPath());
+}
+
+
+bool CStandardUI::DoReplay (CCmdParser &cmd)
+{
+  //++
+  //   The REPLAY command plays back a file created by RECORD.  For the result
+  // to be the same the machine must start from the same state - e.g. run the
+  // same startup script, or LOAD STATE the same snapshot, before replaying.
+  //
+  //   REPLAY <filename>
+  //   REPLAY/CLOSE
+  //--
+  if (g_pConsole == NULL) {
+    CMDERRS("console replay not supported");  return false;
+  }
+  if (m_modClose.IsPresent()) {
+    if (m_argOptFileName.IsPresent())
+      CMDERRS("File name ignored - " << m_argOptFileName.GetValue());
+    g_pConsole->StopReplay();  return true;
+  }
+  if (!m_argOptFileName.IsPresent())
+    {CMDERRS("File name required");  return false;}
+  return g_pConsole->StartReplay(m_argOptFileName.GetFullPath());
+}
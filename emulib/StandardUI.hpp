@@ -29,12 +29,24 @@
 // 29-OCT-15  RLA   Add SET CHECKPOINT command.
 // 29-OCT-15  RLA   Add the SET/SHOW CHECKPOINT commands.
 // 26-AUG-22  RLA   Clean up Linux/WIN32 conditionals.
+// 16-OCT-26  RLA   Add the BENCHMARK command.
+// 16-OCT-26  RLA   Add SET, SHOW and SAVE PROFILE.
+// 16-OCT-26  RLA   Add SHOW STATISTICS.
+// 16-OCT-26  RLA   Add SET and SHOW TRACE.
+// 16-OCT-26  RLA   Add SET CPU/SPEED.
+// 16-OCT-26  RLA   Add SET CPU/[NO]WARP.
+// 16-OCT-26  RLA   Add the FORK command.
+// 16-OCT-26  RLA   Add the RECORD and REPLAY commands.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
 #pragma once
 #include <string>               // C++ std::string class, et al ...
+#include <vector>               // C++ std::vector template
 using std::string;              // ...
+using std::vector;              // ...
+class CCPU;                     // ...
+class CSmartConsole;            // ...
 
 class CStandardUI {
   //++
@@ -58,7 +70,13 @@ public:
   static CCmdArgKeyword m_argVerbosity, m_argForeground, m_argBackground;
   static CCmdArgFileName m_argFileName, m_argOptFileName;
   static CCmdArgString m_argSubstitution, m_argTitle;
-  static CCmdArgNumber m_argRows, m_argColumns, m_argInterval;
+  static CCmdArgNumber m_argRows, m_argColumns, m_argInterval, m_argSeconds;
+  static CCmdArgNumber m_argTop, m_argTraceSize, m_argTraceCount;
+  static CCmdArgFileName m_argSymbolFile;
+  static CCmdArgName m_argCPUspeed;
+  static CCmdArgFileName m_argForkScript;
+  static CCmdArgList m_argForkScripts;
+  static CCmdArgNumber m_argJobs;
 #if defined(_WIN32)
   static CCmdArgNumber m_argX, m_argY;
 #endif
@@ -71,7 +89,9 @@ public:
   static CCmdModifier m_modX, m_modY;
 #endif
   static CCmdModifier m_modForeground, m_modBackground, m_modEnable;
-  static CCmdModifier m_modInterval;
+  static CCmdModifier m_modInterval, m_modClear, m_modSymbols, m_modTop;
+  static CCmdModifier m_modTraceSize, m_modCPUspeed, m_modCPUwarp;
+  static CCmdModifier m_modJobs, m_modClose;
 
   // Verb definitions ...
 public:
@@ -99,6 +119,41 @@ public:
 public:
   static CCmdVerb m_cmdExit, m_cmdQuit;
 
+  // BENCHMARK verb definition ...
+public:
+  static CCmdArgument * const m_argsBenchmark[];
+  static CCmdVerb m_cmdBenchmark;
+
+  // SET, SHOW and SAVE PROFILE verb definitions ...
+public:
+  static CCmdModifier * const m_modsSetProfile[];
+  static CCmdModifier * const m_modsShowProfile[];
+  static CCmdArgument * const m_argsSaveProfile[];
+  static CCmdVerb m_cmdSetProfile, m_cmdShowProfile, m_cmdSaveProfile;
+
+  // SHOW STATISTICS verb definition ...
+public:
+  static CCmdModifier * const m_modsShowStatistics[];
+  static CCmdVerb m_cmdShowStatistics;
+
+  // SET and SHOW TRACE verb definitions ...
+public:
+  static CCmdModifier * const m_modsSetTrace[];
+  static CCmdArgument * const m_argsShowTrace[];
+  static CCmdVerb m_cmdSetTrace, m_cmdShowTrace;
+
+  // FORK verb definition ...
+public:
+  static CCmdArgument * const m_argsFork[];
+  static CCmdModifier * const m_modsFork[];
+  static CCmdVerb m_cmdFork;
+
+  // RECORD and REPLAY verb definitions ...
+public:
+  static CCmdArgument * const m_argsRecord[];
+  static CCmdModifier * const m_modsRecord[];
+  static CCmdVerb m_cmdRecord, m_cmdReplay;
+
   // Verb action routines ....
 public:
   static bool DoSetLog(CCmdParser &cmd), DoSetWindow(CCmdParser &cmd);
@@ -108,6 +163,12 @@ public:
   static bool DoShowOneAlias(CCmdParser &cmd, string sAlias);
   static bool DoShowLog(CCmdParser &cmd), DoShowCheckpoint(CCmdParser &cmd);
   static bool DoShowAllAliases(CCmdParser &cmd);
+  static bool DoBenchmark(CCmdParser &cmd);
+  static bool DoSetProfile(CCmdParser &cmd), DoShowProfile(CCmdParser &cmd);
+  static bool DoSaveProfile(CCmdParser &cmd), DoShowStatistics(CCmdParser &cmd);
+  static bool DoSetTrace(CCmdParser &cmd), DoShowTrace(CCmdParser &cmd);
+  static bool DoFork(CCmdParser &cmd);
+  static bool DoRecord(CCmdParser &cmd), DoReplay(CCmdParser &cmd);
 
   // Other "helper" routines ...
 public:
@@ -119,9 +180,25 @@ public:
   static string Abbreviate (string str, uint32_t max);
   // Show a table of color names for SET WINDOW ...
   static void DoHelpColors();
+  // Format the SHOW STATISTICS report ...
+  static void GetStatistics (vector<string> &vLines);
+  // Write the statistics to the log (called when the program exits) ...
+  static void DumpStatistics();
+  // Print the last few instructions traced (called after a breakpoint, etc) ...
+  static void DumpTrace (size_t nCount=20);
+  // Parse and apply the SET CPU/SPEED modifier ...
+  static bool SetCPUspeed();
+  // Return the current CPU speed as a string for SHOW CPU ...
+  static string GetCPUspeed();
+  // Return the warp mode and total time warped as a string for SHOW CPU ...
+  static string GetCPUwarp();
+  // Run one FORK script in a child process (never returns!) ...
+  static void RunForkChild (CCmdParser &cmd, const string &sScript, int fdOutput);
 
   // Other global data ...
 public:
   static CCommandLine g_oShellCommand;   // original argc/argv shell command
   static string       g_sStartupScript;  // startup script file (if any)
+  static CCPU        *g_pCPU;            // CPU for BENCHMARK and PROFILE
+  static CSmartConsole *g_pConsole;      // console for RECORD and REPLAY
 };
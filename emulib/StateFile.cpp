@@ -0,0 +1,362 @@
+//++
+// StateFile.cpp -> save and restore the complete machine state
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   This module implements the CStateFile class.  When saving, the entire
+// state file is kept in memory and written in one go.  That makes it easy to
+// go back and fill in the length of each section after we've saved it, and
+// state files are only a few hundred kilobytes anyway.  When loading on UNIX
+// the file is mapped instead of read, and it stays open so that SyncMapped()
+// can map pieces of it again.  Elsewhere it's just read into memory.
+//
+//   The file format is simply -
+//
+//	"STGSTATE"	- eight byte magic number
+//	uint32_t	- format version (CStateFile::VERSION)
+//	string		- machine name (e.g. "SBCT11")
+//	sections ...	- one per object saved
+//
+// and each section is -
+//
+//	string		- section name (e.g. "CPU" or "SLU0")
+//	uint32_t	- length of the data that follows, in bytes
+//	data ...	- whatever the object's SyncState() saved
+//
+// A string is a uint32_t byte count followed by the characters, without any
+// terminating NUL.  A SyncMapped() block is preceded by enough zero bytes to
+// start it on a MAP_ALIGNMENT boundary in the file, and the padding counts as
+// part of the section's length.  The padding length isn't stored, since both
+// saving and loading can compute it from the current file offset.
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   New file.
+// 16-OCT-26  RLA   Add SyncMapped() and map the file when loading.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#include <stdlib.h>             // exit(), system(), etc ...
+#include <stdint.h>	        // uint8_t, uint32_t, etc ...
+#include <stdio.h>              // fopen(), fwrite(), etc ...
+#include <string.h>             // memcpy(), memcmp(), etc ...
+#include <assert.h>             // assert() (what else??)
+#include <errno.h>              // errno, ENOENT, etc ...
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>             // sysconf(), etc ...
+#include <sys/stat.h>           // needed for fstat() (what else??)
+#include <sys/mman.h>           // mmap(), munmap(), etc ...
+#define MAP_STATE_FILES         // map state files when loading
+#endif
+#include "EMULIB.hpp"           // emulator library definitions
+#include "SafeCRT.h"		// replacements for Microsoft "safe" CRT functions
+#include "LogFile.hpp"          // emulator library message logging facility
+#include "EventQueue.hpp"       // CEventHandler declarations
+#include "StateFile.hpp"        // declarations for this module
+
+// Magic number at the start of every state file ...
+static const char g_szMagic[] = "STGSTATE";
+#define MAGIC_LENGTH  (sizeof(g_szMagic)-1)
+
+
+CStateFile::CStateFile (const char *pszMachine, bool fLoading)
+{
+  //++
+  //   The constructor just initializes everything.  If we're saving, then we
+  // also write the file header to the buffer now.
+  //--
+  m_sMachine = pszMachine;  m_fLoading = fLoading;
+  m_pFile = NULL;  m_pbFile = NULL;  m_cbFile = 0;  m_fFileMapped = false;
+  m_cbNext = m_cbSection = 0;
+  if (IsSaving()) {
+    SyncBytes((void *) g_szMagic, MAGIC_LENGTH);
+    uint32_t lVersion = VERSION;  Sync(lVersion);
+    Sync(m_sMachine);
+  }
+}
+
+CStateFile::~CStateFile()
+{
+  //++
+  //   Unmap and close the state file, if we're loading.  Any SyncMapped()
+  // blocks have their own mappings and they aren't affected by this ...
+  //--
+#ifdef MAP_STATE_FILES
+  if (m_fFileMapped) munmap((void *) m_pbFile, m_cbFile);
+#endif
+  if (m_pFile != NULL) fclose(m_pFile);
+}
+
+void CStateFile::Error (const string &sMessage)
+{
+  //++
+  // Remember the first error and ignore any after that ...
+  //--
+  if (IsOK()) m_sError = sMessage;
+}
+
+bool CStateFile::Write (const string &sFileName)
+{
+  //++
+  //   Write the entire state buffer to a file.  We never overwrite an existing
+  // state file in place because some emulator (maybe even this one!) might
+  // still have it mapped.  Instead we write a new temporary file and then
+  // rename it, and anybody using the old file keeps the old contents.
+  //--
+  assert(IsSaving());
+  if (!IsOK()) return false;
+  string sTemporary = sFileName + ".tmp";
+  FILE *pFile;  int err = fopen_s(&pFile, sTemporary.c_str(), "wb");
+  if (err != 0) {
+    Error(FormatString("error (%d) opening %s", err, sTemporary.c_str()));  return false;
+  }
+  if (fwrite(m_abData.data(), 1, m_abData.size(), pFile) != m_abData.size())
+    Error("error writing " + sTemporary);
+  fclose(pFile);
+#if defined(_WIN32)
+  // Windows won't rename over an existing file ...
+  if (IsOK()) remove(sFileName.c_str());
+#endif
+  if (IsOK() && (rename(sTemporary.c_str(), sFileName.c_str()) != 0))
+    Error(FormatString("error (%d) renaming %s", errno, sTemporary.c_str()));
+  if (!IsOK()) remove(sTemporary.c_str());
+  return IsOK();
+}
+
+bool CStateFile::Read (const string &sFileName)
+{
+  //++
+  //   Map or read the entire state file and check the header.  If the version
+  // or the machine name are wrong, then fail now before anything has been
+  // changed.  The file stays open until we're destroyed ...
+  //--
+  assert(IsLoading() && (m_pFile == NULL));
+  int err = fopen_s(&m_pFile, sFileName.c_str(), "rb");
+  if (err != 0) {
+    m_pFile = NULL;
+    Error(FormatString("error (%d) opening %s", err, sFileName.c_str()));  return false;
+  }
+#ifdef MAP_STATE_FILES
+  struct stat st;
+  if ((fstat(fileno(m_pFile), &st) == 0) && (st.st_size > 0)) {
+    void *p = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fileno(m_pFile), 0);
+    if (p != MAP_FAILED) {
+      m_pbFile = (const uint8_t *) p;  m_cbFile = (size_t) st.st_size;  m_fFileMapped = true;
+    }
+  }
+#endif
+  if (!m_fFileMapped) {
+    uint8_t abBuffer[16384];  size_t cb;
+    while ((cb = fread(abBuffer, 1, sizeof(abBuffer), m_pFile)) > 0)
+      m_abData.insert(m_abData.end(), abBuffer, abBuffer+cb);
+    m_pbFile = m_abData.data();  m_cbFile = m_abData.size();
+  }
+
+  // Verify the magic number, version and machine name ...
+  if ((m_cbFile < MAGIC_LENGTH) || (memcmp(m_pbFile, g_szMagic, MAGIC_LENGTH) != 0)) {
+    Error(sFileName + " is not a state file");  return false;
+  }
+  uint32_t lVersion = 0;  string sMachine;
+  m_cbNext = MAGIC_LENGTH;  Sync(lVersion);  Sync(sMachine);
+  if (!IsOK()) return false;
+  if (lVersion != VERSION) {
+    Error(FormatString("%s is state file version %u (expected %u)", sFileName.c_str(), lVersion, VERSION));
+    return false;
+  }
+  if (sMachine != m_sMachine) {
+    Error(sFileName + " was saved by " + sMachine);  return false;
+  }
+  return true;
+}
+
+bool CStateFile::Get (void *pData, size_t cb)
+{
+  //++
+  //   Copy the next cb bytes from the buffer.  If there aren't that many
+  // left, then report an error and return FALSE ...
+  //--
+  if (!IsOK()) return false;
+  if (cb > (m_cbFile - m_cbNext)) {
+    Error("unexpected end of state file");  return false;
+  }
+  memcpy(pData, m_pbFile+m_cbNext, cb);  m_cbNext += cb;
+  return true;
+}
+
+void CStateFile::SyncBytes (void *pData, size_t cbData)
+{
+  //++
+  // Save or load a block of raw bytes ...
+  //--
+  if (!IsOK() || (cbData == 0)) return;
+  if (IsLoading())
+    Get(pData, cbData);
+  else
+    m_abData.insert(m_abData.end(), (const uint8_t *) pData, (const uint8_t *) pData + cbData);
+}
+
+void *CStateFile::SyncMapped (void *pData, size_t cbData)
+{
+  //++
+  //   Save or load a block of bytes that starts on a MAP_ALIGNMENT boundary
+  // in the file.  When loading we try to map the block copy-on-write, and if
+  // that works then we return the mapping.  The caller owns it now, and pData
+  // is unchanged.  If the block can't be mapped for any reason, then we just
+  // copy it into pData like SyncBytes() and return pData.
+  //
+  //   Note that mmap() requires the file offset to be a multiple of the host
+  // page size.  MAP_ALIGNMENT is big enough for any host we know about, but
+  // if it isn't then we just fall back to copying.
+  //--
+  if (!IsOK() || (cbData == 0)) return pData;
+  if (IsSaving()) {
+    m_abData.resize(m_abData.size() + PadLength(m_abData.size()), 0);
+    SyncBytes(pData, cbData);  return pData;
+  }
+  size_t cbPad = PadLength(m_cbNext);
+  if ((cbPad > (m_cbFile - m_cbNext))  ||  (cbData > (m_cbFile - m_cbNext - cbPad))) {
+    Error("unexpected end of state file");  return pData;
+  }
+  m_cbNext += cbPad;
+#ifdef MAP_STATE_FILES
+  long lPageSize = sysconf(_SC_PAGESIZE);
+  if ((lPageSize > 0) && ((MAP_ALIGNMENT % lPageSize) == 0)) {
+    void *p = mmap(NULL, cbData, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(m_pFile), (off_t) m_cbNext);
+    if (p != MAP_FAILED) {m_cbNext += cbData;  return p;}
+  }
+#endif
+  Get(pData, cbData);
+  return pData;
+}
+
+void CStateFile::UnmapBytes (void *pData, size_t cbData)
+{
+  //++
+  // Free a block that was mapped by SyncMapped() ...
+  //--
+#ifdef MAP_STATE_FILES
+  munmap(pData, cbData);
+#else
+  // SyncMapped() never returns a mapping, so this should never happen!
+  assert(false);  (void) pData;  (void) cbData;
+#endif
+}
+
+void CStateFile::SyncInteger (uint64_t &q, size_t cb)
+{
+  //++
+  //   Save or load an integer of cb bytes (1, 2, 4 or 8).  It's always stored
+  // least significant byte first, regardless of the host's byte order ...
+  //--
+  assert((cb > 0) && (cb <= sizeof(uint64_t)));
+  uint8_t ab[sizeof(uint64_t)];
+  if (IsLoading()) {
+    if (!Get(ab, cb)) return;
+    q = 0;
+    for (size_t i = cb;  i > 0;  --i) q = (q << 8) | ab[i-1];
+  } else {
+    for (size_t i = 0;  i < cb;  ++i) ab[i] = (uint8_t) (q >> (8*i));
+    SyncBytes(ab, cb);
+  }
+}
+
+void CStateFile::Sync (string &s)
+{
+  //++
+  // Save or load a string - a uint32_t length followed by the text ...
+  //--
+  uint32_t cb = (uint32_t) s.length();  Sync(cb);
+  if (!IsOK()) return;
+  if (cb == 0) {if (IsLoading()) s.clear();  return;}
+  if (IsLoading()) {
+    if (cb > (m_cbFile - m_cbNext)) {
+      Error("unexpected end of state file");  return;
+    }
+    s.assign((const char *) (m_pbFile+m_cbNext), cb);  m_cbNext += cb;
+  } else
+    SyncBytes((void *) s.data(), cb);
+}
+
+void CStateFile::Verify (uint64_t qValue, const char *pszWhat)
+{
+  //++
+  //   Save a configuration value (e.g. the size of a memory), or verify that
+  // it's the same as the value that was saved.  The state of an object can't
+  // be loaded into a different configuration!
+  //--
+  uint64_t q = qValue;  SyncInteger(q, sizeof(q));
+  if (IsOK() && (q != qValue))
+    Error(FormatString("%s %s doesn't match (saved %llu, now %llu)", m_sSection.c_str(), pszWhat,
+      (unsigned long long) q, (unsigned long long) qValue));
+}
+
+bool CStateFile::BeginSection (const char *pszSection)
+{
+  //++
+  //   Start a new section.  When saving we write the name and a dummy length,
+  // which EndSection() will fill in later.  When loading we verify that the
+  // name matches and remember where this section should end.  Sections can't
+  // be nested!
+  //--
+  if (!IsOK()) return false;
+  string sSection(pszSection);  uint32_t cbLength = 0;
+  Sync(sSection);
+  if (IsLoading() && IsOK() && (sSection != pszSection)) {
+    Error(FormatString("found section %s instead of %s", sSection.c_str(), pszSection));
+    return false;
+  }
+  m_sSection = pszSection;  m_cbSection = IsLoading() ? 0 : m_abData.size();
+  Sync(cbLength);
+  if (IsLoading()) m_cbSection = m_cbNext + cbLength;
+  return IsOK();
+}
+
+void CStateFile::EndSection()
+{
+  //++
+  //   Finish the current section.  When saving we go back and fill in the
+  // length of this section, and when loading we verify that the object used
+  // exactly as many bytes as were saved.
+  //--
+  if (!IsOK()) return;
+  if (IsLoading()) {
+    if (m_cbNext != m_cbSection)
+      Error(FormatString("section %s is the wrong length", m_sSection.c_str()));
+  } else {
+    uint32_t cbLength = (uint32_t) (m_abData.size() - m_cbSection - sizeof(uint32_t));
+    for (size_t i = 0;  i < sizeof(uint32_t);  ++i)
+      m_abData[m_cbSection+i] = (uint8_t) (cbLength >> (8*i));
+  }
+}
+
+void CStateFile::AddHandler (CEventHandler *pHandler)
+{
+  //++
+  //   Remember this event handler by name.  Two different handlers with the
+  // same name would be ambiguous, but that's only a problem if one of them
+  // actually has an event pending, so CEventQueue checks that when saving.
+  //--
+  m_Handlers[pHandler->EventName()] = pHandler;
+}
+
+CEventHandler *CStateFile::FindHandler (const string &sName) const
+{
+  //++
+  // Find an event handler by name, or return NULL if there is none ...
+  //--
+  map<string, CEventHandler *>::const_iterator it = m_Handlers.find(sName);
+  return (it == m_Handlers.end()) ? NULL : it->second;
+}
@@ -0,0 +1,190 @@
+//++
+// StateFile.hpp -> save and restore the complete machine state
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   CStateFile is used by the SAVE STATE and LOAD STATE commands to write
+// a snapshot of the entire simulated machine - CPU registers, memory, device
+// registers, pending events, attached image files, everything - to a single
+// binary file, and then to read it back again later.
+//
+//   Every object that has some state to save implements a SyncState() method
+// that calls Sync() for each of its members.  The same SyncState() method is
+// used both for saving and for loading - when we're saving Sync() copies the
+// member to the file, and when we're loading it copies the data from the file
+// back into the member.  That guarantees that the two always agree on the
+// format!  If an object needs to do something extra after its state has been
+// loaded (e.g. update a memory map or an interrupt request) then it can call
+// IsLoading() to find out which way we're going.
+//
+//   The machine's UI code saves each object in its own named section, and
+// every section records its length.  When we load a section we verify that
+// both the name and the length match, and that catches most incompatible
+// changes to an object's state (e.g. somebody added a register to a device).
+// There's also a format version number and the name of the machine in the
+// file header.  All numbers are stored little endian, regardless of the host.
+//
+//   Large blocks, like the contents of RAM and ROM, can be saved with
+// SyncMapped() instead of SyncBytes().  The file is padded so that these
+// blocks start on a MAP_ALIGNMENT boundary, and on UNIX hosts loading maps
+// them directly from the file MAP_PRIVATE rather than copying them.  Pages
+// that the simulation only reads (e.g. all of ROM) are shared with the page
+// cache, and with every other emulator that loaded the same file, and RAM
+// pages are only copied when they're actually written.  The downside is that
+// the state file must not be changed while it's mapped, so Write() always
+// creates a new file and renames it rather than overwriting the old one.
+//
+//   Events are the tricky part, since the event queue contains pointers to
+// CEventHandler objects.  In the file each event is identified by the name
+// of its handler instead, and every object that's saved in a section is also
+// remembered as a potential handler.  The event queue must be the LAST thing
+// saved or loaded so that it can find all the handlers by name.  Objects that
+// contain other event handlers (e.g. timers) must call AddHandler() for them.
+//
+//   Note that a failure while loading a state file leaves the machine in an
+// undefined state, and the only recovery is to RESET it or load another file.
+//
+// Bob Armstrong <bob@jfcl.com>   [16-OCT-2026]
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   New file.
+// 16-OCT-26  RLA   Add SyncMapped() and map the file when loading.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#pragma once
+#include <stdint.h>             // uint8_t, int32_t, and much more ...
+#include <stdio.h>              // FILE, fopen(), etc ...
+#include <string>               // C++ std::string class, et al ...
+#include <vector>               // C++ std::vector template
+#include <map>                  // C++ std::map template
+#include <type_traits>          // std::is_integral, std::is_enum, etc ...
+using std::string;              // ...
+using std::vector;              // ...
+using std::map;                 // ...
+class CEventHandler;            // we need pointers to event handlers
+
+// Standard extension for state files ...
+#define DEFAULT_STATE_FILE_TYPE     ".state"
+
+
+class CStateFile {
+  //++
+  // Save or load a machine state snapshot ...
+  //--
+
+  // Magic numbers ...
+public:
+  enum {
+    VERSION       = 2,          // current state file format version
+    MAP_ALIGNMENT = 65536,      // file alignment for SyncMapped() blocks
+  };
+
+  // Constructor and destructor ...
+public:
+  CStateFile (const char *pszMachine, bool fLoading);
+  virtual ~CStateFile();
+private:
+  // Disallow copy and assignments!
+  CStateFile (const CStateFile&) = delete;
+  CStateFile& operator= (CStateFile const&) = delete;
+
+  // Properties ...
+public:
+  inline bool IsLoading() const {return m_fLoading;}
+  inline bool IsSaving() const {return !m_fLoading;}
+  // Return TRUE if no errors have occurred ...
+  inline bool IsOK() const {return m_sError.empty();}
+  // Return the first error message (or an empty string if none) ...
+  inline string GetError() const {return m_sError;}
+  //   Report an error.  Only the first error is remembered, and after that
+  // all Sync() calls do nothing.
+  void Error (const string &sMessage);
+
+  //   Write the whole state to a file (after everything has been saved),
+  // or read the whole state from a file (before anything is loaded) ...
+public:
+  bool Write (const string &sFileName);
+  bool Read (const string &sFileName);
+
+  //   Save or load one object in a named section.  Any object will do so long
+  // as it has a SyncState(CStateFile &) method, and if it's an event handler
+  // then it's remembered for SyncEvents() too.
+public:
+  template <class T> void Sync (const char *pszSection, T *pObject)
+    {if (BeginSection(pszSection)) {pObject->SyncState(*this);  EndSection();  AddHandler(pObject);}}
+  bool BeginSection (const char *pszSection);
+  void EndSection();
+
+  //   Save or load any integer, bool or enum (but not pointers!), or a fixed
+  // size array of them.  These always use the size of the variable, so be
+  // careful - a uint16_t isn't the same as an address_t!
+public:
+  template <typename T> void Sync (T &x)
+  {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "CStateFile::Sync() needs an integer type");
+    uint64_t q = (uint64_t) x;  SyncInteger(q, sizeof(T));
+    if (IsLoading()) x = (T) q;
+  }
+  template <typename T, size_t N> void Sync (T (&a)[N])
+    {for (size_t i = 0;  i < N;  ++i) Sync(a[i]);}
+  // Save or load a string ...
+  void Sync (string &s);
+  // Save or load a block of bytes (e.g. memory contents or a buffer) ...
+  void SyncBytes (void *pData, size_t cbData);
+  //   Save or load a page aligned block that can be mapped copy-on-write.
+  // When loading this returns either a new mapping of the file, which the
+  // caller now owns and must free with UnmapBytes(), or pData if the block
+  // couldn't be mapped and was copied into pData instead.
+  void *SyncMapped (void *pData, size_t cbData);
+  static void UnmapBytes (void *pData, size_t cbData);
+  //   Verify that a configuration value (e.g. a memory size) is the same as it
+  // was when the state was saved.  The value is never changed!
+  void Verify (uint64_t qValue, const char *pszWhat);
+
+  // Event handlers ...
+public:
+  //   Remember an event handler by name.  Anything that's not an event handler
+  // picks the second overload, which does nothing.
+  void AddHandler (CEventHandler *pHandler);
+  inline void AddHandler (const void *) {}
+  // Find an event handler by name (NULL if none) ...
+  CEventHandler *FindHandler (const string &sName) const;
+
+  // Private methods ...
+private:
+  void SyncInteger (uint64_t &q, size_t cb);
+  bool Get (void *pData, size_t cb);
+  // Return the padding needed to align offset cb to MAP_ALIGNMENT ...
+  static inline size_t PadLength (size_t cb)
+    {return (MAP_ALIGNMENT - (cb % MAP_ALIGNMENT)) % MAP_ALIGNMENT;}
+
+  // Private member data ...
+private:
+  string          m_sMachine;     // machine name (e.g. "SBCT11")
+  bool            m_fLoading;     // TRUE if loading, FALSE if saving
+  string          m_sError;       // first error message, if any
+  vector<uint8_t> m_abData;       // the entire state file (when saving)
+  FILE           *m_pFile;        // state file handle (when loading)
+  const uint8_t  *m_pbFile;       // state file contents (when loading)
+  size_t          m_cbFile;       // size of the file (when loading)
+  bool            m_fFileMapped;  // TRUE if m_pbFile is mapped
+  size_t          m_cbNext;       // next byte to read (when loading)
+  size_t          m_cbSection;    // start of the current section
+  string          m_sSection;     // name of the current section
+  map<string, CEventHandler *> m_Handlers;  // event handlers by name
+};
@@ -57,6 +57,7 @@
 // REVISION HISTORY:
 // 17-DEC-23  RLA   New file.
 //  6-NOV-24  RLA   Add Find(pInterrupt) ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -74,6 +75,7 @@
 #include "DeviceMap.hpp"        // CDeviceMap declaration
 #include "CPU.hpp"              // CCPU base class definitions
 #include "COSMAC.hpp"           // COSMAC 1802 CPU specific declarations
+#include "StateFile.hpp"        // CStateFile declarations
 #include "TLIO.hpp"             // declarations for this module
 
 
@@ -438,3 +440,14 @@ void CTLIO::ShowDevice (ostringstream& ofs) const
     ofs << FormatString("Two level I/O disabled\n");
 }
 
+
+void CTLIO::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the enable and the group select register.  The devices in
+  // each group are saved separately, so there's nothing else to do here ...
+  //--
+  State.Sync(m_fTLIOenabled);  State.Sync(m_nGroupSelect);
+  if (State.IsLoading())
+    m_pCurrentGroup = FindGroup(IsTLIOenabled() ? m_nGroupSelect : DEFAULT_GROUP);
+}
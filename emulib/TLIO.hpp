@@ -22,6 +22,7 @@
 // REVISION HISTORY:
 // 17-DEC-23  RLA   New file.
 //  6-NOV-24  RLA   Add Find(pInterrupt) ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>
@@ -119,6 +120,8 @@ public:
   virtual void SetFlag (address_t nFlag, uint1_t bData) override;
   // Dump the device state for the user ...
   virtual void ShowDevice (ostringstream &ofs) const override;
+  // Save or load the group selection ...
+  virtual void SyncState (CStateFile &State) override;
 
   // Private methods ...
 private:
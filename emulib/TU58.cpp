@@ -101,6 +101,7 @@
 //                  Change Write() to RawWrite().
 // 30-AUG-22  RLA   Convert memcpy_s() to memcpy() for Linux compatibility.
 //  5-MAR-25  RLA   Add Enable() to "disconnect" the TU58 drive.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -115,6 +116,7 @@
 #include "ImageFile.hpp"        // image file methods
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "ConsoleWindow.hpp"    // console window functions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "TU58.hpp"             // declarations for this module
 
 
@@ -939,3 +941,35 @@ string CTU58::CommandToString (uint8_t bCommand)
     default:                return "???";
   }
 }
+
+void CTU58::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the RSP protocol state, the sector buffer, and the names of
+  // the attached image files.  The TU58 isn't a CDevice - it's attached to a
+  // serial port instead - but it has plenty of state just the same.  As with
+  // IDE disks, the image file contents are NOT saved!
+  //--
+  State.Verify(m_nUnits, "number of units");
+  for (uint8_t nUnit = 0;  nUnit < m_nUnits;  ++nUnit) {
+    string sFileName = IsAttached(nUnit) ? GetFileName(nUnit) : "";
+    bool fReadOnly = IsAttached(nUnit) && IsReadOnly(nUnit);
+    State.Sync(sFileName);  State.Sync(fReadOnly);
+    if (State.IsLoading() && State.IsOK()
+     && (sFileName != (IsAttached(nUnit) ? GetFileName(nUnit) : ""))) {
+      Detach(nUnit);
+      if (!sFileName.empty() && !Attach(nUnit, sFileName, fReadOnly))
+        State.Error(FormatString("TU58 unit %d unable to attach %s", nUnit, sFileName.c_str()));
+    }
+  }
+  State.Sync(m_fEnabled);  State.Sync(m_nState);
+  State.Sync(m_RSPbuffer.bFlag);  State.Sync(m_RSPbuffer.bCount);
+  State.Sync(m_RSPbuffer.abData);
+  State.Sync(m_RSPcommand.bOpcode);  State.Sync(m_RSPcommand.bModifier);
+  State.Sync(m_RSPcommand.bUnit);  State.Sync(m_RSPcommand.bSwitches);
+  State.Sync(m_RSPcommand.wSequence);  State.Sync(m_RSPcommand.wCount);
+  State.Sync(m_RSPcommand.wBlock);
+  State.Sync(m_cbRSPpacket);  State.Sync(m_bChecksumH);  State.Sync(m_bChecksumL);
+  State.Sync(m_cbTransfer);  State.Sync(m_wCurrentBlock);  State.Sync(m_cbSector);
+  State.SyncBytes(m_abSector, sizeof(m_abSector));
+}
@@ -23,6 +23,7 @@
 //
 // REVISION HISTORY:
 // 22-JAN-20  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -34,6 +35,7 @@
 using std::string;              // ...
 using std::iterator;            // ...
 using std::vector;              // ...
+class CStateFile;               // ...
 
 
 class CTU58 : public CVirtualConsole {
@@ -153,6 +155,8 @@ public:
   void DetachAll();
   // Display drive status for debugging ...
   void ShowDevice (ostringstream &ofs) const;
+  // Save or load the drive state ...
+  void SyncState (CStateFile &State);
   // Return TRUE if the drive is attached (online) ...
   bool IsAttached (uint8_t nUnit) const
     {assert(nUnit < m_nUnits);  return m_Images[nUnit]->IsOpen();}
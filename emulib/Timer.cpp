@@ -47,6 +47,7 @@
 //
 // REVISION HISTORY:
 //  3-JUL-23  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -60,6 +61,7 @@
 #include "MemoryTypes.h"        // address_t and word_t data types
 #include "EventQueue.hpp"       // CEventQueue declarations
 #include "CPU.hpp"              // needed for HZTONS and NSTOHZ ...
+#include "StateFile.hpp"        // CStateFile declarations
 #include "Timer.hpp"            // declarations for this module
 
 
@@ -172,3 +174,16 @@ void CTimer::Show (ostringstream &ofs) const
   ofs << FormatString("\tEnabled=%d, Frozen=%d, IEN=%d, Period=%uns (%uHz)\n",
     m_fEnabled, m_fFreeze, m_fIEN, m_lPeriod, NSTOHZ(m_lPeriod));
 }
+
+void CTimer::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the timer registers.  A running timer has an event pending,
+  // and since we're an event handler (but not a device, and not in a section
+  // of our own) we have to tell the state file about ourselves.
+  //--
+  State.Sync(m_nMode);  State.Sync(m_fEnabled);  State.Sync(m_fFreeze);
+  State.Sync(m_wJam);  State.Sync(m_wCount);  State.Sync(m_wHold);
+  State.Sync(m_lPeriod);  State.Sync(m_fIEN);
+  State.AddHandler(this);
+}
@@ -9,6 +9,7 @@
 //
 // REVISION HISTORY:
 //  3-JUL-23  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -119,6 +120,8 @@ public:
   bool IsEnabled() const {return m_fEnabled;}
   // Show the timer status ...
   virtual void Show(ostringstream &ofs) const;
+  // Save or load the timer state ...
+  void SyncState (CStateFile &State);
   static string ModeToString (TIMER_MODE nMode);
 
   // Local methods ...
@@ -36,6 +36,7 @@
 // 20-NOV-23  RLA   Rewrite the code at ReceiverReady() to always poll for ^E
 // 16-DEC-23  RLA   Add text & XMODEM speeds to ShowDevice()
 // 10-MAR-24  RLA   Add received break support
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -50,6 +51,7 @@
 #include "MemoryTypes.h"        // address_t and word_t data types
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "UART.hpp"             // declarations for this module
 
 
@@ -201,3 +203,13 @@ void CUART::ShowDevice (ostringstream &ofs) const
     ofs << std::endl;
   }
 }
+
+void CUART::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the generic UART timing and break state.  Any character
+  // in progress, and the next receiver poll, are saved as events ...
+  //--
+  State.Sync(m_llCharacterTime);  State.Sync(m_llPollingInterval);
+  State.Sync(m_llBreakTime);  State.Sync(m_fReceivingBreak);
+}
@@ -26,6 +26,7 @@
 //  6-FEB-20  RLA   New file (adapted from the old implementation)
 // 17-JUN-23  RLA   Add Signetics 2651
 // 10-MAR-24  RLA   Add received break support
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -102,6 +103,7 @@ public:
   virtual void ClearDevice() override;
   virtual void EventCallback (intptr_t lParam) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // These methods need to be provided by the specific UART implementation ...
   virtual void UpdateRBR (uint8_t bData) {};
@@ -32,6 +32,7 @@
 //                  Add console break handling.  Add IsConsoleBreak() ...
 //                  Change existing RS232 break functions to "...SerialBreak(...)"
 // 10-MAR-24  RLA   Add ReceiveSerialBreak() function.
+// 16-OCT-26  RLA   Add IsInputPending() ...
 //--
 #pragma once
 #include <string>               // C++ std::string class, et al ...
@@ -70,6 +71,8 @@ public:
   // Send or receive raw data to or from the serial port or console window ...
   virtual int32_t RawRead (uint8_t *pabBuffer, size_t cbBuffer, uint32_t lTimeout=0) = 0;
   virtual void RawWrite (const char *pabBuffer, size_t cbBuffer) = 0;
+  // Return TRUE if there's input waiting that hasn't been read yet ...
+  virtual bool IsInputPending() {return false;}
 
   //   FYI - the word "break" is used to mean two different things here.  A
   // "serial break" refers to the RS232 long space condition.  This is used by
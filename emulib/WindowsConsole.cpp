@@ -86,6 +86,7 @@
 // 20-NOV-23  RLA   Add keyboard buffer and make IsConsoleBreak() read ahead
 //                  DON'T call RawWrite() from Write() ...
 // 10-MAR-24  RLA   Add Serial Break functions for RCA MS2000.
+// 16-OCT-26  RLA   Add IsInputPending() ...
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -791,6 +792,19 @@ int32_t CConsoleWindow::ReadKey (uint8_t &bData, uint32_t lTimeout)
   }
 }
 
+bool CConsoleWindow::IsInputPending()
+{
+  //++
+  //   Return TRUE if there are any keystrokes waiting that haven't been read
+  // by RawRead() yet.  Like IsConsoleBreak(), this reads ahead and stuffs
+  // anything it finds into the keyboard buffer.  The CPU uses this to decide
+  // whether it's safe to warp ahead thru an idle loop.
+  //--
+  uint8_t bData;
+  while (ReadKey(bData, 0) > 0) m_KeyBuffer.Put(bData);
+  return !m_KeyBuffer.IsEmpty();
+}
+
 bool CConsoleWindow::IsConsoleBreak (uint32_t lTimeout)
 {
   //++
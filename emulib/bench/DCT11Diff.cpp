@@ -0,0 +1,242 @@
+//++
+// DCT11Diff.cpp -> differential test of the DCT11 opcode dispatch table
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   This program checks that the table driven SBCT11 DCT11 emulation behaves
+// exactly the same as the switch statement version that it replaced.  It
+// builds two complete, independent, SBCT11 memory systems - each one with its
+// own event queue, PIC, RAM, EPROM, MCR and memory map - and puts the current
+// CDCT11 on one and the frozen CDCT11ref (see DCT11ref.cpp) on the other.
+//
+//   Then, starting from a random machine state (random RAM, EPROM, registers
+// and PSW), it executes every one of the 65536 possible opcodes as a single
+// instruction on both CPUs and compares the results - all the registers, the
+// PSW, the stop code, the simulated time taken, and every byte of RAM.  Any
+// difference at all is a failure.  The RAM and registers are reset to the same
+// random state before each opcode, and the whole thing is repeated for several
+// different random states.
+//
+//   The only opcode that's skipped is WAIT (000001) - with no devices there
+// are no events and no interrupts, so WAIT would never finish on either CPU.
+//
+//   The random number seed can be given on the command line, and the same seed
+// always produces the same test.
+//
+// Bob Armstrong <bob@jfcl.com>   [16-OCT-2026]
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   New file.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#include <stdlib.h>             // exit(), system(), etc ...
+#include <stdint.h>             // uint8_t, uint32_t, etc ...
+#include <stdio.h>              // printf(), etc ...
+#include <string.h>             // memcmp(), memcpy(), etc ...
+#include <assert.h>             // assert() (what else??)
+#include "EMULIB.hpp"           // emulator library definitions
+#include "LogFile.hpp"          // emulator library message logging facility
+#include "sbct11.hpp"           // SBCT11 addresses (MEMCSR, etc)
+#include "EventQueue.hpp"       // I/O device event queue simulation
+#include "MemoryTypes.h"        // address_t, word_t, etc ...
+#include "Memory.hpp"           // main memory emulation
+#include "Device.hpp"           // CDevice I/O device emulation objects
+#include "DeviceMap.hpp"        // CDeviceMap memory mapped I/O emulation
+#include "MemoryMap.hpp"        // SBCT11 memory mapping hardware
+#include "Interrupt.hpp"        // interrupt simulation logic
+#include "CPU.hpp"              // CCPU base class definitions
+#include "PIC11.hpp"            // DCT11 interrupt emulation
+#include "DCT11.hpp"            // DCT11 CPU emulation (the one being tested)
+#include "DCT11ref.hpp"         // the frozen reference DCT11 emulation
+
+// Test parameters ...
+#define MEMSIZE     65536UL     // size of both RAM and EPROM, in bytes
+#define STATES      4           // number of random states to test
+#define MAXREPORT   20          // maximum mismatches to report per state
+#define OP_WAIT     0000001     // the PDP11 WAIT opcode
+
+
+//   This is the "xorshift" pseudo random number generator.  We don't use
+// rand() because we want the same seed to give the same test everywhere ...
+static uint64_t g_qRandom = 1;
+static uint32_t Random()
+{
+  g_qRandom ^= g_qRandom << 13;  g_qRandom ^= g_qRandom >> 7;  g_qRandom ^= g_qRandom << 17;
+  return (uint32_t) (g_qRandom >> 16);
+}
+
+
+template <class T11>
+class CTestSystem {
+  //++
+  //   One complete SBCT11 CPU and memory system, minus all the I/O devices
+  // except for the MCR.  T11 is the DCT11 emulation to use ...
+  //--
+
+public:
+  CTestSystem() {
+    m_pEvents = DBGNEW CEventQueue();
+    m_pPIC = DBGNEW CPIC11();
+    m_pRAM = DBGNEW CGenericMemory(MEMSIZE);  m_pRAM->SetRAM();
+    m_pROM = DBGNEW CGenericMemory(MEMSIZE);  m_pROM->SetROM();
+    m_pIOpage = DBGNEW CDeviceMap();
+    m_pMCR = DBGNEW CMemoryControl(MEMCSR);
+    m_pIOpage->Install(m_pMCR);
+    m_pMap = DBGNEW CMemoryMap(m_pRAM, m_pROM, m_pIOpage, m_pMCR);
+    m_pCPU = DBGNEW T11(T11::MODE_172000, m_pMap, m_pEvents, m_pPIC);
+  }
+  ~CTestSystem() {
+    delete m_pCPU;  delete m_pMap;  delete m_pMCR;  delete m_pIOpage;
+    delete m_pROM;  delete m_pRAM;  delete m_pPIC;  delete m_pEvents;
+  }
+private:
+  // Disallow copy and assignments!
+  CTestSystem (const CTestSystem&) = delete;
+  CTestSystem& operator= (CTestSystem const &) = delete;
+
+public:
+  // Load the EPROM, which never changes after this ...
+  void LoadROM (const word_t *pImage) {
+    for (uint32_t a = 0;  a < MEMSIZE;  ++a)  m_pROM->UIwrite(a, pImage[a]);
+  }
+  //   Restore the RAM to the original image, but only copy the pages that the
+  // last instruction actually changed ...
+  void RestoreRAM (const word_t *pImage) {
+    for (uint32_t a = 0;  a < MEMSIZE;  a += CMemory::PAGE_SIZE) {
+      word_t *pPage = m_pRAM->GetWritePage(a);
+      if (memcmp(pPage, pImage+a, CMemory::PAGE_SIZE*sizeof(word_t)) != 0)
+        memcpy(pPage, pImage+a, CMemory::PAGE_SIZE*sizeof(word_t));
+    }
+  }
+  //   Reset everything to the initial state, store the opcode at the PC and
+  // then execute exactly one instruction.  Return the stop code and the
+  // simulated time it took ...
+  CCPU::STOP_CODE Step (const word_t *pImage, const uint16_t *pwRegisters, uint16_t wOpcode, uint64_t &qTime) {
+    RestoreRAM(pImage);
+    m_pMCR->PowerOn();
+    m_pMCR->DevWrite(MEMCSR+CMemoryControl::MEMC, CMemoryControl::MEMC_RAM);
+    m_pCPU->MasterClear();
+    for (cpureg_t r = 0;  r <= T11::REG_PSW;  ++r)  m_pCPU->SetRegister(r, pwRegisters[r]);
+    address_t aPC = pwRegisters[T11::REG_PC];
+    m_pRAM->UIwrite(aPC, LOBYTE(wOpcode));  m_pRAM->UIwrite(aPC+1, HIBYTE(wOpcode));
+    uint64_t qStart = m_pEvents->CurrentTime();
+    CCPU::STOP_CODE nStop = m_pCPU->Run(1);
+    qTime = m_pEvents->CurrentTime() - qStart;
+    return nStop;
+  }
+
+  // Other public properties ...
+public:
+  T11 *GetCPU() const {return m_pCPU;}
+  CGenericMemory *GetRAM() const {return m_pRAM;}
+
+  // Private member data...
+private:
+  CEventQueue    *m_pEvents;    // this system's event queue
+  CPIC11         *m_pPIC;       // interrupt controller (always idle)
+  CGenericMemory *m_pRAM;       // 64K bytes of RAM
+  CGenericMemory *m_pROM;       //  "   "    "  EPROM
+  CDeviceMap     *m_pIOpage;    // I/O page (only the MCR)
+  CMemoryControl *m_pMCR;       // MEMC/NXMCS registers
+  CMemoryMap     *m_pMap;       // SBCT11 memory mapping hardware
+  T11            *m_pCPU;       // and the CPU being tested
+};
+
+
+static unsigned TestState (CTestSystem<CDCT11> &New, CTestSystem<CDCT11ref> &Ref, unsigned nState)
+{
+  //++
+  //   Generate a random machine state and then execute every opcode on both
+  // CPUs, starting from that state.  Return the number of opcodes that gave
+  // different results ...
+  //--
+  static word_t abRAM[MEMSIZE], abROM[MEMSIZE];
+  for (size_t i = 0;  i < MEMSIZE;  ++i)  abRAM[i] = (word_t) Random();
+  for (size_t i = 0;  i < MEMSIZE;  ++i)  abROM[i] = (word_t) Random();
+  New.LoadROM(abROM);  Ref.LoadROM(abROM);
+
+  //   Random registers and PSW, except that the PC has to be even and it has
+  // to point to RAM so that we can put the opcode there ...
+  uint16_t awRegisters[CDCT11::REG_PSW+1];
+  for (cpureg_t r = 0;  r < CDCT11::REG_PSW;  ++r)  awRegisters[r] = (uint16_t) Random();
+  awRegisters[CDCT11::REG_PC] &= 0167776;
+  awRegisters[CDCT11::REG_PSW] = Random() & 0377;
+  printf("state %u: PC=%06o SP=%06o PSW=%03o ... ", nState,
+    awRegisters[CDCT11::REG_PC], awRegisters[CDCT11::REG_SP], awRegisters[CDCT11::REG_PSW]);
+  fflush(stdout);
+
+  unsigned nErrors = 0;
+  for (uint32_t nOpcode = 0;  nOpcode <= 0177777;  ++nOpcode) {
+    if (nOpcode == OP_WAIT) continue;
+    uint64_t qNewTime, qRefTime;
+    CCPU::STOP_CODE nNewStop = New.Step(abRAM, awRegisters, (uint16_t) nOpcode, qNewTime);
+    CCPU::STOP_CODE nRefStop = Ref.Step(abRAM, awRegisters, (uint16_t) nOpcode, qRefTime);
+
+    // Compare everything and describe the first difference ...
+    char szWhy[80];  szWhy[0] = '\0';
+    if (nNewStop != nRefStop)
+      sprintf_s(szWhy, sizeof(szWhy), "stop code %d vs %d", nNewStop, nRefStop);
+    else if (qNewTime != qRefTime)
+      sprintf_s(szWhy, sizeof(szWhy), "time %llu vs %llu", (unsigned long long) qNewTime, (unsigned long long) qRefTime);
+    for (cpureg_t r = 0;  (r <= CDCT11::REG_PSW) && (szWhy[0] == '\0');  ++r) {
+      uint16_t wNew = New.GetCPU()->GetRegister(r), wRef = Ref.GetCPU()->GetRegister(r);
+      if (wNew != wRef)
+        sprintf_s(szWhy, sizeof(szWhy), "register %u %06o vs %06o", r, wNew, wRef);
+    }
+    for (uint32_t a = 0;  (a < MEMSIZE) && (szWhy[0] == '\0');  a += CMemory::PAGE_SIZE) {
+      const word_t *pNew = New.GetRAM()->GetReadPage(a), *pRef = Ref.GetRAM()->GetReadPage(a);
+      if (memcmp(pNew, pRef, CMemory::PAGE_SIZE*sizeof(word_t)) == 0) continue;
+      address_t o = 0;
+      while (pNew[o] == pRef[o])  ++o;
+      sprintf_s(szWhy, sizeof(szWhy), "RAM %06o %03o vs %03o", a+o, pNew[o], pRef[o]);
+    }
+    if (szWhy[0] == '\0') continue;
+    if (nErrors++ == 0) printf("\n");
+    if (nErrors <= MAXREPORT)  printf("  MISMATCH opcode %06o - %s\n", nOpcode, szWhy);
+  }
+
+  if (nErrors == 0)
+    printf("all opcodes match\n");
+  else
+    printf("  %u opcodes differ\n", nErrors);
+  return nErrors;
+}
+
+
+int main (int argc, char *argv[])
+{
+  //++
+  //   Build the two systems and test them both with several random states.
+  // The optional argument is the random number seed ...
+  //--
+  CLog *pLog = DBGNEW CLog("dct11diff", NULL);
+  pLog->SetDefaultConsoleLevel(CLog::ERROR);
+  if (argc > 1) g_qRandom = strtoull(argv[1], NULL, 0);
+  if (g_qRandom == 0) g_qRandom = 1;
+  printf("DCT11 dispatch table vs reference, seed %llu\n", (unsigned long long) g_qRandom);
+
+  CTestSystem<CDCT11> *pNew = DBGNEW CTestSystem<CDCT11>();
+  CTestSystem<CDCT11ref> *pRef = DBGNEW CTestSystem<CDCT11ref>();
+  unsigned nErrors = 0;
+  for (unsigned nState = 1;  nState <= STATES;  ++nState)
+    nErrors += TestState(*pNew, *pRef, nState);
+
+  delete pNew;  delete pRef;
+  delete pLog;
+  return (nErrors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+//++
+// EventQueueBench.cpp -> compare the event queue heap with the old linked list
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   This little program runs the same synthetic workload on the real
+// CEventQueue, which is a binary heap (or a sorted list, when it's small),
+// and on CListQueue, which is a copy of the sorted linked list that
+// CEventQueue used to be (see ListQueue.cpp).  It prints the host time per
+// event executed for each, for several different numbers of event handlers.
+// Each workload is run RUNS times, alternating between the two queues, and
+// the best time for each is used.  That way a burst of activity from some
+// other program on the host doesn't make one queue or the other look bad.
+//
+//   The workload is meant to look like a typical emulated machine.  Every
+// handler reschedules itself each time it fires, just like a UART polling
+// for input or a line time clock, and every fourth time it also cancels and
+// reschedules a longer "timeout" event, like a disk or a serial transmitter
+// that gets restarted.  Each handler uses a different delay so that the
+// events are well mixed in the queue.
+//
+//   Note that both queues execute exactly the same events in exactly the same
+// order, and the program checks that by comparing the final simulated time
+// and the total number of callbacks.
+//
+// Bob Armstrong <bob@jfcl.com>   [16-OCT-2026]
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   New file.
+// 16-OCT-26  RLA   Move CListQueue to ListQueue.cpp and take the best of RUNS.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#include <stdlib.h>             // exit(), system(), etc ...
+#include <stdint.h>             // uint8_t, uint32_t, etc ...
+#include <stdio.h>              // printf(), etc ...
+#include <assert.h>             // assert() (what else??)
+#include <chrono>               // steady_clock for timing
+#include <vector>               // C++ std::vector template
+#include <algorithm>            // std::min()
+#include "EMULIB.hpp"           // emulator library definitions
+#include "LogFile.hpp"          // emulator library message logging facility
+#include "EventQueue.hpp"       // the real (heap) event queue
+#include "ListQueue.hpp"        // and the old linked list, for comparison
+using std::vector;              // ...
+
+// Benchmark parameters ...
+#define EVENTS      2000000UL   // number of events to execute for each test
+#define BASE_DELAY  1000ULL     // shortest handler delay, in nanoseconds
+#define RUNS        9           // number of times to run each workload
+
+
+template <class Q> class CBenchHandler : public CEventHandler {
+  //++
+  //   A handler that reschedules itself every time it fires, and every fourth
+  // time also restarts a timeout event (lParam 1).  The timeout is always
+  // cancelled before it fires, so only lParam 0 events are ever executed.
+  //--
+public:
+  CBenchHandler (Q *pEvents, uint64_t qDelay, uint64_t *pqTotal)
+    : m_pEvents(pEvents), m_qDelay(qDelay), m_qCallbacks(0), m_pqTotal(pqTotal) {}
+  virtual void EventCallback (intptr_t lParam) override
+  {
+    assert(lParam == 0);
+    m_pEvents->Schedule(this, 0, m_qDelay);  ++*m_pqTotal;
+    if ((++m_qCallbacks & 3) == 0) {
+      m_pEvents->Cancel(this, 1);  m_pEvents->Schedule(this, 1, 100*m_qDelay);
+    }
+  }
+private:
+  Q        *m_pEvents;          // the queue we're using
+  uint64_t  m_qDelay;           // our rescheduling delay
+  uint64_t  m_qCallbacks;       // number of times we've been called
+  uint64_t *m_pqTotal;          // total callbacks for all handlers
+};
+
+
+template <class Q> static double RunWorkload (unsigned nHandlers, uint64_t &qEndTime, uint64_t &qCallbacks)
+{
+  //++
+  //   Create nHandlers handlers on a new queue of type Q, start them all, and
+  // then jump from one event to the next until EVENTS callbacks have been
+  // executed.  Return the host time per event in nanoseconds ...
+  //--
+  Q *pEvents = DBGNEW Q();
+  vector<CBenchHandler<Q> *> vHandlers;  uint64_t qDone = 0;
+  for (unsigned i = 0;  i < nHandlers;  ++i) {
+    CBenchHandler<Q> *pHandler = DBGNEW CBenchHandler<Q>(pEvents, BASE_DELAY + 37*i, &qDone);
+    vHandlers.push_back(pHandler);  pEvents->Schedule(pHandler, 0, i+1);
+  }
+
+  auto tStart = std::chrono::steady_clock::now();
+  while (qDone < EVENTS) {
+    pEvents->JumpAhead(pEvents->NextEvent());  pEvents->DoEvents();
+  }
+  auto tEnd = std::chrono::steady_clock::now();
+
+  qEndTime = pEvents->CurrentTime();  qCallbacks = qDone;
+  //   Delete the queue BEFORE the handlers - that's the order that used to
+  // write into freed memory ...
+  delete pEvents;
+  for (unsigned i = 0;  i < nHandlers;  ++i) delete vHandlers[i];
+  double dNanoseconds = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(tEnd - tStart).count();
+  return dNanoseconds / (double) qDone;
+}
+
+
+int main (int argc, char *argv[])
+{
+  //++
+  // Run the workload on both queues with several different handler counts ...
+  //--
+  CLog *pLog = DBGNEW CLog("evbench", NULL);
+  pLog->SetDefaultConsoleLevel(CLog::WARNING);
+  static const unsigned anHandlers[] = {2, 8, 32, 128};
+  bool fOK = true;
+
+  printf("%-10s %14s %14s %10s\n", "handlers", "list ns/event", "heap ns/event", "speedup");
+  for (unsigned nHandlers : anHandlers) {
+    uint64_t qListTime, qListCallbacks, qHeapTime, qHeapCallbacks;
+    double dList = RunWorkload<CListQueue>(nHandlers, qListTime, qListCallbacks);
+    double dHeap = RunWorkload<CEventQueue>(nHandlers, qHeapTime, qHeapCallbacks);
+    for (unsigned i = 1;  i < RUNS;  ++i) {
+      dList = std::min(dList, RunWorkload<CListQueue>(nHandlers, qListTime, qListCallbacks));
+      dHeap = std::min(dHeap, RunWorkload<CEventQueue>(nHandlers, qHeapTime, qHeapCallbacks));
+    }
+    printf("%-10u %14.1f %14.1f %9.2fx\n", nHandlers, dList, dHeap, dList/dHeap);
+    if ((qListTime != qHeapTime) || (qListCallbacks != qHeapCallbacks)) {
+      printf("  MISMATCH - list ended at %llu after %llu events, heap at %llu after %llu\n",
+        (unsigned long long) qListTime, (unsigned long long) qListCallbacks,
+        (unsigned long long) qHeapTime, (unsigned long long) qHeapCallbacks);
+      fOK = false;
+    }
+  }
+
+  delete pLog;
+  return fOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+//++
+// ListQueue.cpp -> the old sorted linked list event queue, for EventQueueBench
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   This is the implementation of CListQueue, a copy of the event queue as it
+// was before it was converted to a heap (including its calls to LOGF(), so
+// the comparison is fair).  Please don't "fix" or improve anything here - the
+// whole point is that it doesn't change!
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   Split from EventQueueBench.cpp.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#include <stdlib.h>             // exit(), system(), etc ...
+#include <stdint.h>             // uint8_t, uint32_t, etc ...
+#include <assert.h>             // assert() (what else??)
+#include "EMULIB.hpp"           // emulator library definitions
+#include "LogFile.hpp"          // emulator library message logging facility
+#include "EventQueue.hpp"       // CEventHandler declarations
+#include "ListQueue.hpp"        // declarations for this module
+
+
+CListQueue::~CListQueue()
+{
+  //++
+  // Free all the event blocks, both active and free ...
+  //--
+  while (m_pNextEvent != NULL) {
+    LIST_EVENT *p = m_pNextEvent;  m_pNextEvent = p->pNext;  delete p;
+  }
+  while (m_pFreeEvents != NULL) {
+    LIST_EVENT *p = m_pFreeEvents;  m_pFreeEvents = p->pNext;  delete p;
+  }
+}
+
+void CListQueue::Schedule (CEventHandler *pHandler, intptr_t lParam, uint64_t qDelay)
+{
+  //++
+  // Allocate an event block and insertion sort it into the list ...
+  //--
+  LIST_EVENT *pEvent, *pLast, *pThis;
+  if (m_pFreeEvents != NULL) {
+    pEvent = m_pFreeEvents;  m_pFreeEvents = pEvent->pNext;
+  } else
+    pEvent = DBGNEW LIST_EVENT;
+  pEvent->pHandler = pHandler;  pEvent->lParam = lParam;
+  pEvent->qTime = m_qCurrentTime + qDelay;  pEvent->pNext = NULL;
+  if (pEvent->qTime == 0) pEvent->qTime = 1;
+  LOGF(TRACE, "Scheduled event #%d for %s at %lld", lParam, pHandler->EventName(), pEvent->qTime);
+  if ((m_pNextEvent == NULL) || (pEvent->qTime < m_pNextEvent->qTime)) {
+    pEvent->pNext = m_pNextEvent;  m_pNextEvent = pEvent;
+    m_qNextEvent = pEvent->qTime;
+  } else {
+    pLast = m_pNextEvent;  pThis = pLast->pNext;
+    while ((pThis != NULL) && (pEvent->qTime >= pThis->qTime))
+      pLast = pThis, pThis = pThis->pNext;
+    pEvent->pNext = pLast->pNext;  pLast->pNext = pEvent;
+  }
+}
+
+void CListQueue::Cancel (CEventHandler *pHandler, intptr_t lParam)
+{
+  //++
+  // Search the whole list and remove any matching events ...
+  //--
+  LIST_EVENT *pThis = m_pNextEvent, *pLast = NULL, *pFree;
+  LOGF(TRACE, "Cancelling all events #%d for %s", lParam, pHandler->EventName());
+  while (pThis != NULL) {
+    if ((pThis->pHandler != pHandler) || (pThis->lParam != lParam)) {
+      pLast = pThis;  pThis = pThis->pNext;
+    } else if (pLast == NULL) {
+      pFree = pThis;  m_pNextEvent = pThis->pNext;  pThis = pThis->pNext;
+      pFree->pNext = m_pFreeEvents;  m_pFreeEvents = pFree;
+      m_qNextEvent = (m_pNextEvent == NULL) ? 0 : m_pNextEvent->qTime;
+    } else {
+      pFree = pThis;  pLast->pNext = pThis->pNext;  pThis = pThis->pNext;
+      pFree->pNext = m_pFreeEvents;  m_pFreeEvents = pFree;
+    }
+  }
+}
+
+void CListQueue::DoEvents()
+{
+  //++
+  // Execute every event whose time has come ...
+  //--
+  if ((m_qNextEvent == 0) || (m_qCurrentTime < m_qNextEvent)) return;
+  while ((m_pNextEvent != NULL) && (m_pNextEvent->qTime <= m_qCurrentTime)) {
+    LIST_EVENT *pEvent = m_pNextEvent;  m_pNextEvent = m_pNextEvent->pNext;
+    LOGF(TRACE, "Executing event #%d for %s", pEvent->lParam, pEvent->pHandler->EventName());
+    pEvent->pHandler->EventCallback(pEvent->lParam);
+    pEvent->pNext = m_pFreeEvents;  m_pFreeEvents = pEvent;
+  }
+  m_qNextEvent = (m_pNextEvent == NULL) ? 0 : m_pNextEvent->qTime;
+}
@@ -0,0 +1,70 @@
+//++
+// ListQueue.hpp -> the old sorted linked list event queue, for EventQueueBench
+//
+//   COPYRIGHT (C) 2015-2026 BY SPARE TIME GIZMOS.  ALL RIGHTS RESERVED.
+//
+// LICENSE:
+//    This file is part of the emulator library project.  EMULIB is free
+// software; you may redistribute it and/or modify it under the terms of
+// the GNU Affero General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+//    EMULIB is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License
+// for more details.  You should have received a copy of the GNU Affero General
+// Public License along with EMULIB.  If not, see http://www.gnu.org/licenses/.
+//
+// DESCRIPTION:
+//   THIS IS NOT PART OF ANY EMULATOR!  CListQueue is a copy of the linked list
+// that CEventQueue used to be, before it was converted to a heap, and it's
+// used only by EventQueueBench.cpp as the yardstick.  It lives in a separate
+// translation unit, just like EventQueue.cpp, so that neither one can be
+// inlined into the benchmark loop and the comparison stays fair.
+//
+// REVISION HISTORY:
+// 16-OCT-26  RLA   Split from EventQueueBench.cpp.
+//--
+//000000001111111111222222222233333333334444444444555555555566666666667777777777
+//234567890123456789012345678901234567890123456789012345678901234567890123456789
+#pragma once
+#include <stdint.h>             // uint8_t, uint32_t, etc ...
+#include <assert.h>             // assert() (what else??)
+#include "EventQueue.hpp"       // CEventHandler declarations
+
+
+class CListQueue {
+  //++
+  //   This is the event queue as it was before it was converted to a heap -
+  // a linked list sorted by time, with a free list of event blocks.  Only the
+  // methods that the benchmark needs are here.
+  //--
+
+private:
+  struct LIST_EVENT {
+    uint64_t       qTime;       // simulated time when this event occurs
+    CEventHandler *pHandler;    // handler to call
+    intptr_t       lParam;      // parameter for the handler
+    LIST_EVENT    *pNext;       // next event in the queue, or free list
+  };
+
+public:
+  CListQueue() {m_qCurrentTime = m_qNextEvent = 0;  m_pNextEvent = m_pFreeEvents = NULL;}
+  ~CListQueue();
+
+public:
+  uint64_t CurrentTime() const {return m_qCurrentTime;}
+  uint64_t NextEvent() const {return m_qNextEvent;}
+  uint64_t JumpAhead (uint64_t qTime)
+    {assert(qTime >= m_qCurrentTime);  m_qCurrentTime = qTime;  return m_qCurrentTime;}
+  void Schedule (CEventHandler *pHandler, intptr_t lParam, uint64_t qDelay);
+  void Cancel (CEventHandler *pHandler, intptr_t lParam);
+  void DoEvents();
+
+private:
+  uint64_t    m_qCurrentTime;   // current simulated time
+  uint64_t    m_qNextEvent;     // time of the next event
+  LIST_EVENT *m_pNextEvent;     // list of events, soonest first
+  LIST_EVENT *m_pFreeEvents;    // free event blocks
+};
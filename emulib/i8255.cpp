@@ -14,6 +14,7 @@
 // 11-JUL-22  RLA   Don't forget to update the IRQA/B bits in UpdateInterrupts()!
 //  7-JUL-23  RLA   Change to use CPPI generic PPI base class
 //  7-NOV-24  RLA   Actually make it work (using SBCT11) with the CPPI base class!
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -28,6 +29,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "PPI.hpp"              // generic parallel interface
+#include "StateFile.hpp"        // CStateFile declarations
 #include "i8255.hpp"            // declarations for this module
 
 
@@ -404,3 +406,13 @@ void C8255::ShowDevice (ostringstream &ofs) const
   ofs << FormatString("Port CU %sPUT, CL %sPUT, InputC=0x%02X, OutputC=0x%02x\n",
     (IsInputCU() ? "IN" : "OUT"), (IsInputCL() ? "IN" : "OUT"), m_bInputC, m_bOutputC);
 }
+
+void C8255::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the generic PPI state plus the 8255 mode and status ...
+  //--
+  CPPI::SyncState(State);
+  State.Sync(m_fIEIA);  State.Sync(m_fIEOA);
+  State.Sync(m_bStatus);  State.Sync(m_bMode);
+}
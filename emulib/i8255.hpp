@@ -10,6 +10,7 @@
 //  7-JUL-22  RLA   New file.
 // 10-JUL-22  RLA   Make StrobedOutputX() and InputReadyX() do nothing!
 //  7-JUL-23  RLA   Change to use CPPI generic PPI base class
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -107,6 +108,7 @@ public:
   virtual uint8_t DevRead (address_t nPort);
   virtual void DevWrite (address_t nPort, uint8_t bData);
   virtual void ShowDevice (ostringstream &ofs) const;
+  virtual void SyncState (CStateFile &State);
 
   // Test the 8255 mode register for various conditions ...
 public:
@@ -43,6 +43,7 @@
 #include <assert.h>             // assert() (what else??)
 #include "EMULIB.hpp"           // emulator library definitions
 #include "ConsoleWindow.hpp"    // emulator console window methods
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "ImageFile.hpp"        // emulator library image file methods
 #include "CommandParser.hpp"    // emulator library command line parsing methods
@@ -69,7 +70,7 @@
 // you'll find "extern ..." declarations for them in MS2000.hpp.  Note that they
 // are declared as pointers rather than the actual objects because we want
 // to control the exact order in which they're created and destroyed!
-CConsoleWindow   *g_pConsole    = NULL; // console window object
+CSmartConsole    *g_pConsole    = NULL; // console window object
 CLog             *g_pLog        = NULL; // message logging object (including console!)
 CCmdParser       *g_pParser     = NULL; // command line parser
 // These globals point to the objects being emulated ...
@@ -107,7 +108,7 @@ int main (int argc, char *argv[])
   // object, and after that we create and initialize the log object.  We
   // can't issue any error messages until we done these two things!
   g_pEvents = DBGNEW CEventQueue();
-  g_pConsole = DBGNEW CConsoleWindow();
+  g_pConsole = DBGNEW CSmartConsole(g_pEvents);
   g_pLog = DBGNEW CLog(PROGRAM, g_pConsole);
   g_pLog->SetDefaultConsoleLevel(CLog::WARNING);
 
@@ -134,6 +135,7 @@ int main (int argc, char *argv[])
   g_pMemory->SetROM(ROMBASE, ROMBASE+ROMSIZE-1);
   p_pInterrupt = DBGNEW CSimpleInterrupt();
   g_pCPU = DBGNEW CCOSMAC(g_pMemory, g_pEvents, p_pInterrupt);
+  g_pMemory->SetCPU(g_pCPU);
 
   //   Create the two level I/O controller and attach it to ALL seven CPU I/O
   // instructions plus all four EF inputs.  The Q output, which isn't really
@@ -164,6 +166,8 @@ int main (int argc, char *argv[])
 
   //   Lastly, create the command line parser.  If a startup script was
   // specified on the command line, now is the time to execute it...
+  CStandardUI::g_pCPU = g_pCPU;  g_pCPU->SetWarpConsole(g_pConsole);
+  CStandardUI::g_pConsole = g_pConsole;
   g_pParser = DBGNEW CCmdParser(PROGRAM, CUI::g_aVerbs, &ConfirmExit, g_pConsole);
   if (!CStandardUI::g_sStartupScript.empty())
     g_pParser->OpenScript(CStandardUI::g_sStartupScript);
@@ -173,6 +177,7 @@ int main (int argc, char *argv[])
   // types "EXIT" or "QUIT", the command parser exits and then we shutdown
   // the MS2000 program.
   g_pParser->CommandLoop();
+  CStandardUI::DumpStatistics();
   LOGS(DEBUG, "command parser exited");
 
   // Delete all our global objects.  Once again, the order here is important!
@@ -51,7 +51,7 @@
 // emulated - CPU, memory, switches, display, peripherals, etc.  They're all
 // declared in the MS2000 cpp file and are used by the UI to implement various
 // commands...
-extern class CConsoleWindow   *g_pConsole;    // console window object
+extern class CSmartConsole    *g_pConsole;    // console window object
 extern class CEventQueue      *g_pEvents;     // "to do" list of upcoming eventz
 extern class CCOSMAC          *g_pCPU;        // 1802 COSMAC CPU
 extern class CSimpleInterrupt *p_pInterrupt;  // simple wire-OR interrupt system
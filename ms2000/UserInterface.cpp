@@ -49,6 +49,11 @@
 //      xxxx xx, xx, ...        - deposit several bytes
 //      Rn xxxx                 - deposit in a register
 //
+//   RECO*RD <file>             - record console input and its timing
+//   RECO*RD/CL*OSE             - stop recording console input
+//   REPL*AY <file>             - replay recorded console input
+//   REPL*AY/CL*OSE             - stop replaying console input
+//
 //   SE*T BRE*AKPOINT xxxx      - set breakpoint at address (hex)
 //   CL*EAR BRE*AKPOINT xxxx    - clear   "      "     "       "
 //   SE*T BRE*AKPOINT xxxx-xxxx -  set breakpoint on address range
@@ -146,6 +151,8 @@
 // 
 // REVISION HISTORY:
 //  5-MAR-24  RLA   Adapted from SBC1802.
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -159,6 +166,7 @@
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "ImageFile.hpp"        // emulator library image file methods
 #include "ConsoleWindow.hpp"    // emulator console window methods
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "CommandParser.hpp"    // emulator library command line parsing methods
 #include "CommandLine.hpp"      // Shell (argc/argv) parser methods
 #include "StandardUI.hpp"       // emulator library standard UI commands
@@ -251,7 +259,8 @@ CCmdModifier * const CUI::m_modsLoad[] = {&m_modFileFormat, &m_modBaseAddress,
 CCmdModifier * const CUI::m_modsSave[] = {&m_modFileFormat, &m_modBaseAddress,
                                           &m_modByteCount,  &m_modOverwrite, NULL};
 CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoad);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsSave);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsSave, g_aSaveVerbs);
 
 // ATTACH and DETACH commands ...
 CCmdArgument * const CUI::m_argsAttachDiskette[] = {&m_argFileName, NULL};
@@ -284,7 +293,8 @@ CCmdVerb CUI::m_cmdReset("RE*SET", &DoReset);
 
 // SET, CLEAR and SHOW CPU ...
 CCmdModifier * const CUI::m_modsSetCPU[] = {
-    &m_modCPUextended, &m_modIllegalIO, &m_modIllegalOpcode, &m_modBreakChar, NULL
+    &m_modCPUextended, &m_modIllegalIO, &m_modIllegalOpcode, &m_modBreakChar,
+    &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL
   };
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdClearCPU("CPU", &DoClearCPU);
@@ -318,6 +328,7 @@ CCmdVerb CUI::m_cmdClear("CL*EAR", NULL, NULL, NULL, g_aClearVerbs);
 CCmdVerb * const CUI::g_aSetVerbs[] = {
     &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetDevice,
     &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+    &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
     NULL
   };
 CCmdVerb CUI::m_cmdSet("SE*T", NULL, NULL, NULL, g_aSetVerbs);
@@ -328,6 +339,7 @@ CCmdVerb * const CUI::g_aShowVerbs[] = {
     &m_cmdShowBreakpoint, &m_cmdShowMemory, &m_cmdShowCPU, &m_cmdShowDevice,
     &m_cmdShowVersion,
     &CStandardUI::m_cmdShowLog, &CStandardUI::m_cmdShowAliases,
+    &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
     NULL
   };
 CCmdVerb CUI::m_cmdShow("SH*OW", NULL, NULL, NULL, g_aShowVerbs);
@@ -335,13 +347,13 @@ CCmdVerb CUI::m_cmdShow("SH*OW", NULL, NULL, NULL, g_aShowVerbs);
 // Master list of all verbs ...
 CCmdVerb * const CUI::g_aVerbs[] = {
   &m_cmdLoad, &m_cmdSave, &m_cmdAttachDiskette, &m_cmdDetachDiskette,
-  &m_cmdExamine, &m_cmdDeposit,
+  &m_cmdExamine, &m_cmdDeposit, &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdRun, &m_cmdContinue, &m_cmdStep, &m_cmdReset,
   &m_cmdSet, &m_cmdShow, &m_cmdClear,
   &CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -853,6 +865,10 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
     case CCPU::STOP_NONE:    break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -1027,6 +1043,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   // vaious options (e.g. stop on illegal I/O, stop on illegal opcode, etc).
   //--
   assert(g_pCPU != NULL);
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modIllegalIO.IsPresent())
     g_pCPU->StopOnIllegalIO(m_argStopIO.GetKeyValue() != 0);
   if (m_modIllegalOpcode.IsPresent())
@@ -1051,6 +1069,8 @@ bool CUI::DoShowCPU (CCmdParser &cmd)
   double flMajorCycle = CCOSMAC::CLOCKS_PER_CYCLE / flCrystal;
   CMDOUTF("%s %s %3.2fMHz (%3.2fus per microcycle)",
     g_pCPU->GetName(), g_pCPU->GetDescription(), flCrystal, flMajorCycle);
+  CMDOUTS("Simulation speed " << CStandardUI::GetCPUspeed());
+  CMDOUTS("Idle loops       " << CStandardUI::GetCPUwarp());
   CMDOUTF("%s instruction set, BREAK is Control-%c",
     g_pCPU->IsExtended() ? "Extended" : "Standard", g_pConsole->GetConsoleBreak() + '@');
   CMDOUTF("%s on illegal opcode, %s on illegal I/O",
@@ -46,7 +46,7 @@
 //#define EF_SERIAL     CCOSMAC::EF2// software serial input
 
 // Console, log file and command parser objects.
-extern class CConsoleWindow  *g_pConsole;     // console window object
+extern class CSmartConsole   *g_pConsole;     // console window object
 
 //   These pointers reference the major parts of the PEV2 system being
 // emulated - CPU, memory, POST display, peripherals, etc.
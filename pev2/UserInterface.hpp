@@ -29,6 +29,8 @@
 //
 // REVISION HISTORY:
 // 16-JUN-22  RLA   Adapted from ELF2K.
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -163,6 +165,7 @@ private:
   static CCmdVerb m_cmdShowVersion;
   static CCmdVerb * const g_aSetVerbs[];
   static CCmdVerb * const g_aShowVerbs[];
+  static CCmdVerb * const g_aSaveVerbs[];
   static CCmdVerb * const g_aClearVerbs[];
   static CCmdVerb m_cmdClear, m_cmdSet, m_cmdShow;
 
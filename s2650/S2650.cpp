@@ -9,6 +9,11 @@
 // 27-FEB-20  RLA  STRZ has the source and destination reversed!
 //                 GetEA3A() has incrememnt and decrement reversed!
 // 22-JUN-22  RLA  Add nSense and nFlag parameters to GetSense() and SetFlag()
+// 15-OCT-26  RLA  Only check events at the horizon
+// 16-OCT-26  RLA  Evaluate the condition code lazily
+// 16-OCT-26  RLA  Count instructions executed
+// 16-OCT-26  RLA  Call the profiler and add DisassembleInstruction()
+// 16-OCT-26  RLA  Record the instruction trace buffer
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -65,7 +70,7 @@ void C2650::ClearCPU()
   memset(m_R,     0, sizeof(m_R));
   memset(m_RP,    0, sizeof(m_RP));
   memset(m_RAS, 0, sizeof(m_RAS));
-  m_IAR = 0;  m_PSL = m_PSU = 0;
+  m_IAR = 0;  m_PSU = 0;  SetPSL(0);
   SetPSU(m_PSU, true);
 }
 
@@ -93,6 +98,27 @@ uint8_t C2650::GetPSU ()
   return (m_PSU & PSU_MASK);
 }
 
+size_t C2650::DisassembleInstruction (address_t nPC, string &sCode) const
+{
+  //++
+  //   Disassemble the instruction at nPC and return its length.  This is
+  // used by the profiler to show what's at the busiest addresses.
+  //--
+  return ::Disassemble(m_pMemory, nPC, sCode);
+}
+
+const char *const *C2650::GetTraceNames() const
+{
+  //++
+  //   Return the names of the registers saved in each instruction trace entry.
+  // R1 thru R3 are from whichever register bank is currently selected ...
+  //--
+  static const char *const apszNames[] = {
+    "R0", "R1", "R2", "R3", "PSU", "PSL", NULL
+  };
+  return apszNames;
+}
+
 void C2650::TraceInstruction() const
 {
   //++
@@ -624,7 +650,7 @@ uint64_t C2650::DoExecute (uint8_t bOpcode)
     case 044: if (bReg == 2)
                 SetPSU(m_R[0]);                                               // LPSU
               else if (bReg == 3)
-                m_PSL = m_R[0];                                               // LPSL
+                SetPSL(m_R[0]);                                               // LPSL
               else
                 IllegalOpcode();
               return 2;
@@ -632,23 +658,23 @@ uint64_t C2650::DoExecute (uint8_t bOpcode)
     // Store program status (upper and lower) ...
     case 004: switch (bReg) {
                 case 2:   UpdateCC((m_R[0] = GetPSU()));  break;              // SPSU
-                case 3:   UpdateCC((m_R[0] = m_PSL));     break;              // SPSL
+                case 3:   UpdateCC((m_R[0] = GetPSL()));  break;              // SPSL
                 default:  IllegalOpcode();
               }
               return 2;
 
     case 035: switch (bReg) {
                 case 0: SetPSU(GetPSU() & ~Fetch8());   break;                // CPSU
-                case 1: m_PSL &= ~Fetch8();             break;                // CPSL
+                case 1: SetPSL(GetPSL() & ~Fetch8());   break;                // CPSL
                 case 2: SetPSU(GetPSU() | Fetch8());    break;                // PPSU
-                case 3: m_PSL |= Fetch8();              break;                // PPSL
+                case 3: SetPSL(GetPSL() | Fetch8());    break;                // PPSL
               }
               return 3;
 
     // Test program status ...
     case 055: switch (bReg) {
                 case 0:   TMI(GetPSU(), Fetch8());  break;                    // TPSU
-                case 1:   TMI(m_PSL, Fetch8());     break;                    // TPSL
+                case 1:   TMI(GetPSL(), Fetch8());  break;                    // TPSL
                 default:  IllegalOpcode();
               }
               return 3;
@@ -685,21 +711,25 @@ CCPU::STOP_CODE C2650::Run (uint32_t nCount)
   // an illegal opcode or I/O, the user entering the escape sequence on 
   // the console, etc.  If nCount is zero on entry, then we will run for-       
   // ever until one of the previously mentioned break conditions arises.        
+  //
+  //   Device events are only checked when we reach the event queue horizon.
   //--
   bool fFirst = true;
-  m_nStopCode = STOP_NONE;
+  m_nStopCode = STOP_NONE;  InvalidateHorizon();
   while (m_nStopCode == STOP_NONE) {
 
-    // If any device events need to happen, now is the time...
-    m_pEvents->DoEvents();
+    if (AtHorizon()) {
+      // If any device events need to happen, now is the time...
+      DoHorizon();
 
-    // See if an interrupt is required ...
-    if (m_pInterrupt != NULL) {
-      //if (m_pInterrupt->IsRequested() && ISSET(m_SR, SR_IE))  DoInterrupt();
+      // See if an interrupt is required ...
+      if (m_pInterrupt != NULL) {
+        //if (m_pInterrupt->IsRequested() && ISSET(m_SR, SR_IE))  DoInterrupt();
+      }
     }
 
     // Stop if we've hit a breakpoint ...
-    if (!fFirst && g_pMemory->IsBreak(GetPC())) {
+    if (!fFirst && g_pMemory->CheckBreak(GetPC())) {
       m_nStopCode = STOP_BREAKPOINT;  break;
     } else
       fFirst = false;
@@ -708,8 +738,15 @@ CCPU::STOP_CODE C2650::Run (uint32_t nCount)
     if (ISLOGGED(TRACE)) TraceInstruction();
 
     // Fetch, decode and execute an instruction...
-    m_nLastPC = m_IAR;  uint8_t bOpcode = Fetch8();
+    m_nLastPC = m_IAR;  uint8_t bOpcode = Fetch8();  ++m_qInstructions;
+    TRACE_ENTRY *pTrace = NextTrace();
+    if (pTrace != NULL) {
+      pTrace->lOpcode = bOpcode;
+      for (uint2_t r = 0;  r < 4;  ++r)  pTrace->awRegisters[r] = REG(r);
+      pTrace->awRegisters[4] = m_PSU;  pTrace->awRegisters[5] = GetPSL();
+    }
     AddTime(DoExecute(bOpcode)*CycleTime());
+    Profile(m_nLastPC);
 
     // Check for some termination conditions ...
     if (m_nStopCode == STOP_NONE) {
@@ -732,7 +769,7 @@ uint16_t C2650::GetRegister (cpureg_t nReg) const
     case REG_R1P:  case REG_R2P:  case REG_R3P:
       return m_RP[nReg-REG_R1P];
     case REG_PSU:   return m_PSU;
-    case REG_PSL:   return m_PSL;
+    case REG_PSL:   return GetPSL();
     case REG_IAR:   return m_IAR;
     default:
       if ((nReg >= REG_STACK) && (nReg < REG_STACK+MAXSTACK))
@@ -753,7 +790,7 @@ void C2650::SetRegister (cpureg_t nReg, uint16_t bData)
     case REG_R1P:  case REG_R2P:  case REG_R3P:
       m_RP[nReg-REG_R1P] = MASK8(bData);  break;
     case REG_PSU:   m_PSU = MASK8(bData); break;
-    case REG_PSL:   m_PSL = MASK8(bData); break;
+    case REG_PSL:   SetPSL(MASK8(bData)); break;
     case REG_IAR:   m_IAR = bData;        break;
     default:
       if ((nReg >= REG_STACK) && (nReg < REG_STACK+MAXSTACK))
@@ -7,6 +7,9 @@
 //
 // REVISION HISTORY:
 // 21-FEB-20  RLA   Copied from C2650.
+// 16-OCT-26  RLA   Evaluate the condition code lazily
+// 16-OCT-26  RLA   Add DisassembleInstruction() for the profiler
+// 16-OCT-26  RLA   Add GetTraceNames() for the instruction trace
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -98,6 +101,10 @@ public:
   // Get the address of the next instruction to be executed ...
   inline address_t GetPC() const override {return m_IAR;}
   inline void SetPC (address_t a) override {m_IAR = a;}
+  // Disassemble one instruction (used by the profiler) ...
+  size_t DisassembleInstruction (address_t nPC, string &sCode) const override;
+  // Return the names of the registers saved in the instruction trace ...
+  const char *const *GetTraceNames() const override;
   //   The S2650 data sheet describes instruction execution time in terms of
   // "processor cycles".  Each processor cycle requires three cycles of the
   // crystal clock.
@@ -139,8 +146,8 @@ private:
   uint8_t &REG (uint2_t r)
     {assert(r<4);  return ((r==0) || !ISSET(m_PSL,PSL_RS)) ? m_R[r] : m_RP[r-1];}
   // These two defintions save some typing for memory access...
-  inline uint8_t MEMR (address_t a) {return m_pMemory->CPUread(MASK15(a));}
-  inline void MEMW (address_t a, uint8_t b) {m_pMemory->CPUwrite(MASK15(a), b);}
+  inline uint8_t MEMR (address_t a) {return m_pMemory->FastRead(MASK15(a));}
+  inline void MEMW (address_t a, uint8_t b) {m_pMemory->FastWrite(MASK15(a), b);}
   // Fetch an 8 bit value using the IAR, and increment the IAR ..
   inline uint8_t Fetch8() {uint8_t b=MEMR(m_IAR);  INC13(m_IAR);  return b;}
   // Fetch a 16 bit value.  Note that the 2650 is a big endian machine!
@@ -157,16 +164,28 @@ private:
   inline address_t POP() {address_t a = m_RAS[GetSP()];  SetSP(GetSP()-1);  return a;}
 
   // 2650 PSW primitives ...
+  //   Almost every instruction updates the condition code according to its
+  // result, but only branches and a few others ever look at it.  So UpdateCC()
+  // just remembers the result and the CC bits are figured out later, only when
+  // somebody asks.  If m_fLazyCC is true then the CC bits in m_PSL are garbage
+  // and m_bCCresult is what counts.  Everybody outside these primitives should
+  // use GetPSL() and SetPSL() rather than m_PSL if they care about the CC ...
 private:
   // Set the PSL condition code to an explicit value ...
-  inline void SetCC (uint8_t cc) {m_PSL = (m_PSL & ~PSL_CC) | (cc & PSL_CC);}
+  inline void SetCC (uint8_t cc) {m_PSL = (m_PSL & ~PSL_CC) | (cc & PSL_CC);  m_fLazyCC = false;}
   // Update the CC bits based on the value (positive, negative or zero) ...
-  inline void UpdateCC (uint8_t bVal)
-    {SetCC( (bVal==0) ? CC_ZERO : ISSET(bVal, 0x80) ? CC_NEGATIVE : CC_POSITIVE );}
+  inline void UpdateCC (uint8_t bVal) {m_bCCresult = bVal;  m_fLazyCC = true;}
+  // Return the current CC bits, evaluating the lazy result if necessary ...
+  inline uint8_t GetCC() const
+    {if (!m_fLazyCC) return m_PSL & PSL_CC;
+     return (m_bCCresult==0) ? CC_ZERO : ISSET(m_bCCresult, 0x80) ? CC_NEGATIVE : CC_POSITIVE;}
+  // Get or set the entire PSL, including the condition code ...
+  inline uint8_t GetPSL() const {return (m_PSL & ~PSL_CC) | GetCC();}
+  inline void SetPSL (uint8_t bPSL) {m_PSL = bPSL;  m_fLazyCC = false;}
   // Compare the CC value (note that the CC bits are right justified first!) ...
   //   Note that CC == 3 always matches!!!
   inline bool CompareCC (uint2_t bCC)
-    {return (bCC == 3)  ||  (bCC == ((m_PSL & PSL_CC) >> 6));}
+    {return (bCC == 3)  ||  (bCC == (GetCC() >> 6));}
   // Set or clear the IDC, OVF and/or CY flags ...
   inline void SetIDC (bool f) {if (f) SETBIT(m_PSL, PSL_IDC);  else CLRBIT(m_PSL, PSL_IDC);}
   inline void SetOVF (bool f) {if (f) SETBIT(m_PSL, PSL_OVF);  else CLRBIT(m_PSL, PSL_OVF);}
@@ -210,6 +229,8 @@ private:
   uint8_t   m_R[4];           // primary register set
   uint8_t   m_RP[3];          // alternate register set
   uint8_t   m_PSU, m_PSL;     // program status (upper and lower)
+  bool      m_fLazyCC;        // TRUE if the CC is to be taken from m_bCCresult
+  uint8_t   m_bCCresult;      // last result for the lazy condition code
   address_t m_IAR;            // instruction address register (aka PC)
   address_t m_RAS[MAXSTACK];  // subroutine call/return stack
   // Constant strings for sense and flag names ...
@@ -19,7 +19,7 @@
 #define PORT_SLU0         0xF0  // console 2651 UART (2 ports!)
 
 // Console, log file and command parser objects.
-extern class CConsoleWindow  *g_pConsole;     // console window object
+extern class CSmartConsole   *g_pConsole;     // console window object
 
 //   These pointers reference the major parts of the SBC50 system being
 // emulated - CPU, memory, switches, display, peripherals, etc.  They're all
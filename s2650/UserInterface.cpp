@@ -18,6 +18,8 @@
 //    
 // REVISION HISTORY:
 // 21-FEB-20  RLA   New file.
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -34,6 +36,7 @@
 #include "CommandParser.hpp"    // emulator library command line parsing methods
 #include "CommandLine.hpp"      // Shell (argc/argv) parser methods
 #include "ConsoleWindow.hpp"    // CVirtualConsole declaration
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "SBC50.hpp"            // global declarations for this project
 #include "StandardUI.hpp"       // emulator library standard UI commands
 #include "UserInterface.hpp"    // emulator user interface parse table definitions
@@ -130,7 +133,8 @@ CCmdModifier CUI::m_modByteCount("COU*NT", NULL, &m_argByteCount);
 CCmdArgument * const CUI::m_argsLoadSave[] = {&m_argFileName, NULL};
 CCmdModifier * const CUI::m_modsLoadSave[] = {&m_modFileFormat, &m_modBaseAddress, &m_modByteCount, &m_modRAM, &m_modROM, NULL};
 CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoadSave);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave, g_aSaveVerbs);
 
 // ATTACH and DETACH commands ...
 CCmdVerb CUI::m_cmdAttachSerial("SER*IAL", &DoAttachSerial);
@@ -173,13 +177,14 @@ CCmdVerb CUI::m_cmdClear("CL*EAR", NULL, NULL, NULL, g_aClearVerbs);
 CCmdArgument * const CUI::m_argsSetMemory[] = {&m_argRangeList, NULL};
 CCmdModifier * const CUI::m_modsSetMemory[] = {&m_modRAM, &m_modROM, NULL};
 CCmdModifier * const CUI::m_modsSetSerial[] = {&m_modBaudRate, &m_modInvertData, &m_modPollDelay, NULL};
-CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modIllegalIO, &m_modIllegalOpcode, &m_modBreakChar, NULL};
+CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modIllegalIO, &m_modIllegalOpcode, &m_modBreakChar, &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL};
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdSetMemory = {"MEM*ORY", &DoSetMemory, m_argsSetMemory, m_modsSetMemory};
 CCmdVerb CUI::m_cmdSetSerial = {"SER*IAL", &DoSetSerial, NULL, m_modsSetSerial};
 CCmdVerb * const CUI::g_aSetVerbs[] = {
   &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetMemory, &m_cmdSetSerial,
   &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+  &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
   NULL
 };
 CCmdVerb CUI::m_cmdSet("SE*T", NULL, NULL, NULL, g_aSetVerbs);
@@ -195,6 +200,7 @@ CCmdVerb * const CUI::g_aShowVerbs[] = {
   &m_cmdShowBreakpoint, &m_cmdShowMemory, &m_cmdShowConfiguration,
   &m_cmdShowCPU,& m_cmdShowTime,& m_cmdShowVersion,
   &CStandardUI::m_cmdShowLog, &CStandardUI::m_cmdShowAliases,
+  &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
   &m_cmdShowAll, NULL
 };
 CCmdVerb CUI::m_cmdShow("SH*OW", NULL, NULL, NULL, g_aShowVerbs);
@@ -202,13 +208,13 @@ CCmdVerb CUI::m_cmdShow("SH*OW", NULL, NULL, NULL, g_aShowVerbs);
 // Master list of all verbs ...
 CCmdVerb * const CUI::g_aVerbs[] = {
   &m_cmdLoad, &m_cmdSave, &m_cmdAttach, &m_cmdDetach,
-  &m_cmdExamine, &m_cmdDeposit,
+  &m_cmdExamine, &m_cmdDeposit, &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdSet, &m_cmdShow, &m_cmdReset,
   &m_cmdClear, &m_cmdRun, &m_cmdContinue, &m_cmdStep,
 //&CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 
@@ -705,6 +711,10 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
     case CCPU::STOP_NONE:    break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -840,6 +850,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   //   SET CPU allows you to set the CPU type (e.g. 1802 or 1805), and well as
   // vaious options (e.g. stop on illegal I/O, stop on illegal opcode, etc).
   //--
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modIllegalIO.IsPresent())
     g_pCPU->StopOnIllegalIO(m_argStopIO.GetKeyValue() != 0);
   if (m_modIllegalOpcode.IsPresent())
@@ -863,6 +875,8 @@ bool CUI::DoShowCPU (CCmdParser &cmd)
   CMDOUTF("%s %s %3.2fMHz BREAK=^%c",
     g_pCPU->GetName(), g_pCPU->GetDescription(),
     flCrystal, (g_pConsole->GetConsoleBreak()+'@'));
+  CMDOUTS("Simulation speed " << CStandardUI::GetCPUspeed());
+  CMDOUTS("Idle loops       " << CStandardUI::GetCPUwarp());
   
   // Show simulated CPU time ...
   DoShowTime(cmd);
@@ -0,0 +1,9 @@
+; Headless benchmark - run PIPBUG for 10 seconds ...
+set log/console/level=warning
+load pipbug
+attach serial
+set serial/NOinvert/baud=300
+set memory/rom 0-3ff
+reset
+benchmark 10
+show statistics
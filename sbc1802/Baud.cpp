@@ -25,6 +25,7 @@
 //
 // REVISION HISTORY:
 // 23-JUN-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -42,6 +43,7 @@
 #include "Memory.hpp"           // basic memory emulation declarations ...
 #include "Device.hpp"           // basic I/O device emulation declarations ...
 #include "CPU.hpp"              // CCPU base class definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "Baud.hpp"             // declarations for this module
 
 
@@ -97,3 +99,11 @@ void CBaud::ShowDevice (ostringstream &ofs) const
   ofs << FormatString("SLU0 baud %s, SLU1 %s\n", DecodeBaud(m_bBaud0).c_str(), DecodeBaud(m_bBaud1).c_str());
 }
 
+
+void CBaud::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the baud rate selections ...
+  //--
+  State.Sync(m_bBaud0);  State.Sync(m_bBaud1);
+}
@@ -21,6 +21,7 @@
 //
 // REVISION HISTORY:
 // 23-JUN-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>
@@ -80,6 +81,8 @@ public:
   void DevWrite (address_t nPort, word_t bData) override;
   // Dump the device state for the user ...
   virtual void ShowDevice (ostringstream &ofs) const override;
+  // Save or load the device state ...
+  virtual void SyncState (CStateFile &State) override;
 
   // Private methods ...
 private:
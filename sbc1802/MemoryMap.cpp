@@ -116,6 +116,10 @@
 // 12-MAR-24  RLA   UT71 ROM should extend to $87FF, not $83FF!
 // 24-MAR-25  RLA   Add error message for writes to EPROM
 //                  Add EnablePIC() and EnableRTC()
+// 15-OCT-26  RLA   Add IsSlow() and invalidate the CPU horizon for I/O
+//                  Build the CMemory page table from the RAM and EPROM pages
+// 16-OCT-26  RLA   Count I/O, NXM and EPROM write accesses
+// 16-OCT-26  RLA   Add CMemoryControl::SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -134,6 +138,7 @@
 #include "COSMACopcodes.hpp"    // COSMAC opcode definitions
 #include "CPU.hpp"              // CCPU base class definitions
 #include "COSMAC.hpp"           // declarations for this module
+#include "StateFile.hpp"        // CStateFile declarations
 #include "MemoryMap.hpp"        // declarations for this module
 using std::string;              // too lazy to type "std::string..."!
 
@@ -153,7 +158,7 @@ CMemoryControl::CMemoryControl (uint16_t nPort, CCDP1877 *pPIC)
   // can we do?
   //--
   assert(pPIC != NULL);
-  m_bMap = MCR_BOOT;  m_pPIC = pPIC;
+  m_bMap = MCR_BOOT;  m_pPIC = pPIC;  m_pMemoryMap = NULL;
 }
 
 CMemoryMap::CMemoryMap (CGenericMemory *pRAM, CGenericMemory *pROM, 
@@ -175,6 +180,10 @@ CMemoryMap::CMemoryMap (CGenericMemory *pRAM, CGenericMemory *pROM,
   m_fEnablePIC = m_fEnableRTC = true;
   m_pRAM = pRAM;  m_pROM = pROM;  m_pCPU = NULL;
   m_pMCR = pMCR;  m_pRTC = pRTC;  m_pPIC = pPIC;
+  //   We cache the RAM and EPROM page table entries in our own page table,
+  // so they need to tell us when they change, and so does the MCR ...
+  m_pRAM->SetMapper(this);  m_pROM->SetMapper(this);
+  m_pMCR->SetMemoryMap(this);  UpdatePages();
 }
 
 const char *CMemoryControl::MapToString (uint8_t bMap)
@@ -198,7 +207,19 @@ void CMemoryControl::ClearDevice()
   //   A reset clears the MCR (which selects BOOT mapping mode) and also
   // clears the master interrupt enable ...
   //--
-  m_bMap = MCR_BOOT;  m_pPIC->SetMasterEnable(false);
+  SetMap(MCR_BOOT);  m_pPIC->SetMasterEnable(false);
+}
+
+void CMemoryControl::SetMap (uint8_t bMap)
+{
+  //++
+  //   Change the memory mapping mode.  If it's actually different from the
+  // current mode, then the memory map's page table has to be updated too.
+  //--
+  bMap &= MCR_MASK;
+  if (bMap == m_bMap) return;
+  uint8_t bOld = m_bMap;  m_bMap = bMap;
+  if (m_pMemoryMap != NULL) m_pMemoryMap->RemapPages(bOld, bMap);
 }
 
 word_t CMemoryControl::DevRead (address_t nPort)
@@ -232,7 +253,7 @@ void CMemoryControl::DevWrite (address_t nPort, word_t bData)
   // enable for the CDP1877 PIC.
   //--
   assert(nPort == MCRBASE);
-  m_bMap = bData & MCR_MASK;
+  SetMap(bData & MCR_MASK);
   m_pPIC->SetMasterEnable(ISSET(bData, MCR_MIEN));
   LOGF(TRACE, "MCR write 0x%02X (map=%s, MIEN=%d)", bData, MapToString(m_bMap), m_pPIC->GetMasterEnable());
 }
@@ -330,14 +351,18 @@ word_t CMemoryMap::CPUread (address_t a) const
   // It runs the memory mapping algorithm to figure out which address space
   // and chip should be selected, and then delegates the request to the
   // corresponding object.
+  //
+  //   Note that accessing any of the memory mapped I/O devices might change
+  // the interrupt state, so in that case we invalidate the CPU's horizon.
   //--
   switch (ChipSelect(m_pMCR->GetMap(), a)) {
     case CS_ROM: return m_pROM->CPUread(a);
     case CS_RAM: return m_pRAM->CPUread(a);
-    case CS_RTC: return m_fEnableRTC ? m_pRTC->DevRead(a) : 0;
-    case CS_PIC: return m_fEnablePIC ? m_pPIC->DevRead(a) : 0;
-    case CS_MCR: return m_pMCR->DevRead(a);
+    case CS_RTC: InvalidateHorizon();  CountRead(ACCESS_IO);  return m_fEnableRTC ? m_pRTC->DevRead(a) : 0;
+    case CS_PIC: InvalidateHorizon();  CountRead(ACCESS_IO);  return m_fEnablePIC ? m_pPIC->DevRead(a) : 0;
+    case CS_MCR: InvalidateHorizon();  CountRead(ACCESS_IO);  return m_pMCR->DevRead(a);
     default:
+      CountRead(ACCESS_NXM);
       LOGF(WARNING, "invalid memory reference to %04X", LOWORD(a));
       return 0;
   }
@@ -352,18 +377,23 @@ void CMemoryMap::CPUwrite (address_t a, word_t d)
     case CS_ROM: 
       if (m_pROM->IsWritable(a))
         m_pROM->CPUwrite(a, d);
-      else
+      else {
+        CountWrite(ACCESS_ROM);
         LOGF(WARNING, "write to ROM address 0x%04X at 0x%04X", a, m_pCPU->GetPC());
+      }
       break;
     case CS_RAM: m_pRAM->CPUwrite(a, d);  break;
     case CS_RTC:
+      InvalidateHorizon();  CountWrite(ACCESS_IO);
       if (m_fEnableRTC) m_pRTC->DevWrite(a, d);
       break;
     case CS_PIC:
+      InvalidateHorizon();  CountWrite(ACCESS_IO);
       if (m_fEnablePIC) m_pPIC->DevWrite(a, d);
       break;
-    case CS_MCR: m_pMCR->DevWrite(a, d);  break;
+    case CS_MCR: InvalidateHorizon();  CountWrite(ACCESS_IO);  m_pMCR->DevWrite(a, d);  break;
     default:
+      CountWrite(ACCESS_NXM);
       LOGF(WARNING, "invalid memory reference to %04X", LOWORD(a));
   }
 }
@@ -386,6 +416,73 @@ bool CMemoryMap::IsBreak (address_t a) const
   }
 }
 
+bool CMemoryMap::IsSlow (address_t a) const
+{
+  //++
+  //   Return TRUE if the specified address needs extra access time.  Like
+  // IsBreak(), this only makes sense for RAM and EPROM ...
+  //--
+  switch (ChipSelect(m_pMCR->GetMap(), a)) {
+    case CS_ROM: return m_pROM->IsSlow(a);
+    case CS_RAM: return m_pRAM->IsSlow(a);
+    default: return false;
+  }
+}
+
+void CMemoryMap::MapPage (size_t nPage, uint8_t bMap)
+{
+  //++
+  //   Update our page table entry for one page of CPU addresses.  If the
+  // entire page is mapped to either RAM or EPROM then we can just borrow the
+  // page table entries from that CGenericMemory object, but anything else
+  // (e.g. the $FExx page with the scratchpad RAM and I/O devices) has to go
+  // the slow way.  All the mapping boundaries are on page boundaries except
+  // for that one, so it's enough to look at the first and last byte.
+  //
+  //   The breakpoint bit is borrowed from RAM or EPROM the same way, except
+  // that a mixed page (which might contain some RAM) always gets it set.
+  // IsBreak() will sort it out.
+  //--
+  address_t aFirst = ADDRESS(nPage << PAGE_SHIFT);
+  address_t aLast = ADDRESS(aFirst + PAGE_MASK);
+  CHIP_SELECT nChip = ChipSelect(bMap, aFirst);
+  if ((ChipSelect(bMap, aLast) != nChip) || (aLast != ADDRESS(aFirst+PAGE_MASK))) {
+    SetPage(nPage, NULL, NULL);  SetBreakPage(nPage, true);
+  } else if (nChip == CS_RAM) {
+    SetPage(nPage, m_pRAM->GetReadPage(aFirst), m_pRAM->GetWritePage(aFirst));
+    SetBreakPage(nPage, m_pRAM->IsBreakPage(aFirst));
+  } else if (nChip == CS_ROM) {
+    SetPage(nPage, m_pROM->GetReadPage(aFirst), m_pROM->GetWritePage(aFirst));
+    SetBreakPage(nPage, m_pROM->IsBreakPage(aFirst));
+  } else {
+    SetPage(nPage, NULL, NULL);  SetBreakPage(nPage, false);
+  }
+}
+
+void CMemoryMap::UpdatePages (address_t nFirst, address_t nLast)
+{
+  //++
+  // Rebuild the page table for the current mapping mode ...
+  //--
+  for (size_t nPage = PAGE(nFirst);  nPage <= PAGE(nLast);  ++nPage)
+    MapPage(nPage, m_pMCR->GetMap());
+}
+
+void CMemoryMap::RemapPages (uint8_t bOld, uint8_t bNew)
+{
+  //++
+  //   This is called by the MCR whenever the mapping mode changes, and it
+  // updates only the pages that are actually mapped differently in the old
+  // and new modes.  In practice that's the lower half of memory and/or most
+  // of the upper half, but never the $Fxxx BIOS region.
+  //--
+  for (size_t nPage = 0;  nPage < PAGE_COUNT;  ++nPage) {
+    address_t aOld = ADDRESS(nPage << PAGE_SHIFT), aNew = aOld;
+    if ((ChipSelect(bOld, aOld) != ChipSelect(bNew, aNew)) || (aOld != aNew))
+      MapPage(nPage, bNew);
+  }
+}
+
 bool CMemoryMap::IsIO (address_t a) const
 {
   //++
@@ -408,3 +505,20 @@ void CMemoryControl::ShowDevice(ostringstream &ofs) const
   ofs << FormatString("Memory map 0x%02X (%s), master interrupts %s",
     m_bMap, MapToString(m_bMap), m_pPIC->GetMasterEnable() ? "ENABLED" : "disabled");
 }
+
+void CMemoryControl::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the memory mapping mode, plus the PIC and RTC enables from
+  // the memory map.  Changing the mode remaps pages, so we go thru SetMap().
+  // The master interrupt enable actually lives in the PIC and it's saved there.
+  //--
+  assert(m_pMemoryMap != NULL);
+  uint8_t bMap = m_bMap;  State.Sync(bMap);
+  bool fEnablePIC = m_pMemoryMap->IsPICenabled();  State.Sync(fEnablePIC);
+  bool fEnableRTC = m_pMemoryMap->IsRTCenabled();  State.Sync(fEnableRTC);
+  if (State.IsLoading()) {
+    SetMap(bMap);
+    m_pMemoryMap->EnablePIC(fEnablePIC);  m_pMemoryMap->EnableRTC(fEnableRTC);
+  }
+}
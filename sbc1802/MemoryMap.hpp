@@ -27,6 +27,9 @@
 // 16-JUN-22  RLA   New file.
 // 19-JUN-22  RLA   Split out CMemoryControl
 // 24-MAR-25  RLA   Add SetCPU(), EnablePIC() and EnableRTC().
+// 15-OCT-26  RLA   Add IsSlow() ...
+//                  Add UpdatePages() and RemapPages() for the page table
+// 16-OCT-26  RLA   Add CMemoryControl::SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -38,6 +41,7 @@
 using std::string;              // ...
 class CCDP1877;                 // ...
 class CCDP1879;                 // ...
+class CMemoryMap;               // ...
 
 
 class CMemoryControl : public CDevice {
@@ -90,16 +94,21 @@ public:
   virtual word_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, word_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Other special MCR methods ...
 public:
   inline uint8_t GetMap() const {return m_bMap;}
+  void SetMap (uint8_t bMap);
   static const char *MapToString (uint8_t bMap);
+  // Set the memory map that needs to know when the mapping mode changes ...
+  void SetMemoryMap (CMemoryMap *pMemoryMap) {m_pMemoryMap = pMemoryMap;}
 
   // Private member data...
 protected:
   uint8_t         m_bMap;     // current memory mapping mode selected
   CCDP1877       *m_pPIC;     // programmable interrupt controller
+  CMemoryMap     *m_pMemoryMap; // memory map to update when m_bMap changes
 };
 
 
@@ -142,7 +151,18 @@ public:
   virtual word_t CPUread (address_t a) const;
   virtual void CPUwrite (address_t a, word_t d);
   virtual bool IsBreak (address_t a) const;
+  virtual bool IsSlow (address_t a) const;
   virtual bool IsIO (address_t a) const;
+  // Rebuild the page table for the current (or a new) mapping mode ...
+  virtual void UpdatePages (address_t nFirst=0, address_t nLast=ADDRESS_MAX) override;
+  void RemapPages (uint8_t bOld, uint8_t bNew);
+
+  // Local methods ...
+private:
+  // Force the CPU to recheck interrupts after a memory mapped I/O access ...
+  void InvalidateHorizon() const {if (m_pCPU != NULL) m_pCPU->InvalidateHorizon();}
+  // Update the page table entry for one page ...
+  void MapPage (size_t nPage, uint8_t bMap);
 
 public:
   // Public CMeoryMap methods ...
@@ -37,6 +37,7 @@
 // REVISION HISTORY:
 // 17-JUN-22  RLA   New file.
 // 23-JUN-22  RLA   Add INPUT/ATTENTION switch.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
@@ -55,6 +56,7 @@
 #include "Memory.hpp"           // basic memory emulation declarations ...
 #include "Device.hpp"           // basic I/O device emulation declarations ...
 #include "CPU.hpp"              // CCPU base class definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "POST.hpp"             // declarations for this module
 
 
@@ -160,3 +162,20 @@ void CSwitches::ShowDevice (ostringstream &ofs) const
   if (m_fAttention) ofs << ", ATTENTION requested";
   ofs << std::endl;
 }
+
+void CLEDS::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the last POST code displayed ...
+  //--
+  State.Sync(m_bPOST);
+}
+
+void CSwitches::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the switch settings and the attention flag.  The interrupt
+  // request is restored by the PIC, so we don't call RequestAttention() ...
+  //--
+  State.Sync(m_bSwitches);  State.Sync(m_fAttention);
+}
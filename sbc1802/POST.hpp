@@ -23,6 +23,7 @@
 //
 // REVISION HISTORY:
 // 17-JUN-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>
@@ -84,6 +85,8 @@ public:
   virtual void DevWrite (address_t nPort, word_t bData) override;
   // Dump the device state for the user ...
   virtual void ShowDevice (ostringstream &ofs) const override;
+  // Save or load the device state ...
+  virtual void SyncState (CStateFile &State) override;
 
   // Private methods ...
 private:
@@ -126,6 +129,8 @@ public:
   virtual uint1_t GetSense (address_t nSense, uint1_t bDefault=0) override {return m_fAttention;}
   // Dump the device state for the user ...
   void ShowDevice (ostringstream &ofs) const override;
+  // Save or load the device state ...
+  virtual void SyncState (CStateFile &State) override;
 
   // Private member data...
 protected:
@@ -49,6 +49,7 @@
 // REVISION HISTORY:
 // 26-MAR-25  RLA   New file.
 // 12-MAY-25  RLA   <LF> should output both <CR> and <LF>.  <CR> is ignored.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -70,6 +71,7 @@
 #include "Device.hpp"           // generic device definitions
 #include "PPI.hpp"              // generic parallel interface definitions
 #include "CDP1851.hpp"          // RCA CDP1851 specific PPI emulation
+#include "StateFile.hpp"        // CStateFile declarations
 #include "Printer.hpp"          // declarations for this module
 
 CPrinter::CPrinter (const char *pszName, address_t nPort, CEventQueue *pEvents)
@@ -258,3 +260,16 @@ void CPrinter::ShowDevice (ostringstream &ofs) const
   ofs << FormatString("Width=%d, Column=%d, Buffer=0x%02X, Speed=%ld cps\n",
     m_lLineWidth, m_lCurrentColumn, m_bDataBuffer, NSTOCPS(m_llBusyDelay));
 }
+
+void CPrinter::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the CDP1851 and the printer status.  The printer output
+  // file is NOT changed - it's an output, not part of the machine, and any
+  // printing after a LOAD STATE just goes to whatever file is open now.
+  //--
+  CCDP1851::SyncState(State);
+  State.Sync(m_bCurrentStatus);  State.Sync(m_bLastControl);
+  State.Sync(m_llBusyDelay);  State.Sync(m_lLineWidth);
+  State.Sync(m_lCurrentColumn);  State.Sync(m_bDataBuffer);
+}
@@ -20,6 +20,7 @@
 //
 // REVISION HISTORY:
 // 26-MAR-25  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -96,6 +97,8 @@ public:
   virtual void EventCallback (intptr_t lParam) override;
   // Show the printer status ...
   virtual void ShowDevice (ostringstream& ofs) const override;
+  // Save or load the printer state ...
+  virtual void SyncState (CStateFile &State) override;
 
   // Overrides from CCDP1851 and CPPI ...
 protected:
@@ -43,6 +43,7 @@
 //                  Add second AY-3-8912 PSG and CTwoPSGs class.
 //  2-NOV-24  RLA   Add CDP1878 counter/timer
 //  6-NOV-24  RLA   Make CPU clock frequency programmable
+// 16-OCT-26  RLA   Move all the hardware into a CSBC1802 machine instance.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -95,6 +96,7 @@ CSmartConsole   *g_pConsole     = NULL; // console window object
 CLog            *g_pLog         = NULL; // message logging object (including console!)
 CCmdParser      *g_pParser      = NULL; // command line parser
 // These globals point to the objects being emulated ...
+CSBC1802        *g_pSBC1802     = NULL; // the machine selected for UI commands
 CEventQueue     *g_pEvents      = NULL; // list of upcoming virtual events
 CCOSMAC         *g_pCPU         = NULL; // 1802 COSMAC CPU
 CGenericMemory  *g_pRAM         = NULL; // 64K of RAM emulation
@@ -129,7 +131,7 @@ static bool ConfirmExit (CCmdParser &cmd)
   return true;
 }
 
-static void CreateBaseBoard()
+void CSBC1802::CreateBaseBoard()
 {
   //++
   // Create all the base board peripherals ...
@@ -139,95 +141,176 @@ static void CreateBaseBoard()
   // clock and memory control register.  The latter three peripherals are all
   // memory mapped devices.  After that, we can create the CPU and attach the
   // memory and memory mapped devices.
-  g_pRAM = DBGNEW CGenericMemory(RAMSIZE, RAMBASE, CMemory::MEM_RAM);
-  g_pROM = DBGNEW CGenericMemory(ROMSIZE, ROMBASE, CMemory::MEM_ROM);
-  g_pPIC = DBGNEW CCDP1877(PICBASE);
-  g_pRTC = DBGNEW CCDP1879(RTCBASE, g_pEvents);
-  g_pRTC->AttachInterrupt(g_pPIC->GetLevel(IRQ_RTC));
-  g_pMCR = DBGNEW CMemoryControl(MCRBASE, g_pPIC);
-  g_pMemoryMap = DBGNEW CMemoryMap(g_pRAM, g_pROM, g_pMCR, g_pRTC, g_pPIC);
-  g_pCPU = DBGNEW CCOSMAC(g_pMemoryMap, g_pEvents, g_pPIC);
-  g_pCPU->SetCrystalFrequency(CPUCLK);
-  g_pMemoryMap->SetCPU(g_pCPU);
+  m_pRAM = DBGNEW CGenericMemory(RAMSIZE, RAMBASE, CMemory::MEM_RAM);
+  m_pROM = DBGNEW CGenericMemory(ROMSIZE, ROMBASE, CMemory::MEM_ROM);
+  m_pPIC = DBGNEW CCDP1877(PICBASE);
+  m_pRTC = DBGNEW CCDP1879(RTCBASE, m_pEvents);
+  m_pRTC->AttachInterrupt(m_pPIC->GetLevel(IRQ_RTC));
+  m_pMCR = DBGNEW CMemoryControl(MCRBASE, m_pPIC);
+  m_pMemoryMap = DBGNEW CMemoryMap(m_pRAM, m_pROM, m_pMCR, m_pRTC, m_pPIC);
+  m_pCPU = DBGNEW CCOSMAC(m_pMemoryMap, m_pEvents, m_pPIC);
+  m_pCPU->SetCrystalFrequency(CPUCLK);
+  m_pMemoryMap->SetCPU(m_pCPU);
 
   //   Create the two level I/O controller and attach it to ALL seven CPU I/O
   // instructions plus all four EF inputs.  The Q output, which isn't really
   // used in this design anyway, isn't affected by the two level I/O.
-  g_pTLIO = DBGNEW CTLIO(TLIO_PORT, 1, CCOSMAC::MAXDEVICE);
-  g_pCPU->InstallDevice(g_pTLIO);
-  g_pCPU->InstallSense(g_pTLIO, CCOSMAC::EF1);
-  g_pCPU->InstallSense(g_pTLIO, CCOSMAC::EF2);
-  g_pCPU->InstallSense(g_pTLIO, CCOSMAC::EF3);
-  g_pCPU->InstallSense(g_pTLIO, CCOSMAC::EF4);
+  m_pTLIO = DBGNEW CTLIO(TLIO_PORT, 1, CCOSMAC::MAXDEVICE);
+  m_pCPU->InstallDevice(m_pTLIO);
+  m_pCPU->InstallSense(m_pTLIO, CCOSMAC::EF1);
+  m_pCPU->InstallSense(m_pTLIO, CCOSMAC::EF2);
+  m_pCPU->InstallSense(m_pTLIO, CCOSMAC::EF3);
+  m_pCPU->InstallSense(m_pTLIO, CCOSMAC::EF4);
 
   // The RTC IRQ is attached to group 1 EF2.
-  g_pTLIO->InstallSense(BASE_GROUP, g_pRTC, RTC_IRQ_EF);
+  m_pTLIO->InstallSense(BASE_GROUP, m_pRTC, RTC_IRQ_EF);
 
   //   Attach the LEDs and switches to group 1 port 4.  Note that the switches
   // are also associated with the INPUT button, which is attached to EF4 and
   // also interrupt request level 0.
-  g_pLEDS = DBGNEW CLEDS(LEDS_PORT);
-  g_pSwitches = DBGNEW CSwitches(SWITCHES_PORT);
-  g_pSwitches->AttachInterrupt(g_pPIC->GetLevel(IRQ_INPUT));
-  g_pTLIO->InstallDevice(BASE_GROUP, g_pLEDS);
-  g_pTLIO->InstallDevice(BASE_GROUP, g_pSwitches);
-  g_pTLIO->InstallSense(BASE_GROUP, g_pSwitches, INPUT_EF);
+  m_pLEDS = DBGNEW CLEDS(LEDS_PORT);
+  m_pSwitches = DBGNEW CSwitches(SWITCHES_PORT);
+  m_pSwitches->AttachInterrupt(m_pPIC->GetLevel(IRQ_INPUT));
+  m_pTLIO->InstallDevice(BASE_GROUP, m_pLEDS);
+  m_pTLIO->InstallDevice(BASE_GROUP, m_pSwitches);
+  m_pTLIO->InstallSense(BASE_GROUP, m_pSwitches, INPUT_EF);
 
   // The baud rate generator is attached to group 1 port 7...
-  g_pBRG = DBGNEW CBaud(BAUD_PORT);
-  g_pTLIO->InstallDevice(BASE_GROUP, g_pBRG);
+  m_pBRG = DBGNEW CBaud(BAUD_PORT);
+  m_pTLIO->InstallDevice(BASE_GROUP, m_pBRG);
 
   //   The primary UART is attached to group 1, ports 2-3, and also to
   // EF3 (IRQ) plus EF1 (break)...
-  g_pSLU0 = DBGNEW CCDP1854("SLU0", SLU0_PORT, g_pEvents, g_pConsole, g_pCPU, SLU0_IRQ_EF, SLU0_BREAK_EF);
-  g_pSLU0->AttachInterrupt(g_pPIC->GetLevel(IRQ_SLU0));
-  g_pTLIO->InstallDevice(BASE_GROUP, g_pSLU0);
-  g_pTLIO->InstallSense(BASE_GROUP, g_pSLU0, SLU0_IRQ_EF);
-  g_pTLIO->InstallSense(BASE_GROUP, g_pSLU0, SLU0_BREAK_EF);
+  m_pSLU0 = DBGNEW CCDP1854("SLU0", SLU0_PORT, m_pEvents, m_pConsole, m_pCPU, SLU0_IRQ_EF, SLU0_BREAK_EF);
+  m_pSLU0->AttachInterrupt(m_pPIC->GetLevel(IRQ_SLU0));
+  m_pTLIO->InstallDevice(BASE_GROUP, m_pSLU0);
+  m_pTLIO->InstallSense(BASE_GROUP, m_pSLU0, SLU0_IRQ_EF);
+  m_pTLIO->InstallSense(BASE_GROUP, m_pSLU0, SLU0_BREAK_EF);
 
   // And the IDE disk is attached to group 1, ports 5-6...
-  g_pIDE = DBGNEW CElfDisk(IDE_PORT, g_pEvents);
-  g_pIDE->AttachInterrupt(g_pPIC->GetLevel(IRQ_DISK));
-  g_pTLIO->InstallDevice(BASE_GROUP, g_pIDE);
+  m_pIDE = DBGNEW CElfDisk(IDE_PORT, m_pEvents);
+  m_pIDE->AttachInterrupt(m_pPIC->GetLevel(IRQ_DISK));
+  m_pTLIO->InstallDevice(BASE_GROUP, m_pIDE);
 }
 
-static void CreateExtensionBoard()
+void CSBC1802::CreateExtensionBoard()
 {
   //++
   // Create all the expansion board peripherals ...
   //--
 
   // SLU1 and the TU58 drive ...
-  g_pTU58 = DBGNEW CTU58();
-  g_pSLU1 = DBGNEW CCDP1854("SLU1", SLU1_PORT, g_pEvents, g_pTU58, NULL, SLU1_IRQ_EF, SLU1_SID_EF);
-  g_pSLU1->AttachInterrupt(g_pPIC->GetLevel(IRQ_SLU1));
-  g_pTLIO->InstallDevice(SLU1_GROUP, g_pSLU1);
-  g_pTLIO->InstallSense(SLU1_GROUP, g_pSLU1, SLU1_IRQ_EF);
-  g_pTLIO->InstallSense(SLU1_GROUP, g_pSLU1, SLU1_SID_EF);
+  m_pTU58 = DBGNEW CTU58();
+  m_pSLU1 = DBGNEW CCDP1854("SLU1", SLU1_PORT, m_pEvents, m_pTU58, NULL, SLU1_IRQ_EF, SLU1_SID_EF);
+  m_pSLU1->AttachInterrupt(m_pPIC->GetLevel(IRQ_SLU1));
+  m_pTLIO->InstallDevice(SLU1_GROUP, m_pSLU1);
+  m_pTLIO->InstallSense(SLU1_GROUP, m_pSLU1, SLU1_IRQ_EF);
+  m_pTLIO->InstallSense(SLU1_GROUP, m_pSLU1, SLU1_SID_EF);
 
   // CDP1851 programmable I/O interface w/parallel printer ...
-  g_pPPI = DBGNEW CPrinter("PPI", PPI_PORT, g_pEvents);
-  g_pPPI->AttachInterruptA(g_pPIC->GetLevel(IRQ_PPI));
-  g_pPPI->AttachInterruptB(g_pPIC->GetLevel(IRQ_PPI));
-  g_pTLIO->InstallDevice(PPI_GROUP, g_pPPI);
-  g_pTLIO->InstallSense(PPI_GROUP, g_pPPI, PPI_ARDY_EF);
-  g_pTLIO->InstallSense(PPI_GROUP, g_pPPI, PPI_BRDY_EF);
-  g_pTLIO->InstallSense(PPI_GROUP, g_pPPI, PPI_IRQ_EF);
+  m_pPPI = DBGNEW CPrinter("PPI", PPI_PORT, m_pEvents);
+  m_pPPI->AttachInterruptA(m_pPIC->GetLevel(IRQ_PPI));
+  m_pPPI->AttachInterruptB(m_pPIC->GetLevel(IRQ_PPI));
+  m_pTLIO->InstallDevice(PPI_GROUP, m_pPPI);
+  m_pTLIO->InstallSense(PPI_GROUP, m_pPPI, PPI_ARDY_EF);
+  m_pTLIO->InstallSense(PPI_GROUP, m_pPPI, PPI_BRDY_EF);
+  m_pTLIO->InstallSense(PPI_GROUP, m_pPPI, PPI_IRQ_EF);
 
   // Programmable sound generators ...
-  g_pPSG1 = DBGNEW CPSG("PSG1", PSG1_PORT, g_pEvents);
-  g_pPSG2 = DBGNEW CPSG("PSG2", PSG2_PORT, g_pEvents);
-  g_pTwoPSGs = DBGNEW CTwoPSGs(g_pPSG1, g_pPSG2, g_pEvents);
-  g_pTLIO->InstallDevice(PSG_GROUP, g_pTwoPSGs);
+  m_pPSG1 = DBGNEW CPSG("PSG1", PSG1_PORT, m_pEvents);
+  m_pPSG2 = DBGNEW CPSG("PSG2", PSG2_PORT, m_pEvents);
+  m_pTwoPSGs = DBGNEW CTwoPSGs(m_pPSG1, m_pPSG2, m_pEvents);
+  m_pTLIO->InstallDevice(PSG_GROUP, m_pTwoPSGs);
 
   // CDP1878 counter/timer ...
-  g_pCTC = DBGNEW CCDP1878("CTC", g_pEvents, TIMER_IRQ_EF);
-  g_pCTC->SetClockA(g_pCPU->GetCrystalFrequency());
-  g_pCTC->SetClockB(BAUDCLK/4UL);
+  m_pCTC = DBGNEW CCDP1878("CTC", m_pEvents, TIMER_IRQ_EF);
+  m_pCTC->SetClockA(m_pCPU->GetCrystalFrequency());
+  m_pCTC->SetClockB(BAUDCLK/4UL);
 
-  g_pCTC->AttachInterrupt(g_pPIC->GetLevel(IRQ_TIMER));
-  g_pTLIO->InstallDevice(TIMER_GROUP, g_pCTC);
-  g_pTLIO->InstallSense(TIMER_GROUP, g_pCTC, TIMER_IRQ_EF);
+  m_pCTC->AttachInterrupt(m_pPIC->GetLevel(IRQ_TIMER));
+  m_pTLIO->InstallDevice(TIMER_GROUP, m_pCTC);
+  m_pTLIO->InstallSense(TIMER_GROUP, m_pCTC, TIMER_IRQ_EF);
+}
+
+CSBC1802::CSBC1802 (CEventQueue *pEvents, CSmartConsole *pConsole)
+{
+  //++
+  //   Create one complete SBC1802 - CPU, memory, and all the base board and
+  // extension board peripherals.  Every device schedules its events on the
+  // event queue we're given here, and SLU0 talks to the console, so separate
+  // instances with separate event queues are completely independent.
+  //--
+  assert((pEvents != NULL) && (pConsole != NULL));
+  m_pEvents = pEvents;  m_pConsole = pConsole;
+  CreateBaseBoard();
+  CreateExtensionBoard();
+}
+
+CSBC1802::~CSBC1802()
+{
+  //++
+  //   Delete all the emulated hardware.  Once again, the order here is
+  // important!  If this instance is the one that's selected, then clear
+  // all the global pointers too.
+  //--
+  if (g_pSBC1802 == this) Deselect();
+
+  // First delete the extension board peripherals ...
+  delete m_pCTC;      // CDP1878 counter/timer
+  delete m_pTwoPSGs;  // two PSG implementation
+  delete m_pPSG2;     // programmable sound generator #1
+  delete m_pPSG1;     // programmable sound generator #1
+  delete m_pPPI;      // CDP1851 programmable I/O interface
+  delete m_pSLU1;     // secondary serial line unit (for TU58)
+  delete m_pTU58;     // TU58 tape emulator
+
+  // Delete the base board peripherals, in the reverse order of their creation.
+  delete m_pIDE;      // Elf disk emulator
+  delete m_pSLU0;     // console serial line unit
+  delete m_pBRG;      // baud rate generator
+  delete m_pSwitches; // DIP configuration switches (DELETED by CCPU!)
+  delete m_pLEDS;     // 7 segment POST display (DELETED by CCPU!)
+  delete m_pTLIO;     // two level I/O controller
+  delete m_pCPU;      // the COSMAC CPU
+  delete m_pMemoryMap;// the memory mapping hardware
+  delete m_pMCR;      // memory control register
+  delete m_pRTC;      // the real time clock
+  delete m_pPIC;      // interrupt controller
+  delete m_pROM;      // the EPROM emulation
+  delete m_pRAM;      // the SRAM emulation
+}
+
+void CSBC1802::Select()
+{
+  //++
+  //   Make this instance the one that the UI commands operate on by copying
+  // all our device pointers to the corresponding g_pXXX globals.
+  //--
+  g_pSBC1802 = this;
+  g_pEvents = m_pEvents;  g_pConsole = m_pConsole;
+  g_pRAM = m_pRAM;  g_pROM = m_pROM;  g_pPIC = m_pPIC;  g_pRTC = m_pRTC;
+  g_pMCR = m_pMCR;  g_pMemoryMap = m_pMemoryMap;  g_pCPU = m_pCPU;
+  g_pTLIO = m_pTLIO;  g_pLEDS = m_pLEDS;  g_pSwitches = m_pSwitches;
+  g_pBRG = m_pBRG;  g_pSLU0 = m_pSLU0;  g_pIDE = m_pIDE;
+  g_pTU58 = m_pTU58;  g_pSLU1 = m_pSLU1;  g_pPPI = m_pPPI;
+  g_pPSG1 = m_pPSG1;  g_pPSG2 = m_pPSG2;  g_pTwoPSGs = m_pTwoPSGs;
+  g_pCTC = m_pCTC;
+  CStandardUI::g_pCPU = m_pCPU;  CStandardUI::g_pConsole = m_pConsole;
+}
+
+void CSBC1802::Deselect()
+{
+  //++
+  //   Clear all the device globals (but not the event queue or the console,
+  // which are shared by the whole program) ...
+  //--
+  g_pSBC1802 = NULL;  CStandardUI::g_pCPU = NULL;
+  g_pRAM = g_pROM = NULL;  g_pPIC = NULL;  g_pRTC = NULL;
+  g_pMCR = NULL;  g_pMemoryMap = NULL;  g_pCPU = NULL;
+  g_pTLIO = NULL;  g_pLEDS = NULL;  g_pSwitches = NULL;
+  g_pBRG = NULL;  g_pSLU0 = g_pSLU1 = NULL;  g_pIDE = NULL;
+  g_pTU58 = NULL;  g_pPPI = NULL;  g_pPSG1 = g_pPSG2 = NULL;
+  g_pTwoPSGs = NULL;  g_pCTC = NULL;
 }
 
 int main (int argc, char *argv[])
@@ -267,14 +350,14 @@ int main (int argc, char *argv[])
   CMDOUTS("Built on " << __DATE__ << " " << __TIME__);
  //CMDOUTF("Word size = %d; Address size = %d; default radix = %d", WORDSIZE, ADDRSIZE, RADIX);
 
-  // Create the base board peripherals ...
-  CreateBaseBoard();
-
-  // Create the extension board peripherals ...
-  CreateExtensionBoard();
+  //   Create the SBC1802 itself, both base board and extension board, and
+  // make it the machine that all the UI commands operate on ...
+  g_pSBC1802 = DBGNEW CSBC1802(g_pEvents, g_pConsole);
+  g_pSBC1802->Select();
 
   //   Lastly, create the command line parser.  If a startup script was
   // specified on the command line, now is the time to execute it...
+  g_pCPU->SetWarpConsole(g_pConsole);
   g_pParser = DBGNEW CCmdParser(PROGRAM, CUI::g_aVerbs, &ConfirmExit, g_pConsole);
   if (!CStandardUI::g_sStartupScript.empty())
     g_pParser->OpenScript(CStandardUI::g_sStartupScript);
@@ -284,34 +367,12 @@ int main (int argc, char *argv[])
   // types "EXIT" or "QUIT", the command parser exits and then we shutdown
   // the SBC1802 program.
   g_pParser->CommandLoop();
+  CStandardUI::DumpStatistics();
   LOGS(DEBUG, "command parser exited");
 
   // Delete all our global objects.  Once again, the order here is important!
   delete g_pParser;   // the command line parser can go away first
-
-  // First delete the extension board peripherals ...
-  delete g_pCTC;      // CDP1878 counter/timer
-  delete g_pTwoPSGs;  // two PSG implementation
-  delete g_pPSG2;     // programmable sound generator #1
-  delete g_pPSG1;     // programmable sound generator #1
-  delete g_pPPI;      // CDP1851 programmable I/O interface
-  delete g_pSLU1;     // secondary serial line unit (for TU58)
-  delete g_pTU58;     // TU58 tape emulator
-
-  // Delete the base board peripherals, in the reverse order of their creation.
-  delete g_pIDE;      // Elf disk emulator
-  delete g_pSLU0;     // console serial line unit
-  delete g_pBRG;      // baud rate generator
-  delete g_pSwitches; // DIP configuration switches (DELETED by CCPU!)
-  delete g_pLEDS;     // 7 segment POST display (DELETED by CCPU!)
-  delete g_pTLIO;     // two level I/O controller
-  delete g_pCPU;      // the COSMAC CPU
-  delete g_pMemoryMap;// the memory mapping hardware
-  delete g_pMCR;      // memory control register
-  delete g_pRTC;      // the real time clock
-  delete g_pPIC;      // interrupt controller
-  delete g_pROM;      // the EPROM emulation
-  delete g_pRAM;      // the SRAM emulation
+  delete g_pSBC1802;  // then all the emulated hardware
 
   // Lastly we can get rid of the log file, console window and event queue.
 shutdown:
@@ -22,6 +22,7 @@
 //
 // REVISION HISTORY:
 // 16-JUN-22  RLA   Adapted from ELF2K.
+// 16-OCT-26  RLA   Add the CSBC1802 machine instance class.
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -120,3 +121,61 @@ extern class CPSG           *g_pPSG2;         // AY-3-8912 programmable sound ge
 extern class CTwoPSGs       *g_pTwoPSGs;      // SBC1802 implementation of two PSGs
 extern class CPrinter       *g_pPPI;          // CDP1851 programmable I/O interface
 extern class CCDP1878       *g_pCTC;          // CDP1878 counter/timer
+
+
+class CSBC1802 {
+  //++
+  //   One instance of this class owns all the hardware for one complete
+  // SBC1802 - CPU, memory, and every base and extension board peripheral.
+  // It doesn't own the event queue or the console; those are passed to the
+  // constructor, and a machine with its own event queue is entirely separate
+  // from any other.  The UI still uses the g_pXXX globals above, and Select()
+  // points them all at this instance.
+  //--
+
+  // Constructor and destructor ...
+public:
+  CSBC1802 (class CEventQueue *pEvents, class CSmartConsole *pConsole);
+  virtual ~CSBC1802();
+private:
+  // Disallow copy and assignments!
+  CSBC1802 (const CSBC1802&) = delete;
+  CSBC1802& operator= (CSBC1802 const&) = delete;
+
+  // Public methods ...
+public:
+  // Point the g_pXXX globals at this machine, or clear them ...
+  void Select();
+  static void Deselect();
+
+  // Private methods ...
+private:
+  void CreateBaseBoard();
+  void CreateExtensionBoard();
+
+  // Private member data ...
+private:
+  class CEventQueue    *m_pEvents;      // event queue (NOT owned by us!)
+  class CSmartConsole  *m_pConsole;     // console window (NOT owned either)
+  class CCOSMAC        *m_pCPU;         // 1802 COSMAC CPU
+  class CGenericMemory *m_pRAM;         // SRAM emulation
+  class CGenericMemory *m_pROM;         // EPROM emulation
+  class CMemoryControl *m_pMCR;         // memory control register
+  class CMemoryMap     *m_pMemoryMap;   // memory mapping hardware
+  class CTLIO          *m_pTLIO;        // two level I/O controller
+  class CLEDS          *m_pLEDS;        // 7 segment LED display
+  class CSwitches      *m_pSwitches;    // DIP switches
+  class CBaud          *m_pBRG;         // baud rate generator for SLU0 & 1
+  class CCDP1854       *m_pSLU0;        // console UART
+  class CElfDisk       *m_pIDE;         // IDE disk interface
+  class CCDP1879       *m_pRTC;         // CDP1879 real time clock
+  class CCDP1877       *m_pPIC;         // CDP1877 interrupt controller
+  class CCDP1854       *m_pSLU1;        // secondary UART (for TU58)
+  class CTU58          *m_pTU58;        // TU58 drive emulator
+  class CPSG           *m_pPSG1;        // programmable sound generator #1
+  class CPSG           *m_pPSG2;        // programmable sound generator #2
+  class CTwoPSGs       *m_pTwoPSGs;     // SBC1802 implementation of two PSGs
+  class CPrinter       *m_pPPI;         // CDP1851 programmable I/O interface
+  class CCDP1878       *m_pCTC;         // CDP1878 counter/timer
+};
+extern CSBC1802             *g_pSBC1802;      // the selected SBC1802 machine
@@ -50,6 +50,7 @@
 //
 // REVISION HISTORY:
 // 29-OCT-24  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -69,6 +70,7 @@
 #include "COSMAC.hpp"           // CDP1802 COSMAC specific defintions
 #include "Device.hpp"           // generic device definitions
 #include "PSG.hpp"              // programmable sound generator
+#include "StateFile.hpp"        // CStateFile declarations
 #include "TwoPSGs.hpp"          // declarations for this module
 
 
@@ -139,3 +141,12 @@ void CTwoPSGs::ShowDevice (ostringstream &ofs) const
   // routines directly!
   //--
 }
+
+void CTwoPSGs::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the last port address.  The two PSG chips themselves are
+  // saved separately ...
+  //--
+  State.Sync(m_nLastN);
+}
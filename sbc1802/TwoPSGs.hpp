@@ -23,6 +23,7 @@
 //
 // REVISION HISTORY:
 // 29-OCT-24  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -57,6 +58,7 @@ public:
   virtual word_t DevRead (address_t nRegister) override;
   virtual void DevWrite (address_t nRegister, word_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Private methods ...
 protected:
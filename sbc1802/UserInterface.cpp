@@ -35,6 +35,9 @@
 //      /RO*M                   -   "   "     "    "  ROM    "      "
 //      /OVER*WRITE             - don't prompt if file already exists (SAVE only!)
 //
+//   SA*VE STA*TE filename      - save the entire machine state
+//   LO*AD STA*TE filename      - restore the entire machine state
+//
 //   ATT*ACH DI*SK filename     - attach IDE drive to image file
 //   DET*ACH DI*SK              - detach IDE drive
 //      /UNIT=0|1               - 0 -> master, 1-> slave
@@ -103,6 +106,11 @@
 //      /DEL*AY=delay           - set character delay, in milliseconds
 //   RE*CEIVE/X*MODEM/CL*OSE    - abort any XMODEM transfer in progress
 //
+//   RECO*RD <file>             - record console input and its timing
+//   RECO*RD/CL*OSE             - stop recording console input
+//   REPL*AY <file>             - replay recorded console input
+//   REPL*AY/CL*OSE             - stop replaying console input
+//
 //   SH*OW MEM*ORY              - show memory map for all modes
 //   CL*EAR MEM*ORY             - clear ALL of memory (RAM and ROM, not NVR!)
 //      /RAM                    - clear RAM address space only ***
@@ -212,6 +220,9 @@
 // 25-MAR-25  RLA   Add SET DEVICE xxx/ENABLE or /DISABLE for RTC, PIC,
 //                  PPI, CTC, and PSG1 & 2
 // 28-MAR-25  RLA   Add ATTACH PRINTER, DETACH PRINTER and SET DEVICE PRINTER.
+// 16-OCT-26  RLA   Add SAVE STATE and LOAD STATE
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -256,6 +267,7 @@
 #include "Timer.hpp"            // generic counter/timer
 #include "CDP1878.hpp"          // CDP1878 specific counter/timer
 #include "ElfDisk.hpp"          // SBC1802/ELF2K to IDE interface
+#include "StateFile.hpp"        // machine state save and restore
 #include "UserInterface.hpp"    // emulator user interface parse table definitions
 
 // LOAD/SAVE file format keywords ...
@@ -343,8 +355,15 @@ CCmdModifier * const CUI::m_modsLoad[] = {&m_modFileFormat, &m_modBaseAddress,
 CCmdModifier * const CUI::m_modsSave[] = {&m_modFileFormat, &m_modBaseAddress,
                                           &m_modByteCount, &m_modROM, 
                                           &m_modOverwrite, NULL};
-CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoad);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsSave);
+CCmdVerb * const CUI::g_aLoadVerbs[] = {&m_cmdLoadState, NULL};
+CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoad, g_aLoadVerbs);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, &m_cmdSaveState, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsSave, g_aSaveVerbs);
+
+// LOAD STATE and SAVE STATE commands ...
+CCmdArgument * const CUI::m_argsState[] = {&m_argFileName, NULL};
+CCmdVerb CUI::m_cmdLoadState("STA*TE", &DoLoadState, m_argsState, NULL);
+CCmdVerb CUI::m_cmdSaveState("STA*TE", &DoSaveState, m_argsState, NULL);
 
 // ATTACH and DETACH commands ...
 CCmdArgument * const CUI::m_argsAttach[] = {&m_argFileName, NULL};
@@ -398,7 +417,7 @@ CCmdVerb CUI::m_cmdInput("IN*PUT", &DoInput, m_argsInput, NULL);
 // SET, CLEAR and SHOW CPU ...
 CCmdModifier * const CUI::m_modsSetCPU[] = {
     &m_modCPUextended, &m_modIllegalIO, &m_modIllegalOpcode,
-    &m_modBreakChar, &m_modClockFrequency, NULL
+    &m_modBreakChar, &m_modClockFrequency, &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL
   };
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdClearCPU("CPU", &DoClearCPU);
@@ -430,6 +449,7 @@ CCmdVerb CUI::m_cmdClear("CL*EAR", NULL, NULL, NULL, g_aClearVerbs);
 CCmdVerb * const CUI::g_aSetVerbs[] = {
     &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetDevice,
     &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+    &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
 #ifdef THREADS
     &CStandardUI::m_cmdSetCheckpoint,
 #endif
@@ -443,6 +463,7 @@ CCmdVerb * const CUI::g_aShowVerbs[] = {
     &m_cmdShowBreakpoint, &m_cmdShowMemory, &m_cmdShowCPU, &m_cmdShowDevice,
     &m_cmdShowVersion,
     &CStandardUI::m_cmdShowLog, &CStandardUI::m_cmdShowAliases,
+    &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
 #ifdef THREADS
     &CStandardUI::m_cmdShowCheckpoint,
 #endif
@@ -463,12 +484,13 @@ CCmdVerb * const CUI::g_aVerbs[] = {
   &m_cmdLoad, &m_cmdSave, &m_cmdAttach, &m_cmdDetach,
   &m_cmdExamine, &m_cmdDeposit,
   &m_cmdSendFile, &m_cmdReceiveFile, 
+  &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdRun, &m_cmdContinue, &m_cmdStep, &m_cmdReset,
   &m_cmdInput, &m_cmdSet, &m_cmdShow, &m_cmdClear,
   &CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -635,6 +657,95 @@ bool CUI::DoSave (CCmdParser &cmd)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////// SAVE STATE and LOAD STATE COMMANDS /////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void CUI::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the state of every object in the SBC1802, each in its own
+  // section.  The order doesn't matter much, EXCEPT that the event queue must
+  // be last so that all the event handlers are known by then!  Note that the
+  // two PSG chips aren't in the two level I/O map - only CTwoPSGs is - so we
+  // have to save them separately.
+  //--
+  State.Sync("CPU", g_pCPU);
+  State.Sync("RAM", g_pRAM);
+  State.Sync("ROM", g_pROM);
+  State.Sync("PIC", g_pPIC);
+  State.Sync("MCR", g_pMCR);
+  State.Sync("RTC", g_pRTC);
+  State.Sync("TLIO", g_pTLIO);
+  State.Sync("LEDS", g_pLEDS);
+  State.Sync("SWITCHES", g_pSwitches);
+  State.Sync("BRG", g_pBRG);
+  State.Sync("SLU0", g_pSLU0);
+  State.Sync("IDE", g_pIDE);
+  State.Sync("SLU1", g_pSLU1);
+  State.Sync("TU58", g_pTU58);
+  State.Sync("PPI", g_pPPI);
+  State.Sync("PSG1", g_pPSG1);
+  State.Sync("PSG2", g_pPSG2);
+  State.Sync("PSGS", g_pTwoPSGs);
+  State.Sync("CTC", g_pCTC);
+  State.Sync("CONSOLE", g_pConsole);
+  State.Sync("EVENTS", g_pEvents);
+}
+
+bool CUI::DoSaveState (CCmdParser &cmd)
+{
+  //++
+  //   SAVE STATE writes a snapshot of the entire machine - CPU, memory, all
+  // devices and any pending events - to a file.  LOAD STATE can restore it
+  // later and continue exactly where we left off.  Note that the contents of
+  // any attached disk or tape images are NOT saved, only their names.
+  //
+  // Format:
+  //    SAVE STATE <file>
+  //--
+  string sFileName = m_argFileName.GetFullPath();
+  sFileName = CCmdParser::SetDefaultExtension(sFileName, DEFAULT_STATE_FILE_TYPE);
+  if (FileExists(sFileName)) {
+    if (!cmd.AreYouSure(sFileName + " already exists")) return false;
+  }
+  CStateFile State(PROGRAM, false);
+  SyncState(State);
+  if (!State.Write(sFileName)) {
+    CMDERRS("unable to save state - " << State.GetError());  return false;
+  }
+  CMDOUTF("machine state saved to %s", sFileName.c_str());
+  return true;
+}
+
+bool CUI::DoLoadState (CCmdParser &cmd)
+{
+  //++
+  //   LOAD STATE restores a machine state saved by SAVE STATE.  The file has
+  // to be from the same emulator with the same configuration (e.g. memory
+  // sizes), and that's checked as we go.  If anything goes wrong after we've
+  // started loading, then the machine is left in an undefined state!
+  //
+  // Format:
+  //    LOAD STATE <file>
+  //--
+  string sFileName = m_argFileName.GetFullPath();
+  sFileName = CCmdParser::SetDefaultExtension(sFileName, DEFAULT_STATE_FILE_TYPE);
+  CStateFile State(PROGRAM, true);
+  if (!State.Read(sFileName)) {
+    CMDERRS("unable to load state - " << State.GetError());  return false;
+  }
+  SyncState(State);
+  if (!State.IsOK()) {
+    CMDERRS("unable to load state - " << State.GetError());
+    CMDERRS("machine state is undefined - RESET recommended");
+    return false;
+  }
+  CMDOUTF("machine state loaded from %s", sFileName.c_str());
+  return true;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////// ATTACH and DETACH COMMANDS //////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -1189,7 +1300,6 @@ bool CUI::DoReceiveFile (CCmdParser &cmd)
     return g_pConsole->OpenLog(sFileName, fAppend);
 }
 
-
 ////////////////////////////////////////////////////////////////////////////////
 /////////////////// RUN, STEP, CONTINUE and RESET COMMANDS /////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -1232,6 +1342,10 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
     case CCPU::STOP_NONE:    break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -1447,6 +1561,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   // vaious options (e.g. stop on illegal I/O, stop on illegal opcode, etc).
   //--
   assert(g_pCPU != NULL);
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modIllegalIO.IsPresent())
     g_pCPU->StopOnIllegalIO(m_argStopIO.GetKeyValue() != 0);
   if (m_modIllegalOpcode.IsPresent())
@@ -1477,6 +1593,8 @@ bool CUI::DoShowCPU (CCmdParser &cmd)
   double flMajorCycle = CCOSMAC::CLOCKS_PER_CYCLE / flCrystal;
   CMDOUTF("%s %s %3.2fMHz (%3.2fus per microcycle)",
     g_pCPU->GetName(), g_pCPU->GetDescription(), flCrystal, flMajorCycle);
+  CMDOUTS("Simulation speed " << CStandardUI::GetCPUspeed());
+  CMDOUTS("Idle loops       " << CStandardUI::GetCPUwarp());
   CMDOUTF("%s instruction set, BREAK is Control-%c",
     g_pCPU->IsExtended() ? "Extended" : "Standard", g_pConsole->GetConsoleBreak() + '@');
   CMDOUTF("%s on illegal opcode, %s on illegal I/O",
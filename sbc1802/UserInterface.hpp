@@ -29,6 +29,9 @@
 //
 // REVISION HISTORY:
 // 16-JUN-22  RLA   Adapted from ELF2K.
+// 16-OCT-26  RLA   Add SAVE STATE and LOAD STATE
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -127,6 +130,10 @@ private:
   static CCmdModifier * const m_modsSave[];
   static CCmdVerb m_cmdLoad, m_cmdSave;
 
+  // LOAD STATE and SAVE STATE commands ...
+  static CCmdArgument * const m_argsState[];
+  static CCmdVerb m_cmdLoadState, m_cmdSaveState;
+
   // ATTACH and DETACH commands ...
   static CCmdArgument * const m_argsAttach[];
   static CCmdModifier * const m_modsDetach[];
@@ -175,6 +182,8 @@ private:
   static CCmdVerb m_cmdShowVersion;
   static CCmdVerb * const g_aSetVerbs[];
   static CCmdVerb * const g_aShowVerbs[];
+  static CCmdVerb * const g_aLoadVerbs[];
+  static CCmdVerb * const g_aSaveVerbs[];
   static CCmdVerb * const g_aClearVerbs[];
   static CCmdVerb m_cmdClear, m_cmdSet, m_cmdShow;
 
@@ -192,6 +201,7 @@ public:
   // Verb action routines ....
 private:
   static bool DoLoad(CCmdParser &cmd), DoSave(CCmdParser &cmd);
+  static bool DoLoadState(CCmdParser &cmd), DoSaveState(CCmdParser &cmd);
   static bool DoDeposit(CCmdParser &cmd), DoExamine(CCmdParser &cmd);
   static bool DoAttachDisk(CCmdParser &cmd), DoDetachDisk(CCmdParser &cmd);
   static bool DoAttachTape(CCmdParser &cmd), DoDetachTape(CCmdParser &cmd);
@@ -228,4 +238,5 @@ private:
   static string ShowDeviceSense (const class CDevice *pDevice);
   static string ShowBreakpoints (const CGenericMemory *pMemory);
   static bool DoCloseSend(CCmdParser &cmd), DoCloseReceive(CCmdParser &cmd);
+  static void SyncState (class CStateFile &State);
 };
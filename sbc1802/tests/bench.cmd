@@ -0,0 +1,39 @@
+; Headless benchmark - run a compute bound checksum loop for 200 seconds ...
+;
+;   The loop sums the first page of the EPROM into R8.0, over and over, and
+; never waits for the console or executes an IDL, so the results measure the
+; CPU and memory rather than the idle loop fast forward ...
+;
+;   RAM isn't mapped at 0000 after a reset, so a short prologue in the
+; scratchpad RAM selects the ROM0 memory map first ...
+;
+;	FE80	F8 FE	LDI	FE	; R9 = FEE7 (the MCR)
+;	FE82	B9	PHI	9
+;	FE83	F8 E7	LDI	E7
+;	FE85	A9	PLO	9
+;	FE86	F8 04	LDI	04	; select the ROM0 map
+;	FE88	59	STR	9
+;	FE89	C0 0000	LBR	0000	; and go run the loop from RAM
+;
+;	0000	E7	SEX	7	; X = R7 (data pointer)
+;	0001	F8 80	LDI	80	; R7 = 8000 (the first page of EPROM)
+;	0003	B7	PHI	7
+;	0004	F8 00	LDI	00
+;	0006	A7	PLO	7
+;	0007	88	GLO	8	; D = running sum
+;	0008	F4	ADD		;  ... plus the next byte
+;	0009	A8	PLO	8	;  ... and save it again
+;	000A	17	INC	7	; bump the pointer
+;	000B	87	GLO	7	;  ... and loop for 256 bytes
+;	000C	3A 07	BNZ	07
+;	000E	30 01	BR	01	; then start over
+set logging/console/level=warning
+set cpu/extended
+clear memory
+load eprom.hex/rom
+reset
+deposit 0fe80 F8,FE,B9,F8,E7,A9,F8,04,59,C0,00,00
+deposit 0 E7,F8,80,B7,F8,00,A7,88,F4,A8,17,87,3A,07,30,01
+deposit r0 0fe80
+benchmark 200
+show statistics
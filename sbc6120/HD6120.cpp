@@ -100,6 +100,14 @@
 // REVISION HISTORY:
 // 31-JUL-22  RLA  New file.
 //  6-NOV-24  RLA  Add set default CPU clock to constructor.
+// 15-OCT-26  RLA  Only check events and interrupts at the horizon
+// 16-OCT-26  RLA  Skip ahead when spinning in an idle or polling loop
+// 16-OCT-26  RLA  Cache the control panel interrupt attention word
+// 16-OCT-26  RLA  Count instructions executed
+// 16-OCT-26  RLA  Call the profiler and add DisassembleInstruction()
+// 16-OCT-26  RLA  Count interrupts acknowledged
+// 16-OCT-26  RLA  Record the instruction trace buffer
+// 16-OCT-26  RLA  Device IOTs are writes for idle loop detection
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -145,6 +153,7 @@ C6120::C6120(CMemory *pMainMemory, CMemory *pPanelMemory, CEventQueue *pEvent,
   //--
   m_pMainMemory = pMainMemory;  m_pPanelDirect = m_pPanelIndirect = pPanelMemory;
   m_pMainInterrupt = pMainInterrupt;  m_pPanelInterrupt = pPanelInterrupt;
+  m_plPanelAttention = (pPanelInterrupt != NULL) ? pPanelInterrupt->GetAttention() : &g_lNoAttention;
   m_StartupMode = STARTUP_PANEL;  m_fHLThalts = false;
   SetCrystalFrequency(DEFAULT_CLOCK);
   ClearCPU();
@@ -564,8 +573,9 @@ void C6120::DoGroup2()
   if (ISSET(m_IR, 0002)) {
     if (IsStopOnHalt())
       m_nStopCode = STOP_HALT;
-    else
-      SETFF(FF_HLTFLG);
+    else {
+      SETFF(FF_HLTFLG);  InvalidateHorizon();
+    }
   }
 
   // All these take 7 clocks (except OSR, which takes one more) ...
@@ -963,7 +973,10 @@ void C6120::Do62xx()
 void C6120::DoIOT()
 {
   //++
+  //   Note that any IOT, including all the 600x and 62xx internal ones, might
+  // change the interrupt state so we always invalidate the horizon here.
   //--
+  InvalidateHorizon();
   word_t wDevice = (m_IR & 0770) >> 3;
   if (wDevice == 0)
     Do600x();
@@ -976,9 +989,15 @@ void C6120::DoIOT()
     // doesn't really apply to the PDP8.  We assume all PDP8 devices are marked
     // as INOUT and thus appear on both maps, but just to be safe we'll search
     // them both.
+    //
+    //   There's no way to tell an IOT that only tests a flag from one that
+    // outputs something (TLS, a disk command, etc), so every IOT that reaches
+    // a device counts as a write for the idle loop detection.  Otherwise a
+    // loop that does output could be skipped, and the output lost.
     CDevice *pDevice = FindInputDevice(wDevice);
     if (pDevice == NULL) pDevice = FindOutputDevice(wDevice);
     if (pDevice != NULL) {
+      LoopWrite();
       if (!pDevice->DevIOT(m_IR, m_AC, m_PC)) UnimplementedIO();
     } else
       UnimplementedIO();
@@ -1017,7 +1036,7 @@ void C6120::IBtoIF()
     if (ISFF(FF_IIFF)) CLRFF(FF_FZ);
     if (ISFF(FF_PEXIT)) {
       CLRFF(FF_CTRL|FF_PEXIT);  SETFF(FF_FFETCH);
-      UpdateMemoryPointers();
+      UpdateMemoryPointers();  InvalidateHorizon();
     }
   }
   m_IF = m_IB;  CLRFF(FF_IIFF);
@@ -1082,10 +1101,19 @@ void C6120::PanelInterrupt()
 void C6120::FetchAndExecute()
 {
   //++
-  // Fetch and execute one instruction...
+  //   Fetch and execute one instruction.  If the instruction trace is enabled,
+  // the registers are recorded before the instruction executes ...
   //--
   m_MA = m_PC;  m_nLastPC = m_IF|m_PC;
+  TRACE_ENTRY *pTrace = NextTrace();
+  if (pTrace != NULL) {
+    pTrace->awRegisters[0] = m_AC;  pTrace->awRegisters[1] = m_MQ;
+    pTrace->awRegisters[2] = m_PS;  pTrace->awRegisters[3] = m_DF >> 12;
+    pTrace->awRegisters[4] = m_SP1;  pTrace->awRegisters[5] = m_SP2;
+    pTrace->awRegisters[6] = IsPanel() ? 1 : 0;
+  }
   m_PC = INC12(m_PC);  m_IR = ReadDirect();
+  if (pTrace != NULL) pTrace->lOpcode = m_IR;
            if (m_IR < 06000) DoMRI();
       else if (m_IR < 07000) DoIOT();
       else if ((m_IR & 00400) == 0) DoGroup1();
@@ -1093,6 +1121,55 @@ void C6120::FetchAndExecute()
       else                          DoGroup3();
 }
 
+size_t C6120::DisassembleInstruction (address_t nPC, string &sCode) const
+{
+  //++
+  //   Disassemble the instruction at nPC for the profiler.  Every PDP-8
+  // instruction is one word.  Note that the profiler doesn't distinguish
+  // between control panel and main memory addresses, and we always show
+  // what's in main memory here.
+  //--
+  sCode = ::Disassemble(nPC, m_pMainMemory->CPUread(nPC));
+  return 1;
+}
+
+const char *const *C6120::GetTraceNames() const
+{
+  //++
+  //   Return the names of the registers saved in each instruction trace entry.
+  // The IF is part of the PC, and CP is 1 for control panel instructions ...
+  //--
+  static const char *const apszNames[] = {
+    "AC", "MQ", "PS", "DF", "SP1", "SP2", "CP", NULL
+  };
+  return apszNames;
+}
+
+void C6120::DisassembleTrace (const TRACE_ENTRY &Entry, string &sCode) const
+{
+  //++
+  //   PDP-8 instructions are always one word, so we can disassemble the
+  // opcode saved in the trace entry.  That's right even for control panel
+  // memory, which DisassembleInstruction() can't see.
+  //--
+  sCode = ::Disassemble(Entry.nPC, Entry.lOpcode);
+}
+
+bool C6120::GetLoopState (uint64_t &qState) const
+{
+  //++
+  //   Return a hash of all the HD6120 internal registers for the idle loop
+  // detection in CCPU.  Note that the flags include the control panel mode
+  // bit, so the same address in main and panel memory won't be confused.
+  //--
+  qState = LoopHash(0, (m_AC << 12) | m_MQ);
+  qState = LoopHash(qState, (m_PS << 12) | m_Flags);
+  qState = LoopHash(qState, (m_SP1 << 12) | m_SP2);
+  qState = LoopHash(qState, (m_DF << 16) | m_IB);
+  qState = LoopHash(qState, (m_IF << 16) | m_PC);
+  return true;
+}
+
 CCPU::STOP_CODE C6120::Run (uint32_t nCount)
 {
   //++
@@ -1104,58 +1181,78 @@ CCPU::STOP_CODE C6120::Run (uint32_t nCount)
   // an illegal opcode or I/O, the user entering the escape sequence on 
   // the console, etc.  If nCount is zero on entry, then we will run for-       
   // ever until one of the previously mentioned break conditions arises.        
+  //
+  //   Device events and interrupt requests are only checked when we reach the
+  // event queue horizon.  That's normally the time of the next event, but any
+  // IOT, HLT, or exit from panel mode invalidates the horizon so that we'll
+  // check again before the next instruction.
   //--
   bool fFirst = true;
-  m_nStopCode = STOP_NONE;
+  m_nStopCode = STOP_NONE;  InvalidateHorizon();  ResetIdleLoop();
 
   while (m_nStopCode == STOP_NONE) {
-    // If any device events need to happen, now is the time...
-    DoEvents();
-
-    //   If the interrupt inhibit (IIFF) is set then no interrupts, neither
-    // panel nor main, are recognized.  If the force fetch (FFETCH) flag is
-    // set, then all interrupts are ignored until after the next instruction
-    // is fetched and executed.  This is used to guarantee that at least one
-    // instruction will be executed after an ION or panel exit.
-    if (!ISFF(FF_IIFF) && !ISFF(FF_FFETCH)) {
-      //   Check for external control panel interrupt requests and set the
-      // BTSTRP flag if we find one ...
-      if (IsCPREQ()) {
-        SETFF(FF_BTSTRP);  m_pPanelInterrupt->AcknowledgeRequest();
-      }
-      //   If any of the four flags, PWRON, PNLTRP, BTSTRP, or HLTFLG are set
-      // then force a panel interrupt.  Don't even bother checking for main
-      // memory interrupts in that case because those won't be acknowledged.
+    //   Skip all the interrupt stuff unless we've reached the horizon ...
+    if (AtHorizon()) {
+      // If any device events need to happen, now is the time...
+      DoHorizon();
+
+      //   If the interrupt inhibit (IIFF) is set then no interrupts, neither
+      // panel nor main, are recognized.  If the force fetch (FFETCH) flag is
+      // set, then all interrupts are ignored until after the next instruction
+      // is fetched and executed.  This is used to guarantee that at least one
+      // instruction will be executed after an ION or panel exit.
       //
-      //   However, if no panel interrupt is pending and main interrupts are
-      // enabled by the IEFF, then check for a main memory interrupt.
-      //
-      //   And it probably doesn't need mentioning, but there's no interrupt
-      // (neither panel nor main) if we're already in panel memory!
-      if (!IsPanel()) {
-        if (ISFF(FF_PWRON|FF_PNLTRP|FF_BTSTRP|FF_HLTFLG)) {
-          PanelInterrupt();
-        } else if (ISPS(PS_IEFF) && IsIRQ()) {
-          MainInterrupt();
+      //   Either way, IIFF is cleared by the next JMP or JMS and FFETCH is
+      // cleared after the next instruction, so until they're both gone we
+      // have to keep checking after every instruction.
+      if (ISFF(FF_IIFF) || ISFF(FF_FFETCH)) {
+        InvalidateHorizon();
+      } else {
+        //   Check for external control panel interrupt requests and set the
+        // BTSTRP flag if we find one ...
+        if (IsCPREQ()) {
+          SETFF(FF_BTSTRP);  m_pPanelInterrupt->AcknowledgeRequest();
+        }
+        //   If any of the four flags, PWRON, PNLTRP, BTSTRP, or HLTFLG are set
+        // then force a panel interrupt.  Don't even bother checking for main
+        // memory interrupts in that case because those won't be acknowledged.
+        //
+        //   However, if no panel interrupt is pending and main interrupts are
+        // enabled by the IEFF, then check for a main memory interrupt.
+        //
+        //   And it probably doesn't need mentioning, but there's no interrupt
+        // (neither panel nor main) if we're already in panel memory!
+        if (!IsPanel()) {
+          if (ISFF(FF_PWRON|FF_PNLTRP|FF_BTSTRP|FF_HLTFLG)) {
+            PanelInterrupt();  ++m_qInterrupts;
+          } else if (ISPS(PS_IEFF) && IsIRQ()) {
+            MainInterrupt();  ++m_qInterrupts;
+          }
         }
       }
+      CLRFF(FF_FFETCH);
     }
-    CLRFF(FF_FFETCH);
 
     // Stop after we hit a breakpoint ...
-    if (!fFirst && m_pMemoryDirect->IsBreak(IForZ()|m_PC)) {
+    if (!fFirst && m_pMemoryDirect->CheckBreak(IForZ()|m_PC)) {
       m_nStopCode = STOP_BREAKPOINT;  break;
     }
     fFirst = false;
 
     // Ok, we're ready to execute one instruction!
-    FetchAndExecute();
+    FetchAndExecute();  ++m_qInstructions;
 
     //   If the PC hasn't changed and interrupts are disabled, then we're stuck
     // in an infinite loop!
     if (((m_IF | m_PC) == m_nLastPC) && !ISPS(PS_IEFF))
       m_nStopCode = STOP_ENDLESS_LOOP;
 
+    // Skip ahead if we're spinning in an idle or polling loop ...
+    CheckIdleLoop(m_IF|m_PC);
+
+    // Charge this instruction to the profiler, if it's enabled ...
+    Profile(m_nLastPC);
+
     // Terminate if we've executed enough instructions ... 
     if (m_nStopCode == STOP_NONE) {
       if ((nCount > 0) && (--nCount == 0))  m_nStopCode = STOP_FINISHED;
@@ -23,6 +23,10 @@
 //
 // REVISION HISTORY:
 // 31-JUL-22  RLA   Copied from C2650.
+// 16-OCT-26  RLA   Add GetLoopState() for idle loop detection
+// 16-OCT-26  RLA   Test the interrupt attention words in IsIRQ() and IsCPREQ()
+// 16-OCT-26  RLA   Add DisassembleInstruction() for the profiler
+// 16-OCT-26  RLA   Add GetTraceNames() and DisassembleTrace() for the trace
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -139,6 +143,14 @@ public:
   // Get the address of the next instruction to be executed ...
   virtual address_t GetPC() const override {return m_IF|m_PC;}
   virtual void SetPC (address_t a) override {m_IF = m_IB = (a & 070000);  m_PC = (a & 07777);}
+  // Disassemble one instruction (used by the profiler) ...
+  virtual size_t DisassembleInstruction (address_t nPC, string &sCode) const override;
+  // Addresses are always shown in octal ...
+  virtual unsigned GetAddressRadix() const override {return 8;}
+  // Return the names of the registers saved in the instruction trace ...
+  virtual const char *const *GetTraceNames() const override;
+  // Disassemble a trace entry from the saved opcode ...
+  virtual void DisassembleTrace (const TRACE_ENTRY &Entry, string &sCode) const override;
   // Return the instruction at the PC (used for tracing) ...
   inline word_t GetCurrentInstruction() const {return ReadDirect(m_PC);}
   // Get or set the startup mode ...
@@ -159,8 +171,8 @@ public:
   void SetPanelIndirect (CMemory *pMemory)
     {m_pPanelIndirect = pMemory;  UpdateMemoryPointers();}
   // TRUE if an interrupt is current requested ...
-  inline bool IsIRQ() const {return (m_pMainInterrupt != NULL) && m_pMainInterrupt->IsRequested();}
-  inline bool IsCPREQ() const {return (m_pPanelInterrupt != NULL) && m_pPanelInterrupt->IsRequested();}
+  inline bool IsIRQ() const {return IsAttention() && m_pMainInterrupt->IsRequested();}
+  inline bool IsCPREQ() const {return (*m_plPanelAttention != 0) && m_pPanelInterrupt->IsRequested();}
 
   // HD6120 public methods ...
 public:
@@ -197,14 +209,14 @@ private:
   inline bool IsFZ() const {return (m_Flags & (FF_FZ|FF_CTRL)) == (FF_FZ|FF_CTRL);}
   inline address_t IForZ() const {return IsFZ() ? 0 : m_IF;}
   // Read/Write memory using the instruction field and the direct memory space ...
-  inline word_t ReadDirect (word_t ea) const {return m_pMemoryDirect->CPUread(IForZ() | ea);}
+  inline word_t ReadDirect (word_t ea) const {return m_pMemoryDirect->FastRead(IForZ() | ea);}
   inline word_t ReadDirect() const {return ReadDirect(m_MA);}
-  inline void WriteDirect (word_t ea, word_t md) {m_pMemoryDirect->CPUwrite((IForZ() | ea), md);}
+  inline void WriteDirect (word_t ea, word_t md) {LoopWrite();  m_pMemoryDirect->FastWrite((IForZ() | ea), md);}
   inline void WriteDirect (word_t md) {WriteDirect(m_MA, md);}
   // Read/Write memory using the data field and the indirect memory space ...
-  inline word_t ReadIndirect (word_t eq) const {return m_pMemoryIndirect->CPUread(m_DF | eq);}
+  inline word_t ReadIndirect (word_t eq) const {return m_pMemoryIndirect->FastRead(m_DF | eq);}
   inline word_t ReadIndirect() const {return ReadIndirect(m_MA);}
-  inline void WriteIndirect (word_t ea, word_t md) {m_pMemoryIndirect->CPUwrite((m_DF | ea), md);}
+  inline void WriteIndirect (word_t ea, word_t md) {LoopWrite();  m_pMemoryIndirect->FastWrite((m_DF | ea), md);}
   inline void WriteIndirect (word_t md) {WriteIndirect(m_MA, md);}
 
   // Basic, non-memory, PDP-8 operations ...
@@ -243,8 +255,8 @@ private:
   // HD6120 stack operations ...
 private:
   //   Note that the stacks are ALWAYS in field zero, regardless of the DF ...
-  inline void PUSH (word_t &SP, word_t w) {m_pMemoryDirect->CPUwrite(SP, w);  SP = DEC12(SP);}
-  inline word_t POP (word_t &SP) {SP = INC12(SP);  return m_pMemoryDirect->CPUread(SP);}
+  inline void PUSH (word_t &SP, word_t w) {LoopWrite();  m_pMemoryDirect->FastWrite(SP, w);  SP = DEC12(SP);}
+  inline word_t POP (word_t &SP) {SP = INC12(SP);  return m_pMemoryDirect->FastRead(SP);}
 
   //   Calculate the effective address (EA) for memory reference instructions.
   // In every case, the result is always left in the MA register ...
@@ -309,6 +321,8 @@ private:
   void PanelInterrupt();
   // Fetch and execute the next instruction ...
   void FetchAndExecute();
+  // Return the CPU state for idle loop detection ...
+  bool GetLoopState (uint64_t &qState) const override;
 
   // PDP8 internal registers and state ...
 private:
@@ -328,6 +342,7 @@ private:
   bool        m_fHLThalts;      // TRUE if the HLT opcode should reall halt
   CInterrupt *m_pMainInterrupt; // sources for main memory interrupts
   CInterrupt *m_pPanelInterrupt;//   "  "   "  control panel  "   "
+  const uint32_t *m_plPanelAttention; // attention word for m_pPanelInterrupt
   CMemory    *m_pMainMemory;    // memory object for 6120/PDP8 main memory
   CMemory    *m_pPanelDirect;   // 6120 control panel memory direct access
   CMemory    *m_pPanelIndirect; //  "      "      "     "    indirect  "
@@ -18,6 +18,8 @@
 //
 // REVISION HISTORY:
 // 21-Aug-22  RLA   New file.
+// 15-OCT-26  RLA   Add IsSlow() ...
+// 16-OCT-26  RLA   Add IsIO() ...
 //--
 #pragma once
 #include <assert.h>             // assert() ...
@@ -62,6 +64,10 @@ public:
   virtual void CPUwrite (address_t a, word_t d) override;
   // Breakpoints in RAMdisk aren't implemented!
   virtual bool IsBreak (address_t a) const override {return false;}
+  // And there's no such thing as slow RAM disk either ...
+  virtual bool IsSlow (address_t a) const override {return false;}
+  // Nor is any of it I/O ...
+  virtual bool IsIO (address_t a) const override {return false;}
 
   // Basic memory properties ...
 public:
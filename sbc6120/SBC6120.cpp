@@ -34,6 +34,7 @@
 #include <assert.h>             // assert() (what else??)
 #include "EMULIB.hpp"           // emulator library definitions
 #include "ConsoleWindow.hpp"    // emulator console window methods
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "ImageFile.hpp"        // emulator library image file methods
 #include "CommandParser.hpp"    // emulator library command line parsing methods
@@ -62,7 +63,7 @@
 // you'll find "extern ..." declarations for them in SBC6120.hpp.  Note that they
 // are declared as pointers rather than the actual objects because we want
 // to control the exact order in which they're created and destroyed!
-CConsoleWindow   *g_pConsole        = NULL; // console window object
+CSmartConsole    *g_pConsole        = NULL; // console window object
 CLog             *g_pLog            = NULL; // message logging object (including console!)
 CCmdParser       *g_pParser         = NULL; // command line parser
 // These globals point to the objects being emulated ...
@@ -105,7 +106,8 @@ int main (int argc, char *argv[])
   //   The very first thing is to create and initialize the console window
   // object, and after that we create and initialize the log object.  We
   // can't issue any error messages until we done these two things!
-  g_pConsole = DBGNEW CConsoleWindow();
+  g_pEvents = DBGNEW CEventQueue();
+  g_pConsole = DBGNEW CSmartConsole(g_pEvents);
   g_pLog = DBGNEW CLog(PROGRAM, g_pConsole);
 
   //   Parse the command options.  Note that we want to do this BEFORE we
@@ -128,7 +130,6 @@ int main (int argc, char *argv[])
  //CMDOUTF("Word size = %d; Address size = %d; default radix = %d", WORDSIZE, ADDRSIZE, RADIX);
 
   // Create the emulated CPU, memory and peripheral devices ...
-  g_pEvents         = DBGNEW CEventQueue();
   g_pPanelInterrupt = DBGNEW CSimpleInterrupt(CSimpleInterrupt::EDGE_TRIGGERED);
   g_pMainInterrupt  = DBGNEW CSimpleInterrupt(CSimpleInterrupt::LEVEL_TRIGGERED);;
   g_pMainMemory     = DBGNEW CGenericMemory(MAIN_MEMORY_SIZE,  0, CMemory::MEM_RAM);
@@ -154,6 +155,8 @@ int main (int argc, char *argv[])
 
   //   Lastly, create the command line parser.  If a startup script was
   // specified on the command line, now is the time to execute it...
+  CStandardUI::g_pCPU = g_pCPU;  g_pCPU->SetWarpConsole(g_pConsole);
+  CStandardUI::g_pConsole = g_pConsole;
   g_pParser = DBGNEW CCmdParser(PROGRAM, CUI::g_aVerbs, &ConfirmExit, g_pConsole);
   if (!CStandardUI::g_sStartupScript.empty())
     g_pParser->OpenScript(CStandardUI::g_sStartupScript);
@@ -163,6 +166,7 @@ int main (int argc, char *argv[])
   // types "EXIT" or "QUIT", the command parser exits and then we shutdown
   // the SBC6120 program.
   g_pParser->CommandLoop();
+  CStandardUI::DumpStatistics();
   LOGS(DEBUG, "command parser exited");
 
   // Delete all our global objects.  Once again, the order here is important!
@@ -180,10 +184,10 @@ int main (int argc, char *argv[])
   delete g_pMainMemory;       // main PDP-8 memory
   delete g_pMainInterrupt;    // conventional interrupt sources
   delete g_pPanelInterrupt;   // control panel interrupt sources
-  delete g_pEvents;           // the event queue
 shutdown:
   delete g_pLog;              // close the log file
   delete g_pConsole;          // lastly (always lastly!) close the console window
+  delete g_pEvents;           // the event queue
 #ifdef _DEBUG
 #ifdef _WIN32
   system("pause");
@@ -44,7 +44,7 @@
 #define IDE_DEVICE_CODE     047   // IDE/PPI IOTs 647x
 
 // Console, log file and command parser objects.
-extern class CConsoleWindow  *g_pConsole;     // console window object
+extern class CSmartConsole   *g_pConsole;     // console window object
 
 //   These pointers reference the major parts of the SBC6120 system being
 // emulated - CPU, memory, switches, display, peripherals, etc.  They're all
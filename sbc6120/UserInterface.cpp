@@ -72,6 +72,11 @@
 //   ST*EP [nnnn]               - single step and trace nnnn instructions
 //   RES*ET                     - reset CPU and all devices
 //
+//   RECO*RD <file>             - record console input and its timing
+//   RECO*RD/CL*OSE             - stop recording console input
+//   REPL*AY <file>             - replay recorded console input
+//   REPL*AY/CL*OSE             - stop replaying console input
+//
 //   SE*T BRE*AKPOINT ooooo     - set breakpoint at address (octal)
 //   CL*EAR BRE*AKPOINT 00000   - clear   "      "     "       "
 //   CL*EAR BRE*AKPOINTS        - clear all breakpoints
@@ -165,6 +170,8 @@
 // REVISION HISTORY:
 // 16-JUN-22  RLA   Adapted from ELF2K.
 // 28-JUL-22  RLA   FindDevice() doesn't work for SET DEVICE
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -178,6 +185,7 @@
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "ImageFile.hpp"        // emulator library image file methods
 #include "ConsoleWindow.hpp"    // emulator console window methods
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "CommandParser.hpp"    // emulator library command line parsing methods
 #include "CommandLine.hpp"      // Shell (argc/argv) parser methods
 #include "StandardUI.hpp"       // emulator library standard UI commands
@@ -291,7 +299,8 @@ CCmdModifier * const CUI::m_modsLoad[] = {&m_modFileFormat, &m_modBaseAddress, &
 CCmdModifier * const CUI::m_modsSave[] = {&m_modFileFormat, &m_modBaseAddress, &m_modWordCount,
                                           &m_modEPROM, &m_modPanel, &m_modOverwrite, NULL};
 CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoad);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsSave);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsSave, g_aSaveVerbs);
 
 // ATTACH and DETACH commands ...
 CCmdArgument * const CUI::m_argsAttach[] = {&m_argFileName, NULL};
@@ -330,7 +339,7 @@ CCmdVerb CUI::m_cmdReset("RE*SET", &DoReset);
 // SET, CLEAR and SHOW CPU ...
 CCmdModifier * const CUI::m_modsSetCPU[] = {
     &m_modHaltOpcode, &m_modIllegalIO, &m_modIllegalOpcode,
-    &m_modBreakChar, &m_modStartupMode, NULL
+    &m_modBreakChar, &m_modStartupMode, &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL
 };
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdClearCPU("CPU", &DoClearCPU);
@@ -364,6 +373,7 @@ CCmdVerb CUI::m_cmdClear("CL*EAR", NULL, NULL, NULL, g_aClearVerbs);
 CCmdVerb * const CUI::g_aSetVerbs[] = {
   &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetDevice,
   &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+  &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
 #ifdef THREADS
   &CStandardUI::m_cmdSetCheckpoint,
 #endif
@@ -377,6 +387,7 @@ CCmdVerb * const CUI::g_aShowVerbs[] = {
   &m_cmdShowBreakpoint, &m_cmdShowCPU, &m_cmdShowDevice,
   &m_cmdShowMemory, &m_cmdShowVersion,
     &CStandardUI::m_cmdShowLog, &CStandardUI::m_cmdShowAliases,
+    &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
 #ifdef THREADS
     &CStandardUI::m_cmdShowCheckpoint,
 #endif
@@ -386,15 +397,15 @@ CCmdVerb CUI::m_cmdShow("SH*OW", NULL, NULL, NULL, g_aShowVerbs);
 
 // Master list of all verbs ...
 CCmdVerb * const CUI::g_aVerbs[] = {
-  &m_cmdExamine, &m_cmdDeposit,
+  &m_cmdExamine, &m_cmdDeposit, &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdLoad, &m_cmdSave, 
   &m_cmdAttach, &m_cmdDetach,
   &m_cmdRun, &m_cmdContinue, &m_cmdStep, &m_cmdReset,
   &m_cmdSet, &m_cmdShow, &m_cmdClear,
   &CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 
@@ -1055,6 +1066,10 @@ CCPU::STOP_CODE CUI::RunSimulation (uint32_t nSteps)
     case CCPU::STOP_NONE:    break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -1239,6 +1254,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   // opcodes and IOTs, etc ...
   //--
   assert(g_pCPU != NULL);
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modIllegalIO.IsPresent())
     g_pCPU->StopOnIllegalIO(m_argStopIO.GetKeyValue() != 0);
   if (m_modIllegalOpcode.IsPresent())
@@ -1265,6 +1282,8 @@ bool CUI::DoShowCPU (CCmdParser &cmd)
   CMDOUTF("%s %s %3.2fMHz, BREAK is Control-%c, STARTUP is %s",
     g_pCPU->GetName(), g_pCPU->GetDescription(), flCrystal, g_pConsole->GetConsoleBreak()+'@',
     g_pCPU->GetStartupMode() == C6120::STARTUP_MAIN ? "MAIN" : "PANEL");
+  CMDOUTS("Simulation speed " << CStandardUI::GetCPUspeed());
+  CMDOUTS("Idle loops       " << CStandardUI::GetCPUwarp());
   CMDOUTF("%s on illegal opcode, %s on illegal IOT, %s on HLT opcode",
     g_pCPU->IsStopOnIllegalOpcode() ? "STOP" : "CONTINUE",
     g_pCPU->IsStopOnIllegalIO() ? "STOP" : "CONTINUE",
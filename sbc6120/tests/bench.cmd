@@ -0,0 +1,29 @@
+; Headless benchmark - run a compute bound checksum loop for 60 seconds ...
+;
+;   The loop checksums 512 words of field 0, starting with itself, over and
+; over.  It runs in main memory and never waits for the console, so the
+; results measure the CPU and memory rather than the firmware's idle loop ...
+;
+;	0200	7300	CLA CLL		; start with a clear AC
+;	0201	1220	TAD	0220	; point auto index 10 at 0200
+;	0202	3010	DCA	0010
+;	0203	1221	TAD	0221	; and set the word count to 512
+;	0204	3222	DCA	0222
+;	0205	1410	TAD I	0010	; add the next word
+;	0206	7004	RAL		;  ... and stir the sum
+;	0207	2222	ISZ	0222	; loop for all 512 words
+;	0210	5205	JMP	0205
+;	0211	3223	DCA	0223	; save the checksum
+;	0212	5200	JMP	0200	; and start over
+;	0220	0177			; starting address - 1
+;	0221	7000			; -512
+SET LOGGING/CONSOLE/LEVEL=WARNING
+SET CPU/NOHALT/IO=IGNORE/OPCODE=STOP/STARTUP=MAIN
+CLEAR CPU
+LOAD/EPROM/FORMAT=INTEL 320h 320l
+RESET
+DEPOSIT 200 7300,1220,3010,1221,3222,1410,7004,2222,5205,3223,5200
+DEPOSIT 220 0177,7000
+DEPOSIT PC 200
+BENCHMARK 60
+SHOW STATISTICS
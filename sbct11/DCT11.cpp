@@ -32,8 +32,8 @@
 //   As far as accessing RAM or ROM goes, the 8 bit and 16 bit modes are
 // indistinguishable except for the number of memory accesses required.  The
 // header file for this module contains some inline routines to do word accesses
-// as two byte operations, and this code can pretty much otherwise ignore the
-// issue.
+// with the CMemory FastReadW() and FastWriteW() methods, which transfer both
+// bytes at once, and this code can pretty much otherwise ignore the issue.
 // 
 //   Also, the PDP11 uses memory mapped I/O exclusively, but there's nothing
 // in here to distinguish a RAM/ROM access from an I/O device.  We just call the
@@ -43,14 +43,14 @@
 // and has no idea what's I/O.
 // 
 //   I/O devices are potentially a problem when it comes to 8 bit vs 16 bit
-// memory, though.  Reading or writing a 16 bit I/O device register will actually
-// occur as two distinct 8 bit operations rather than one 16 bit operation.  If
-// accessing the I/O register has side effects, like clearing bits or interrupts,
-// then this might be an issue.  In the case of the SBCT11 though, and indeed in
-// most T11 designs, all peripherals are 8 bit devices.  They're mapped to an
-// even bus address and the corresponding, odd, MSB address is ignored.  The only
+// memory, though.  If accessing the I/O register has side effects, like clearing
+// bits or interrupts, then it matters whether a 16 bit register is accessed as
+// one word or two bytes.  In the case of the SBCT11 though, and indeed in most
+// T11 designs, all peripherals are 8 bit devices.  They're mapped to an even bus
+// address and the corresponding, odd, MSB address is ignored.  The only
 // exception in the SBCT11 is the IDE data register which is actually a full 16
-// bits wide.  That's handled with some special kludgy code in the IDE module.
+// bits wide.  Word accesses are passed to the device as a single DevReadW() or
+// DevWriteW() call, and the IDE module overrides those for the data register.
 //
 // BUS TIMEOUTS and ODD ADDRESSES
 //   The T11 chip does NOT implement a bus timeout and memory access never
@@ -173,6 +173,18 @@
 // 18-JUL-22  RLA Implement the WAIT instruction...
 //                RESET needs to call CMemoryMap::ClearDevices()
 //                Invent AddCycles() to handle long/short microcycles
+// 15-OCT-26  RLA Only check events and interrupts at the horizon
+// 16-OCT-26  RLA Skip ahead when spinning in an idle or polling loop
+// 16-OCT-26  RLA Test the interrupt attention word before calling the PIC
+// 16-OCT-26  RLA Use whole word memory accesses for READW() and WRITEW()
+// 16-OCT-26  RLA Decode opcodes thru a dispatch table built at startup
+// 16-OCT-26  RLA Evaluate the condition codes lazily
+// 16-OCT-26  RLA Count instructions and obey the event queue time limit
+// 16-OCT-26  RLA Call the profiler and add DisassembleInstruction()
+// 16-OCT-26  RLA Record the instruction trace buffer
+// 16-OCT-26  RLA Count interrupts acknowledged
+// 16-OCT-26  RLA Add SyncState()
+// 16-OCT-26  RLA Build the dispatch table with std::call_once()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -180,6 +192,7 @@
 #include <stdint.h>             // uint8_t, uint32_t, etc ...
 #include <assert.h>             // assert() (what else??)
 #include <cstring>              // needed for memset()
+#include <mutex>                // std::call_once() for the dispatch table
 #include "EMULIB.hpp"           // emulator library definitions
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "CommandParser.hpp"    // needed for type KEYWORD
@@ -191,6 +204,7 @@
 #include "DCT11opcodes.hpp"     // T11 opcode definitions
 #include "CPU.hpp"              // CCPU base class definitions
 #include "Device.hpp"           // CDevice I/O device emulation objects
+#include "StateFile.hpp"        // CStateFile declarations
 #include "DCT11.hpp"            // declarations for this module
 
 
@@ -209,6 +223,16 @@ const CCmdArgKeyword::KEYWORD CDCT11::g_keysRegisters[] = {
 #define SP  REG(REG_SP)
 #define PSW m_bPSW
 
+//++
+// These macros extract various special parts of a PDP11 opcode ...
+//--
+#define SOURCE(op)      (((op) >> 6) & 077)
+#define DESTINATION(op) (((op)     ) & 077)
+#define SRCMODE(op)     (((op) >> 9) & 7)
+#define DSTMODE(op)     (((op) >> 3) & 7)
+#define SRCREG(op)      (((op) >> 6) & 7)
+#define DSTREG(op)      (((op)     ) & 7)
+
 
 ////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////// CPU CONTROL METHODS //////////////////////////////
@@ -219,6 +243,7 @@ CDCT11::CDCT11 (uint16_t wMode, CMemoryMap *pMemory, CEventQueue *pEvent, CPIC11
 {
   //++
   //--
+  InitializeDispatch();
   SetCrystalFrequency(DEFAULT_CLOCK);
   SetMode(wMode);
   MasterClear();
@@ -253,7 +278,7 @@ void CDCT11::MasterClear()
   memset(m_wR, 0, sizeof(m_wR));
   SetPC(GetStartAddress());
   m_bRequests = 0;  m_wItrapVector = 0;
-  PSW = PSW_PRIO;
+  SetPSW(PSW_PRIO);
 }
 
 uint16_t CDCT11::GetRegister (cpureg_t nReg) const
@@ -264,7 +289,7 @@ uint16_t CDCT11::GetRegister (cpureg_t nReg) const
   if (nReg < 8)
     return REG(nReg);
   else if (nReg == REG_PSW)
-    return MKWORD(0, PSW);
+    return MKWORD(0, CurrentPSW());
   else
     return 0;
 }
@@ -277,7 +302,7 @@ void CDCT11::SetRegister (cpureg_t nReg, uint16_t wData)
   if (nReg < 8)
     REG(nReg) = wData;
   else if (nReg == REG_PSW)
-    PSW = MASK8(wData);
+    SetPSW(MASK8(wData));
 }
 
 string CDCT11::GetPSW() const
@@ -294,6 +319,48 @@ string CDCT11::GetPSW() const
   return sPSW;
 }
 
+uint8_t CDCT11::ComputeCC() const
+{
+  //++
+  //   Figure out the N, Z, V and C bits from the lazy condition code state.
+  // See the comments in DCT11.hpp for more details ...
+  //--
+  if (m_bCCop == CC_PSW) return m_bPSW & PSW_CC;
+  uint8_t bCC = 0;
+  if (ISNEGW(m_wCCresult)) bCC |= PSW_N;
+  if (m_wCCresult == 0)    bCC |= PSW_Z;
+  switch (m_bCCop) {
+    case CC_LOGIC:
+      break;
+    case CC_INCW:
+      if (m_wCCresult == 0100000) bCC |= PSW_V;
+      break;
+    case CC_INCB:
+      if (m_wCCresult == 0177600) bCC |= PSW_V;
+      break;
+    case CC_DECW:
+      if (m_wCCresult == 0077777) bCC |= PSW_V;
+      break;
+    case CC_DECB:
+      if (m_wCCresult == 0000177) bCC |= PSW_V;
+      break;
+    case CC_ADDW:
+      if (ISNEGW((~m_wCCa ^ m_wCCb) & (m_wCCa ^ m_wCCresult))) bCC |= PSW_V;
+      if (m_wCCresult < m_wCCa) bCC |= PSW_C;
+      return bCC;
+    case CC_SUBW:
+      if (ISNEGW((m_wCCa ^ m_wCCb) & (~m_wCCb ^ m_wCCresult))) bCC |= PSW_V;
+      if (m_wCCa < m_wCCb) bCC |= PSW_C;
+      return bCC;
+    case CC_SUBB:
+      if (ISNEGB((m_wCCa ^ m_wCCb) & (~m_wCCb ^ m_wCCresult))) bCC |= PSW_V;
+      if (m_wCCa < m_wCCb) bCC |= PSW_C;
+      return bCC;
+  }
+  // All the rest leave C unchanged ...
+  return bCC | (m_bPSW & PSW_C);
+}
+
 void CDCT11::AddCycles (uint32_t lCycles)
 {
   //++
@@ -316,7 +383,8 @@ void CDCT11::AddCycles (uint32_t lCycles)
 ///////////////////////// DOUBLE OPERAND INSTRUCTIONS //////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-uint32_t CDCT11::CALCEA (bool fByte, uint8_t bMode, uint8_t bReg, uint16_t &wEA)
+template <uint8_t bMode>
+uint32_t CDCT11::CALCEA (bool fByte, uint8_t bReg, uint16_t &wEA)
 {
   //++
   //   Calculate the actual address of the operand given the addressing mode
@@ -367,7 +435,8 @@ uint32_t CDCT11::CALCEA (bool fByte, uint8_t bMode, uint8_t bReg, uint16_t &wEA)
   return 0; // avoid C4715...
 }
 
-uint32_t CDCT11::MOVW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::MOVW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   //   This is the basic code for the MOV (word) instruction. This routine spends
@@ -391,8 +460,8 @@ uint32_t CDCT11::MOVW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   // register mode addressing, since that is always the fastest.  So register
   // mode takes zero time for the EA calculation...
   uint16_t wSRCea = 0, wDSTea = 0;  uint32_t nCycles = 0;
-  if (bSRCmode != 0) nCycles += CALCEAW(bSRCmode, bSRCreg, wSRCea);
-  if (bDSTmode != 0) nCycles += CALCEAW(bDSTmode, bDSTreg, wDSTea);
+  if (bSRCmode != 0) nCycles += CALCEAW<bSRCmode>(bSRCreg, wSRCea);
+  if (bDSTmode != 0) nCycles += CALCEAW<bDSTmode>(bDSTreg, wDSTea);
 
   //   Now, fetch the source operand.  This takes no additional time, since that
   // was already included in the EA calculation ...
@@ -400,7 +469,7 @@ uint32_t CDCT11::MOVW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
 
   //   Set the condition codes.  MOV sets or clears N and Z according to the
   // source operand.  It always clears V and leaves C unchanged.
-  SetZNW(wSource);  SetV(false);
+  LazyLogicW(wSource);
 
   //   And store the result.  Note that when we did CALCEAW() for the destination
   // that already included most of the time destination time, BUT writing the
@@ -418,7 +487,8 @@ uint32_t CDCT11::MOVW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   return nCycles + 3;
 }
 
-uint32_t CDCT11::MOVB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::MOVB (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   //   And this is the code for MOVB - the same as above, but byte mode.  Note
@@ -427,10 +497,10 @@ uint32_t CDCT11::MOVB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   // instruction with a register destination will zero fill.
   //--
   uint16_t wSRCea = 0, wDSTea = 0;  uint32_t nCycles = 0;
-  if (bSRCmode != 0) nCycles += CALCEAB(bSRCmode, bSRCreg, wSRCea);
-  if (bDSTmode != 0) nCycles += CALCEAB(bDSTmode, bDSTreg, wDSTea);
+  if (bSRCmode != 0) nCycles += CALCEAB<bSRCmode>(bSRCreg, wSRCea);
+  if (bDSTmode != 0) nCycles += CALCEAB<bDSTmode>(bDSTreg, wDSTea);
   uint8_t bSource = (bSRCmode == 0) ? LOBYTE(REG(bSRCreg)) : READB(wSRCea);
-  SetZNB(bSource);  SetV(false);
+  LazyLogicB(bSource);
   if (bDSTmode == 0) {
     REG(bDSTreg) = SXT8(bSource);  nCycles += 1;
   } else {
@@ -447,26 +517,26 @@ uint32_t CDCT11::MOVB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
 //--
 #define FETCH_DOUBLE_OPERANDS_BYTE(bSRC, bDST)                            \
   uint16_t wSRCea = 0, wDSTea = 0;  uint32_t nCycles = 0;                 \
-  if (bSRCmode != 0) nCycles += CALCEAB(bSRCmode, bSRCreg, wSRCea);       \
-  if (bDSTmode != 0) nCycles += CALCEAB(bDSTmode, bDSTreg, wDSTea);       \
+  if (bSRCmode != 0) nCycles += CALCEAB<bSRCmode>(bSRCreg, wSRCea);       \
+  if (bDSTmode != 0) nCycles += CALCEAB<bDSTmode>(bDSTreg, wDSTea);       \
   uint8_t bSRC = (bSRCmode == 0) ? LOBYTE(REG(bSRCreg)) : READB(wSRCea);  \
   uint8_t bDST = (bDSTmode == 0) ? LOBYTE(REG(bDSTreg)) : READB(wDSTea);
 
 #define FETCH_DOUBLE_OPERANDS_WORD(wSRC, wDST)                            \
   uint16_t wSRCea = 0, wDSTea = 0;  uint32_t nCycles = 0;                 \
-  if (bSRCmode != 0) nCycles += CALCEAW(bSRCmode, bSRCreg, wSRCea);       \
-  if (bDSTmode != 0) nCycles += CALCEAW(bDSTmode, bDSTreg, wDSTea);       \
+  if (bSRCmode != 0) nCycles += CALCEAW<bSRCmode>(bSRCreg, wSRCea);       \
+  if (bDSTmode != 0) nCycles += CALCEAW<bDSTmode>(bDSTreg, wDSTea);       \
   uint16_t wSRC = (bSRCmode == 0) ? REG(bSRCreg) : READW(wSRCea);         \
   uint16_t wDST = (bDSTmode == 0) ? REG(bDSTreg) : READW(wDSTea);
 
 #define FETCH_SINGLE_OPERAND_BYTE(bDST)                                   \
   uint16_t wDSTea = 0;  uint32_t nCycles = 0;                             \
-  if (bDSTmode != 0) nCycles += CALCEAB(bDSTmode, bDSTreg, wDSTea);       \
+  if (bDSTmode != 0) nCycles += CALCEAB<bDSTmode>(bDSTreg, wDSTea);       \
   uint8_t bDST = (bDSTmode == 0) ? LOBYTE(REG(bDSTreg)) : READB(wDSTea);
 
 #define FETCH_SINGLE_OPERAND_WORD(wDST)                                   \
   uint16_t wDSTea = 0;  uint32_t nCycles = 0;                             \
-  if (bDSTmode != 0) nCycles += CALCEAW(bDSTmode, bDSTreg, wDSTea);       \
+  if (bDSTmode != 0) nCycles += CALCEAW<bDSTmode>(bDSTreg, wDSTea);       \
   uint16_t wDST = (bDSTmode == 0) ? REG(bDSTreg) : READW(wDSTea);
 
 #define STORE_RESULT_BYTE(bResult)                                        \
@@ -484,7 +554,8 @@ uint32_t CDCT11::MOVB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   }
 
 
-uint32_t CDCT11::BISW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::BISW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // BIT SET (WORD) ...
@@ -492,12 +563,13 @@ uint32_t CDCT11::BISW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //   Sets Z and N; clears V and doesn't change C.
   //--
   FETCH_DOUBLE_OPERANDS_WORD(wSRC, wDST);
-  wDST = wDST | wSRC;  SetZNW(wDST);  SetV(false);
+  wDST = wDST | wSRC;  LazyLogicW(wDST);
   STORE_RESULT_WORD(wDST);
   return nCycles + 3;
 }
 
-uint32_t CDCT11::BISB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::BISB (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // BIT SET (BYTE) ...
@@ -505,12 +577,13 @@ uint32_t CDCT11::BISB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //   Sets Z and N; clears V and doesn't change C.
   //--
   FETCH_DOUBLE_OPERANDS_BYTE(bSRC, bDST);
-  bDST = bDST | bSRC;  SetZNB(bDST);  SetV(false);
+  bDST = bDST | bSRC;  LazyLogicB(bDST);
   STORE_RESULT_BYTE(bDST);
   return nCycles + 3;
 }
 
-uint32_t CDCT11::BICW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::BICW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // BIT CLEAR (WORD) ...
@@ -518,12 +591,13 @@ uint32_t CDCT11::BICW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //   Sets Z and N; clears V and doesn't change C.
   //--
   FETCH_DOUBLE_OPERANDS_WORD(wSRC, wDST);
-  wDST = wDST & ~wSRC;  SetZNW(wDST);  SetV(false);
+  wDST = wDST & ~wSRC;  LazyLogicW(wDST);
   STORE_RESULT_WORD(wDST);
   return nCycles + 3;
 }
 
-uint32_t CDCT11::BICB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::BICB (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // BIT CLEAR (BYTE) ...
@@ -531,12 +605,13 @@ uint32_t CDCT11::BICB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //   Sets Z and N; clears V and doesn't change C.
   //--
   FETCH_DOUBLE_OPERANDS_BYTE(bSRC, bDST);
-  bDST = bDST & ~bSRC;  SetZNB(bDST);  SetV(false);
+  bDST = bDST & ~bSRC;  LazyLogicB(bDST);
   STORE_RESULT_BYTE(bDST);
   return nCycles + 3;
 }
 
-uint32_t CDCT11::BITW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::BITW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // BIT TEST (WORD) ...
@@ -544,7 +619,7 @@ uint32_t CDCT11::BITW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //   Sets Z and N; clears V and doesn't change C.
   //--
   FETCH_DOUBLE_OPERANDS_WORD(wSRC1, wSRC2);
-  uint16_t wResult = wSRC2 & wSRC1;  SetZNW(wResult);  SetV(false);
+  uint16_t wResult = wSRC2 & wSRC1;  LazyLogicW(wResult);
   //   Note that even though this doesn't actually store the result, there is
   // still one extra cycle required for the destination time (but not two, as
   // it would be if the result was actually stored).  I've no idea what happens
@@ -552,7 +627,8 @@ uint32_t CDCT11::BITW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   return nCycles + 3 + 1;
 }
 
-uint32_t CDCT11::BITB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::BITB (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // BIT TEST (BYTE) ...
@@ -560,11 +636,12 @@ uint32_t CDCT11::BITB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //   Sets Z and N; clears V and doesn't change C.
   //--
   FETCH_DOUBLE_OPERANDS_BYTE(bSRC1, bSRC2);
-  uint8_t bResult = bSRC2 & bSRC1;  SetZNB(bResult);  SetV(false);
+  uint8_t bResult = bSRC2 & bSRC1;  LazyLogicB(bResult);
   return nCycles + 3 + 1;  // See BITW() ...
 }
 
-uint32_t CDCT11::CMPW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::CMPW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // COMPARE (WORD) ...
@@ -577,14 +654,12 @@ uint32_t CDCT11::CMPW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //--
   FETCH_DOUBLE_OPERANDS_WORD(wSRC1, wSRC2);
   uint16_t wResult = MASK16(wSRC1 - wSRC2);
-  SetN(ISNEGW(wResult));
-  SetZ(wResult==0);
-  SetV(ISNEGW((wSRC1 ^ wSRC2) & (~wSRC2 ^ wResult)));
-  SetC(wSRC1 < wSRC2);
+  LazyCC(CC_SUBW, wResult, wSRC1, wSRC2);
   return nCycles + 3 + 1;
 }
 
-uint32_t CDCT11::CMPB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::CMPB (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // COMPARE (BYTE) ...
@@ -597,14 +672,12 @@ uint32_t CDCT11::CMPB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //--
   FETCH_DOUBLE_OPERANDS_BYTE(bSRC1, bSRC2);
   uint8_t bResult = MASK8(bSRC1 - bSRC2);
-  SetN(ISNEGB(bResult));
-  SetZ(bResult==0);
-  SetV(ISNEGB((bSRC1 ^ bSRC2) & (~bSRC2 ^ bResult)));
-  SetC(bSRC1 < bSRC2);
+  LazyCC(CC_SUBB, SXT8(bResult), bSRC1, bSRC2);
   return nCycles + 3 + 1;
 }
 
-uint32_t CDCT11::ADDW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::ADDW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // ADD (WORD) ...
@@ -617,15 +690,13 @@ uint32_t CDCT11::ADDW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //--
   FETCH_DOUBLE_OPERANDS_WORD(wSRC1, wSRC2);
   uint16_t wResult = MASK16(wSRC2 + wSRC1);
-  SetN(ISNEGW(wResult));
-  SetZ(wResult == 0);
-  SetV(ISNEGW((~wSRC1 ^ wSRC2) & (wSRC1 ^ wResult)));
-  SetC(wResult < wSRC1); // ??? IS THIS REALLY RIGHT??  SEE simh!
+  LazyCC(CC_ADDW, wResult, wSRC1, wSRC2);
   STORE_RESULT_WORD(wResult);
   return nCycles + 3;
 }
 
-uint32_t CDCT11::SUBW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bSRCmode, uint8_t bDSTmode>
+uint32_t CDCT11::SUBW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // SUBTRACT (WORD) ...
@@ -639,15 +710,13 @@ uint32_t CDCT11::SUBW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint
   //--
   FETCH_DOUBLE_OPERANDS_WORD(wSRC1, wSRC2);
   uint16_t wResult = MASK16(wSRC2 - wSRC1);
-  SetN(ISNEGW(wResult));
-  SetZ(wResult == 0);
-  SetV(ISNEGW((wSRC1 ^ wSRC2) & (~wSRC1 ^ wResult)));
-  SetC(wSRC2 < wSRC1);
+  LazyCC(CC_SUBW, wResult, wSRC2, wSRC1);
   STORE_RESULT_WORD(wResult);
   return nCycles + 3;
 }
 
-uint32_t CDCT11::XORW (uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::XORW (uint8_t bSRCreg, uint8_t bDSTreg)
 {
   //++
   // EXCLUSIVE OR (WORD)
@@ -657,9 +726,9 @@ uint32_t CDCT11::XORW (uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
   //     - the source MUST be a register.
   //--
   uint16_t wDSTea = 0;  uint32_t nCycles = 0;
-  if (bDSTmode != 0) nCycles += CALCEAW(bDSTmode, bDSTreg, wDSTea);
+  if (bDSTmode != 0) nCycles += CALCEAW<bDSTmode>(bDSTreg, wDSTea);
   uint16_t wDST = (bDSTmode == 0) ? REG(bDSTreg) : READW(wDSTea);
-  wDST ^= REG(bSRCreg);  SetZNW(wDST);  SetV(false);
+  wDST ^= REG(bSRCreg);  LazyLogicW(wDST);
   STORE_RESULT_WORD(wDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
@@ -669,7 +738,8 @@ uint32_t CDCT11::XORW (uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg)
 ////////////////////////// SINGLE OPERAND INSTRUCTIONS /////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-uint32_t CDCT11::CLRW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::CLRW (uint8_t bDSTreg)
 {
   //++
   // CLEAR (WORD)
@@ -681,13 +751,14 @@ uint32_t CDCT11::CLRW (uint8_t bDSTmode, uint8_t bDSTreg)
   //     effects.
   //--
   FETCH_SINGLE_OPERAND_WORD(wDST);
-  SetZ(true);  SetV(false);  SetN(false);  SetC(false);
+  LazyTestW(0);
   // Avoid "unused variable" warnings for wDST!
   wDST = 0;  STORE_RESULT_WORD(wDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::CLRB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::CLRB (uint8_t bDSTreg)
 {
   //++
   // CLEAR (BYTE)
@@ -696,13 +767,14 @@ uint32_t CDCT11::CLRB (uint8_t bDSTmode, uint8_t bDSTreg)
   //   See other comments under CLRW()...
   //--
   FETCH_SINGLE_OPERAND_BYTE(bDST);
-  SetZ(true);  SetV(false);  SetN(false);  SetC(false);
+  LazyTestB(0);
   // Avoid "unused variable" warnings for bDST!
   bDST = 0;  STORE_RESULT_BYTE(bDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::COMW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::COMW (uint8_t bDSTreg)
 {
   //++
   // COMPLEMENT (WORD)
@@ -716,7 +788,8 @@ uint32_t CDCT11::COMW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::COMB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::COMB (uint8_t bDSTreg)
 {
   //++
   // COMPLEMENT (BYTE)
@@ -730,7 +803,8 @@ uint32_t CDCT11::COMB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::INCW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::INCW (uint8_t bDSTreg)
 {
   //++
   // INCREMENT (WORD)
@@ -739,14 +813,14 @@ uint32_t CDCT11::INCW (uint8_t bDSTmode, uint8_t bDSTreg)
   //   Sets V if DST rolled over from 077777 to 100000
   //--
   FETCH_SINGLE_OPERAND_WORD(wDST);
-  SetV(wDST == 077777);
   wDST = MASK16(wDST+1);
-  SetZNW(wDST);
+  LazyCC(CC_INCW, wDST);
   STORE_RESULT_WORD(wDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::INCB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::INCB (uint8_t bDSTreg)
 {
   //++
   // INCREMENT (BYTE)
@@ -755,14 +829,14 @@ uint32_t CDCT11::INCB (uint8_t bDSTmode, uint8_t bDSTreg)
   //   Sets V if DST rolled over from 0177 to 0200
   //--
   FETCH_SINGLE_OPERAND_BYTE(bDST);
-  SetV(bDST == 0177);
   bDST = MASK8(bDST + 1);
-  SetZNB(bDST);
+  LazyCC(CC_INCB, SXT8(bDST));
   STORE_RESULT_BYTE(bDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::DECW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::DECW (uint8_t bDSTreg)
 {
   //++
   // DECREMENT (WORD)
@@ -771,14 +845,14 @@ uint32_t CDCT11::DECW (uint8_t bDSTmode, uint8_t bDSTreg)
   //   Sets V if DST rolled over from 100000 to 077777
   //--
   FETCH_SINGLE_OPERAND_WORD(wDST);
-  SetV(wDST == 0100000);
   wDST = MASK16(wDST - 1);
-  SetZNW(wDST);
+  LazyCC(CC_DECW, wDST);
   STORE_RESULT_WORD(wDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::DECB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::DECB (uint8_t bDSTreg)
 {
   //++
   // DECREMENT (BYTE)
@@ -787,14 +861,14 @@ uint32_t CDCT11::DECB (uint8_t bDSTmode, uint8_t bDSTreg)
   //   Sets V if DST rolled over from 0200 to 0177
   //--
   FETCH_SINGLE_OPERAND_BYTE(bDST);
-  SetV(bDST == 0200);
   bDST = MASK8(bDST - 1);
-  SetZNB(bDST);
+  LazyCC(CC_DECB, SXT8(bDST));
   STORE_RESULT_BYTE(bDST);
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::NEGW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::NEGW (uint8_t bDSTreg)
 {
   //++
   // TWO'S COMPLEMENT NEGATE (WORD)
@@ -810,7 +884,8 @@ uint32_t CDCT11::NEGW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::NEGB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::NEGB (uint8_t bDSTreg)
 {
   //++
   // TWO'S COMPLEMENT NEGATE (BYTE)
@@ -826,7 +901,8 @@ uint32_t CDCT11::NEGB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ADCW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ADCW (uint8_t bDSTreg)
 {
   //++
   // ADD WITH CARRY (WORD)
@@ -843,7 +919,8 @@ uint32_t CDCT11::ADCW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ADCB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ADCB (uint8_t bDSTreg)
 {
   //++
   // ADD WITH CARRY (BYTE)
@@ -860,7 +937,8 @@ uint32_t CDCT11::ADCB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::SBCW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::SBCW (uint8_t bDSTreg)
 {
   //++
   // SUBTRACT WITH CARRY (WORD)
@@ -877,7 +955,8 @@ uint32_t CDCT11::SBCW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::SBCB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::SBCB (uint8_t bDSTreg)
 {
   //++
   // SUBTRACT WITH CARRY (BYTE)
@@ -894,7 +973,8 @@ uint32_t CDCT11::SBCB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::TSTW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::TSTW (uint8_t bDSTreg)
 {
   //++
   // TEST (WORD)
@@ -908,12 +988,13 @@ uint32_t CDCT11::TSTW (uint8_t bDSTmode, uint8_t bDSTreg)
   //     side effects.
   //--
   FETCH_SINGLE_OPERAND_WORD(wDST);
-  SetZNW(wDST);  SetV(false);  SetC(false);
+  LazyTestW(wDST);
 //STORE_RESULT_WORD(wDST);
   return nCycles + 4;
 }
 
-uint32_t CDCT11::TSTB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::TSTB (uint8_t bDSTreg)
 {
   //++
   // TEST (BYTE)
@@ -922,12 +1003,13 @@ uint32_t CDCT11::TSTB (uint8_t bDSTmode, uint8_t bDSTreg)
   //   See notes in TSTW!
   //--
   FETCH_SINGLE_OPERAND_BYTE(bDST);
-  SetZNB(bDST);  SetV(false);  SetC(false);
+  LazyTestB(bDST);
   //STORE_RESULT_BYTE(bDST);
   return nCycles + 4;
 }
 
-uint32_t CDCT11::RORW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::RORW (uint8_t bDSTreg)
 {
   //++
   // ROTATE RIGHT (WORD)
@@ -943,7 +1025,8 @@ uint32_t CDCT11::RORW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::RORB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::RORB (uint8_t bDSTreg)
 {
   //++
   // ROTATE RIGHT (BYTE)
@@ -959,7 +1042,8 @@ uint32_t CDCT11::RORB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ROLW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ROLW (uint8_t bDSTreg)
 {
   //++
   // ROTATE LEFT (WORD)
@@ -975,7 +1059,8 @@ uint32_t CDCT11::ROLW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ROLB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ROLB (uint8_t bDSTreg)
 {
   //++
   // ROTATE LEFT (BYTE)
@@ -991,7 +1076,8 @@ uint32_t CDCT11::ROLB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ASRW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ASRW (uint8_t bDSTreg)
 {
   //++
   // ARITHMETIC SHIFT RIGHT (WORD)
@@ -1007,7 +1093,8 @@ uint32_t CDCT11::ASRW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ASRB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ASRB (uint8_t bDSTreg)
 {
   //++
   // ARITHMETIC SHIFT RIGHT (BYTE)
@@ -1023,7 +1110,8 @@ uint32_t CDCT11::ASRB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ASLW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ASLW (uint8_t bDSTreg)
 {
   //++
   // ARITHMETIC SHIFT LEFT (WORD)
@@ -1040,7 +1128,8 @@ uint32_t CDCT11::ASLW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::ASLB (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::ASLB (uint8_t bDSTreg)
 {
   //++
   // ARITHMETIC SHIFT LEFT (BYTE)
@@ -1057,7 +1146,8 @@ uint32_t CDCT11::ASLB (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::SXTW (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::SXTW (uint8_t bDSTreg)
 {
   //++
   // SIGN EXTEND (WORD)
@@ -1076,7 +1166,8 @@ uint32_t CDCT11::SXTW (uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::SWAB(uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::SWAB (uint8_t bDSTreg)
 {
   //++
   // SWAB BYTES
@@ -1091,7 +1182,8 @@ uint32_t CDCT11::SWAB(uint8_t bDSTmode, uint8_t bDSTreg)
   return nCycles + (bDSTmode == 0) ? 4 : 5;
 }
 
-uint32_t CDCT11::MTPS (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::MTPS (uint8_t bDSTreg)
 {
   //++
   // MOVE TO PSW (BYTE)
@@ -1105,15 +1197,19 @@ uint32_t CDCT11::MTPS (uint8_t bDSTmode, uint8_t bDSTreg)
   FETCH_SINGLE_OPERAND_BYTE(bDST);
   uint8_t bOldBits = PSW & (PSW_T);
   uint8_t bOldPrio = (PSW & PSW_PRIO) >> 5;
-  PSW = (bDST & (PSW_N | PSW_Z | PSW_V | PSW_C | PSW_PRIO)) | bOldBits;
+  SetPSW((bDST & (PSW_CC | PSW_PRIO)) | bOldBits);
   uint8_t bNewPrio = (PSW & PSW_PRIO) >> 5;
-  if (bOldPrio != bNewPrio)
+  if (bOldPrio != bNewPrio) {
     LOGF(DEBUG, "CPU priority changed from BR%d to BR%d", bOldPrio, bNewPrio);
-  // TBA NYI TODO - RECALCULATE INTERRUPTS NOW THAT PRIO IS CHANGED?!?
+    //   Changing the priority might unblock a pending interrupt, so make sure
+    // that Run() checks again after this instruction ...
+    InvalidateHorizon();
+  }
   return nCycles + 8;
 }
 
-uint32_t CDCT11::MFPS (uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::MFPS (uint8_t bDSTreg)
 {
   //++
   // MOVE FROM PSW (BYTE)
@@ -1126,8 +1222,8 @@ uint32_t CDCT11::MFPS (uint8_t bDSTmode, uint8_t bDSTreg)
   //   MFPS to a register destination works like MOVB and sign extends!
   //--
   FETCH_SINGLE_OPERAND_BYTE(bDST);
-  bDST = MASK8(PSW);
-  SetZNB(bDST);  SetV(false);
+  bDST = CurrentPSW();
+  LazyLogicB(bDST);
   if (bDSTmode == 0) {
     REG(bDSTreg) = SXT8(bDST);  nCycles += 1;
   } else {
@@ -1150,7 +1246,8 @@ uint32_t CDCT11::MFPS (uint8_t bDSTmode, uint8_t bDSTreg)
 #define BRANCH(o)   {PC = MASK16(PC + 2*SXT8(o));}
 
 
-uint32_t CDCT11::DoBranch (bool fByte, uint8_t bOpcode, uint8_t bOffset)
+template <bool fByte, uint8_t bOpcode>
+uint32_t CDCT11::DoBranch (uint16_t wIR)
 {
   //++
   //   This method handles all 15 PDP11 branch instructions.  The opcodes for
@@ -1168,6 +1265,7 @@ uint32_t CDCT11::DoBranch (bool fByte, uint8_t bOpcode, uint8_t bOffset)
   // regardless of whether the branch is taken or not.  That makes our life
   // easier...
   //--
+  uint8_t bOffset = LOBYTE(wIR);
   if (!fByte) {
     switch (bOpcode) {
       case 0: /* would be "BRANCH NEVER! */     assert(false);
@@ -1204,7 +1302,7 @@ uint32_t CDCT11::DoBranch (bool fByte, uint8_t bOpcode, uint8_t bOffset)
   return 4;
 }
 
-uint32_t CDCT11::SOB (uint8_t bReg, uint8_t bOffset)
+uint32_t CDCT11::SOB (uint16_t wIR)
 {
   //++
   // SUBTRACT ONE AND BRANCH (if not zero!) ...
@@ -1214,13 +1312,15 @@ uint32_t CDCT11::SOB (uint8_t bReg, uint8_t bOffset)
   //   Note that SOB can only branch BACKWARDS!  Also note that the time for
   //     SOB is independent of whether the branch is taken or not.
   //--
+  uint8_t bReg = SRCREG(wIR), bOffset = DESTINATION(wIR);
   REG(bReg) = MASK16(REG(bReg) - 1);
   if (REG(bReg) != 0)
     PC = MASK16(PC - bOffset - bOffset);
   return 6;
 }
 
-uint32_t CDCT11::JMP (uint8_t bMode, uint8_t bReg)
+template <uint8_t bMode>
+uint32_t CDCT11::JMP (uint8_t bReg)
 {
   //++
   // JUMP
@@ -1231,7 +1331,7 @@ uint32_t CDCT11::JMP (uint8_t bMode, uint8_t bReg)
   if (bMode == 0)
     return InstructionTrap(VEC_RESERVED);
   else {
-    nCycles += CALCEAW(bMode, bReg, wEA);
+    nCycles += CALCEAW<bMode>(bReg, wEA);
     PC = wEA;
   }
   return nCycles+3;
@@ -1250,7 +1350,8 @@ uint32_t CDCT11::JMP (uint8_t bMode, uint8_t bReg)
 #define POPB(x)    {uint16_t t;  POPW(t);  (x) = MASK8(t);}
 
 
-uint32_t CDCT11::JSR (uint8_t bReg, uint8_t bDSTmode, uint8_t bDSTreg)
+template <uint8_t bDSTmode>
+uint32_t CDCT11::JSR (uint8_t bReg, uint8_t bDSTreg)
 {
   //++
   // JUMP TO SUBROUTINE
@@ -1261,7 +1362,7 @@ uint32_t CDCT11::JSR (uint8_t bReg, uint8_t bDSTmode, uint8_t bDSTreg)
   if (bDSTmode == 0)
     return InstructionTrap(VEC_RESERVED);
   else {
-    nCycles += CALCEAW(bDSTmode, bDSTreg, wEA);
+    nCycles += CALCEAW<bDSTmode>(bDSTreg, wEA);
     PUSHW(REG(bReg));  REG(bReg) = PC;  PC = wEA;
   }
   return nCycles+7;
@@ -1296,7 +1397,7 @@ uint32_t CDCT11::RTI (bool fInhibit)
   // bit is still set in m_bRequests!), but RTT will NOT be traced under the
   // same circumstances.
   //--
-  POPW(PC);  POPB(PSW);
+  uint8_t bPSW;  POPW(PC);  POPB(bPSW);  SetPSW(bPSW);  InvalidateHorizon();
   if (fInhibit)
     CLRBIT(m_bRequests, REQ_TRACE);
   else if (ISSET(PSW, PSW_T))
@@ -1316,7 +1417,7 @@ uint32_t CDCT11::TrapNow (uint16_t wNewPC, uint16_t wNewPSW)
   //   Note that, if the new PSW we loaded does NOT have the T bit set, then we
   // don't trap at the end of this instruction!!
   //--
-  PUSHB(PSW);  PUSHW(PC);  PC = wNewPC;  PSW = MASK8(wNewPSW);
+  PUSHB(CurrentPSW());  PUSHW(PC);  PC = wNewPC;  SetPSW(MASK8(wNewPSW));  InvalidateHorizon();
   LOGF(DEBUG, "TrapNow() new PC=%06o, new prio=BR%d", wNewPC, (wNewPSW & PSW_PRIO) >> 5);
   if (!ISSET(PSW, PSW_T)) CLRBIT(m_bRequests, REQ_TRACE);
   return 16;
@@ -1408,9 +1509,9 @@ uint32_t CDCT11::WAIT()
   if ((PSW & PSW_PRIO) == PSW_PRI7)
     LOGF(WARNING, "WAIT at priority 7 - HALT is your only way out!");
   while (true) {
-    m_pEvents->JumpAhead(m_pEvents->NextEvent());
-    DoEvents();
-    if (   (GetPIC()->FindRequest(PSW) != 0)
+    m_pEvents->JumpAhead(m_pEvents->NextStop());
+    DoHorizon();
+    if (   (IsAttention() && (GetPIC()->FindRequest(PSW) != 0))
         || (m_bRequests != 0)
         || (m_nStopCode != STOP_NONE)) break;
   }
@@ -1444,55 +1545,41 @@ uint32_t CDCT11::RESET()
 //////////////////////////// INSTRUCTION DECODING //////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-//++
-// These macros extract various special parts of a PDP11 opcode ...
-//--
-#define SOURCE(op)      (((op) >> 6) & 077)
-#define DESTINATION(op) (((op)     ) & 077)
-#define SRCMODE(op)     (((op) >> 9) & 7)
-#define DSTMODE(op)     (((op) >> 3) & 7)
-#define SRCREG(op)      (((op) >> 6) & 7)
-#define DSTREG(op)      (((op)     ) & 7)
+// The opcode dispatch table, shared by all CDCT11 instances ...
+CDCT11::OPCODE CDCT11::g_apDispatch[CDCT11::DISPATCH_SIZE] = {NULL};
 
-uint32_t CDCT11::DoSingleOperand (bool fByte, uint8_t bOpcode, uint8_t bDSTmode, uint8_t bDSTreg)
-{
-  //++
-  //   This method is called for all 00xxDD and 10xxDD instructions, where xx
-  // is 050 thru 077.  On the PDP11 these are mostly the single operand
-  // instructions like CLR(B), NEG(B), TST(B), etc, but with a few wildcards
-  // thrown in like MTPS and MFPS.  And a large number of these opcodes are
-  // not implemented on the DCT11.
-  //--
-  switch (bOpcode) {
-    case 050:  if (fByte) return CLRB(bDSTmode, bDSTreg);  else return CLRW(bDSTmode, bDSTreg); // CLR(B)
-    case 051:  if (fByte) return COMB(bDSTmode, bDSTreg);  else return COMW(bDSTmode, bDSTreg); // COM(B)
-    case 052:  if (fByte) return INCB(bDSTmode, bDSTreg);  else return INCW(bDSTmode, bDSTreg); // INC(B)
-    case 053:  if (fByte) return DECB(bDSTmode, bDSTreg);  else return DECW(bDSTmode, bDSTreg); // DEC(B)
-    case 054:  if (fByte) return NEGB(bDSTmode, bDSTreg);  else return NEGW(bDSTmode, bDSTreg); // NEG(B)
-    case 055:  if (fByte) return ADCB(bDSTmode, bDSTreg);  else return ADCW(bDSTmode, bDSTreg); // ADC(B)
-    case 056:  if (fByte) return SBCB(bDSTmode, bDSTreg);  else return SBCW(bDSTmode, bDSTreg); // SBC(B)
-    case 057:  if (fByte) return TSTB(bDSTmode, bDSTreg);  else return TSTW(bDSTmode, bDSTreg); // TST(B)
-    case 060:  if (fByte) return RORB(bDSTmode, bDSTreg);  else return RORW(bDSTmode, bDSTreg); // ROR(B)
-    case 061:  if (fByte) return ROLB(bDSTmode, bDSTreg);  else return ROLW(bDSTmode, bDSTreg); // ROL(B)
-    case 062:  if (fByte) return ASRB(bDSTmode, bDSTreg);  else return ASRW(bDSTmode, bDSTreg); // ASR(B)
-    case 063:  if (fByte) return ASLB(bDSTmode, bDSTreg);  else return ASLW(bDSTmode, bDSTreg); // ASL(B)
-    case 064:  if (fByte) return MTPS(bDSTmode, bDSTreg);  else /* ILLEGAL! */ break;           // MTPS
-    case 067:  if (fByte) return MFPS(bDSTmode, bDSTreg);  else return SXTW(bDSTmode, bDSTreg); // MFPS/SXT
-  }
-  return InstructionTrap(VEC_ILLEGAL);
+template <uint32_t (CDCT11::*OP) (uint8_t, uint8_t)>
+uint32_t CDCT11::DoDoubleOperand (uint16_t wIR)
+{
+  //++
+  //   This is the dispatch table entry for all double operand instructions.
+  // The source and destination addressing modes are already built into OP,
+  // so all that's left is to extract the two register fields.  JSR and XOR
+  // come here too, since they keep a register number in the source field.
+  //--
+  return (this->*OP) (SRCREG(wIR), DSTREG(wIR));
+}
+
+template <uint32_t (CDCT11::*OP) (uint8_t)>
+uint32_t CDCT11::DoSingleOperand (uint16_t wIR)
+{
+  //++
+  //   And this is the dispatch table entry for all single operand instructions,
+  // as well as JMP and RTS.  Once again the addressing mode is built into OP
+  // and only the destination register is left for us ...
+  //--
+  return (this->*OP) (DSTREG(wIR));
 }
 
 uint32_t CDCT11::DoOpcode00 (uint16_t wOpcode)
 {
   //++
-  //   This method executes all opcodes 000000..000377. This is a
-  // random assortment of things the PDP11 designers couldn't fit
-  // in anywhere else.  And on the T11, a lot of these are not
-  // implemented...
+  //   This method executes opcodes 000000..000077. This is a random
+  // assortment of things the PDP11 designers couldn't fit in anywhere
+  // else.  And on the T11, a lot of these are not implemented...
   //--
-  assert(wOpcode < 0400);
-  if (wOpcode < 0100) {
-    switch (wOpcode) {
+  assert(wOpcode < 0100);
+  switch (wOpcode) {
     case 00:  return HALT();                            // HALT
     case 01:  return WAIT();                            // WAIT
     case 02:  return RTI();                             // RTI
@@ -1502,17 +1589,160 @@ uint32_t CDCT11::DoOpcode00 (uint16_t wOpcode)
     case 06:  return RTT();                             // RTT
     case 07:  REG(0) = PROCESSOR_TYPE;  return 5;       // MFPT
     default:  return InstructionTrap(VEC_ILLEGAL);      // illegal
-    }
-  } else if (wOpcode < 0200)
-    return JMP(DSTMODE(wOpcode), DSTREG(wOpcode));
-  else if (wOpcode < 0210)
-    return RTS(DSTREG(wOpcode));
-  else if (wOpcode < 0240)
-    return InstructionTrap(VEC_ILLEGAL);
-  else if (wOpcode < 0300)
-    return SETCLRCC(wOpcode);
-  else
-    return SWAB(DSTMODE(wOpcode), DSTREG(wOpcode));
+  }
+}
+
+//++
+//   These macros generate the dispatch table entries for one opcode in all
+// its addressing modes.  Each one expands to a small table of template
+// instances indexed by the mode field(s) of the opcode, so the compiler
+// generates a separate handler for every combination and the mode tests in
+// CALCEA(), FETCH_xyz_OPERANDS and STORE_RESULT_xyz all fold away.
+//--
+#define DOUBLE1(op,s,d) &CDCT11::DoDoubleOperand<&CDCT11::op<s,d> >
+#define DOUBLE8(op,s)   DOUBLE1(op,s,0), DOUBLE1(op,s,1), DOUBLE1(op,s,2), DOUBLE1(op,s,3), \
+                        DOUBLE1(op,s,4), DOUBLE1(op,s,5), DOUBLE1(op,s,6), DOUBLE1(op,s,7)
+#define DSTREG8(op)     &CDCT11::DoDoubleOperand<&CDCT11::op<0> >, &CDCT11::DoDoubleOperand<&CDCT11::op<1> >, \
+                        &CDCT11::DoDoubleOperand<&CDCT11::op<2> >, &CDCT11::DoDoubleOperand<&CDCT11::op<3> >, \
+                        &CDCT11::DoDoubleOperand<&CDCT11::op<4> >, &CDCT11::DoDoubleOperand<&CDCT11::op<5> >, \
+                        &CDCT11::DoDoubleOperand<&CDCT11::op<6> >, &CDCT11::DoDoubleOperand<&CDCT11::op<7> >
+#define SINGLE8(op)     &CDCT11::DoSingleOperand<&CDCT11::op<0> >, &CDCT11::DoSingleOperand<&CDCT11::op<1> >, \
+                        &CDCT11::DoSingleOperand<&CDCT11::op<2> >, &CDCT11::DoSingleOperand<&CDCT11::op<3> >, \
+                        &CDCT11::DoSingleOperand<&CDCT11::op<4> >, &CDCT11::DoSingleOperand<&CDCT11::op<5> >, \
+                        &CDCT11::DoSingleOperand<&CDCT11::op<6> >, &CDCT11::DoSingleOperand<&CDCT11::op<7> >
+#define BRANCH8(f)      &CDCT11::DoBranch<f,0>, &CDCT11::DoBranch<f,1>, &CDCT11::DoBranch<f,2>, &CDCT11::DoBranch<f,3>, \
+                        &CDCT11::DoBranch<f,4>, &CDCT11::DoBranch<f,5>, &CDCT11::DoBranch<f,6>, &CDCT11::DoBranch<f,7>
+
+#define DOUBLE(op)      {static const OPCODE ap[64] = {                         \
+                          DOUBLE8(op,0), DOUBLE8(op,1), DOUBLE8(op,2), DOUBLE8(op,3), \
+                          DOUBLE8(op,4), DOUBLE8(op,5), DOUBLE8(op,6), DOUBLE8(op,7)}; \
+                        return ap[(SRCMODE(wIR) << 3) | DSTMODE(wIR)];}
+#define JSRXOR(op)      {static const OPCODE ap[8] = {DSTREG8(op)};             \
+                        return ap[DSTMODE(wIR)];}
+#define SINGLE(op)      {static const OPCODE ap[8] = {SINGLE8(op)};             \
+                        return ap[DSTMODE(wIR)];}
+#define SINGLE2(ow,ob)  {static const OPCODE ap[2][8] = {{SINGLE8(ow)}, {SINGLE8(ob)}}; \
+                        return ap[fByte ? 1 : 0][DSTMODE(wIR)];}
+
+CDCT11::OPCODE CDCT11::Decode (uint16_t wIR)
+{
+  //++
+  //   Decode the opcode wIR and return the dispatch table entry for it.  This
+  // is only used to build the dispatch table, so it doesn't need to be fast.
+  // Note that the destination register field (the three least significant
+  // bits) is never examined here, because it isn't part of the table index!
+  //--
+  bool fByte = ISSET(wIR, 0100000);
+
+  // Start off by decoding just the upper 4 bits of the instruction ...
+  switch ((wIR >> 12) & 017) {
+    // All double operand instructions ...
+    case 001:  DOUBLE(MOVW);
+    case 011:  DOUBLE(MOVB);
+    case 002:  DOUBLE(CMPW);
+    case 012:  DOUBLE(CMPB);
+    case 003:  DOUBLE(BITW);
+    case 013:  DOUBLE(BITB);
+    case 004:  DOUBLE(BICW);
+    case 014:  DOUBLE(BICB);
+    case 005:  DOUBLE(BISW);
+    case 015:  DOUBLE(BISB);
+    case 006:  DOUBLE(ADDW);
+    case 016:  DOUBLE(SUBW);
+
+    // Opcodes 000000 .. 000377 ...
+    case 000:
+      if (wIR < 000100)
+        return &CDCT11::DoOpcode00;
+      else if (wIR < 000200)
+        SINGLE(JMP)
+      else if (wIR < 000210)
+        return &CDCT11::DoSingleOperand<&CDCT11::RTS>;
+      else if (wIR < 000240)
+        return &CDCT11::DoTrap<VEC_ILLEGAL>;
+      else if (wIR < 000300)
+        return &CDCT11::SETCLRCC;
+      else if (wIR < 000400)
+        SINGLE(SWAB)
+      // Opcodes 000400 .. 003777 ...
+      else if (wIR < 004000) {
+        //   Note that entry zero, "BRANCH NEVER", can never be used because
+        // those opcodes are all the 0000xx group above ...
+        static const OPCODE ap[8] = {BRANCH8(false)};
+        return ap[HIBYTE(wIR) & 7];
+      }
+      // Opcodes 004000 .. 004777 ...
+      else if (wIR < 005000)
+        JSRXOR(JSR)
+      // Opcodes 005000 .. 007777 fall thru to the single operand decoding ...
+      break;
+
+    // ...
+    case 010:
+      if (wIR < 0104000) {
+        // Opcodes 100000 .. 103777 ...
+        static const OPCODE ap[8] = {BRANCH8(true)};
+        return ap[HIBYTE(wIR) & 7];
+      } else if (wIR < 0104400)
+        // Opcodes 104000 .. 104377 ...
+        return &CDCT11::DoTrap<VEC_EMT>;
+      else if (wIR < 0105000)
+        // Opcodes 104400 .. 104777 ...
+        return &CDCT11::DoTrap<VEC_TRAP>;
+      // Opcodes 105000 .. 107777 fall thru to the single operand decoding ...
+      break;
+
+    //   The only two 07xxxx opcodes implemented on the T11 are SOB and XOR.
+    // The others are mostly EIS/FIS instructions that are unimplemented.
+    case 007:
+      if (SRCMODE(wIR) == 4)
+        JSRXOR(XORW)
+      else if (SRCMODE(wIR) == 7)
+        return &CDCT11::SOB;
+      else
+        return &CDCT11::DoTrap<VEC_ILLEGAL>;
+
+    // 17xxxx opcodes are all FPP instructions unimplemented on the T11 ...
+    case 017:
+      return &CDCT11::DoTrap<VEC_ILLEGAL>;
+  }
+
+  //   That leaves the 0050DD..0077DD and 1050DD..1077DD opcodes.  On the PDP11
+  // these are mostly the single operand instructions like CLR(B), NEG(B),
+  // TST(B), etc, but with a few wildcards thrown in like MTPS and MFPS.  And a
+  // large number of these opcodes are not implemented on the DCT11.
+  switch ((wIR >> 6) & 077) {
+    case 050:  SINGLE2(CLRW, CLRB);                     // CLR(B)
+    case 051:  SINGLE2(COMW, COMB);                     // COM(B)
+    case 052:  SINGLE2(INCW, INCB);                     // INC(B)
+    case 053:  SINGLE2(DECW, DECB);                     // DEC(B)
+    case 054:  SINGLE2(NEGW, NEGB);                     // NEG(B)
+    case 055:  SINGLE2(ADCW, ADCB);                     // ADC(B)
+    case 056:  SINGLE2(SBCW, SBCB);                     // SBC(B)
+    case 057:  SINGLE2(TSTW, TSTB);                     // TST(B)
+    case 060:  SINGLE2(RORW, RORB);                     // ROR(B)
+    case 061:  SINGLE2(ROLW, ROLB);                     // ROL(B)
+    case 062:  SINGLE2(ASRW, ASRB);                     // ASR(B)
+    case 063:  SINGLE2(ASLW, ASLB);                     // ASL(B)
+    case 064:  if (fByte) SINGLE(MTPS);  break;         // MTPS
+    case 067:  SINGLE2(SXTW, MFPS);                     // MFPS/SXT
+  }
+  return &CDCT11::DoTrap<VEC_ILLEGAL>;
+}
+
+void CDCT11::InitializeDispatch()
+{
+  //++
+  //   Build the opcode dispatch table.  This only needs to be done once, no
+  // matter how many CDCT11 instances there are.  CPUs might be created on
+  // different threads, so std::call_once() makes sure the table is filled in
+  // exactly once and that nobody uses it until it's complete ...
+  //--
+  static std::once_flag s_fDispatch;
+  std::call_once(s_fDispatch, [] {
+    for (uint32_t i = 0;  i < DISPATCH_SIZE;  ++i)
+      g_apDispatch[i] = Decode(MASK16(i << DISPATCH_SHIFT));
+  });
 }
 
 uint32_t CDCT11::DoRequests (CPIC11::IRQ_t nIRQ)
@@ -1542,7 +1772,7 @@ uint32_t CDCT11::DoRequests (CPIC11::IRQ_t nIRQ)
     assert(nIRQ > 0);
     address_t wVector = GetPIC()->GetVector(nIRQ);
     nCycles += TrapNow(wVector);
-    GetPIC()->AcknowledgeRequest(nIRQ);
+    GetPIC()->AcknowledgeRequest(nIRQ);  ++m_qInterrupts;
     LOGF(DEBUG, "external interrupt CP%d, vector=%03o", nIRQ, wVector);
   }
   if (ISSET(m_bRequests, REQ_POWERFAIL)) {
@@ -1560,74 +1790,51 @@ uint32_t CDCT11::DoRequests (CPIC11::IRQ_t nIRQ)
   return nCycles;
 }
 
-uint32_t CDCT11::DoExecute (uint16_t wIR)
+size_t CDCT11::DisassembleInstruction (address_t nPC, string &sCode) const
 {
   //++
-  // Execute the instruction and return the number of cycles used ...
+  //   Disassemble the instruction at nPC and return its length.  This is
+  // used by the profiler to show what's at the busiest addresses.
   //--
+  return ::Disassemble(m_pMemory, nPC, sCode);
+}
 
-  // Start off by decoding just the upper 4 bits of the instruction ...
-  uint8_t bOpcode = (wIR >> 12) & 017;
-  switch (bOpcode) {
-    // All double operand instructions ...
-    case 001:  return MOVW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 011:  return MOVB(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 002:  return CMPW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 012:  return CMPB(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 003:  return BITW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 013:  return BITB(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 004:  return BICW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 014:  return BICB(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 005:  return BISW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 015:  return BISB(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 006:  return ADDW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-    case 016:  return SUBW(SRCMODE(wIR), SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-
-    // Single operand instructions, branch, trap, HALT, WAIT, etc ...
-    case 000:
-      if (wIR < 000400)
-        // Opcodes 000000 .. 000377 ...
-        return DoOpcode00(wIR);
-      else if (wIR < 004000)
-        // Opcodes 000400 .. 003777 ...
-        return DoBranch(false, HIBYTE(wIR) & 7, LOBYTE(wIR));
-      else if (wIR < 005000)
-        // Opcodes 004000 .. 004777 ...
-        return JSR(SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-      else
-        // Opcodes 005000 .. 007777 ...
-        return DoSingleOperand(false, ((wIR>>6) & 077), DSTMODE(wIR), DSTREG(wIR));
-
-    // ...
-    case 010:
-      if (wIR < 0104000)
-        // Opcodes 100000 .. 103777 ...
-        return DoBranch(true, HIBYTE(wIR) & 7, LOBYTE(wIR));
-      else if (wIR < 0104400)
-        // Opcodes 104000 .. 104377 ...
-        return InstructionTrap(VEC_EMT);
-      else if (wIR < 0105000)
-        // Opcodes 104400 .. 104777 ...
-        return InstructionTrap(VEC_TRAP);
-      else
-        // Opcodes 105000 .. 107777 ...
-        return DoSingleOperand(true, ((wIR>>6) & 077), DSTMODE(wIR), DSTREG(wIR));
+const char *const *CDCT11::GetTraceNames() const
+{
+  //++
+  //   Return the names of the registers saved in each instruction trace entry.
+  // That's R0 thru R5, SP and the PSW (the PC is saved separately) ...
+  //--
+  static const char *const apszNames[] = {
+    "R0", "R1", "R2", "R3", "R4", "R5", "SP", "PSW", NULL
+  };
+  return apszNames;
+}
 
-    //   The only two 07xxxx opcodes implemented on the T11 are SOB and XOR.
-    // The others are mostly EIS/FIS instructions that are unimplemented.
-    case 007:
-      if (SRCMODE(wIR) == 4)
-        return XORW(SRCREG(wIR), DSTMODE(wIR), DSTREG(wIR));
-      else if (SRCMODE(wIR) == 7)
-        return SOB(SRCREG(wIR), DESTINATION(wIR));
-      else
-        return InstructionTrap(VEC_ILLEGAL);
+void CDCT11::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the DCT11 registers.  The condition codes are saved in
+  // their lazy form, exactly as they are, along with any pending traps ...
+  //--
+  State.Sync(m_wR);  State.Sync(m_bPSW);
+  State.Sync(m_bCCop);  State.Sync(m_wCCresult);  State.Sync(m_wCCa);  State.Sync(m_wCCb);
+  State.Sync(m_wMode);  State.Sync(m_bRequests);  State.Sync(m_wItrapVector);
+  CCPU::SyncState(State);
+}
 
-    // 17xxxx opcodes are all FPP instructions unimplemented on the T11 ...
-    case 017:
-      return InstructionTrap(VEC_ILLEGAL);
-  }
-  return 0;
+bool CDCT11::GetLoopState (uint64_t &qState) const
+{
+  //++
+  //   Return a hash of all the DCT11 internal registers for the idle loop
+  // detection in CCPU.  That's just the general registers, the PSW, the mode
+  // register and any pending trap requests.
+  //--
+  qState = 0;
+  for (unsigned r = 0;  r < MAXREG;  ++r)  qState = LoopHash(qState, m_wR[r]);
+  qState = LoopHash(qState, MKWORD(m_bRequests, CurrentPSW()));
+  qState = LoopHash(qState, m_wMode);
+  return true;
 }
 
 CCPU::STOP_CODE CDCT11::Run (uint32_t nCount)
@@ -1641,39 +1848,54 @@ CCPU::STOP_CODE CDCT11::Run (uint32_t nCount)
   // an illegal opcode or I/O, the user entering the escape sequence on 
   // the console, etc.  If nCount is zero on entry, then we will run for-       
   // ever until one of the previously mentioned break conditions arises.        
+  //
+  //   Device events and external interrupt requests are only checked when we
+  // reach the event queue horizon.  That's normally the time of the next event,
+  // but any I/O page access, or any instruction that changes the PSW priority,
+  // will invalidate the horizon so that we'll check again.
   //--
   bool fFirst = true;
-  m_nStopCode = STOP_NONE;
+  m_nStopCode = STOP_NONE;  InvalidateHorizon();  ResetIdleLoop();
 
   while (m_nStopCode == STOP_NONE) {
-    // If any device events need to happen, now is the time...
-    DoEvents();
+    //   If any device events need to happen, now is the time.  Remember that
+    // we'll need to look for interrupt requests after this instruction too...
+    bool fHorizon = AtHorizon();
+    if (fHorizon) DoHorizon();
 
     //   If the T bit is set in the PSW, then set a trace trap request.
     // This will be handled at the END of this instruction!
     if (ISPSW(PSW_T)) BreakpointRequest();
 
     // Stop after we hit a breakpoint ...
-    if (!fFirst && m_pMemory->IsBreak(GetPC())) {
+    if (!fFirst && m_pMemory->CheckBreak(GetPC())) {
       m_nStopCode = STOP_BREAKPOINT;  break;
     }
     fFirst = false;
 
-    // Trace instruction execution ...
-    //string sCode;
-    //Disassemble(m_pMemory, PC, sCode);
-
     // Fetch, decode and execute an instruction...
-    m_nLastPC = PC;
+    m_nLastPC = PC;  ++m_qInstructions;
     uint16_t wIR = FETCHW();
+
+    // Record this instruction in the trace buffer, if it's enabled ...
+    TRACE_ENTRY *pTrace = NextTrace();
+    if (pTrace != NULL) {
+      pTrace->lOpcode = wIR;
+      for (unsigned r = 0;  r < REG_PC;  ++r)  pTrace->awRegisters[r] = m_wR[r];
+      pTrace->awRegisters[REG_PC] = CurrentPSW();
+    }
+
     uint32_t nCycles = DoExecute(wIR);
     AddCycles(nCycles);
 
-    //LOGF(TRACE, "%06o/ %-35s SP/%06o PSW/%03o", PC, sCode.c_str(), SP, PSW);
-
-    // Look for an external interrupt .GT. PSW priority ...
-    CPIC11::IRQ_t nIRQ = GetPIC()->FindRequest(PSW);
-    if (nIRQ > 0) SETBIT(m_bRequests, REQ_EXTERNAL);
+    //   Look for an external interrupt .GT. PSW priority, but only if we were
+    // at the horizon OR this instruction has invalidated it, AND only if the
+    // PIC says that something might be requesting ...
+    CPIC11::IRQ_t nIRQ = 0;
+    if ((fHorizon || AtHorizon())  &&  IsAttention()) {
+      nIRQ = GetPIC()->FindRequest(PSW);
+      if (nIRQ > 0) SETBIT(m_bRequests, REQ_EXTERNAL);
+    }
 
     // If there are any trap or interrupt requests pending, do them now ...
     if (m_bRequests != 0) {
@@ -1681,6 +1903,12 @@ CCPU::STOP_CODE CDCT11::Run (uint32_t nCount)
       AddCycles(nCycles);
     }
 
+    // Skip ahead if we're spinning in an idle or polling loop ...
+    CheckIdleLoop(PC);
+
+    // Charge this instruction to the profiler, if it's enabled ...
+    Profile(m_nLastPC);
+
     // Terminate if we've executed enough instructions ... 
     if (m_nStopCode == STOP_NONE) {
       if ((nCount > 0)  &&  (--nCount == 0))  m_nStopCode = STOP_FINISHED;
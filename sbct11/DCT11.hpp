@@ -22,6 +22,13 @@
 //
 // REVISION HISTORY:
 // 27-FEB-20  RLA   Copied from C2650.
+// 16-OCT-26  RLA   Add GetLoopState() for idle loop detection
+// 16-OCT-26  RLA   Use FastReadW() and FastWriteW() for word accesses
+// 16-OCT-26  RLA   Decode opcodes thru a dispatch table built at startup
+// 16-OCT-26  RLA   Evaluate the condition codes lazily
+// 16-OCT-26  RLA   Add DisassembleInstruction() for the profiler
+// 16-OCT-26  RLA   Add GetTraceNames() for the instruction trace
+// 16-OCT-26  RLA   Add SyncState() for SAVE/LOAD STATE
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -87,6 +94,7 @@ public:
       // The DCT11 doesn't implement priorities 3..1!
       PSW_PRI0= 0000000,      //  ... priority 0
     PSW_BITS  = 0000377,      // PSW bits that are actually implemented
+    PSW_CC    = PSW_N|PSW_Z|PSW_V|PSW_C, // all the condition code bits
   };
 
   // DCT11 trap bits and vectors ...
@@ -146,6 +154,12 @@ public:
   // Get the address of the next instruction to be executed ...
   inline address_t GetPC() const override {return m_wR[REG_PC];}
   inline void SetPC (address_t a) override {m_wR[REG_PC] = a;}
+  // Disassemble one instruction (used by the profiler) ...
+  size_t DisassembleInstruction (address_t nPC, string &sCode) const override;
+  // Addresses are always shown in octal ...
+  unsigned GetAddressRadix() const override {return 8;}
+  // Return the names of the registers saved in the instruction trace ...
+  const char *const *GetTraceNames() const override;
   // Decode the PSW and return it as a string ...
   string GetPSW() const;
   // Get or set the T11 mode register ...
@@ -173,6 +187,8 @@ public:
   unsigned GetRegisterSize (cpureg_t r) const override {return (r == REG_PSW) ? 8 : 16;}
   uint16_t GetRegister (cpureg_t nReg) const override;
   void SetRegister (cpureg_t nReg, uint16_t nVal) override;
+  // Save or load the CPU state ...
+  void SyncState (CStateFile &State) override;
   // Request the CPU halt (for NXM trap or console BREAK) ...
   void HaltRequest() {SETBIT(m_bRequests, REQ_HALT);}
   // Request the CPU take the power fail trap vector ...
@@ -194,20 +210,18 @@ private:
   //   The other thing is that the SBCT11 actually uses the T11 in 16 bit bus mode.
   // This is transparent as far as RAM/ROM goes, but it could conceiveably have some
   // effect on I/O devices, because it's the difference between one word access vs
-  // two byte accesses.  HOWEVER, the only actual 16 bit I/O device in the SBCT11 is
-  // the IDE data register, and we just handle that one as a special case. 
-  inline uint8_t READB (address_t a) const {return m_pMemory->CPUread(a);}
-  inline void WRITEB (address_t a, uint8_t b) {m_pMemory->CPUwrite(a, b);}
+  // two byte accesses.  Word accesses use the CMemory FastReadW() and FastWriteW()
+  // methods, and the memory map passes them to I/O devices as one transaction.
+  inline uint8_t READB (address_t a) const {return m_pMemory->FastRead(a);}
+  inline void WRITEB (address_t a, uint8_t b) {LoopWrite();  m_pMemory->FastWrite(a, b);}
   // Word versions of the above ...
   //   Note that the T11 has no concept of odd address traps - a word access
   // simply drops the LSB, so a word access to an odd address actually just
   // accesses the next lower even address...
   //
   //   BTW, remember that the PDP-11 is a little endian machine!
-  inline uint16_t READW (address_t a) const
-    {uint8_t l = READB(a & (~1));  uint8_t h = READB(a|1);  return MKWORD(h,l);}
-  inline void WRITEW (address_t a, uint16_t w)
-    {WRITEB((a & (~1)), LOBYTE(w));  WRITEB((a|1), HIBYTE(w));}
+  inline uint16_t READW (address_t a) const {return m_pMemory->FastReadW(a);}
+  inline void WRITEW (address_t a, uint16_t w) {LoopWrite();  m_pMemory->FastWriteW(a, w);}
   //   Fetch the word (presumably an opcode) pointed to by the PC and increment
   // the PC by 2.  We want to be careful here in the case that the PC contains
   // an odd address.  This shouldn't normally happen, but if it does we need the
@@ -215,19 +229,65 @@ private:
   inline uint16_t FETCHW()
     {uint16_t w = READW(m_wR[REG_PC]);  INC16(m_wR[REG_PC], 2);  return w;}
 
+  //   The condition codes are evaluated lazily.  Most instructions set N, Z, V
+  // and/or C, but most of the time the next instruction just changes them all
+  // over again.  So for the most common instructions we simply remember the
+  // result, the operands and the kind of operation in m_bCCop, and work out the
+  // actual bits only if something (a branch, MFPS, a trap, the UI, etc) asks
+  // for them.  When m_bCCop is CC_PSW the N, Z, V and C bits in m_bPSW are
+  // correct; otherwise they're garbage and the lazy state is what counts.
+  //
+  //   Note that byte results are saved sign extended to 16 bits, so N and Z
+  // can always be tested the same way regardless of the operand size.  Also,
+  // the CC_LOGIC, CC_INCx and CC_DECx operations don't change C, so for those
+  // the C bit in m_bPSW is always correct.
+private:
+  enum _CC_OPS {
+    CC_PSW,                   // N, Z, V and C are all in the PSW already
+    CC_LOGIC,                 // N and Z from the result, V=0, C unchanged
+    CC_INCW,                  // INC - V set if the result is 100000
+    CC_INCB,                  // INCB - V set if the result is 200
+    CC_DECW,                  // DEC - V set if the result is 077777
+    CC_DECB,                  // DECB - V set if the result is 177
+    CC_ADDW,                  // ADD - result = A + B
+    CC_SUBW,                  // SUB or CMP - result = A - B
+    CC_SUBB,                  // CMPB - result = A - B
+  };
+  uint8_t ComputeCC() const;
+  void FlushCC() {if (m_bCCop != CC_PSW) {m_bPSW = (m_bPSW & ~PSW_CC) | ComputeCC();  m_bCCop = CC_PSW;}}
+  // Make sure the C bit in the PSW is correct before a C preserving operation ...
+  inline void KeepC() {if (m_bCCop >= CC_ADDW) FlushCC();}
+  // Save the lazy condition code state ...
+  inline void LazyCC (uint8_t bOp, uint16_t wResult)
+    {KeepC();  m_bCCop = bOp;  m_wCCresult = wResult;}
+  inline void LazyCC (uint8_t bOp, uint16_t wResult, uint16_t wA, uint16_t wB)
+    {m_bCCop = bOp;  m_wCCresult = wResult;  m_wCCa = wA;  m_wCCb = wB;}
+  inline void LazyLogicW (uint16_t w) {LazyCC(CC_LOGIC, w);}
+  inline void LazyLogicB (uint8_t  b) {LazyCC(CC_LOGIC, SXT8(b));}
+  // Same as LazyLogic, but C is always cleared ...
+  inline void LazyTestW (uint16_t w) {m_bCCop = CC_LOGIC;  m_wCCresult = w;  CLRBIT(m_bPSW, PSW_C);}
+  inline void LazyTestB (uint8_t  b) {LazyTestW(SXT8(b));}
+
   // DCT11 PSW primitives ...
 private:
-  // Test whether a particular PSW bit is set or cleared ...
+  // Return the PSW with the current condition codes ...
+  inline uint8_t GetCC() const {return (m_bCCop == CC_PSW) ? (m_bPSW & PSW_CC) : ComputeCC();}
+  inline uint8_t CurrentPSW() const {return (m_bPSW & ~PSW_CC) | GetCC();}
+  // Test whether a PSW bit (T or priority only - not N, Z, V or C!) is set ...
   inline bool ISPSW (uint16_t f) const {return ISSET(m_bPSW, f);}
-  inline uint8_t ISN() const {return ISPSW(PSW_N) ? 1 : 0;}
-  inline uint8_t ISZ() const {return ISPSW(PSW_Z) ? 1 : 0;}
-  inline uint8_t ISV() const {return ISPSW(PSW_V) ? 1 : 0;}
-  inline uint8_t ISC() const {return ISPSW(PSW_C) ? 1 : 0;}
+  inline uint8_t ISN() const
+    {return ((m_bCCop == CC_PSW) ? ISSET(m_bPSW, PSW_N) : ISNEGW(m_wCCresult)) ? 1 : 0;}
+  inline uint8_t ISZ() const
+    {return ((m_bCCop == CC_PSW) ? ISSET(m_bPSW, PSW_Z) : (m_wCCresult == 0)) ? 1 : 0;}
+  inline uint8_t ISV() const {return ISSET(GetCC(), PSW_V) ? 1 : 0;}
+  inline uint8_t ISC() const {return ISSET(GetCC(), PSW_C) ? 1 : 0;}
   // Set or clear the N, Z, V, and/or C flags ...
-  inline void SetN (bool f) {if (f) SETBIT(m_bPSW, PSW_N);  else CLRBIT(m_bPSW, PSW_N);}
-  inline void SetZ (bool f) {if (f) SETBIT(m_bPSW, PSW_Z);  else CLRBIT(m_bPSW, PSW_Z);}
-  inline void SetV (bool f) {if (f) SETBIT(m_bPSW, PSW_V);  else CLRBIT(m_bPSW, PSW_V);}
-  inline void SetC (bool f) {if (f) SETBIT(m_bPSW, PSW_C);  else CLRBIT(m_bPSW, PSW_C);}
+  inline void SetN (bool f) {FlushCC();  if (f) SETBIT(m_bPSW, PSW_N);  else CLRBIT(m_bPSW, PSW_N);}
+  inline void SetZ (bool f) {FlushCC();  if (f) SETBIT(m_bPSW, PSW_Z);  else CLRBIT(m_bPSW, PSW_Z);}
+  inline void SetV (bool f) {FlushCC();  if (f) SETBIT(m_bPSW, PSW_V);  else CLRBIT(m_bPSW, PSW_V);}
+  inline void SetC (bool f) {FlushCC();  if (f) SETBIT(m_bPSW, PSW_C);  else CLRBIT(m_bPSW, PSW_C);}
+  // Load the entire PSW, including the condition codes ...
+  inline void SetPSW (uint8_t b) {m_bPSW = b;  m_bCCop = CC_PSW;}
   // Test the 8 or 16 bit sign bit ...
   static inline bool ISNEGW (uint16_t w) {return ISSET(w, 0100000);}
   static inline bool ISNEGB (uint8_t  b) {return ISSET(b, 0200);}
@@ -235,61 +295,76 @@ private:
   inline void SetZNB (uint8_t  b) {SetZ(b==0);  SetN(ISNEGB(b));}
   inline void SetZNW (uint16_t w) {SetZ(w==0);  SetN(ISNEGW(w));}
 
+  // Opcode dispatch table ...
+  //   The dispatch table has one entry for every opcode with the destination
+  // register field dropped, so that's 8K entries rather than 64K.  Each entry
+  // points to a specialized handler with the addressing modes, branch condition
+  // or whatever already resolved at compile time; the handler extracts just
+  // the register numbers at run time.  The table is shared by all instances
+  // and is built the first time a CDCT11 object is created.
+private:
+  typedef uint32_t (CDCT11::*OPCODE) (uint16_t wIR);
+  enum {
+    DISPATCH_SHIFT  = 3,        // low opcode bits ignored by the dispatch table
+    DISPATCH_SIZE   = 020000,   // number of dispatch table entries (64K >> 3)
+  };
+  static OPCODE g_apDispatch[DISPATCH_SIZE];
+
   // DCT11 Two operand instructions ...
 private:
-  uint32_t MOVW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t MOVB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t CMPW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t CMPB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t BITW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t BITB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t BICW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t BICB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t BISW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t BISB (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ADDW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t SUBW (uint8_t bSRCmode, uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t XORW (uint8_t bSRCreg, uint8_t bDSTmode, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t MOVW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t MOVB (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t CMPW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t CMPB (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t BITW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t BITB (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t BICW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t BICB (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t BISW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t BISB (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t ADDW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bSRCmode, uint8_t bDSTmode> uint32_t SUBW (uint8_t bSRCreg, uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t XORW (uint8_t bSRCreg, uint8_t bDSTreg);
 
   // DCT11 Single operand instructions ...
 private:
-  uint32_t CLRW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t CLRB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t COMW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t COMB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t INCW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t INCB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t DECW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t DECB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t NEGW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t NEGB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ADCW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ADCB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t SBCW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t SBCB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t TSTW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t TSTB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t RORW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t RORB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ROLW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ROLB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ASRW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ASRB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ASLW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t ASLB (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t SXTW (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t MTPS (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t MFPS (uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t SWAB (uint8_t bDSTmode, uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t CLRW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t CLRB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t COMW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t COMB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t INCW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t INCB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t DECW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t DECB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t NEGW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t NEGB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ADCW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ADCB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t SBCW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t SBCB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t TSTW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t TSTB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t RORW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t RORB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ROLW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ROLB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ASRW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ASRB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ASLW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t ASLB (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t SXTW (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t MTPS (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t MFPS (uint8_t bDSTreg);
+  template <uint8_t bDSTmode> uint32_t SWAB (uint8_t bDSTreg);
 
   // DCT11 Branch, jump and trap instructions ...
 private:
-  uint32_t DoBranch (bool fByte, uint8_t bOpcode, uint8_t bOffset);
+  template <bool fByte, uint8_t bOpcode> uint32_t DoBranch (uint16_t wIR);
   uint32_t TrapNow (uint16_t wVector);
   uint32_t TrapNow (uint16_t wNewPC, uint16_t wNewPSW);
-  uint32_t SOB (uint8_t bReg, uint8_t bOffset);
-  uint32_t JMP (uint8_t bMode, uint8_t bReg);
-  uint32_t JSR (uint8_t bReg, uint8_t bDSTmode, uint8_t bDSTreg);
+  uint32_t SOB (uint16_t wIR);
+  template <uint8_t bMode> uint32_t JMP (uint8_t bReg);
+  template <uint8_t bDSTmode> uint32_t JSR (uint8_t bReg, uint8_t bDSTreg);
   uint32_t RTS (uint8_t bReg);
   uint32_t RTI (bool fInhibit=false);
   uint32_t RTT() {return RTI(true);}
@@ -306,19 +381,28 @@ private:
   // Sign extend an 8 bit value to 16 bits ..
   static inline uint16_t SXT8 (uint8_t b) {return ISSET(b,0200) ? (b|0177400) : b;}
   // Calculate the effective address given the mode and register ...
-  uint32_t CALCEA (bool fByte, uint8_t bMode, uint8_t bReg, uint16_t &wEA);
-  uint32_t CALCEAB (uint8_t bMode, uint8_t bReg, uint16_t& wEA)
-    {return CALCEA(true, bMode, bReg, wEA);}
-  uint32_t CALCEAW (uint8_t bMode, uint8_t bReg, uint16_t& wEA)
-    {return CALCEA(false, bMode, bReg, wEA);}
+  template <uint8_t bMode> uint32_t CALCEA (bool fByte, uint8_t bReg, uint16_t &wEA);
+  template <uint8_t bMode> uint32_t CALCEAB (uint8_t bReg, uint16_t& wEA)
+    {return CALCEA<bMode>(true, bReg, wEA);}
+  template <uint8_t bMode> uint32_t CALCEAW (uint8_t bReg, uint16_t& wEA)
+    {return CALCEA<bMode>(false, bReg, wEA);}
   // Decode and execute the opcode just fetched ...
   uint32_t DoOpcode00 (uint16_t wOpcode);
-  uint32_t DoSingleOperand (bool fByte, uint8_t bOpcode, uint8_t bDSTmode, uint8_t bDSTreg);
-  uint32_t DoExecute (uint16_t wIR);
+  uint32_t DoExecute (uint16_t wIR)
+    {return (this->*g_apDispatch[wIR >> DISPATCH_SHIFT]) (wIR);}
+  // Build the opcode dispatch table ...
+  static void InitializeDispatch();
+  static OPCODE Decode (uint16_t wIR);
+  // Dispatch table entries for each class of opcode ...
+  template <uint32_t (CDCT11::*OP) (uint8_t, uint8_t)> uint32_t DoDoubleOperand (uint16_t wIR);
+  template <uint32_t (CDCT11::*OP) (uint8_t)> uint32_t DoSingleOperand (uint16_t wIR);
+  template <address_t wVector> uint32_t DoTrap (uint16_t wIR) {return InstructionTrap(wVector);}
   // Process halt, trap and interrupt requests ...
   uint32_t BreakpointRequest() {SETBIT(m_bRequests, REQ_TRACE);  return 6;};
   uint32_t InstructionTrap (address_t wVector);
   uint32_t DoRequests (CPIC11::IRQ_t nIRQ);
+  // Return the CPU state for idle loop detection ...
+  bool GetLoopState (uint64_t &qState) const override;
   // Accumulate simulated time ...
   void AddCycles (uint32_t lCycles);
 
@@ -326,6 +410,9 @@ private:
 private:
   uint16_t   m_wR[MAXREG];    // primary register set
   uint8_t    m_bPSW;          // program status word
+  uint8_t    m_bCCop;         // lazy condition codes - operation
+  uint16_t   m_wCCresult;     //   "      "       "   - result
+  uint16_t   m_wCCa, m_wCCb;  //   "      "       "   - operands
   uint16_t   m_wMode;         // T11 mode register
   uint8_t    m_bRequests;     // trap and interrupt requests pending
   address_t  m_wItrapVector;  // vector for pending instruction trap
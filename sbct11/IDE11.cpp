@@ -48,6 +48,8 @@
 // 20-JAN-20  RLA   New file.
 //  3-SEP-25  RLA   Fix DevWrite() so writes to the odd data byte work.
 // 16-SEP-25  RLA   Add m_fEnabled to simulate no IDE interface.
+// 16-OCT-26  RLA   Transfer whole words to and from the data register.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -63,6 +65,7 @@
 #include "CPU.hpp"              // CCPU base class definitions
 #include "Device.hpp"           // basic I/O device emulation declarations ...
 #include "IDE.hpp"              // IDE/ATA disk emulation
+#include "StateFile.hpp"        // CStateFile declarations
 #include "IDE11.hpp"            // declarations for this module
 
 
@@ -136,6 +139,38 @@ void CIDE11::DevWrite (address_t nAddress, word_t bData)
   }
 }
 
+uint16_t CIDE11::DevReadW (address_t nAddress)
+{
+  //++
+  //   The IDE data register is the only real 16 bit register in the SBCT11,
+  // and the T11 always reads it with a single word access.  Since the drive
+  // is in 8 bit mode, that's just two consecutive bytes from the data buffer,
+  // low byte first.  Everything else is an 8 bit register and gets the usual
+  // two byte treatment ...
+  //--
+  assert(nAddress >= GetBasePort());
+  address_t nRegister = (nAddress - GetBasePort()) ^ CS1FX;
+  if (!m_fEnabled || (nRegister != DATA_REG)) return CIDE::DevReadW(nAddress);
+  uint8_t bLow = CIDE::DevRead(DATA_REG);
+  uint8_t bHigh = CIDE::DevRead(DATA_REG);
+  return MKWORD(bHigh, bLow);
+}
+
+void CIDE11::DevWriteW (address_t nAddress, uint16_t wData)
+{
+  //++
+  //   And the same for writing the data register.  Note that writes ignore
+  // the WRITE_ONLY bit, just like DevWrite() does ...
+  //--
+  assert(nAddress >= GetBasePort());
+  address_t nRegister = ((nAddress - GetBasePort()) ^ CS1FX) & ~WRITE_ONLY;
+  if (!m_fEnabled || (nRegister != DATA_REG)) {
+    CIDE::DevWriteW(nAddress, wData);  return;
+  }
+  CIDE::DevWrite(DATA_REG, LOBYTE(wData));
+  CIDE::DevWrite(DATA_REG, HIBYTE(wData));
+}
+
 void CIDE11::ShowDevice (ostringstream &ofs) const
 {
   //++
@@ -145,3 +180,12 @@ void CIDE11::ShowDevice (ostringstream &ofs) const
   else
     ofs << FormatString("IDE DISABLED");
 }
+
+void CIDE11::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the generic IDE state and our enable flag ...
+  //--
+  CIDE::SyncState(State);
+  State.Sync(m_fEnabled);
+}
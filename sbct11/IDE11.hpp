@@ -21,6 +21,8 @@
 //
 // REVISION HISTORY:
 // 11-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add DevReadW() and DevWriteW()
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -60,7 +62,10 @@ public:
 //virtual void ClearDevice() override {CIDE::ClearDevice();}
   virtual word_t DevRead (address_t nAddress) override;
   virtual void DevWrite (address_t nAddress, word_t bData) override;
+  virtual uint16_t DevReadW (address_t nAddress) override;
+  virtual void DevWriteW (address_t nAddress, uint16_t wData) override;
   virtual void ShowDevice (ostringstream& ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
   // Enable or disable the IDE11 interface ...
   void Enable (bool fEnable=true) {m_fEnabled = fEnable;}
   bool IsEnabled() const {return m_fEnabled;}
@@ -50,6 +50,7 @@
 // 
 // REVISION HISTORY:
 // 10-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -65,6 +66,7 @@
 #include "EventQueue.hpp"       // CEventQueue definitions
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "LTC11.hpp"            // declarations for this module
 
 
@@ -143,3 +145,12 @@ void CLTC11::EventCallback (intptr_t lParam)
   if (m_fEnable) RequestInterrupt(true);
   ScheduleEvent(EVENT_TICK, HZTONS(HERTZ));
 }
+
+void CLTC11::SyncState (CStateFile &State)
+{
+  //++
+  //   The enable bit is the only state we have.  The flag is really the
+  // interrupt request, and the next tick is an event ...
+  //--
+  State.Sync(m_fEnable);
+}
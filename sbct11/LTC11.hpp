@@ -21,6 +21,7 @@
 //
 // REVISION HISTORY:
 // 10-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -61,6 +62,7 @@ public:
   virtual uint8_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, uint8_t bData) override;
   virtual void EventCallback (intptr_t lParam) override;
+  virtual void SyncState (CStateFile &State) override;
   virtual void AttachInterrupt (CSimpleInterrupt *pInterrupt);
 
   // Private methods ...
@@ -58,6 +58,13 @@
 // REVISION HISTORY:
 //  7-JUL-22  RLA   New file.
 // 18-JUL-22  RLA   Add ClearDevices() ...
+// 15-OCT-26  RLA   Add IsSlow() and invalidate the CPU horizon for I/O
+//                  Build the CMemory page table from the RAM and EPROM pages
+//                  Use a chip select table and a flat I/O page array
+// 16-OCT-26  RLA   Add CPUreadW() and CPUwriteW() for whole word transfers
+// 16-OCT-26  RLA   Count I/O page, NXM and ROM write accesses
+// 16-OCT-26  RLA   Add CMemoryControl::SyncState()
+// 16-OCT-26  RLA   Drop the flat I/O page array and UpdateIOpage()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -75,6 +82,7 @@
 #include "Device.hpp"           // generic I/O device definitions
 #include "CPU.hpp"              // generic CPU definitions
 #include "DCT11.hpp"            // DCT11 specific definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "MemoryMap.hpp"        // declarations for this module
 
 
@@ -111,14 +119,27 @@ void CMemoryControl::DevWrite (address_t nPort, word_t bData)
   //--
   assert(nPort >= GetBasePort());
   if ((nPort-GetBasePort()) == MEMC) {
-    m_fRAM = ISSET(bData, MEMC_RAM);
+    SetMode(ISSET(bData, MEMC_RAM), m_fNXE);
     LOGF(TRACE, "MCR %s mode", m_fRAM ? "RAM" : "ROM");
   } else if ((nPort-GetBasePort()) == NXMCS) {
-    m_fNXE = ISSET(bData, NXMCS_NXE);
+    SetMode(m_fRAM, ISSET(bData, NXMCS_NXE));
     if (!m_fNXE) m_fNXM = false;
   }
 }
 
+void CMemoryControl::SetMode (bool fRAM, bool fNXE)
+{
+  //++
+  //   Change the RAM and/or NXE bits.  Both of these change the memory map,
+  // so if either one actually changes then we need to tell the CMemoryMap
+  // object so it can update its page table.
+  //--
+  bool fOldRAM = m_fRAM, fOldNXE = m_fNXE;
+  m_fRAM = fRAM;  m_fNXE = fNXE;
+  if ((m_pMemoryMap != NULL) && ((fOldRAM != fRAM) || (fOldNXE != fNXE)))
+    m_pMemoryMap->RemapPages(fOldRAM, fOldNXE);
+}
+
 void CMemoryControl::ShowDevice (ostringstream &ofs) const
 {
   //++
@@ -130,6 +151,17 @@ void CMemoryControl::ShowDevice (ostringstream &ofs) const
   ofs << std::endl;
 }
 
+void CMemoryControl::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the RAM, NXE and NXM bits.  Changing RAM or NXE changes
+  // the memory map, so we go thru SetMode() for those ...
+  //--
+  bool fRAM = m_fRAM, fNXE = m_fNXE;
+  State.Sync(fRAM);  State.Sync(fNXE);  State.Sync(m_fNXM);
+  if (State.IsLoading()) SetMode(fRAM, fNXE);
+}
+
 CMemoryMap::CMemoryMap (CGenericMemory *pRAM, CGenericMemory *pROM,
                         CDeviceMap *pIOpage, CMemoryControl *pMCR)
 {
@@ -146,6 +178,12 @@ CMemoryMap::CMemoryMap (CGenericMemory *pRAM, CGenericMemory *pROM,
   assert((pIOpage != NULL) && (pMCR != NULL));
   m_pRAM = pRAM;  m_pROM = pROM;  m_pCPU = NULL;
   m_pMCR = pMCR;  m_pIOpage = pIOpage;
+  //   We cache the RAM and EPROM page table entries in our own page table,
+  // so they need to tell us when they change, and so does the MCR ...
+  m_pRAM->SetMapper(this);  m_pROM->SetMapper(this);
+  m_pMCR->SetMemoryMap(this);  UpdatePages();
+  assert(IOPAGE_BASE == IOPAGE);
+  static_assert((size_t) IOPAGE_SIZE <= (size_t) CDeviceMap::DENSE_LIMIT, "I/O page is too big for the dense device map");
 }
 
 CMemoryMap::CHIP_SELECT CMemoryMap::ChipSelect (address_t a, bool fRAM, bool fNXE)
@@ -160,13 +198,10 @@ CMemoryMap::CHIP_SELECT CMemoryMap::ChipSelect (address_t a, bool fRAM, bool fNX
   //   Note that in the SBCT11 the memory address is NEVER modified regardless
   // of which device is selected!
   //
-  //   It's worth sparing a moment to think about the expense, in CPU time,
-  // of this function.  After all, this function will be called for EVERY
-  // SINGLE MEMORY access performed by the CPU emulation!  That's a lot, and
-  // you could undoubtedly find ways to optimize this considerably.  It's
-  // not really necessary though, because this implementation seems to be
-  // "fast enough."  It's a testament to how fast modern PCs have become that
-  // this is so...
+  //   Note that this is no longer called for every memory reference.  All the
+  // SBCT11 mapping boundaries fall on page boundaries, so MapPage() uses this
+  // to fill in the m_aChipSelect table, one entry per page, for the current
+  // MEMC state.  CPUread() and CPUwrite() just index that table.
   //--
   if (a < ROM_BASE_0) 
     // Addresses 000000..001777 always select the RAM, regardless ...
@@ -228,23 +263,28 @@ void CMemoryMap::NXMtrap (address_t wAddress) const
 word_t CMemoryMap::CPUread (address_t a) const
 {
   //++
-  //   This method is called for _every_ CPU memory read operation (yikes!).
-  // It runs the memory mapping algorithm to figure out which address space
-  // and chip should be selected, and then delegates the request to the
+  //   This method is called for every CPU memory read that can't be handled
+  // by the page table.  It looks up the chip selected by this address, for
+  // the current MEMC state, and then delegates the request to the
   // corresponding object.
+  //
+  //   Note that any I/O page access might change the interrupt state, so in
+  // that case we invalidate the CPU's horizon.
   //--
   CDevice *pDevice;
-  switch (ChipSelect(a, g_pMCR->IsRAM(), g_pMCR->IsNXE())) {
+  switch (GetChipSelect(a)) {
     case CS_ROM: return m_pROM->CPUread(a);
     case CS_RAM: return m_pRAM->CPUread(a);
     case CS_IOPAGE:
-      if ((pDevice = m_pIOpage->Find(a)) != NULL)
-        return pDevice->DevRead(a);
-      else
-        NXMtrap(a);
+      InvalidateHorizon();
+      if ((pDevice = FindIO(a)) != NULL) {
+        CountRead(ACCESS_IO);  return pDevice->DevRead(a);
+      } else {
+        CountRead(ACCESS_NXM);  NXMtrap(a);
+      }
       return WORD_MAX;
     default:
-      NXMtrap(a);  return WORD_MAX;
+      CountRead(ACCESS_NXM);  NXMtrap(a);  return WORD_MAX;
   }
 }
 
@@ -254,17 +294,66 @@ void CMemoryMap::CPUwrite (address_t a, word_t d)
   // The same idea as CPUread(), except this time write to a location...
   //--
   CDevice *pDevice;
-  switch (ChipSelect(a, g_pMCR->IsRAM(), g_pMCR->IsNXE())) {
-    case CS_ROM: /* can't write to ROM! */  break;
+  switch (GetChipSelect(a)) {
+    case CS_ROM: /* can't write to ROM! */  CountWrite(ACCESS_ROM);  break;
     case CS_RAM: m_pRAM->CPUwrite(a, d);    break;
     case CS_IOPAGE:
-      if ((pDevice = m_pIOpage->Find(a)) != NULL)
-        pDevice->DevWrite(a, d);
-      else
-        NXMtrap(a);
+      InvalidateHorizon();
+      if ((pDevice = FindIO(a)) != NULL) {
+        CountWrite(ACCESS_IO);  pDevice->DevWrite(a, d);
+      } else {
+        CountWrite(ACCESS_NXM);  NXMtrap(a);
+      }
+      break;
+    default:
+      CountWrite(ACCESS_NXM);  NXMtrap(a);  break;
+  }
+}
+
+uint16_t CMemoryMap::CPUreadW (address_t a) const
+{
+  //++
+  //   Read a whole 16 bit word for the DCT11.  Both bytes of a word are always
+  // in the same page, so they always select the same chip and one decode is
+  // enough.  In the I/O page the two bytes might belong to different devices
+  // (or none at all!), so only if both belong to the same device do we give
+  // it a single word transaction.  Otherwise just do two byte reads ...
+  //--
+  CDevice *pDevice;
+  switch (GetChipSelect(a)) {
+    case CS_ROM: return m_pROM->CPUreadW(a);
+    case CS_RAM: return m_pRAM->CPUreadW(a);
+    case CS_IOPAGE:
+      InvalidateHorizon();
+      pDevice = FindIO(a & ~1);
+      if ((pDevice != NULL)  &&  (pDevice == FindIO(a | 1))) {
+        CountRead(ACCESS_IO);  return pDevice->DevReadW(a & ~1);
+      }
+      return CMemory::CPUreadW(a);
+    default:
+      CountRead(ACCESS_NXM);  NXMtrap(a);  return MKWORD(WORD_MAX, WORD_MAX);
+  }
+}
+
+void CMemoryMap::CPUwriteW (address_t a, uint16_t w)
+{
+  //++
+  // The same as CPUreadW(), but for writing ...
+  //--
+  CDevice *pDevice;
+  switch (GetChipSelect(a)) {
+    case CS_ROM: /* can't write to ROM! */  CountWrite(ACCESS_ROM);  break;
+    case CS_RAM: m_pRAM->CPUwriteW(a, w);   break;
+    case CS_IOPAGE:
+      InvalidateHorizon();
+      pDevice = FindIO(a & ~1);
+      if ((pDevice != NULL)  &&  (pDevice == FindIO(a | 1))) {
+        CountWrite(ACCESS_IO);  pDevice->DevWriteW(a & ~1, w);
+      } else
+        CMemory::CPUwriteW(a, w);
       break;
     default:
-      NXMtrap(a);  break;
+      CountWrite(ACCESS_NXM);  NXMtrap(a);  break;
   }
 }
 
@@ -286,18 +375,92 @@ bool CMemoryMap::IsBreak (address_t a) const
   // figure out which one of those two is currently selected first.  Break
   // points are not supported, and we always return FALSE, for I/O devices.
   //--
-  switch (ChipSelect(a, g_pMCR->IsRAM(), g_pMCR->IsNXE())) {
+  switch (GetChipSelect(a)) {
     case CS_ROM: return m_pROM->IsBreak(a);
     case CS_RAM: return m_pRAM->IsBreak(a);
     default: return false;
   }
 }
 
+bool CMemoryMap::IsSlow (address_t a) const
+{
+  //++
+  //   Return TRUE if the specified address needs extra access time.  Like
+  // IsBreak(), this only makes sense for RAM and EPROM ...
+  //--
+  switch (GetChipSelect(a)) {
+    case CS_ROM: return m_pROM->IsSlow(a);
+    case CS_RAM: return m_pRAM->IsSlow(a);
+    default: return false;
+  }
+}
+
+void CMemoryMap::InvalidateHorizon() const
+{
+  //++
+  // Force the CPU to recheck interrupts after an I/O page access ...
+  //--
+  if (m_pCPU != NULL) m_pCPU->InvalidateHorizon();
+}
+
+void CMemoryMap::MapPage (size_t nPage, bool fRAM, bool fNXE)
+{
+  //++
+  //   Update the chip select table and our page table entry for one page of
+  // CPU addresses.  If the page selects RAM or EPROM then we can just borrow
+  // the page table entries from that CGenericMemory object.  Remember that
+  // EPROM can never be written, regardless of its memory flags, and that the
+  // NXM region and the I/O page always have to go the slow way.
+  //
+  //   All the SBCT11 mapping boundaries fall on page boundaries, so the first
+  // and last byte of any page always select the same chip.  And the page's
+  // breakpoint bit comes from the selected memory too.
+  //--
+  address_t aFirst = ADDRESS(nPage << PAGE_SHIFT);
+  CHIP_SELECT nChip = ChipSelect(aFirst, fRAM, fNXE);
+  assert(ChipSelect(ADDRESS(aFirst+PAGE_MASK), fRAM, fNXE) == nChip);
+  m_aChipSelect[nPage] = nChip;
+  if (nChip == CS_RAM) {
+    SetPage(nPage, m_pRAM->GetReadPage(aFirst), m_pRAM->GetWritePage(aFirst));
+    SetBreakPage(nPage, m_pRAM->IsBreakPage(aFirst));
+  } else if (nChip == CS_ROM) {
+    SetPage(nPage, m_pROM->GetReadPage(aFirst), NULL);
+    SetBreakPage(nPage, m_pROM->IsBreakPage(aFirst));
+  } else {
+    SetPage(nPage, NULL, NULL);  SetBreakPage(nPage, false);
+  }
+}
+
+void CMemoryMap::UpdatePages (address_t nFirst, address_t nLast)
+{
+  //++
+  // Rebuild the page table for the current memory mode ...
+  //--
+  for (size_t nPage = PAGE(nFirst);  nPage <= PAGE(nLast);  ++nPage)
+    MapPage(nPage, m_pMCR->IsRAM(), m_pMCR->IsNXE());
+}
+
+void CMemoryMap::RemapPages (bool fOldRAM, bool fOldNXE)
+{
+  //++
+  //   This is called by the MCR whenever the RAM or NXE bits change, and it
+  // updates only the pages that are actually mapped differently in the old
+  // and new modes.  That's everything from 002000 to 170377, but the RAM at
+  // the bottom, the EPROM at the top, and the I/O page never change.
+  //--
+  bool fRAM = m_pMCR->IsRAM(), fNXE = m_pMCR->IsNXE();
+  for (size_t nPage = 0;  nPage < PAGE_COUNT;  ++nPage) {
+    address_t a = ADDRESS(nPage << PAGE_SHIFT);
+    if (ChipSelect(a, fOldRAM, fOldNXE) != ChipSelect(a, fRAM, fNXE))
+      MapPage(nPage, fRAM, fNXE);
+  }
+}
+
 bool CMemoryMap::IsIO (address_t a) const
 {
   //++
   //   Return true if the specified (and mapped) address is an I/O device and
   // false if it is either RAM or EPROM.  This is pretty easy to figure out.
   //--
-  return ChipSelect(a, g_pMCR->IsRAM(), g_pMCR->IsNXE()) == CS_IOPAGE;
+  return GetChipSelect(a) == CS_IOPAGE;
 }
@@ -29,6 +29,13 @@
 //
 // REVISION HISTORY:
 //  6-JUL-22  RLA   New file.
+// 15-OCT-26  RLA   Add IsSlow() ...
+//                  Add UpdatePages() and RemapPages() for the page table
+//                  Add the chip select table and flat I/O page array
+// 16-OCT-26  RLA   Add CPUreadW() and CPUwriteW()
+// 16-OCT-26  RLA   Add CMemoryControl::SyncState()
+// 16-OCT-26  RLA   Initialize the MCR bits before PowerOn() reads them
+// 16-OCT-26  RLA   Drop UpdateIOpage() and use the dense CDeviceMap instead
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -38,6 +45,7 @@
 #include "Device.hpp"           // generic I/O device definitions
 class CDeviceMap;               // ...
 class CDCT11;                   // ...
+class CMemoryMap;               // ...
 
 class CMemoryControl : public CDevice {
   //++
@@ -60,7 +68,8 @@ public:
 public:
   // Constructor and destructor...
   CMemoryControl (address_t nPort)
-    : CDevice("MCR", "MCR11", "Memory Control Registers", INOUT, nPort, PORTS)
+    : CDevice("MCR", "MCR11", "Memory Control Registers", INOUT, nPort, PORTS),
+      m_fRAM(false), m_fNXE(false), m_fNXM(false), m_pMemoryMap(NULL)
     {PowerOn();}
   virtual ~CMemoryControl() {};
 private:
@@ -76,11 +85,12 @@ public:
   virtual word_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, word_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Special MCR methods ...
 public:
   // Simulate a power up clear!
-  void PowerOn() {m_fRAM = m_fNXE = m_fNXM = false;}
+  void PowerOn() {SetMode(false, false);  m_fNXM = false;}
   // Return true if RAM or ROM mode is selected ...
   bool IsRAM() const {return  m_fRAM;}
   bool IsROM() const {return !m_fRAM;}
@@ -90,6 +100,13 @@ public:
   // writing to the NXMCS register!
   void SetNXM() {m_fNXM = true;}
   bool IsNXM() const {return m_fNXM;}
+  // Set the memory map that needs to know when the RAM or NXE bits change ...
+  void SetMemoryMap (CMemoryMap *pMemoryMap) {m_pMemoryMap = pMemoryMap;}
+
+  // Local methods ...
+private:
+  // Change the RAM and NXE bits and update the memory map ...
+  void SetMode (bool fRAM, bool fNXE);
 
   // Private member data...
 protected:
@@ -98,6 +115,7 @@ protected:
   bool    m_fRAM;       // TRUE if RAM mode is selected
   bool    m_fNXE;       // TRUE if NXM trapping is enabled
   bool    m_fNXM;       // TRUE if a NXM error has occurred
+  CMemoryMap *m_pMemoryMap; // memory map to update when RAM or NXE change
 };
 
 
@@ -115,6 +133,12 @@ public:
     CS_IOPAGE     = 3,  // some I/O device is selected
   };
   typedef enum _CHIP_SELECT CHIP_SELECT;
+  enum {
+    //   The I/O page is everything from 176400 up.  This is the same as
+    // IOPAGE in sbct11.hpp, but we need it here for FindIO().
+    IOPAGE_BASE   = 0176400,              // first address in the I/O page
+    IOPAGE_SIZE   = 0200000-IOPAGE_BASE,  // number of bytes in the I/O page
+  };
 
 public:
   // Constructor and destructor ...
@@ -131,10 +155,18 @@ public:
   // CPU memory access functions ...
   virtual word_t CPUread (address_t a) const override;
   virtual void CPUwrite (address_t a, word_t d) override;
+  virtual uint16_t CPUreadW (address_t a) const override;
+  virtual void CPUwriteW (address_t a, uint16_t w) override;
   virtual bool IsBreak (address_t a) const override;
+  virtual bool IsSlow (address_t a) const override;
   virtual bool IsIO (address_t a) const;
+  // Rebuild the page table for the current (or a new) memory mode ...
+  virtual void UpdatePages (address_t nFirst=0, address_t nLast=ADDRESS_MAX) override;
+  void RemapPages (bool fOldRAM, bool fOldNXE);
   // Figure out what address space should be selected ...
   static CHIP_SELECT ChipSelect(address_t a, bool fRAM, bool fNXE);
+  // Return the chip currently selected by this address (from the table) ...
+  inline CHIP_SELECT GetChipSelect (address_t a) const {return m_aChipSelect[PAGE(a)];}
   // Return the name of the memory associated with a CHIP_SELECT ...
   static const char *GetChipName (CHIP_SELECT nSelect);
   // Clear all I/O devices (equivalent to a PDP11 BCLR!) ...
@@ -144,6 +176,14 @@ public:
 private:
   // Call the DCT11's external halt request, if NXM trapping is enabled.
   void NXMtrap (address_t wAddress) const;
+  // Force the CPU to recheck interrupts after an I/O page access ...
+  void InvalidateHorizon() const;
+  // Update the page table entry for one page ...
+  void MapPage (size_t nPage, bool fRAM, bool fNXE);
+  //   Find the device (if any) at this I/O page address.  The I/O page is
+  // smaller than CDeviceMap::DENSE_LIMIT, so this is always an array lookup.
+  inline CDevice *FindIO (address_t a) const
+    {assert(a >= IOPAGE_BASE);  return m_pIOpage->Find(a);}
 
   // SBC1802 Memory Map internal state ...
 private:
@@ -152,4 +192,5 @@ private:
   CGenericMemory *m_pROM;     // and a 64K EPROM space
   CDeviceMap     *m_pIOpage;  // memory mapped I/O devices
   CMemoryControl *m_pMCR;     // memory control register
+  CHIP_SELECT     m_aChipSelect[PAGE_COUNT];  // chip selected by each page
 };
@@ -87,6 +87,8 @@
 //    
 // REVISION HISTORY:
 // 18-JUN-22  RLA   New file.
+// 16-OCT-26  RLA   Use the request bit map in FindRequest() ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -101,6 +103,7 @@
 #include "Interrupt.hpp"        // generic priority interrupt controller
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
+#include "StateFile.hpp"        // CStateFile declarations
 #include "PIC11.hpp"           // declarations for this module
 #include "DCT11.hpp"            // DEC DCT11 CPU definitions
 
@@ -124,11 +127,14 @@ const address_t CPIC11::g_awVectors[CPIC11::IRQLEVELS] = {
 CPIC11::CPIC11()
 {
   //++
-  // The constructor creates all 15 CSimpleInterrupt objects ...
+  //   The constructor creates all 15 CSimpleInterrupt objects and attaches
+  // each one to its bit (CP1 is bit 0) in the m_lRequests bit map ...
   //--
-  for (IRQ_t i = 0;  i < IRQLEVELS;  ++i)
+  m_nLastIRQ = 0;  m_lRequests = 0;
+  for (IRQ_t i = 0;  i < IRQLEVELS;  ++i) {
     m_pLevel[i] = DBGNEW CSimpleInterrupt(CSimpleInterrupt::EDGE_TRIGGERED);
-  m_nLastIRQ = 0;
+    m_pLevel[i]->SetAttention(&m_lRequests, 1UL << i);
+  }
 }
 
 CPIC11::~CPIC11()
@@ -149,6 +155,16 @@ void CPIC11::ClearInterrupt()
   m_nLastIRQ = 0;
 }
 
+void CPIC11::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the requests for every level.  Loading a level updates
+  // its bit in m_lRequests too, so we don't need to save that separately.
+  //--
+  for (IRQ_t i = 1; i <= IRQLEVELS; ++i)  GetLevel(i)->SyncState(State);
+  State.Sync(m_nLastIRQ);
+}
+
 CPIC11::IRQ_t CPIC11::FindRequest (uint8_t bPSW)
 {
   //++
@@ -156,13 +172,15 @@ CPIC11::IRQ_t CPIC11::FindRequest (uint8_t bPSW)
   // greater than the specified CPU priority level.  Note that if you don't
   // care about the CPU and just want the highest priority requests, pass
   // zero as the PSW!
+  //
+  //   Since the priorities in g_abPriority[] never decrease as the CP code
+  // increases, the highest CP requesting is also the highest priority one.
+  // If that one can't interrupt the CPU, then none of the others can either.
   //--
   bPSW &= CDCT11::PSW_PRIO;
-  for (IRQ_t i = IRQLEVELS;  i > 0;  --i) {
-    if (GetPriority(i) <= bPSW) return (m_nLastIRQ = 0);
-    if (GetLevel(i)->IsRequested()) return (m_nLastIRQ = i);
-  }
-  return (m_nLastIRQ = 0);
+  IRQ_t nIRQ = (IRQ_t) FindHighestBit(m_lRequests);
+  if ((nIRQ == 0)  ||  (GetPriority(nIRQ) <= bPSW)) return (m_nLastIRQ = 0);
+  return (m_nLastIRQ = nIRQ);
 }
 
 void CPIC11::AcknowledgeRequest (IRQ_t nIRQ)
@@ -21,6 +21,8 @@
 //
 // REVISION HISTORY:
 //  7-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Keep a bit map of active requests ...
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -28,6 +30,7 @@
 #include "MemoryTypes.h"        // address_t and word_t data types
 #include "Interrupt.hpp"        // generic priority interrupt controller
 using std::string;              // ...
+class CStateFile;               // save/load state file
 
 
 class CPIC11 : public CInterrupt
@@ -79,11 +82,15 @@ public:
 public:
   // Clear all interrupt requests ...
   virtual void ClearInterrupt() override;
+  // Save or load all the requests in a state file ...
+  void SyncState (CStateFile &State);
   //  These two methods are not used on the T11, so assert if they're ever
   // called.  Use FindRequest() and AcknowledgeRequest(nIRQ) instead!
   virtual bool IsRequested() const override {assert(false); return false;}
   // Acknowledge an interrupt request ...
   virtual void AcknowledgeRequest() override {assert(false);}
+  // Return our attention word (non-zero if any CP is requesting) ...
+  virtual const uint32_t *GetAttention() const override {return &m_lRequests;}
 
   // Unique public CPIC11 methods ...
 public:
@@ -107,6 +114,7 @@ protected:
 protected:
   CSimpleInterrupt *m_pLevel[IRQLEVELS];// simple interrupt for each level
   IRQ_t             m_nLastIRQ;         // last IRQ returned by FindRequest()
+  CSimpleInterrupt::IRQMASK m_lRequests;// bit map of CPs requesting now
 
   // Static tables ...
 protected:
@@ -44,6 +44,7 @@
 //
 // REVISION HISTORY:
 //  7-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -60,6 +61,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "i8255.hpp"            // generic PPI base class
+#include "StateFile.hpp"        // CStateFile declarations
 #include "PPI11.hpp"            // declarations for this module
 
 
@@ -130,3 +132,12 @@ void CPPI11::ShowDevice (ostringstream &ofs) const
   ofs << FormatString("SBCT11 POST=%1X\n", m_bPOST);
   C8255::ShowDevice(ofs);
 }
+
+void CPPI11::SyncState (CStateFile &State)
+{
+  //++
+  // Save or load the 8255 and the last POST code ...
+  //--
+  C8255::SyncState(State);
+  State.Sync(m_bPOST);
+}
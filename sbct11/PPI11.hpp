@@ -25,6 +25,7 @@
 //
 // REVISION HISTORY:
 //  7-JUL-22  RLA   New file.
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -56,6 +57,7 @@ public:
   virtual uint8_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, uint8_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
 
   // Overridden methods from C8255 ...
 public:
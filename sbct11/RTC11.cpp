@@ -52,6 +52,7 @@
 // REVISION HISTORY:
 // 11-JUL-22  RLA   New file.
 // 15-AUG-25  RLA   Ignore writes to the high (odd) byte on the new PCB!
+// 16-OCT-26  RLA   Add SyncState()
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -68,6 +69,7 @@
 #include "CPU.hpp"              // CPU definitions
 #include "Device.hpp"           // generic device definitions
 #include "DS12887.hpp"          // Dallas DS12887 emulation
+#include "StateFile.hpp"        // CStateFile declarations
 #include "RTC11.hpp"            // declarations for this module
 
 
@@ -229,3 +231,15 @@ void CRTC11::ShowDevice (ostringstream &ofs) const
   else
     ofs << FormatString("RTC DISABLED");
 }
+
+void CRTC11::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load our own registers and then the DS12887 chip.  The DS12887
+  // isn't in the device map, so nobody else will save it, and it's also an
+  // event handler in its own right ...
+  //--
+  State.Sync(m_bAddress);  State.Sync(m_wCache);
+  State.Sync(m_fOldPCB);  State.Sync(m_fEnabled);
+  m_p12887->SyncState(State);  State.AddHandler(m_p12887);
+}
@@ -22,6 +22,7 @@
 // REVISION HISTORY:
 // 11-JUL-22  RLA   New file.
 // 16-SEP-25  RLA   Add m_fEnable to allow the chip to be "uninstalled".
+// 16-OCT-26  RLA   Add SyncState()
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -73,6 +74,7 @@ public:
   virtual uint8_t DevRead (address_t nPort) override;
   virtual void DevWrite (address_t nPort, uint8_t bData) override;
   virtual void ShowDevice (ostringstream &ofs) const override;
+  virtual void SyncState (CStateFile &State) override;
   
   // Local methods ...
 private:
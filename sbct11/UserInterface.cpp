@@ -41,6 +41,9 @@
 //
 //   SA*VE filename             - save memory to file
 //   The modifiers for SAVE are identical to LOAD!
+//
+//   SA*VE STA*TE filename      - save the entire machine state
+//   LO*AD STA*TE filename      - restore the entire machine state
 // 
 //   ATT*ACH DI*SK filename     - attach IDE drive to image file
 //      /UNIT=0|1               - 0 -> master, 1-> slave
@@ -103,6 +106,11 @@
 //      /DEL*AY=delay           - set character delay, in milliseconds
 //   RE*CEIVE/X*MODEM/CL*OSE    - abort any XMODEM transfer in progress
 //
+//   RECO*RD <file>             - record console input and its timing
+//   RECO*RD/CL*OSE             - stop recording console input
+//   REPL*AY <file>             - replay recorded console input
+//   REPL*AY/CL*OSE             - stop replaying console input
+//
 //   SE*T BRE*AKPOINT oooooo    - set breakpoint at address (octal)
 //   CL*EAR BRE*AKPOINT oooooo   - clear   "      "     "       "
 //   CL*EAR BRE*AKPOINTS        - clear all breakpoints
@@ -211,6 +219,10 @@
 // 17-DEC-23  RLA   Add SEND and RECEIVE commands
 // 16-SEP-25  RLA   Add SET DEVICE commands
 // 23-SEP-25  RLA   Add split baud rates for SLU1.
+// 16-OCT-26  RLA   Add SAVE STATE and LOAD STATE
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Make DEPOSIT ignore a stale /ROM left over from LOAD
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -251,6 +263,7 @@
 #include "IDE.hpp"              // generic IDE disk drive emulation
 #include "IDE11.hpp"            // SBCT11 IDE disk interface
 #include "TU58.hpp"             // TU58 emulator
+#include "StateFile.hpp"        // machine state save and restore
 #include "UserInterface.hpp"    // declarations for this module
 
 
@@ -342,8 +355,15 @@ CCmdModifier CUI::m_modPBRI("PBRI", "NOPBRI");
 CCmdArgument * const CUI::m_argsLoadSave[] = {&m_argFileName, NULL};
 CCmdModifier * const CUI::m_modsLoadSave[] = {&m_modFileFormat, &m_modBaseAddress,
                                               &m_modByteCount, &m_modROM, &m_modNVR, NULL};
-CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoadSave);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave);
+CCmdVerb * const CUI::g_aLoadVerbs[] = {&m_cmdLoadState, NULL};
+CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoadSave, g_aLoadVerbs);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, &m_cmdSaveState, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave, g_aSaveVerbs);
+
+// LOAD STATE and SAVE STATE commands ...
+CCmdArgument * const CUI::m_argsState[] = {&m_argFileName, NULL};
+CCmdVerb CUI::m_cmdLoadState("STA*TE", &DoLoadState, m_argsState, NULL);
+CCmdVerb CUI::m_cmdSaveState("STA*TE", &DoSaveState, m_argsState, NULL);
 
 // ATTACH and DETACH commands ...
 CCmdArgument * const CUI::m_argsAttach[] = {&m_argFileName, NULL};
@@ -390,7 +410,7 @@ CCmdVerb CUI::m_cmdReset("RE*SET", &DoReset);
 CCmdVerb CUI::m_cmdHalt("HA*LT", &DoHalt);
 
 // SET, CLEAR and SHOW CPU ...
-CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modBreakChar, &m_modCPUmode, NULL};
+CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modBreakChar, &m_modCPUmode, &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL};
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdClearCPU("CPU", &DoClearCPU);
 CCmdVerb CUI::m_cmdShowCPU("CPU", &DoShowCPU);
@@ -421,6 +441,7 @@ CCmdVerb CUI::m_cmdClear("CL*EAR", NULL, NULL, NULL, g_aClearVerbs);
 CCmdVerb * const CUI::g_aSetVerbs[] = {
     &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetDevice,
     &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+    &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
 #ifdef THREADS
     &CStandardUI::m_cmdSetCheckpoint,
 #endif
@@ -437,6 +458,7 @@ CCmdVerb * const CUI::g_aShowVerbs[] = {
     &m_cmdShowBreakpoint, &m_cmdShowMemory, &m_cmdShowDevice, &m_cmdShowCPU,
     &m_cmdShowDisk, &m_cmdShowTape, &m_cmdShowTime, &m_cmdShowVersion,
     &CStandardUI::m_cmdShowLog, &CStandardUI::m_cmdShowAliases,
+    &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
 #ifdef THREADS
     &CStandardUI::m_cmdShowCheckpoint,
 #endif
@@ -457,12 +479,13 @@ CCmdVerb * const CUI::g_aVerbs[] = {
   &m_cmdLoad, &m_cmdSave, &m_cmdAttach, &m_cmdDetach,
   &m_cmdExamine, &m_cmdDeposit,
   &m_cmdSendFile, &m_cmdReceiveFile, 
+  &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdRun, &m_cmdContinue, &m_cmdStep, &m_cmdReset,
   &m_cmdHalt, &m_cmdSet, &m_cmdShow, &m_cmdClear, 
   &CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 
@@ -685,6 +708,86 @@ bool CUI::DoSave (CCmdParser &cmd)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////// SAVE STATE and LOAD STATE COMMANDS /////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void CUI::SyncState (CStateFile &State)
+{
+  //++
+  //   Save or load the state of every object in the SBCT11, each in its own
+  // section.  The order doesn't matter much, EXCEPT that the event queue must
+  // be last so that all the event handlers are known by then!
+  //--
+  State.Sync("CPU", g_pCPU);
+  State.Sync("RAM", g_pRAM);
+  State.Sync("ROM", g_pROM);
+  State.Sync("MCR", g_pMCR);
+  State.Sync("PIC", g_pPIC);
+  State.Sync("LTC", g_pLTC);
+  State.Sync("SLU0", g_pSLU0);
+  State.Sync("SLU1", g_pSLU1);
+  State.Sync("RTC", g_pRTC);
+  State.Sync("PPI", g_pPPI);
+  State.Sync("IDE", g_pIDE);
+  State.Sync("TU58", g_pTU58);
+  State.Sync("CONSOLE", g_pConsole);
+  State.Sync("EVENTS", g_pEvents);
+}
+
+bool CUI::DoSaveState (CCmdParser &cmd)
+{
+  //++
+  //   SAVE STATE writes a snapshot of the entire machine - CPU, memory, all
+  // devices and any pending events - to a file.  LOAD STATE can restore it
+  // later and continue exactly where we left off.  Note that the contents of
+  // any attached disk or tape images are NOT saved, only their names.
+  //
+  // Format:
+  //    SAVE STATE <file>
+  //--
+  string sFileName = m_argFileName.GetFullPath();
+  sFileName = CCmdParser::SetDefaultExtension(sFileName, DEFAULT_STATE_FILE_TYPE);
+  if (FileExists(sFileName)) {
+    if (!cmd.AreYouSure(sFileName + " already exists")) return false;
+  }
+  CStateFile State(PROGRAM, false);
+  SyncState(State);
+  if (!State.Write(sFileName)) {
+    CMDERRS("unable to save state - " << State.GetError());  return false;
+  }
+  CMDOUTF("machine state saved to %s", sFileName.c_str());
+  return true;
+}
+
+bool CUI::DoLoadState (CCmdParser &cmd)
+{
+  //++
+  //   LOAD STATE restores a machine state saved by SAVE STATE.  The file has
+  // to be from the same emulator with the same configuration (e.g. memory
+  // sizes), and that's checked as we go.  If anything goes wrong after we've
+  // started loading, then the machine is left in an undefined state!
+  //
+  // Format:
+  //    LOAD STATE <file>
+  //--
+  string sFileName = m_argFileName.GetFullPath();
+  sFileName = CCmdParser::SetDefaultExtension(sFileName, DEFAULT_STATE_FILE_TYPE);
+  CStateFile State(PROGRAM, true);
+  if (!State.Read(sFileName)) {
+    CMDERRS("unable to load state - " << State.GetError());  return false;
+  }
+  SyncState(State);
+  if (!State.IsOK()) {
+    CMDERRS("unable to load state - " << State.GetError());
+    CMDERRS("machine state is undefined - RESET recommended");
+    return false;
+  }
+  CMDOUTF("machine state loaded from %s", sFileName.c_str());
+  return true;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////// ATTACH and DETACH COMMANDS //////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -1044,8 +1147,13 @@ bool CUI::DoDepositRange (address_t nStart, address_t nEnd, CCmdArgList &List)
   // proceeding to successively higher addresses.  If the number of data items
   // would cause nEnd to be exceeded, then give an error message and quit.  nEnd
   // is otherwise ignored - i.e. it's not an error to specify too few items!
+  //
+  //   DEPOSIT always writes RAM.  Don't use GetMemorySpace() here - DEPOSIT
+  // doesn't accept /ROM, so the parser never resets that modifier and it may
+  // still be set from an earlier LOAD/ROM or EXAMINE/ROM!
   //--
-  CGenericMemory *pMemory = GetMemorySpace();
+  assert(g_pRAM != NULL);
+  CGenericMemory *pMemory = g_pRAM;
   bool fByte = m_modWordByte.IsPresent() && m_modWordByte.IsNegated();
   bool fHasEnd = nStart != nEnd;
   if (!fByte && ISSET(nStart, 1)) --nStart;
@@ -1289,6 +1397,10 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
     default:  break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -1486,6 +1598,8 @@ bool CUI::DoShowCPU (CCmdParser &cmd)
   CMDOUTF("%s %s %3.2fMHz MODE=%06o BREAK=^%c",
     g_pCPU->GetName(), g_pCPU->GetDescription(),
     flCrystal, g_pCPU->GetMode(), (g_pConsole->GetConsoleBreak()+'@'));
+  CMDOUTS("Simulation speed " << CStandardUI::GetCPUspeed());
+  CMDOUTS("Idle loops       " << CStandardUI::GetCPUwarp());
   double flMicrocycle = (g_pCPU->IsLMC() ? 4.0 : 3.0) * 1000.0 / flCrystal;
   
   // Show simulated CPU time ...
@@ -1526,6 +1640,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   // startup and halt/restart address!) and the break character ...
   //--
   assert(g_pCPU != NULL);
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modBreakChar.IsPresent())
     g_pConsole->SetConsoleBreak(m_argBreakChar.GetNumber());
   if (m_modCPUmode.IsPresent())
@@ -29,6 +29,9 @@
 //
 // REVISION HISTORY:
 // 23-JUL-19  RLA   New file.
+// 16-OCT-26  RLA   Add SAVE STATE and LOAD STATE
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -125,6 +128,10 @@ private:
   static CCmdModifier * const m_modsLoadSave[];
   static CCmdVerb m_cmdLoad, m_cmdSave;
 
+  // LOAD STATE and SAVE STATE commands ...
+  static CCmdArgument * const m_argsState[];
+  static CCmdVerb m_cmdLoadState, m_cmdSaveState;
+
   // ATTACH and DETACH commands ...
   static CCmdArgument * const m_argsAttach[];
   static CCmdModifier * const m_modsAttachDisk[];
@@ -171,6 +178,8 @@ private:
   static CCmdVerb m_cmdClear;
   static CCmdVerb * const g_aSetVerbs[];
   static CCmdVerb * const g_aShowVerbs[];
+  static CCmdVerb * const g_aLoadVerbs[];
+  static CCmdVerb * const g_aSaveVerbs[];
   static CCmdVerb m_cmdSet, m_cmdShow;
   static CCmdVerb m_cmdShowTime, m_cmdShowVersion;
   static CCmdVerb m_cmdShowDisk, m_cmdShowTape;
@@ -190,6 +199,7 @@ public:
 private:
   static bool DoLoad(CCmdParser &cmd), DoSave(CCmdParser &cmd);
   static bool DoLoadNVR(CCmdParser &cmd), DoSaveNVR(CCmdParser &cmd);
+  static bool DoLoadState(CCmdParser &cmd), DoSaveState(CCmdParser &cmd);
   static bool DoDeposit(CCmdParser &cmd), DoExamine(CCmdParser &cmd);
   static bool DoAttachDisk(CCmdParser &cmd), DoDetachDisk(CCmdParser &cmd);
   static bool DoAttachTape(CCmdParser &cmd), DoDetachTape(CCmdParser &cmd);
@@ -226,4 +236,5 @@ private:
   static void ShowOneDevice (const class CDevice *pDevice, bool fHeading=false);
   static string ShowBreakpoints (const CGenericMemory *pMemory);
   static bool DoCloseSend(CCmdParser &cmd), DoCloseReceive(CCmdParser &cmd);
+  static void SyncState (class CStateFile &State);
 };
@@ -0,0 +1,21 @@
+; Headless benchmark - run a compute bound checksum loop for 60 seconds ...
+;
+;   The loop checksums the first 256 words of the bootstrap EPROM, over and
+; over, and never WAITs or waits for the console, so the results measure the
+; CPU and memory rather than the idle loop fast forward.  Addresses below
+; 002000 are always RAM, even in ROM mode ...
+;
+;	000400	012700 173000	MOV	#173000, R0	; data pointer
+;	000404	012701 000400	MOV	#400, R1	; word count
+;	000410	062002		ADD	(R0)+, R2	; add the next word
+;	000412	074203		XOR	R2, R3		;  ... and stir it
+;	000414	006103		ROL	R3		;  ... into R3
+;	000416	077104		SOB	R1, 000410	; loop for 256 words
+;	000420	000767		BR	000400		; and start over
+SET LOG/CONSOLE/LEVEL=WARNING
+LOAD boots11.hex/FORMAT=INTEL/ROM
+RESET
+DEPOSIT 400 012700,173000,012701,000400,062002,074203,006103,077104,000767
+DEPOSIT PC 400
+BENCHMARK 60
+SHOW STATISTICS
@@ -31,6 +31,11 @@
 // REVISION HISTORY:
 // 13-FEB-20  RLA  New file.
 // 22-JUN-22  RLA  Add nSense and nFlag parameters to GetSense() and SetFlag()
+// 15-OCT-26  RLA  Only check events at the horizon
+// 16-OCT-26  RLA  Count instructions executed
+// 16-OCT-26  RLA  Call the profiler and add DisassembleInstruction()
+// 16-OCT-26  RLA  Count interrupts acknowledged
+// 16-OCT-26  RLA  Record the instruction trace buffer
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -144,7 +149,7 @@ void CSCMP2::DoInterrupt()
   // acknowledge, and another 7 for the XPPC.
   //--
   if (ISSET(m_SR, SR_IE) && (UpdateSense(0) != 0)) {
-    CLRBIT(m_SR, SR_IE);
+    CLRBIT(m_SR, SR_IE);  ++m_qInterrupts;
     XPPC(3);
     AddTime(13ULL*m_qMicrocycleTime);
     LOGF(TRACE, "INTERRUPTED - old PC=0x%04X, new PC=0x%04X", m_P[REG_P3], GetPC());
@@ -187,9 +192,9 @@ uint8_t CSCMP2::AddMemory (address_t wEA, int8_t bAdd)
   // the new value.  Return the new value also.  This is used by the ILD and
   // DLD instructions ...
   //--
-  uint8_t bData = m_pMemory->CPUread(wEA);
+  uint8_t bData = m_pMemory->FastRead(wEA);
   bData += bAdd;
-  m_pMemory->CPUwrite(wEA, bData);
+  m_pMemory->FastWrite(wEA, bData);
   return bData;
 }
 
@@ -278,6 +283,27 @@ void CSCMP2::SIO()
   if (UpdateSense(SIN) != 0) m_EX |= 0x80;
 }
 
+size_t CSCMP2::DisassembleInstruction (address_t nPC, string &sCode) const
+{
+  //++
+  //   Disassemble the instruction at nPC and return its length.  This is
+  // used by the profiler to show what's at the busiest addresses.
+  //--
+  return Disassemble2(m_pMemory, nPC, sCode);
+}
+
+const char *const *CSCMP2::GetTraceNames() const
+{
+  //++
+  //   Return the names of the registers saved in each instruction trace entry.
+  // The PC (P0) is saved separately ...
+  //--
+  static const char *const apszNames[] = {
+    "AC", "E", "SR", "P1", "P2", "P3", NULL
+  };
+  return apszNames;
+}
+
 void CSCMP2::TraceInstruction() const
 {
   //++
@@ -473,23 +499,27 @@ CCPU::STOP_CODE CSCMP2::Run (uint32_t nCount)
   // an illegal opcode or I/O, the user entering the escape sequence on	
   // the console, etc.  If nCount is zero on entry, then we will run for-	
   // ever until one of the previously mentioned break conditions arises.	
+  //
+  //   Device events are only checked when we reach the event queue horizon.
   //--
   bool fFirst = true;
-  m_nStopCode = STOP_NONE;
+  m_nStopCode = STOP_NONE;  InvalidateHorizon();
   while (m_nStopCode == STOP_NONE) {
 
-    // If any device events need to happen, now is the time...
-    m_pEvents->DoEvents();
+    if (AtHorizon()) {
+      // If any device events need to happen, now is the time...
+      DoHorizon();
 
-    // See if an interrupt is required ...
-    if (m_pInterrupt != NULL) {
-      // Do we really need a CInterrupt object here?  The only source
-      // for interrupts is SENSE A, after all!
-      //if (ISSET(m_SR, SR_IE))  DoInterrupt();
+      // See if an interrupt is required ...
+      if (m_pInterrupt != NULL) {
+        // Do we really need a CInterrupt object here?  The only source
+        // for interrupts is SENSE A, after all!
+        //if (ISSET(m_SR, SR_IE))  DoInterrupt();
+      }
     }
 
     // Stop if we've hit a breakpoint ...
-    if (!fFirst && m_pMemory->IsBreak(GetPC())) {
+    if (!fFirst && m_pMemory->CheckBreak(GetPC())) {
       m_nStopCode = STOP_BREAKPOINT;  break;
     } else
       fFirst = false;
@@ -500,9 +530,17 @@ CCPU::STOP_CODE CSCMP2::Run (uint32_t nCount)
     // Fetch, decode and execute an instruction...
     //   Note that the SC/MP is super weird - it incrememebts the PC _before_
     // fetching the opcode, not after!!
-    m_nLastPC = INCPC();
-    uint8_t bOpcode = m_pMemory->CPUread(m_P[REG_PC]);
+    m_nLastPC = INCPC();  ++m_qInstructions;
+    uint8_t bOpcode = m_pMemory->FastRead(m_P[REG_PC]);
+    TRACE_ENTRY *pTrace = NextTrace();
+    if (pTrace != NULL) {
+      pTrace->lOpcode = bOpcode;
+      pTrace->awRegisters[0] = m_AC;  pTrace->awRegisters[1] = m_EX;
+      pTrace->awRegisters[2] = m_SR;  pTrace->awRegisters[3] = m_P[REG_P1];
+      pTrace->awRegisters[4] = m_P[REG_P2];  pTrace->awRegisters[5] = m_P[REG_P3];
+    }
     AddTime(DoExecute(bOpcode)*m_qMicrocycleTime);
+    Profile(m_nLastPC);
 
     // Check for some termination conditions ...
     if (m_nStopCode == STOP_NONE) {
@@ -9,6 +9,8 @@
 //
 // REVISION HISTORY:
 // 13-FEB-20  RLA   Copied from CCOSMAC.
+// 16-OCT-26  RLA   Add DisassembleInstruction() for the profiler
+// 16-OCT-26  RLA   Add GetTraceNames() for the instruction trace
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -100,6 +102,10 @@ public:
   //   Rememher that the weirdo SC/MP increments the PC BEFORE fetching the
   // next instruction, hence the +1 here!
   inline address_t GetPC() const override {return INC12(m_P[REG_PC]);}
+  // Disassemble one instruction (used by the profiler) ...
+  size_t DisassembleInstruction (address_t nPC, string &sCode) const override;
+  // Return the names of the registers saved in the instruction trace ...
+  const char *const *GetTraceNames() const override;
 
   // CSCMP2 public functions ...
 public:
@@ -141,13 +147,13 @@ private:
   // Calculate the effective address for this instruction ...
   address_t CalculateEA (uint2_t p, bool fAuto=false);
   // Fetch an immediate operand from memory ...
-  inline uint8_t LoadImmediate() {return m_pMemory->CPUread(INCPC());}
+  inline uint8_t LoadImmediate() {return m_pMemory->FastRead(INCPC());}
   // Fetch a directly addressed operand from memory ...
   uint8_t Load (uint2_t p, bool fAuto=false)
-    {return m_pMemory->CPUread(CalculateEA(p, fAuto));}
+    {return m_pMemory->FastRead(CalculateEA(p, fAuto));}
   // Store a directly addressed operand in memory ...
   void Store (uint8_t bData, uint2_t p, bool fAuto=false)
-    {m_pMemory->CPUwrite(CalculateEA(p, fAuto), bData);}
+    {m_pMemory->FastWrite(CalculateEA(p, fAuto), bData);}
 
   // Other, more complex, internal SC/MP operations ...
 private:
@@ -32,6 +32,11 @@
 //      /RO*M                   -   "   "     "    "  ROM    "      "
 //      /OVER*WRITE             - don't prompt if file already exists (SAVE only!)
 //
+//   RECO*RD <file>             - record console input and its timing
+//   RECO*RD/CL*OSE             - stop recording console input
+//   REPL*AY <file>             - replay recorded console input
+//   REPL*AY/CL*OSE             - stop replaying console input
+//
 //   SE*T BRE*AKPOINT xxxx      - set breakpoint at address xxxx
 //   CL*EAR BRE*AKPOINT xxxx    - clear   "      "     "     "
 //   CL*EAR BRE*AKPOINTS        - clear all breakpoints
@@ -119,6 +124,8 @@
 //    
 // REVISION HISTORY:
 // 23-JUL-19  RLA   New file.
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -135,6 +142,7 @@
 #include "CommandParser.hpp"    // emulator library command line parsing methods
 #include "CommandLine.hpp"      // Shell (argc/argv) parser methods
 #include "ConsoleWindow.hpp"    // needed for CVirtualConsole 
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "SCMP2.hpp"             // global declarations for this project
 #include "StandardUI.hpp"       // emulator library standard UI commands
 #include "UserInterface.hpp"    // emulator user interface parse table definitions
@@ -247,7 +255,8 @@ CCmdArgument * const CUI::m_argsLoadSave[] = {&m_argFileName, NULL};
 CCmdModifier * const CUI::m_modsLoadSave[] = {&m_modFileFormat, &m_modBaseAddress, &m_modByteCount,
                                               &m_modOverwrite, &m_modRAM, &m_modROM, NULL};
 CCmdVerb CUI::m_cmdLoad("LO*AD", &DoLoad, m_argsLoadSave, m_modsLoadSave);
-CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave);
+CCmdVerb * const CUI::g_aSaveVerbs[] = {&CStandardUI::m_cmdSaveProfile, NULL};
+CCmdVerb CUI::m_cmdSave("SA*VE", &DoSave, m_argsLoadSave, m_modsLoadSave, g_aSaveVerbs);
 
 // ATTACH and DETACH commands ...
 CCmdArgument * const CUI::m_argsAttachSerial[] = {&m_argSenseInput, &m_argFlagOutput, NULL};
@@ -289,13 +298,14 @@ CCmdVerb CUI::m_cmdSetBreakpoint("BRE*AKPOINT", &DoSetBreakpoint, m_argsSetBreak
 CCmdArgument * const CUI::m_argsSetMemory[] = {&m_argRangeList, NULL};
 CCmdModifier * const CUI::m_modsSetMemory[] = {&m_modRAM, &m_modROM, NULL};
 CCmdModifier * const CUI::m_modsSetSerial[] = {&m_modBaudRate, &m_modInvertData, &m_modPollDelay, NULL};
-CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modIllegalOpcode, &m_modBreakChar, &m_modClockFrequency, NULL};
+CCmdModifier * const CUI::m_modsSetCPU[] = {&m_modIllegalOpcode, &m_modBreakChar, &m_modClockFrequency, &CStandardUI::m_modCPUspeed, &CStandardUI::m_modCPUwarp, NULL};
 CCmdVerb CUI::m_cmdSetCPU = {"CPU", &DoSetCPU, NULL, m_modsSetCPU};
 CCmdVerb CUI::m_cmdSetMemory = {"MEM*ORY", &DoSetMemory, m_argsSetMemory, m_modsSetMemory};
 CCmdVerb CUI::m_cmdSetSerial = {"SER*IAL", &DoSetSerial, NULL, m_modsSetSerial};
 CCmdVerb * const CUI::g_aSetVerbs[] = {
   &m_cmdSetBreakpoint, &m_cmdSetCPU, &m_cmdSetMemory, &m_cmdSetSerial,
   &CStandardUI::m_cmdSetLog, &CStandardUI::m_cmdSetWindow,
+  &CStandardUI::m_cmdSetProfile, &CStandardUI::m_cmdSetTrace,
   NULL
 };
 CCmdVerb CUI::m_cmdSet("SE*T", NULL, NULL, NULL, g_aSetVerbs);
@@ -312,6 +322,7 @@ CCmdVerb * const CUI::g_aShowVerbs[] = {
   &m_cmdShowBreakpoint, &m_cmdShowMemory, &m_cmdShowCPU,
   &m_cmdShowConfiguration, &m_cmdShowSerial,
   &CStandardUI::m_cmdShowLog, &m_cmdShowVersion,
+  &CStandardUI::m_cmdShowProfile, &CStandardUI::m_cmdShowStatistics, &CStandardUI::m_cmdShowTrace,
   &CStandardUI::m_cmdShowAliases, &m_cmdShowAll,
   NULL
 };
@@ -320,13 +331,13 @@ CCmdVerb CUI::m_cmdShow("SH*OW", NULL, NULL, NULL, g_aShowVerbs);
 // Master list of all verbs ...
 CCmdVerb * const CUI::g_aVerbs[] = {
   &m_cmdLoad, &m_cmdSave, &m_cmdAttach, &m_cmdDetach,
-  &m_cmdExamine, &m_cmdDeposit,
+  &m_cmdExamine, &m_cmdDeposit, &CStandardUI::m_cmdRecord, &CStandardUI::m_cmdReplay,
   &m_cmdSet, &m_cmdShow, &m_cmdReset,
   &m_cmdClear, &m_cmdRun, &m_cmdContinue, &m_cmdStep,
 //&CStandardUI::m_cmdDefine, &CStandardUI::m_cmdUndefine,
   &CStandardUI::m_cmdIndirect, &CStandardUI::m_cmdExit,
-  &CStandardUI::m_cmdQuit, &CCmdParser::g_cmdHelp,
-  NULL
+  &CStandardUI::m_cmdQuit, &CStandardUI::m_cmdBenchmark,
+  &CStandardUI::m_cmdFork, &CCmdParser::g_cmdHelp, NULL
 };
 
 
@@ -761,6 +772,8 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
 
   // Decode the reason we stopped ...
   switch (nStop) {
+    case CCPU::STOP_ILLEGAL_IO:
+      CMDERRF("illegal I/O at 0x%04X", g_pCPU->GetLastPC());  break;
     case CCPU::STOP_ILLEGAL_OPCODE:
       CMDERRF("illegal instruction at 0x%04X", g_pCPU->GetLastPC());  break;
     case CCPU::STOP_HALT:
@@ -775,6 +788,10 @@ unsigned CUI::RunSimulation (uint32_t nSteps)
     case CCPU::STOP_NONE:    break;
   }
 
+  // Show the last few instructions if the trace buffer is enabled ...
+  if ((nStop == CCPU::STOP_BREAKPOINT) || (nStop == CCPU::STOP_ILLEGAL_OPCODE))
+    CStandardUI::DumpTrace();
+
   // And we're done!
   return nStop;
 }
@@ -910,6 +927,8 @@ bool CUI::DoSetCPU (CCmdParser &cmd)
   //   SET CPU allows you to set the CPU type (e.g. 1802 or 1805), and well as
   // various options (e.g. stop on illegal opcode, set clock frequency, etc).
   //--
+  if (CStandardUI::m_modCPUspeed.IsPresent() && !CStandardUI::SetCPUspeed()) return false;
+  if (CStandardUI::m_modCPUwarp.IsPresent()) g_pCPU->SetWarp(!CStandardUI::m_modCPUwarp.IsNegated());
   if (m_modIllegalOpcode.IsPresent())
     g_pCPU->StopOnIllegalOpcode(m_argStopOpcode.GetKeyValue() != 0);
   if (m_modBreakChar.IsPresent())
@@ -931,6 +950,8 @@ bool CUI::DoShowCPU (CCmdParser &cmd)
   double flMicroCycle = CSCMP2::CLOCKS_PER_MICROCYCLE / flCrystal;
   CMDOUTF("%s %s %3.2fMHz (%3.2fus per microcycle)",
     g_pCPU->GetName(), g_pCPU->GetDescription(), flCrystal, flMicroCycle);
+  CMDOUTS("Simulation speed " << CStandardUI::GetCPUspeed());
+  CMDOUTS("Idle loops       " << CStandardUI::GetCPUwarp());
   CMDOUTF("%s on illegal opcode, console break character ^%c",
     g_pCPU->IsStopOnIllegalOpcode() ? "Stop" : "Continue",
     (g_pConsole->GetConsoleBreak() + '@'));
@@ -0,0 +1,29 @@
+; Headless benchmark - run a compute bound checksum loop for 600 seconds ...
+;
+;   The loop sums the first page of the NIBL ROM into E, over and over, and
+; never waits for the console.  The serial port is left detached so that the
+; results measure the CPU and memory, not bit banged serial polling ...
+;
+;	1001	C4 00	LDI	0x00	; P1 = 0000 (data pointer)
+;	1003	35	XPAH	P1
+;	1004	C4 00	LDI	0x00
+;	1006	31	XPAL	P1
+;	1007	C4 1F	LDI	0x1F	; P2 = 1FF0 (loop counter)
+;	1009	36	XPAH	P2
+;	100A	C4 F0	LDI	0xF0
+;	100C	32	XPAL	P2
+;	100D	C5 01	LD	@1(P1)	; AC = next byte
+;	100F	70	ADE		; add the running sum
+;	1010	01	XAE		;  ... and save it in E
+;	1011	BA 00	DLD	0(P2)	; count the bytes
+;	1013	9C F8	JNZ	100D	;  ... 256 of them
+;	1015	90 EA	JMP	1001	; and start over
+set log/console/level=warning
+set memory 0-0fff/rom
+set memory 1000-ffff/ram
+load nibl
+reset
+deposit 1001 C4,00,35,C4,00,31,C4,1F,36,C4,F0,32,C5,01,70,01,BA,00,9C,F8,90,EA
+deposit pc 1000
+benchmark 600
+show statistics
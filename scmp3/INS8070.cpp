@@ -48,6 +48,12 @@
 //                 Can't use REL8(m_PC) we have to use REL8(m_PC+1)
 //                 Opcode $8B, ST EA,xx[P3] wrongly uses P2 instead of P3
 //                 Opcode $CB, ST A,xx[P3] made the same mistsake!
+// 15-OCT-26  RLA  Only check events and interrupts at the horizon
+// 16-OCT-26  RLA  Evaluate the CY/L and OV flags lazily
+// 16-OCT-26  RLA  Count instructions executed
+// 16-OCT-26  RLA  Call the profiler and add DisassembleInstruction()
+// 16-OCT-26  RLA  Count interrupts acknowledged
+// 16-OCT-26  RLA  Record the instruction trace buffer
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -103,7 +109,7 @@ void CSCMP3::ClearCPU()
   CCPU::ClearCPU();
   m_PC = m_SP = m_P2 = m_P3 = m_T = 0;  m_A = m_E = 0;
   // DON'T clear the sense bits in the status, but clear everything else ...
-  CLRBIT(m_S, ~(SR_SA | SR_SB));
+  CLRBIT(m_S, ~(SR_SA | SR_SB));  m_bCCop = CC_STATUS;
   UpdateFlag(FLAG1, 0);  UpdateFlag(FLAG2, 0);  UpdateFlag(FLAG3, 0);
 }
 
@@ -140,7 +146,8 @@ void CSCMP3::SetStatus (uint8_t bData)
   bool fOldF1 = ISSET(m_S, SR_F1), fNewF1 = ISSET(bData, SR_F1);
   bool fOldF2 = ISSET(m_S, SR_F2), fNewF2 = ISSET(bData, SR_F2);
   bool fOldF3 = ISSET(m_S, SR_F3), fNewF3 = ISSET(bData, SR_F3);
-  m_S = (m_S & (SR_SA|SR_SB)) | (bData & ~(SR_SA|SR_SB));
+  m_S = (m_S & (SR_SA|SR_SB)) | (bData & ~(SR_SA|SR_SB));  m_bCCop = CC_STATUS;
+  if (ISSET(m_S, SR_IE)) InvalidateHorizon();
   if (fOldF1 != fNewF1) UpdateFlag(FLAG1, fNewF1 ? 1 : 0);
   if (fOldF2 != fNewF2) UpdateFlag(FLAG2, fNewF2 ? 1 : 0);
   if (fOldF3 != fNewF3) UpdateFlag(FLAG3, fNewF3 ? 1 : 0);
@@ -152,7 +159,7 @@ uint8_t CSCMP3::GetStatus()
   // Return the current status byte, but update all sense inputs first ...
   //--
   UpdateSense(SENSEA);  UpdateSense(SENSEB);
-  return m_S;
+  FlushCC();  return m_S;
 }
 
 uint8_t CSCMP3::MEMR8 (address_t wAddr)
@@ -173,7 +180,7 @@ uint8_t CSCMP3::MEMR8 (address_t wAddr)
   //--
   //if (m_pMemory->IsBreak(wAddr)) Break(STOP_BREAKPOINT);
   if (m_pMemory->IsSlow(wAddr)) AddCycles(1);
-  return m_pMemory->CPUread(wAddr);
+  return m_pMemory->FastRead(wAddr);
 }
 
 void CSCMP3::MEMW8 (address_t wAddr, uint8_t bData)
@@ -185,7 +192,7 @@ void CSCMP3::MEMW8 (address_t wAddr, uint8_t bData)
   //--
   //if (m_pMemory->IsBreak(wAddr)) Break(STOP_BREAKPOINT);
   if (m_pMemory->IsSlow(wAddr)) AddCycles(1); 
-  m_pMemory->CPUwrite(wAddr, bData);
+  m_pMemory->FastWrite(wAddr, bData);
 }
 
 address_t CSCMP3::AUTO (uint16_t &wReg, uint8_t bOffset)
@@ -218,7 +225,7 @@ void CSCMP3::DoInterrupt()
   //--
   if (ISSET(m_S, SR_IE) && (ISSET(GetStatus(), SR_SA|SR_SB))) {
     uint16_t wOldPC = m_PC;
-    CLRBIT(m_S, SR_IE);  Push16(m_PC);  AddCycles(9);
+    CLRBIT(m_S, SR_IE);  Push16(m_PC);  AddCycles(9);  ++m_qInterrupts;
     //   Remember the PC pre-increment thing, so the correct value for the PC
     // is the interrupt vector MINUS ONE!!
     m_PC = (ISSET(m_S,SR_SA) ? INTA_VEC : INTB_VEC) - 1;
@@ -230,21 +237,10 @@ void CSCMP3::AddA (uint8_t bData)
 {
   //++
   //   Add an 8 bit binary value to A.  The CY/L and OV flags are also updated
-  // according to the result.
+  // according to the result, but that happens later in ComputeCC() ...
   //--
-  uint16_t wResult = m_A + bData;  CLRBIT(m_S, SR_CYL|SR_OV);
-  // The carry flag is easy ...
-  if (HIBYTE(wResult) != 0) SETBIT(m_S, SR_CYL);
-  //  There are two cases that result in a twos complement overflow - if we
-  // add two positive numbers and get a negative result, or if we add two
-  // negative numbers and get a positive result.  Any other combination can
-  // never overflow.
-  uint8_t bResult = LOBYTE(wResult);
-  if (   (!ISNEG8(m_A) && !ISNEG8(bData) &&  ISNEG8(bResult))
-      || ( ISNEG8(m_A) &&  ISNEG8(bData) && !ISNEG8(bResult)))
-    SETBIT(m_S, SR_OV);
-  // Update A and we're done ...
-  m_A = bResult;
+  m_bCCop = CC_ADD8;  m_wCCa = m_A;  m_wCCb = bData;
+  m_A = LOBYTE(m_A + bData);
 }
 
 void CSCMP3::AddEA (uint16_t wData)
@@ -252,17 +248,41 @@ void CSCMP3::AddEA (uint16_t wData)
   //++
   //    This routine adds a 16 bit value to the EA register pair.  It's pretty
   // much the same as ADDA(), except that this one is a little messy because
-  // the E and A registers are stored separately.  Except for the number of bits
-  // involved, the rules for setting CY and OV are the same.
+  // the E and A registers are stored separately ...
   //--
-  uint16_t wEA = GetEA();  CLRBIT(m_S, SR_CYL | SR_OV);
-  uint32_t lResult = wEA + wData;
-  if (HIWORD(lResult) != 0) SETBIT(m_S, SR_CYL);
-  uint16_t wResult = LOWORD(lResult);
-  if (   (!ISNEG16(wEA) && !ISNEG16(wData) &&  ISNEG16(wResult))
-      || ( ISNEG16(wEA) &&  ISNEG16(wData) && !ISNEG16(wResult)))
-    SETBIT(m_S, SR_OV);
-  SetEA(wResult);
+  uint16_t wEA = GetEA();
+  m_bCCop = CC_ADD16;  m_wCCa = wEA;  m_wCCb = wData;
+  SetEA(LOWORD(wEA + wData));
+}
+
+uint8_t CSCMP3::ComputeCC() const
+{
+  //++
+  //   Compute the CY/L and OV flags for the last AddA() or AddEA().  Except for
+  // the number of bits involved, the rules for setting CY and OV are the same.
+  // The carry flag is easy, and there are two cases that result in a twos
+  // complement overflow - if we add two positive numbers and get a negative
+  // result, or if we add two negative numbers and get a positive result.  Any
+  // other combination can never overflow.
+  //--
+  uint8_t bFlags = 0;
+  if (m_bCCop == CC_ADD8) {
+    uint16_t wResult = m_wCCa + m_wCCb;
+    if (HIBYTE(wResult) != 0) bFlags |= SR_CYL;
+    uint8_t bA = LOBYTE(m_wCCa), bB = LOBYTE(m_wCCb), bResult = LOBYTE(wResult);
+    if (   (!ISNEG8(bA) && !ISNEG8(bB) &&  ISNEG8(bResult))
+        || ( ISNEG8(bA) &&  ISNEG8(bB) && !ISNEG8(bResult)))
+      bFlags |= SR_OV;
+  } else if (m_bCCop == CC_ADD16) {
+    uint32_t lResult = m_wCCa + m_wCCb;
+    if (HIWORD(lResult) != 0) bFlags |= SR_CYL;
+    uint16_t wResult = LOWORD(lResult);
+    if (   (!ISNEG16(m_wCCa) && !ISNEG16(m_wCCb) &&  ISNEG16(wResult))
+        || ( ISNEG16(m_wCCa) &&  ISNEG16(m_wCCb) && !ISNEG16(wResult)))
+      bFlags |= SR_OV;
+  } else
+    bFlags = m_S & (SR_CYL|SR_OV);
+  return bFlags;
 }
 
 void CSCMP3::Multiply()
@@ -280,7 +300,7 @@ void CSCMP3::Multiply()
   //--
   int32_t lResult = ((int16_t) GetEA()) * ((int16_t) m_T);
   m_T = LOWORD(lResult);  SetEA(HIWORD(lResult));
-  CLRBIT(m_S, SR_CYL|SR_OV);
+  CLRBIT(m_S, SR_CYL|SR_OV);  m_bCCop = CC_STATUS;
 }
 
 void CSCMP3::Divide()
@@ -299,7 +319,7 @@ void CSCMP3::Divide()
   // and always clear OV.  I also return the proper remainder in T, but that
   // probably doesn't matter since real INS807x software should ignore it.
   //--
-  CLRBIT(m_S, SR_CYL|SR_OV);
+  CLRBIT(m_S, SR_CYL|SR_OV);  m_bCCop = CC_STATUS;
   if (m_T == 0) {
     LOGF(DEBUG, "Division by zero at 0x%04X", GetPC());
     SETBIT(m_S, SR_CYL);  return;
@@ -406,6 +426,27 @@ void CSCMP3::AddMemory (address_t wAddr, int8_t bAdd)
   MEMW8(wAddr, m_A);
 }
 
+size_t CSCMP3::DisassembleInstruction (address_t nPC, string &sCode) const
+{
+  //++
+  //   Disassemble the instruction at nPC and return its length.  This is
+  // used by the profiler to show what's at the busiest addresses.
+  //--
+  return Disassemble3(m_pMemory, nPC, sCode);
+}
+
+const char *const *CSCMP3::GetTraceNames() const
+{
+  //++
+  //   Return the names of the registers saved in each instruction trace entry.
+  // The PC is saved separately ...
+  //--
+  static const char *const apszNames[] = {
+    "A", "E", "S", "T", "SP", "P2", "P3", NULL
+  };
+  return apszNames;
+}
+
 void CSCMP3::TraceInstruction() const
 {
   //++
@@ -504,9 +545,9 @@ uint64_t CSCMP3::DoExecute (uint8_t bOpcode)
     //   0x36 - unimplemented
     //   0x37 - unimplemented
     case 0x38: m_A = Pop8();				 return  6;  // POP A
-    case 0x39: SetStatus(m_S & IMM8());			 return  5;  // AND S, #data8
+    case 0x39: SetStatus(CurrentStatus() & IMM8());	 return  5;  // AND S, #data8
     case 0x3A: SetEA(Pop16());				 return  9;  // POP EA
-    case 0x3B: SetStatus(m_S | IMM8());			 return  5;  // OR S, #data8
+    case 0x3B: SetStatus(CurrentStatus() | IMM8());	 return  5;  // OR S, #data8
     case 0x3C: ShiftRightA();				 return  3;  // SR A
     case 0x3D: ShiftRightAL();				 return  3;  // SRL A
     case 0x3E: RotateRightA();				 return  3;  // RR A
@@ -743,20 +784,29 @@ CCPU::STOP_CODE CSCMP3::Run (uint32_t nCount)
   // the simulation such as an illegal opcode or I/O, the user entering the escape
   // sequence on the console, etc.  If nCount is zero on entry, then we will run
   // forever until one of the previously mentioned break conditions occurs.	
+  //
+  //   Device events are only checked when we reach the event queue horizon.
+  // Interrupts are a bit different though - the SENSE A and B inputs are
+  // polled and we can't tell when they might change.  So as long as the IE
+  // bit is set we have to keep checking after every instruction...
   //--
   bool fFirst = true;
-  m_nStopCode = STOP_NONE;
+  m_nStopCode = STOP_NONE;  InvalidateHorizon();
   while (m_nStopCode == STOP_NONE) {
 
-    // If any device events need to happen, now is the time...
-    m_pEvents->DoEvents();
+    if (AtHorizon()) {
+      // If any device events need to happen, now is the time...
+      DoHorizon();
 
-    // See if an interrupt is required ...
-    // TBA TODO NYI - SUPPRESS INTERRUPTS FOR ONE INSTRUCTION AFTER IE IS SET!!??!
-    if ((m_pInterrupt != NULL) && ISSET(m_S, SR_IE))  DoInterrupt();
+      // See if an interrupt is required ...
+      // TBA TODO NYI - SUPPRESS INTERRUPTS FOR ONE INSTRUCTION AFTER IE IS SET!!??!
+      if ((m_pInterrupt != NULL) && ISSET(m_S, SR_IE)) {
+        DoInterrupt();  if (ISSET(m_S, SR_IE)) InvalidateHorizon();
+      }
+    }
 
     // Stop if we've hit a breakpoint ...
-    if (!fFirst && m_pMemory->IsBreak(GetPC())) {
+    if (!fFirst && m_pMemory->CheckBreak(GetPC())) {
       m_nStopCode = STOP_BREAKPOINT;  break;
     } else
       fFirst = false;
@@ -767,9 +817,18 @@ CCPU::STOP_CODE CSCMP3::Run (uint32_t nCount)
     // Fetch, decode and execute an instruction...
     //   Note that the SC/MP is super weird - it increments the PC _before_
     // fetching the opcode, not after!!
-    m_nLastPC = GetPC();
+    m_nLastPC = GetPC();  ++m_qInstructions;
     uint8_t bOpcode = MEMR8(INC16(m_PC));
+    TRACE_ENTRY *pTrace = NextTrace();
+    if (pTrace != NULL) {
+      pTrace->lOpcode = bOpcode;
+      pTrace->awRegisters[0] = m_A;  pTrace->awRegisters[1] = m_E;
+      pTrace->awRegisters[2] = CurrentStatus();  pTrace->awRegisters[3] = m_T;
+      pTrace->awRegisters[4] = m_SP;  pTrace->awRegisters[5] = m_P2;
+      pTrace->awRegisters[6] = m_P3;
+    }
     AddCycles(DoExecute(bOpcode));
+    Profile(m_nLastPC);
 
     // Check for some termination conditions ...
     if (m_nStopCode == STOP_NONE) {
@@ -806,7 +865,7 @@ uint16_t CSCMP3::GetRegister (cpureg_t nReg) const
   switch (nReg) {
     case REG_A:  return m_A;
     case REG_E:  return m_E;
-    case REG_S:  return m_S;
+    case REG_S:  return CurrentStatus();
     case REG_PC: return m_PC;
     case REG_SP: return m_SP;
     case REG_P2: return m_P2;
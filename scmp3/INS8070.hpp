@@ -9,6 +9,9 @@
 //
 // REVISION HISTORY:
 // 30-OCT-25  RLA   New file.
+// 16-OCT-26  RLA   Evaluate the CY/L and OV flags lazily
+// 16-OCT-26  RLA   Add DisassembleInstruction() for the profiler
+// 16-OCT-26  RLA   Add GetTraceNames() for the instruction trace
 //--
 //000000001111111111222222222233333333334444444444555555555566666666667777777777
 //234567890123456789012345678901234567890123456789012345678901234567890123456789
@@ -102,6 +105,10 @@ public:
   //   Remember that the weirdo SC/MP increments the PC BEFORE fetching the
   // next instruction, hence the +1 here!
   inline address_t GetPC() const override {return ADDRESS(m_PC+1);}
+  // Disassemble one instruction (used by the profiler) ...
+  size_t DisassembleInstruction (address_t nPC, string &sCode) const override;
+  // Return the names of the registers saved in the instruction trace ...
+  const char *const *GetTraceNames() const override;
 
   // CSCMP3 public functions ...
 public:
@@ -197,7 +204,7 @@ private:
   //   SRL shifts A right with the current carry bit shifted in on the left.
   // Note that there is NO SLL instruction!
   inline void ShiftRightAL()
-    {ShiftRightA();  if (ISSET(m_S,SR_CYL)) m_A |= 0x80;}
+    {FlushCC();  ShiftRightA();  if (ISSET(m_S,SR_CYL)) m_A |= 0x80;}
   //   RR shifts A right, and the bit shifted out on the right is shifted in
   // on the left. The carry bit is not affected.  There is no RL instruction!
   inline void RotateRightA()
@@ -205,11 +212,34 @@ private:
   //   RRL shifts A right.  The bit shifted out on the right is shifted into
   // the carry bit, and the previous carry bit is shifted in on the left.
   void RotateRightAL()
-    {uint8_t b = ISSET(m_S,SR_CYL);  CLRBIT(m_S,SR_CYL);
-     if (m_A & 1) SETBIT(m_S,SR_CYL);  ShiftRightA();  if (b) m_A |= 0x80;}
+    {FlushCC();  uint8_t b = ISSET(m_S,SR_CYL);  CLRBIT(m_S,SR_CYL);
+     if (m_A & 1) SETBIT(m_S,SR_CYL);
+     ShiftRightA();  if (b) m_A |= 0x80;}
   // Add or subtract from the A register ...
   void AddA(uint8_t bData);
 
+  // Lazy CY/L and OV flags ...
+  //   The add and subtract instructions always update CY/L and OV, but hardly
+  // anything ever looks at them.  So AddA() and AddEA() just remember the two
+  // operands and the size of the operation, and the actual flags are computed
+  // later only if somebody wants them.  If m_bCCop is CC_STATUS then the CY/L
+  // and OV bits in m_S are correct; otherwise they're garbage and must be
+  // computed from m_wCCa and m_wCCb.  Only those two bits are lazy - all the
+  // other status bits are always up to date.
+private:
+  enum _CC_OPS {
+    CC_STATUS,                // CY/L and OV are in m_S already
+    CC_ADD8,                  // CY/L and OV from an 8 bit add
+    CC_ADD16,                 //   "   "   "   "  " 16 "    "
+  };
+  uint8_t ComputeCC() const;
+  inline uint8_t GetCC() const
+    {return (m_bCCop == CC_STATUS) ? (m_S & (SR_CYL|SR_OV)) : ComputeCC();}
+  inline void FlushCC()
+    {if (m_bCCop != CC_STATUS) {m_S = (m_S & ~(SR_CYL|SR_OV)) | ComputeCC();  m_bCCop = CC_STATUS;}}
+  // Return the status register with the current CY/L and OV flags ...
+  inline uint8_t CurrentStatus() const {return (m_S & ~(SR_CYL|SR_OV)) | GetCC();}
+
   // Other special instructions ...
 private:
   // Multiply and divide ...
@@ -246,6 +276,8 @@ private:
   uint8_t   m_A;	      // basic accumulator for all arithmetic/logic
   uint8_t   m_E;	      // extension register
   uint8_t   m_S;	      // status register
+  uint8_t   m_bCCop;          // lazy CY/L and OV - type of operation
+  uint16_t  m_wCCa, m_wCCb;   //  "    "    "   "  - operands
   uint16_t  m_T;              // temporary register
   uint1_t   m_Flag[MAXFLAG];  // three single bit outputs
   uint1_t   m_Sense[MAXSENSE];// two single bit inputs
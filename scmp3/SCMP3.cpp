@@ -18,6 +18,7 @@
 #include <assert.h>             // assert() (what else??)
 #include "EMULIB.hpp"           // emulator library definitions
 #include "ConsoleWindow.hpp"    // emulator console window methods
+#include "SmartConsole.hpp"     // console file transfer functions
 #include "LogFile.hpp"          // emulator library message logging facility
 #include "ImageFile.hpp"        // emulator library image file methods
 #include "CommandParser.hpp"    // emulator library command line parsing methods
@@ -40,7 +41,7 @@
 // you'll find "extern ..." declarations for them in SCMP.hpp.  Note that they
 // are declared as pointers rather than the actual objects because we want
 // to control the exact order in which they're created and destroyed!
-CConsoleWindow  *g_pConsole     = NULL; // console window object
+CSmartConsole   *g_pConsole     = NULL; // console window object
 CLog            *g_pLog         = NULL; // message logging object (including console!)
 CCmdParser      *g_pParser      = NULL; // command line parser
 // These globals point to the objects being emulated ...
@@ -69,7 +70,8 @@ int main (int argc, char *argv[])
   //   The very first thing is to create and initialize the console window
   // object, and after that we create and initialize the log object.  We
   // can't issue any error messages until we done these two things!
-  g_pConsole = DBGNEW CConsoleWindow();
+  g_pEvents = DBGNEW CEventQueue();
+  g_pConsole = DBGNEW CSmartConsole(g_pEvents);
   g_pLog = DBGNEW CLog(PROGRAM, g_pConsole);
 
   //   Parse the command options.  Note that we want to do this BEFORE we
@@ -90,12 +92,14 @@ int main (int argc, char *argv[])
   CMDOUTS("Built on " << __DATE__ << " " << __TIME__);
 
   // Create the emulated CPU, memory and peripheral devices ...
-  g_pEvents = DBGNEW CEventQueue();
   g_pMemory = DBGNEW CGenericMemory(MEMSIZE);
   g_pCPU = DBGNEW CSCMP3(g_pMemory, g_pEvents);
+  g_pMemory->SetCPU(g_pCPU);
 
   //   Lastly, create the command line parser.  If a startup script was
   // specified on the command line, now is the time to execute it...
+  CStandardUI::g_pCPU = g_pCPU;  g_pCPU->SetWarpConsole(g_pConsole);
+  CStandardUI::g_pConsole = g_pConsole;
   g_pParser = DBGNEW CCmdParser(PROGRAM, CUI::g_aVerbs, &ConfirmExit, g_pConsole);
   if (!CStandardUI::g_sStartupScript.empty())
     g_pParser->OpenScript(CStandardUI::g_sStartupScript);
@@ -105,6 +109,7 @@ int main (int argc, char *argv[])
   // types "EXIT" or "QUIT", the command parser exits and then we shutdown
   // the SC/MP program.
   g_pParser->CommandLoop();
+  CStandardUI::DumpStatistics();
   LOGS(DEBUG, "command parser exited");
 
 shutdown:
@@ -112,8 +117,8 @@ shutdown:
   delete g_pParser;   // the command line parser can go away first
   delete g_pCPU;      // the CPU
   delete g_pMemory;   // the memory object
-  delete g_pEvents;   // event queue
   delete g_pLog;      // close the log file
   delete g_pConsole;  // lastly (always lastly!) close the console window
+  delete g_pEvents;   // event queue
   return 0;
 }
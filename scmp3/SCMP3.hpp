@@ -36,7 +36,7 @@
 //                          7     // GPIO/PS2 secondary port
 
 // Console, log file and command parser objects.
-extern class CConsoleWindow  *g_pConsole;     // console window object
+extern class CSmartConsole   *g_pConsole;     // console window object
 
 //   These pointers reference the major parts of the SC/MP system being
 // emulated - CPU, memory, switches, display, peripherals, etc.  They're all
@@ -13,6 +13,8 @@
 //
 // REVISION HISTORY:
 // 23-JUL-19  RLA   New file.
+// 16-OCT-26  RLA   Add RECORD and REPLAY commands.
+// 16-OCT-26  RLA   Move RECORD and REPLAY to CStandardUI.
 //--
 #pragma once
 #include <stdint.h>             // uint8_t, int32_t, and much more ...
@@ -134,6 +136,7 @@ private:
   static CCmdModifier * const m_modsSetMemory[];
   static CCmdVerb * const g_aSetVerbs[];
   static CCmdVerb * const g_aShowVerbs[];
+  static CCmdVerb * const g_aSaveVerbs[];
   static CCmdVerb m_cmdSet, m_cmdShow, m_cmdShowCPU;
   static CCmdVerb m_cmdShowAll, m_cmdShowVersion;
   static CCmdVerb m_cmdShowConfiguration, m_cmdShowMemory;
@@ -0,0 +1,28 @@
+; Headless benchmark - run a compute bound checksum loop for 200 seconds ...
+;
+;   The loop sums the first page of the BASIC ROM into E, over and over, and
+; never waits for the console.  The serial port is left detached so that the
+; results measure the CPU and memory, not bit banged serial polling ...
+;
+;	1001	26 00 00	LD	P2,=0000	; data pointer
+;	1004	27 F0 2F	LD	P3,=2FF0	; loop counter
+;	1007	C6 01		LD	A,@1,P2		; A = next byte
+;	1009	70		ADD	A,E		; add the running sum
+;	100A	01		XCH	A,E		;  ... and save it in E
+;	100B	9B 00		DLD	A,0,P3		; count the bytes
+;	100D	7C F8		BNZ	1007		;  ... 256 of them
+;	100F	24 00 10	JMP	1001		; and start over
+SET LOG/CONSOLE/LEVEL=WARN
+SET MEMORY 00000-009FF/ROM/FAST
+SET MEMORY 00A00-00FFF/NORAM/NOROM
+SET MEMORY 01000-02FFF/RAM/SLOW
+SET MEMORY 03000-0FFFF/NORAM/NOROM
+SET MEMORY 0FD00-0FD00/ROM/SLOW
+SET MEMORY 0FFC0-0FFFF/RAM/FAST
+SET CPU/OPCODE=STOP/CLOCK=4000000
+LOAD basic3
+RESET
+DEPOSIT 1001 26,00,00,27,F0,2F,C6,01,70,01,9B,00,7C,F8,24,00,10
+DEPOSIT PC 1000
+BENCHMARK 200
+SHOW STATISTICS